@@ -0,0 +1,240 @@
+/**
+ * @file approach_controller.cpp
+ *
+ * @brief PID velocity controller for approaching / centering over a target
+ *
+ */
+
+#include "approach_controller.h"
+#include "flight_log.h"
+#include "metrics.h"
+
+#include <math.h>
+#include <sys/time.h>
+
+
+// ------------------------------------------------------------------------------
+//   缺省增益
+// ------------------------------------------------------------------------------
+Approach_Params::
+Approach_Params()
+{
+    //               alt    kp     ki     kd    max_speed
+    schedule[0] = {  5.f, 0.80f, 0.10f, 0.15f, 0.8f};
+    schedule[1] = { 15.f, 0.60f, 0.06f, 0.10f, 1.5f};
+    schedule[2] = { 30.f, 0.45f, 0.03f, 0.05f, 2.5f};
+    max_accel = 2.0f;
+    d_filter_hz = 2.0f;
+    hold_ms = 300;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Approach_Controller::
+Approach_Controller(const Approach_Params &params_) : params(params_)
+{
+    reset(APPROACH_PHASE_WAYPOINT, 0, 0);
+    running = false;
+}
+
+void
+Approach_Controller::
+reset(uint8_t phase_, float tolerance_, uint64_t time_usec)
+{
+    running = true;
+    phase = phase_;
+    tolerance = tolerance_;
+
+    integral_x = integral_y = 0;
+    last_ex = last_ey = 0;
+    d_x = d_y = 0;
+    out_vx = out_vy = 0;
+    last_usec = 0;
+    inside_since = 0;
+    is_converged = false;
+
+    start_usec = time_usec;
+    converged_usec = 0;
+    initial_error = 0;
+    dir_x = dir_y = 0;
+    overshoot = 0;
+    peak_speed = 0;
+    updates = 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   增益插值
+// ------------------------------------------------------------------------------
+Approach_Gains
+Approach_Controller::
+gains_at(float alt) const
+{
+    const Approach_Gains *s = params.schedule;
+    if (alt <= s[0].alt)
+        return s[0];
+    for (int i = 1; i < APPROACH_SCHEDULE_POINTS; i++)
+    {
+        if (alt <= s[i].alt)
+        {
+            float t = (alt - s[i - 1].alt) / (s[i].alt - s[i - 1].alt);
+            Approach_Gains g;
+            g.alt = alt;
+            g.kp = s[i - 1].kp + t * (s[i].kp - s[i - 1].kp);
+            g.ki = s[i - 1].ki + t * (s[i].ki - s[i - 1].ki);
+            g.kd = s[i - 1].kd + t * (s[i].kd - s[i - 1].kd);
+            g.max_speed = s[i - 1].max_speed + t * (s[i].max_speed - s[i - 1].max_speed);
+            return g;
+        }
+    }
+    return s[APPROACH_SCHEDULE_POINTS - 1];
+}
+
+
+// ------------------------------------------------------------------------------
+//   Update
+// ------------------------------------------------------------------------------
+void
+Approach_Controller::
+update(float ex, float ey, float alt, float tvx, float tvy, uint64_t time_usec, float &vx, float &vy)
+{
+    Approach_Gains g = gains_at(alt);
+    float err = sqrtf(ex * ex + ey * ey);
+
+    if (updates == 0)
+    {
+        initial_error = err;
+        if (err > 1e-3f)
+        {
+            dir_x = ex / err;
+            dir_y = ey / err;
+        }
+    }
+
+    // 第一次更新没有微分项, 时间间隔按控制周期
+    float dt = last_usec ? (time_usec - last_usec) * 1e-6f : 1.0f / APPROACH_CONTROL_HZ;
+    if (dt <= 0 || dt > 1)
+        dt = 1.0f / APPROACH_CONTROL_HZ;
+    if (last_usec)
+    {
+        float alpha = dt / (dt + 1.0f / (2 * (float)M_PI * params.d_filter_hz));
+        d_x += alpha * ((ex - last_ex) / dt - d_x);
+        d_y += alpha * ((ey - last_ey) / dt - d_y);
+    }
+    last_ex = ex;
+    last_ey = ey;
+    last_usec = time_usec;
+
+    float cx = tvx + g.kp * ex + g.ki * integral_x + g.kd * d_x;
+    float cy = tvy + g.kp * ey + g.ki * integral_y + g.kd * d_y;
+
+    // 合速度限幅, 保持方向; 饱和时不积分
+    float speed = sqrtf(cx * cx + cy * cy);
+    bool saturated = speed > g.max_speed;
+    if (saturated)
+    {
+        cx *= g.max_speed / speed;
+        cy *= g.max_speed / speed;
+    }
+    else
+    {
+        integral_x += ex * dt;
+        integral_y += ey * dt;
+    }
+
+    // 限制加速度, 避免设定点突变
+    float dvx = cx - out_vx, dvy = cy - out_vy;
+    float dv = sqrtf(dvx * dvx + dvy * dvy);
+    float max_dv = params.max_accel * dt;
+    if (dv > max_dv)
+    {
+        cx = out_vx + dvx * max_dv / dv;
+        cy = out_vy + dvy * max_dv / dv;
+    }
+    out_vx = vx = cx;
+    out_vy = vy = cy;
+
+    // 收敛判断
+    if (err < tolerance)
+    {
+        if (!inside_since)
+            inside_since = time_usec;
+        if (!is_converged && time_usec - inside_since >= (uint64_t)params.hold_ms * 1000)
+        {
+            is_converged = true;
+            converged_usec = time_usec;
+        }
+    }
+    else
+        inside_since = 0;
+
+    // 统计: 超调为沿初始误差方向越过目标的距离
+    float along = ex * dir_x + ey * dir_y;
+    if (-along > overshoot)
+        overshoot = -along;
+    float v = sqrtf(vx * vx + vy * vy);
+    if (v > peak_speed)
+        peak_speed = v;
+    updates++;
+
+    if (FLIGHT_LOG_ENABLED(LOG_LEVEL_DEBUG))
+    {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        log_Control rec;
+        rec.time_us = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+        rec.phase = phase;
+        rec.ex = ex;
+        rec.ey = ey;
+        rec.vx = vx;
+        rec.vy = vy;
+        rec.alt = alt;
+        rec.kp = g.kp;
+        flight_log.write(&rec, sizeof(rec));
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   Finish
+// ------------------------------------------------------------------------------
+void
+Approach_Controller::
+finish(uint64_t time_usec)
+{
+    static Metric_Histogram &converge_ms = metrics.histogram("approach.converge_ms");
+    static Metric_Histogram &overshoot_cm = metrics.histogram("approach.overshoot_cm");
+    static Metric_Counter &failed = metrics.counter("approach.not_converged");
+
+    if (!running)
+        return;
+    running = false;
+
+    uint64_t end = is_converged ? converged_usec : time_usec;
+    uint32_t duration_ms = end > start_usec ? (end - start_usec) / 1000 : 0;
+    if (is_converged)
+    {
+        converge_ms.record(duration_ms);
+        overshoot_cm.record((uint64_t)(overshoot * 100));
+    }
+    else
+        failed.add();
+
+    if (FLIGHT_LOG_ENABLED(LOG_LEVEL_INFO))
+    {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        log_Approach rec;
+        rec.time_us = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+        rec.phase = phase;
+        rec.converged = is_converged;
+        rec.duration_ms = duration_ms;
+        rec.initial_error = initial_error;
+        rec.overshoot = overshoot;
+        rec.peak_speed = peak_speed;
+        rec.updates = updates > 65535 ? 65535 : updates;
+        flight_log.write(&rec, sizeof(rec));
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file approach_controller.h
+ *
+ * @brief PID velocity controller for approaching / centering over a target
+ *
+ * 取代按单位方向以 0.2 / 0.3 / 0.5 m/s 固定速度逐步靠近目标的做法.
+ * 输入为目标相对飞机的水平位置误差 (m, NED), 输出水平速度设定点:
+ *
+ *     v = v_target + kp * e + ki * ∫e + kd * de/dt
+ *
+ * v_target 为跟踪器估计的目标速度 (前馈). 增益按高度插值 (gain scheduling):
+ * 高处像素误差换算成的位置误差噪声大, 增益低而限速高; 低处增益高而限速低.
+ * 输出的合速度限制在 max_speed 内 (保持方向), 饱和时积分不再累加 (anti-windup).
+ * 误差连续 hold_ms 小于 tolerance 时认为收敛.
+ *
+ * 由任务线程按固定频率 APPROACH_CONTROL_HZ 调用, 与设定点的发送频率相同,
+ * 视觉帧之间使用跟踪器的预测值. 每次逼近结束时写一条 APR 日志记录
+ * (收敛用时、初始误差、超调量、峰值速度), 调试等级下每次更新写一条 CTL 记录, 供离线整定增益.
+ *
+ */
+
+#ifndef APPROACH_CONTROLLER_H_
+#define APPROACH_CONTROLLER_H_
+
+#include <stdint.h>
+
+
+// 控制 / 设定点发送频率
+#define APPROACH_CONTROL_HZ 10
+
+#define APPROACH_SCHEDULE_POINTS 3
+
+// 逼近的种类, 写在日志中区分
+enum Approach_Phase
+{
+    APPROACH_PHASE_WAYPOINT = 0,    // 按局部坐标飞向目标
+    APPROACH_PHASE_CENTER,          // 按图像对正目标
+    APPROACH_PHASE_HOLD,            // 识别时保持对正
+    APPROACH_PHASE_DROP,            // 对正投放点
+};
+
+// 某一高度上的增益
+struct Approach_Gains
+{
+    float alt;          // 目标上方高度 (m)
+    float kp;
+    float ki;
+    float kd;
+    float max_speed;    // m/s
+};
+
+struct Approach_Params
+{
+    Approach_Gains schedule[APPROACH_SCHEDULE_POINTS];  // 按 alt 从低到高
+    float max_accel;        // 速度设定点每秒最大变化 (m/s^2)
+    float d_filter_hz;      // 微分项低通截止频率
+    uint32_t hold_ms;       // 误差持续小于 tolerance 多久算收敛
+
+    Approach_Params();
+};
+
+
+class Approach_Controller
+{
+
+public:
+
+    Approach_Controller(const Approach_Params &params = Approach_Params());
+
+    Approach_Params params;
+
+    // 开始一次逼近, tolerance 为收敛半径 (m)
+    void reset(uint8_t phase, float tolerance, uint64_t time_usec);
+
+    // ex, ey: 目标减飞机的水平位置 (m); alt: 目标上方高度 (m); tvx, tvy: 目标速度前馈
+    void update(float ex, float ey, float alt, float tvx, float tvy, uint64_t time_usec,
+                float &vx, float &vy);
+
+    bool converged() const { return is_converged; }
+    bool active() const { return running; }
+
+    // 结束本次逼近并写 APR 记录
+    void finish(uint64_t time_usec);
+
+    // 按高度插值的增益
+    Approach_Gains gains_at(float alt) const;
+
+private:
+
+    bool running;
+    uint8_t phase;
+    float tolerance;
+
+    float integral_x, integral_y;
+    float last_ex, last_ey;
+    float d_x, d_y;                 // 滤波后的误差变化率
+    float out_vx, out_vy;           // 上一次输出, 限制加速度
+    uint64_t last_usec;
+    uint64_t inside_since;          // 进入收敛半径的时刻, 0 为不在半径内
+    bool is_converged;
+
+    // 统计
+    uint64_t start_usec;
+    uint64_t converged_usec;
+    float initial_error;
+    float dir_x, dir_y;             // 初始误差方向, 用来计算超调
+    float overshoot;
+    float peak_speed;
+    uint32_t updates;
+
+};
+
+
+#endif // APPROACH_CONTROLLER_H_
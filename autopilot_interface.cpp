@@ -53,21 +53,37 @@
 // ------------------------------------------------------------------------------
 
 #include "autopilot_interface.h"
-
-bool stable = false, updateellipse = false, getlocalposition = false, drop = false;
-int TargetNum = 0;
-coordinate droptarget;
+#include "flight_log.h"
+#include "metrics.h"
+#include "mission.h"
+#include "swarm_map.h"
+#include "runtime_config.h"
+
+Ellipse_History ellipse_history;
+Target_Tracker target_tracker;
+Camera_Model camera_model;
+State_History state_history;
 // ----------------------------------------------------------------------------------
 //   Time
 // ------------------- ---------------------------------------------------------------
+static uint64_t replay_time_usec = 0;// 非0时为离线回放的时间
+
 uint64_t
 get_time_usec()
 {
+	if (replay_time_usec)
+		return replay_time_usec;
 	static struct timeval _time_stamp;
 	gettimeofday(&_time_stamp, NULL);
 	return _time_stamp.tv_sec*1000000 + _time_stamp.tv_usec;
 }
 
+void
+set_replay_time(uint64_t time_usec)
+{
+	replay_time_usec = time_usec;
+}
+
 // -------------------------------------------------------------------------------
 //  计算三维距离
 // -------------------------------------------------------------------------------
@@ -309,12 +325,18 @@ Autopilot_Interface(Serial_Port *serial_port_, Serial_Port *WL_port_)
 
 	serial_port = serial_port_; // serial port management object
     WL_port = WL_port_;
+    wl_link.open(WL_port, Machine_Num);
+
+    tlog = NULL;
 
 }
 
 Autopilot_Interface::
 ~Autopilot_Interface()
-{}
+{
+	if (tlog)
+		fclose(tlog);
+}
 
 
 // ------------------------------------------------------------------------------
@@ -357,13 +379,13 @@ Autopilot_Interface::
 RTL(int sysnum )
 {
     mavlink_command_long_t com3 = { 0 };
-    com3.target_system= 01;
+    com3.target_system= sysnum;     // 对方收到后改为 1 转发给自己的飞控
     com3.target_component = 01;
     com3.command = 20;
 
     mavlink_message_t message3;
-    mavlink_msg_command_long_encode(sysnum, sysnum, &message3, &com3);
-    int len3 = WL_write_message(message3);
+    mavlink_msg_command_long_encode(Machine_Num, sysnum, &message3, &com3);
+    WL_write_message(message3, WL_PRIORITY_HIGH, true);
 }
 
 // ------------------------------------------------------------------------------
@@ -403,245 +425,292 @@ read_messages()
 		// ----------------------------------------------------------------------
 		if( success )
 		{
+			metrics.mavlink_rx[message.msgid].add();
+			if (tlog)
+				write_tlog(message);
+			handle_message(message, this_timestamps);
+		} // end: if read message
 
-			// Store message sysid and compid.
-			// Note this doesn't handle multiple message sources.
-			current_messages.sysid  = message.sysid;
-			current_messages.compid = message.compid;
+		// Check for receipt of all items
+		received_all =
+				this_timestamps.heartbeat                  &&
+//				this_timestamps.battery_status             &&
+//				this_timestamps.radio_status               &&
+//				this_timestamps.local_position_ned         &&
+//				this_timestamps.global_position_int        &&
+//				this_timestamps.position_target_local_ned  &&
+//				this_timestamps.position_target_global_int &&
+//				this_timestamps.highres_imu                &&
+//				this_timestamps.attitude                   &&
+				this_timestamps.sys_status
+				;
+
+		// give the write thread time to use the port
+		if ( writing_status != false ) {
+			usleep(100); // look for components of batches at 10kHz
+		}
 
-			// Handle Message ID
-			switch (message.msgid)
-			{
+	} // end: while not received all
 
-				case MAVLINK_MSG_ID_HEARTBEAT:
-				{
+	return;
+}
+
+// ------------------------------------------------------------------------------
+//   Handle Message
+//   read_messages 收到一条消息后调用, 离线回放时也可以直接注入消息
+// ------------------------------------------------------------------------------
+void
+Autopilot_Interface::
+handle_message(const mavlink_message_t &message, Time_Stamps &this_timestamps)
+{
+	// Store message sysid and compid.
+	// Note this doesn't handle multiple message sources.
+	current_messages.sysid  = message.sysid;
+	current_messages.compid = message.compid;
+
+	// Handle Message ID
+	switch (message.msgid)
+	{
+
+		case MAVLINK_MSG_ID_HEARTBEAT:
+		{
 //					printf("MAVLINK_MSG_ID_HEARTBEAT\n");
-					mavlink_msg_heartbeat_decode(&message, &(current_messages.heartbeat));
-					current_messages.time_stamps.heartbeat = get_time_usec();
-					this_timestamps.heartbeat = current_messages.time_stamps.heartbeat;
-					break;
-				}
+			mavlink_msg_heartbeat_decode(&message, &(current_messages.heartbeat));
+			current_messages.time_stamps.heartbeat = get_time_usec();
+			static Metric_Age &heartbeat_age = metrics.age("fc.heartbeat");
+			heartbeat_age.touch();
+			this_timestamps.heartbeat = current_messages.time_stamps.heartbeat;
+			break;
+		}
 
-				case MAVLINK_MSG_ID_SYS_STATUS:
-				{
-					printf("MAVLINK_MSG_ID_SYS_STATUS\n");
-					mavlink_msg_sys_status_decode(&message, &(current_messages.sys_status));
-					current_messages.time_stamps.sys_status = get_time_usec();
-					this_timestamps.sys_status = current_messages.time_stamps.sys_status;
-					break;
-				}
+		case MAVLINK_MSG_ID_SYS_STATUS:
+		{
+			printf("MAVLINK_MSG_ID_SYS_STATUS\n");
+			mavlink_msg_sys_status_decode(&message, &(current_messages.sys_status));
+			current_messages.time_stamps.sys_status = get_time_usec();
+			this_timestamps.sys_status = current_messages.time_stamps.sys_status;
+			break;
+		}
 
-				case MAVLINK_MSG_ID_BATTERY_STATUS:
-				{
-					printf("MAVLINK_MSG_ID_BATTERY_STATUS\n");
-					mavlink_msg_battery_status_decode(&message, &(current_messages.battery_status));
-					current_messages.time_stamps.battery_status = get_time_usec();
-					this_timestamps.battery_status = current_messages.time_stamps.battery_status;
-					break;
-				}
+		case MAVLINK_MSG_ID_BATTERY_STATUS:
+		{
+			printf("MAVLINK_MSG_ID_BATTERY_STATUS\n");
+			mavlink_msg_battery_status_decode(&message, &(current_messages.battery_status));
+			current_messages.time_stamps.battery_status = get_time_usec();
+			this_timestamps.battery_status = current_messages.time_stamps.battery_status;
+			break;
+		}
 
-				case MAVLINK_MSG_ID_RADIO_STATUS:
-				{
-					printf("MAVLINK_MSG_ID_RADIO_STATUS\n");
-					mavlink_msg_radio_status_decode(&message, &(current_messages.radio_status));
-					current_messages.time_stamps.radio_status = get_time_usec();
-					this_timestamps.radio_status = current_messages.time_stamps.radio_status;
-					break;
-				}
+		case MAVLINK_MSG_ID_RADIO_STATUS:
+		{
+			printf("MAVLINK_MSG_ID_RADIO_STATUS\n");
+			mavlink_msg_radio_status_decode(&message, &(current_messages.radio_status));
+			current_messages.time_stamps.radio_status = get_time_usec();
+			this_timestamps.radio_status = current_messages.time_stamps.radio_status;
+			break;
+		}
 
-				case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
-				{
+		case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
+		{
 //					printf("MAVLINK_MSG_ID_LOCAL_POSITION_NED\n");
-					getlocalposition = true;
-					mavlink_msg_local_position_ned_decode(&message, &(current_messages.local_position_ned));
-					current_messages.time_stamps.local_position_ned = get_time_usec();
-					this_timestamps.local_position_ned = current_messages.time_stamps.local_position_ned;
+			mavlink_msg_local_position_ned_decode(&message, &(current_messages.local_position_ned));
+			current_messages.time_stamps.local_position_ned = get_time_usec();
+			static Metric_Age &local_position_age = metrics.age("fc.local_position_ned");
+			local_position_age.touch();
+			this_timestamps.local_position_ned = current_messages.time_stamps.local_position_ned;
 //                    std::cout<<"local_position.x:"<<current_messages.local_position_ned.x<<std::endl
 //                             <<"local_position.y:"<<current_messages.local_position_ned.y<<std::endl
 //                             <<"local_position.z:"<<current_messages.local_position_ned.z<<std::endl;
-                    local_position = current_messages.local_position_ned;
-					break;
-				}
+			state_history.push_position(current_messages.time_stamps.local_position_ned, current_messages.local_position_ned);
+			mission_events.post(MISSION_EVENT_LOCAL_POSITION);
+			break;
+		}
 
-				case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
-				{
+		case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+		{
 //					printf("MAVLINK_MSG_ID_GLOBAL_POSITION_INT\n");
-					mavlink_msg_global_position_int_decode(&message, &(current_messages.global_position_int));
+			mavlink_msg_global_position_int_decode(&message, &(current_messages.global_position_int));
 //                    std::cout<<"lat:"<<current_messages.global_position_int.lat<<std::endl;
-					current_messages.time_stamps.global_position_int = get_time_usec();
-					this_timestamps.global_position_int = current_messages.time_stamps.global_position_int;
-                    global_position = current_messages.global_position_int;
-					break;
-				}
-
-				case MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED:
-				{
-					printf("MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED\n");
-					mavlink_msg_position_target_local_ned_decode(&message, &(current_messages.position_target_local_ned));
-					current_messages.time_stamps.position_target_local_ned = get_time_usec();
-					this_timestamps.position_target_local_ned = current_messages.time_stamps.position_target_local_ned;
-					break;
-				}
-
-				case MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT:
-				{
-					printf("MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT\n");
-					mavlink_msg_position_target_global_int_decode(&message, &(current_messages.position_target_global_int));
-					current_messages.time_stamps.position_target_global_int = get_time_usec();
-					this_timestamps.position_target_global_int = current_messages.time_stamps.position_target_global_int;
-					break;
-				}
-
-				case MAVLINK_MSG_ID_HIGHRES_IMU:
-				{
-					printf("MAVLINK_MSG_ID_HIGHRES_IMU\n");
-					mavlink_msg_highres_imu_decode(&message, &(current_messages.highres_imu));
-					current_messages.time_stamps.highres_imu = get_time_usec();
-					this_timestamps.highres_imu = current_messages.time_stamps.highres_imu;
-					break;
-				}
+			current_messages.time_stamps.global_position_int = get_time_usec();
+			this_timestamps.global_position_int = current_messages.time_stamps.global_position_int;
+			state_history.push_heading(current_messages.time_stamps.global_position_int, current_messages.global_position_int.hdg);
+			mission_events.post(MISSION_EVENT_GLOBAL_POSITION);
+			break;
+		}
 
-				case MAVLINK_MSG_ID_ATTITUDE:
-				{
-					printf("MAVLINK_MSG_ID_ATTITUDE\n");
-					mavlink_msg_attitude_decode(&message, &(current_messages.attitude));
-					current_messages.time_stamps.attitude = get_time_usec();
-					this_timestamps.attitude = current_messages.time_stamps.attitude;
-					break;
-				}
-				case MAVLINK_MSG_ID_SET_MODE:
-				{
-					printf("MAVLINK_MSG_ID_SET_MODE\n");
-					mavlink_msg_set_mode_decode(&message, &(current_messages.set_mode));
-					std::cout<<"base_mode:"<<current_messages.set_mode.base_mode<<std::endl
-							 <<"custom_mode:"<<current_messages.set_mode.custom_mode<<std::endl;
-					current_messages.time_stamps.setmode = get_time_usec();
-					this_timestamps.setmode = current_messages.time_stamps.setmode;
-					break;
-				}
-				case MAVLINK_MSG_ID_COMMAND_LONG:
-				{
-					printf("MAVLINK_MSG_ID_COMMAND_LONG\n");
-					mavlink_msg_command_long_decode(&message, &(current_messages.command_long));
-					std::cout<<"command:"<<current_messages.command_long.command<<std::endl
-							 <<"confirmation:"<<(float)current_messages.command_long.confirmation<<std::endl
-							<<"param1:"<<current_messages.command_long.param1<<std::endl
-					<<"param2:"<<current_messages.command_long.param2<<std::endl
-					<<"param3:"<<current_messages.command_long.param3<<std::endl
-					<<"param4:"<<current_messages.command_long.param4<<std::endl
-					<<"param5:"<<current_messages.command_long.param5<<std::endl
-					<<"param6:"<<current_messages.command_long.param6<<std::endl
-					<<"param7:"<<current_messages.command_long.param7<<std::endl;
-					current_messages.time_stamps.command_long = get_time_usec();
-					this_timestamps.command_long = current_messages.time_stamps.command_long;
-					break;
-				}
-				case MAVLINK_MSG_ID_MISSION_ITEM:
-				{
-					std::cout<<"MAVLINK_MSG_ID_MISSION_ITEM"<<endl;
-					mavlink_msg_mission_item_decode(&message, &(current_messages.mission_item));
-					std::cout<<"frame:"<<(float)current_messages.mission_item.frame<<std::endl
-							 <<"command:"<<current_messages.mission_item.command<<std::endl
-							 <<"current:"<<(float)current_messages.mission_item.current<<std::endl
-							 <<"param2:"<<current_messages.mission_item.param2<<std::endl
-							 <<"param3:"<<current_messages.mission_item.param3<<std::endl
-							 <<"param4:"<<current_messages.mission_item.param4<<std::endl
-							 <<"param1:"<<current_messages.mission_item.param1<<std::endl
-							 <<"autocontinue:"<<(float)current_messages.mission_item.autocontinue<<std::endl
-							 <<"z:"<<current_messages.mission_item.z<<std::endl;
-					current_messages.time_stamps.mission_item = get_time_usec();
-					this_timestamps.mission_item = current_messages.time_stamps.mission_item;
-					break;
-				}
-				case MAVLINK_MSG_ID_COMMAND_ACK:
-                {
-                    printf("MAVLINK_MSG_ID_COMMAND_ACK\n");
-                    mavlink_msg_command_ack_decode(&message, &(current_messages.command_ack));
-                    std::cout<<"command:"<<(float)current_messages.command_ack.command<<std::endl
-                             <<"result:"<<(float)current_messages.command_ack.result<<std::endl;
-                    current_messages.time_stamps.command_ack = get_time_usec();
-                    this_timestamps.command_ack = current_messages.time_stamps.command_ack;
-                    break;
-                }
+		case MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED:
+		{
+			printf("MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED\n");
+			mavlink_msg_position_target_local_ned_decode(&message, &(current_messages.position_target_local_ned));
+			current_messages.time_stamps.position_target_local_ned = get_time_usec();
+			this_timestamps.position_target_local_ned = current_messages.time_stamps.position_target_local_ned;
+			break;
+		}
 
-				case MAVLINK_MSG_ID_PARAM_VALUE:
-				{
-					printf("MAVLINK ID PARAM_VALUE!\n");
-					mavlink_msg_param_value_decode(&message,&(current_messages.param_value));
-					this_timestamps.param_value = current_messages.time_stamps.param_value;
-					std::cout<<"param_id:"<<current_messages.param_value.param_id<<std::endl
-							 <<"param_value:"<<current_messages.param_value.param_value<<std::endl
-							 <<"param_type:"<<(float)current_messages.param_value.param_type<<std::endl
-							 <<"param_index:"<<current_messages.param_value.param_index<<std::endl;
-					break;
-				}
-				case MAVLINK_MSG_ID_STATUSTEXT:
-				{
-					printf("Mavlink ID statustext!\n");
-					mavlink_msg_statustext_decode(&message,&(current_messages.statustext));
-					this_timestamps.statustext = current_messages.time_stamps.statustext;
-					std::cout<<"severity:"<<(float)current_messages.statustext.severity<<std::endl
-							 <<"text:"<<current_messages.statustext.text<<std::endl;
-					break;
-				}
+		case MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT:
+		{
+			printf("MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT\n");
+			mavlink_msg_position_target_global_int_decode(&message, &(current_messages.position_target_global_int));
+			current_messages.time_stamps.position_target_global_int = get_time_usec();
+			this_timestamps.position_target_global_int = current_messages.time_stamps.position_target_global_int;
+			break;
+		}
 
-                case MAVLINK_MSG_ID_MISSION_COUNT:
-                {
-                    printf("mavlink id mission_count!\n");
-                    mavlink_msg_mission_count_decode(&message,&(current_messages.mission_count));
-                    std::cout<<"mission count :"<<current_messages.mission_count.count<<std::endl;
-                    break;
-                }
-                case MAVLINK_MSG_ID_MISSION_ACK:
-                {
-                    printf("mavlink id mission_ack!\n");
-                    mavlink_msg_mission_ack_decode(&message,&(current_messages.mission_ack));
-                    std::cout<<"mission_ack:"<<(float)current_messages.mission_ack.type<<std::endl;
-                    break;
-                }
-                case MAVLINK_MSG_ID_MISSION_ITEM_REACHED:
-                {
-                    std::cout<<"mavlink id mission_item_reached!"<<endl;
-                    mavlink_msg_mission_item_reached_decode(&message,&(current_messages.mission_item_reached));
-                    std::cout<<"mission_item_reached seq :"<<current_messages.mission_item_reached.seq<<endl;
+		case MAVLINK_MSG_ID_HIGHRES_IMU:
+		{
+//					printf("MAVLINK_MSG_ID_HIGHRES_IMU\n");
+			mavlink_msg_highres_imu_decode(&message, &(current_messages.highres_imu));
+			current_messages.time_stamps.highres_imu = get_time_usec();
+			this_timestamps.highres_imu = current_messages.time_stamps.highres_imu;
+			break;
+		}
 
-                    break;
-                }
+		case MAVLINK_MSG_ID_ATTITUDE:
+		{
+//					printf("MAVLINK_MSG_ID_ATTITUDE\n");
+			mavlink_msg_attitude_decode(&message, &(current_messages.attitude));
+			current_messages.time_stamps.attitude = get_time_usec();
+			this_timestamps.attitude = current_messages.time_stamps.attitude;
+			state_history.push_attitude(current_messages.time_stamps.attitude, current_messages.attitude);
+			break;
+		}
+		case MAVLINK_MSG_ID_SET_MODE:
+		{
+			printf("MAVLINK_MSG_ID_SET_MODE\n");
+			Set_Mode_View set_mode(message);
+			std::cout<<"base_mode:"<<(float)set_mode.base_mode()<<std::endl
+					 <<"custom_mode:"<<set_mode.custom_mode()<<std::endl;
+			current_messages.time_stamps.setmode = get_time_usec();
+			this_timestamps.setmode = current_messages.time_stamps.setmode;
+			break;
+		}
+		case MAVLINK_MSG_ID_COMMAND_LONG:
+		{
+			printf("MAVLINK_MSG_ID_COMMAND_LONG\n");
+			Command_Long_View command_long(message);
+			std::cout<<"command:"<<command_long.command()<<std::endl
+					 <<"confirmation:"<<(float)command_long.confirmation()<<std::endl
+					<<"param1:"<<command_long.param1()<<std::endl
+			<<"param2:"<<command_long.param2()<<std::endl
+			<<"param3:"<<command_long.param3()<<std::endl
+			<<"param4:"<<command_long.param4()<<std::endl
+			<<"param5:"<<command_long.param5()<<std::endl
+			<<"param6:"<<command_long.param6()<<std::endl
+			<<"param7:"<<command_long.param7()<<std::endl;
+			current_messages.time_stamps.command_long = get_time_usec();
+			this_timestamps.command_long = current_messages.time_stamps.command_long;
+			break;
+		}
+		case MAVLINK_MSG_ID_MISSION_ITEM:
+		{
+			std::cout<<"MAVLINK_MSG_ID_MISSION_ITEM"<<endl;
+			Mission_Item_View mission_item(message);
+			std::cout<<"frame:"<<(float)mission_item.frame()<<std::endl
+					 <<"command:"<<mission_item.command()<<std::endl
+					 <<"current:"<<(float)mission_item.current()<<std::endl
+					 <<"param2:"<<mission_item.param2()<<std::endl
+					 <<"param3:"<<mission_item.param3()<<std::endl
+					 <<"param4:"<<mission_item.param4()<<std::endl
+					 <<"param1:"<<mission_item.param1()<<std::endl
+					 <<"autocontinue:"<<(float)mission_item.autocontinue()<<std::endl
+					 <<"z:"<<mission_item.z()<<std::endl;
+			current_messages.time_stamps.mission_item = get_time_usec();
+			this_timestamps.mission_item = current_messages.time_stamps.mission_item;
+			break;
+		}
+		case MAVLINK_MSG_ID_COMMAND_ACK:
+        {
+            printf("MAVLINK_MSG_ID_COMMAND_ACK\n");
+            Command_Ack_View command_ack(message);
+            command_ack.decode(current_messages.command_ack);
+            std::cout<<"command:"<<(float)command_ack.command()<<std::endl
+                     <<"result:"<<(float)command_ack.result()<<std::endl;
+            current_messages.time_stamps.command_ack = get_time_usec();
+            this_timestamps.command_ack = current_messages.time_stamps.command_ack;
+            break;
+        }
 
+		case MAVLINK_MSG_ID_PARAM_VALUE:
+		{
+			printf("MAVLINK ID PARAM_VALUE!\n");
+			Param_Value_View param_value(message);
+			this_timestamps.param_value = current_messages.time_stamps.param_value;
+			std::cout<<"param_id:"<<std::string(param_value.param_id(), strnlen(param_value.param_id(), param_value.param_id_len))<<std::endl
+					 <<"param_value:"<<param_value.param_value()<<std::endl
+					 <<"param_type:"<<(float)param_value.param_type()<<std::endl
+					 <<"param_index:"<<param_value.param_index()<<std::endl;
+			break;
+		}
+		case MAVLINK_MSG_ID_STATUSTEXT:
+		{
+			printf("Mavlink ID statustext!\n");
+			Statustext_View statustext(message);
+			this_timestamps.statustext = current_messages.time_stamps.statustext;
+			std::cout<<"severity:"<<(float)statustext.severity()<<std::endl
+					 <<"text:"<<std::string(statustext.text(), strnlen(statustext.text(), statustext.text_len))<<std::endl;
+			break;
+		}
 
-				default:
-				{
-					printf("Warning, did not handle message id %i\n",message.msgid);
-					break;
-				}
+        case MAVLINK_MSG_ID_MISSION_COUNT:
+        {
+            printf("mavlink id mission_count!\n");
+            std::cout<<"mission count :"<<Mission_Count_View(message).count()<<std::endl;
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_ACK:
+        {
+            printf("mavlink id mission_ack!\n");
+            std::cout<<"mission_ack:"<<(float)Mission_Ack_View(message).type()<<std::endl;
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_ITEM_REACHED:
+        {
+            std::cout<<"mavlink id mission_item_reached!"<<endl;
+            current_messages.mission_item_reached.seq = Mission_Item_Reached_View(message).seq();
+            std::cout<<"mission_item_reached seq :"<<current_messages.mission_item_reached.seq<<endl;
+            mission_events.post(MISSION_EVENT_MISSION_ITEM, current_messages.mission_item_reached.seq);
 
+            break;
+        }
 
-			} // end: switch msgid
 
-		} // end: if read message
+		default:
+		{
+			printf("Warning, did not handle message id %i\n",message.msgid);
+			break;
+		}
 
-		// Check for receipt of all items
-		received_all =
-				this_timestamps.heartbeat                  &&
-//				this_timestamps.battery_status             &&
-//				this_timestamps.radio_status               &&
-//				this_timestamps.local_position_ned         &&
-//				this_timestamps.global_position_int        &&
-//				this_timestamps.position_target_local_ned  &&
-//				this_timestamps.position_target_global_int &&
-//				this_timestamps.highres_imu                &&
-//				this_timestamps.attitude                   &&
-				this_timestamps.sys_status
-				;
 
-		// give the write thread time to use the port
-		if ( writing_status != false ) {
-			usleep(100); // look for components of batches at 10kHz
-		}
+	} // end: switch msgid
+}
 
-	} // end: while not received all
+// ------------------------------------------------------------------------------
+//   Telemetry Log
+//   与 QGroundControl 的 .tlog 相同: 8 字节大端的 usec 时间戳 + 原始 MAVLink 数据包
+// ------------------------------------------------------------------------------
+bool
+Autopilot_Interface::
+open_tlog(const char *path)
+{
+	tlog = fopen(path, "wb");
+	if (!tlog)
+	{
+		fprintf(stderr, "WARNING: could not open telemetry log %s\n", path);
+		return false;
+	}
+	return true;
+}
 
-	return;
+void
+Autopilot_Interface::
+write_tlog(const mavlink_message_t &message)
+{
+	uint8_t buf[8 + MAVLINK_MAX_PACKET_LEN];
+	uint64_t t = get_time_usec();
+	for (int i = 0; i < 8; i++)
+		buf[i] = (uint8_t)(t >> (56 - 8 * i));
+	uint16_t len = mavlink_msg_to_send_buffer(buf + 8, &message);
+	fwrite(buf, 1, 8 + len, tlog);
 }
 
 // ------------------------------------------------------------------------------
@@ -655,6 +724,8 @@ write_message(mavlink_message_t message)
     int len = serial_port->write_message(message);
     // book keep
     write_count++;
+    static Metric_Counter &messages_sent = metrics.counter("fc.tx_messages");
+    messages_sent.add();
     // Done!
     return len;
 }
@@ -671,12 +742,11 @@ WL_read_messages()
     {
         mavlink_message_t message;
         success = WL_port->read_message(message);
-        if ((message.sysid != 40)&&(message.sysid != Machine_Num))
-        {
-            break;
-        }
-        if(success)
+        // 不是发给本机的、确认、PING 和重传的消息由 wl_link 处理掉
+        if(success && wl_link.receive(message))
         {
+            static Metric_Counter &wl_received = metrics.counter("wl.rx_messages");
+            wl_received.add();
             Inter_message.sysid  = message.sysid;
             Inter_message.compid = message.compid;
             switch (message.msgid)
@@ -687,7 +757,6 @@ WL_read_messages()
                     mavlink_msg_heartbeat_decode(&message, &(Inter_message.heartbeat));
                     Inter_message.time_stamps.heartbeat = get_time_usec();
                     this_timestamps.heartbeat = Inter_message.time_stamps.heartbeat;
-                    printf("uart2 is succeed!\n");
                     break;
                 }
                 case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
@@ -727,6 +796,13 @@ WL_read_messages()
                     this_timestamps.position_target_global_int = Inter_message.time_stamps.position_target_global_int;
                     break;
                 }
+                case MAVLINK_MSG_ID_V2_EXTENSION:
+                {
+                    // 其他飞机的目标地图
+                    if (!swarm_map.receive(message))
+                        printf("Warning, unknown V2_EXTENSION type %u\n", mavlink_msg_v2_extension_get_message_type(&message));
+                    break;
+                }
                 case MAVLINK_MSG_ID_MISSION_ACK:
                 {
                     printf("mavlink id mission_ack!\n");
@@ -749,6 +825,7 @@ WL_read_messages()
 							 <<"param7:"<<Inter_message.command_long.param7<<std::endl;
 					Inter_message.time_stamps.command_long = get_time_usec();
 					this_timestamps.command_long = Inter_message.time_stamps.command_long;
+					mission_events.post(MISSION_EVENT_COMMAND, Inter_message.command_long.command);
 					if((Inter_message.command_long.command==400)&&(Inter_message.command_long.param1 == 0))
 					{
 						mavlink_message_t disarm;
@@ -814,19 +891,15 @@ WL_read_messages()
 // ------------------------------------------------------------------------------
 int
 Autopilot_Interface::
-WL_write_message(mavlink_message_t message)
+WL_write_message(mavlink_message_t message, uint8_t priority, bool reliable)
 {
-    // do the write
-	int len;
-	for (int i = 0; i < 20; ++i)
-	{
-		len = WL_port->write_message(message);
-		usleep(5000);
-	}
+    // 只放进发送队列, 由 WL 写线程发出 (reliable 的单播消息收到确认前重发)
+    if (!wl_link.send(message, priority, reliable))
+        return 0;
 
     WL_write_count++;
     // Done!
-    return len;
+    return 1;
 }
 int
 Autopilot_Interface::
@@ -834,15 +907,14 @@ Send_WL_Global_Position(int Target_machine, mavlink_global_position_int_t Target
 {
     mavlink_message_t Global_messgge;
 	int Glolen = 0;
-    mavlink_msg_global_position_int_encode(Target_machine,Target_machine,&Global_messgge,&Target_Global_Position);
-//    int Glolen = WL_write_message(Global_messgge);
-		Glolen = WL_write_message(Global_messgge);
+    // 没有 target_system 字段, 目标机号写在 compid 中
+    mavlink_msg_global_position_int_encode(Machine_Num,Target_machine,&Global_messgge,&Target_Global_Position);
+		Glolen = WL_write_message(Global_messgge, WL_PRIORITY_NORMAL, true);
 		if(Glolen <= 0)
 		{
-			printf("fail send wl message! try again! ");
-			Glolen = WL_write_message(Global_messgge);
+			// 本条已入队, 队列满时丢掉的是 NORMAL 队列中最早的一条, 不一定是位置消息, 见 wl.tx_dropped
+			printf("WL queue full, oldest NORMAL priority packet dropped\n");
 		}
-		printf("send wl message succeed!\n");
     return Glolen;
 }
 
@@ -868,6 +940,8 @@ write_global_setpoint()
 	//   WRITE
 	// --------------------------------------------------------------------------
 	int len = write_message(message);
+	static Metric_Counter &setpoints_sent = metrics.counter("fc.global_setpoints");
+	setpoints_sent.add();
 	// check the write
 	if ( len <= 0 )
 		fprintf(stderr,"WARNING: could not send POSITION_TARGET_GLOBAL_INT \n");
@@ -896,12 +970,27 @@ write_local_setpoint()
 	mavlink_msg_set_position_target_local_ned_encode(system_id, companion_id, &message, &sp);
 	// do the write
 	int len = write_message(message);
+	static Metric_Counter &setpoints_sent = metrics.counter("fc.local_setpoints");
+	setpoints_sent.add();
 	// check the write
 	if ( len <= 0 )
 		fprintf(stderr,"WARNING: could not send POSITION_TARGET_LOCAL_NED \n");
-	else
-//		printf("%lu POSITION_TARGET  = [ %f , %f , %f ] \n", write_count, sp.x, sp.y, sp.z);
-	std::cout<<sp.type_mask<<std::endl;
+	else if (FLIGHT_LOG_ENABLED(LOG_LEVEL_DEBUG))
+	{
+		log_Setpoint rec;
+		rec.time_us   = get_time_usec();
+		rec.type_mask = sp.type_mask;
+		rec.frame     = sp.coordinate_frame;
+		rec.x         = sp.x;
+		rec.y         = sp.y;
+		rec.z         = sp.z;
+		rec.vx        = sp.vx;
+		rec.vy        = sp.vy;
+		rec.vz        = sp.vz;
+		rec.yaw       = sp.yaw;
+		rec.yaw_rate  = sp.yaw_rate;
+		flight_log.write(&rec, sizeof(rec));
+	}
 
 	return;
 }
@@ -1029,34 +1118,8 @@ toggle_offboard_control( bool flag )
 
 	Servo_Control(11,1250);
 
-    ///////请求数据流(关闭ALL)
-    mavlink_request_data_stream_t com1 = { 0 };
-    com1.target_system= 01;
-    com1.target_component = 01;
-    com1.req_stream_id = MAV_DATA_STREAM_ALL;
-    com1.req_message_rate = 2;
-    com1.start_stop = 0;
-    mavlink_message_t message1;
-    mavlink_msg_request_data_stream_encode(255, 190, &message1, &com1);
-    int len1 = serial_port->write_message(message1);
-    usleep(100);
-
-    /////////////////////////////////请求位置数据流
-    mavlink_request_data_stream_t comdata = { 0 };
-    comdata.req_message_rate = 5;
-    comdata.req_stream_id = MAV_DATA_STREAM_POSITION;
-    comdata.start_stop = 1;
-    comdata.target_system = 1;
-    comdata.target_component = 1;
-    mavlink_message_t Rmassage;
-    mavlink_msg_request_data_stream_encode(255,190,&Rmassage,&comdata);
-	int Rlen;
-    //重复发送确保指令收到
-    for (int i = 0; i < 3; ++i)
-    {
-    	Rlen = serial_port->write_message(Rmassage);
-        usleep(100);
-    }
+    ///////请求数据流: 按启动时协商的频率重发 (原来关闭 ALL 后只请求 5Hz 的位置数据流)
+    stream_rates.apply(*this);
     usleep(200);
 
     ////////////////////////////////////////解锁
@@ -1100,7 +1163,8 @@ toggle_offboard_control( bool flag )
 
     // Done!
 
-    return Rlen;
+    // 数据流请求改由 stream_rates 发送, 返回值为设置模式消息的写入长度, 调用处据此判断是否写出
+    return len;
 }
 
 
@@ -1189,6 +1253,15 @@ start()
 	}
 
 
+	// --------------------------------------------------------------------------
+	//   NEGOTIATE STREAM RATES
+	// --------------------------------------------------------------------------
+
+	// 只保留需要的遥测, 腾出串口带宽给设定点; 写线程还没有启动, 直接写串口
+	if ( not stream_rates.negotiate(*this) )
+		fprintf(stderr, "WARNING: some telemetry streams below requested rate\n");
+
+
 	// --------------------------------------------------------------------------
 	//   GET INITIAL POSITION
 	// --------------------------------------------------------------------------
@@ -1267,6 +1340,7 @@ stop()
 
 	// signal exit
 	time_to_exit = true;
+	wl_link.stop();
 
 	// wait for exit
 	pthread_join(read_tid ,NULL);
@@ -1383,194 +1457,6 @@ handle_quit( int sig )
 
 }
 
-int
-Autopilot_Interface::
-Throw(float yaw,int Tnum)
-{
-    float local_alt = -22;
-	mavlink_set_position_target_local_ned_t locsp;
-	set_velocity(0, 0, 0.5, locsp);
-	set_yaw(yaw, locsp);
-	locsp.z = local_alt;
-	update_local_setpoint(locsp);
-	while(1)
-    {
-        if((current_messages.local_position_ned.z+0.5-local_alt)>=0)
-        {
-			set_velocity(0, 0, 0, locsp);
-			set_yaw(yaw, locsp);
-			update_local_setpoint(locsp);
-        	break;
-        }
-        else
-        {
-            set_velocity(0, 0, 0.5, locsp);
-            set_yaw(yaw, locsp);
-            update_local_setpoint(locsp);
-            usleep(200000);
-        }
-    }
-
-	//执行reng的过程
-    drop = true;
-    //给响应时间识别小圆,需加判断是否写入目标点
-    while(drop)
-	{
-		float loc = droptarget.locx+droptarget.locy;
-		if(loc!=0)
-		{
-			break;
-		}
-		else
-		{
-			usleep(20000);
-		}
-	}
-
-//    int i = 0;
-
-    while (drop)
-    {
-		float locx = droptarget.x;
-		float locy = droptarget.y;
-    	mavlink_local_position_ned_t pos = current_messages.local_position_ned;
-//    	float disx = locx - pos.x;
-//    	float disy = locy - pos.y;
-    	float adisx = fabsf(locx);
-    	float adisy	= fabsf(locy);
-
-    	if(adisx >= adisy)
-		{
-			set_velocity(0.2*(locx /adisx),0.2*(locy/adisx),0,locsp);
-		}
-		else
-		{
-			set_velocity(0.2*(locx/adisy),0.2*(locy/adisy),0,locsp);
-		}
-        set_yaw(yaw, // [rad]
-                locsp);
-        // SEND THE COMMAND
-        update_local_setpoint(locsp);
-        mavlink_local_position_ned_t locpos = current_messages.local_position_ned;
-
-        if ((adisx < 5)&&(adisy < 5))
-        {
-            Set_Mode(05);
-            usleep(10000);
-            Set_Mode(04);
-            printf("input drop process!!!\n");
-            // ------------------------------------------------------------------------------
-            //	驱动舵机：<PWM_Value:1100-1900> 打开：1700、关闭：1250
-            //	ServoId：AUX_OUT1-6 对应148-153/9-14
-            // ------------------------------------------------------------------------------
-            sleep(1);
-            int lenn = Servo_Control(11+Tnum, 1700);
-            ofstream fout("little_ellipse.txt");
-            fout<<"droptarget_a:"<<droptarget.a<<endl;
-            fout.close();
-            Tnum = Tnum + 1;
-            sleep(1);
-            drop = false;
-            break;
-        }
-        else
-        {
-            usleep(200000);
-        }
-    }
-    return Tnum;
-}
-
-int
-Autopilot_Interface::
-//ThrowF(float yaw,int32_t lat,int32_t lon,int Num)
-ThrowF(float yaw,target* targetF)
-{
-	mavlink_set_position_target_global_int_t glosp;
-	mavlink_set_position_target_local_ned_t losp;
-	int T = 0;
-	//detect hight
-	float hight = 20;
-	Set_Mode(05);
-	usleep(400);
-	Set_Mode(04);
-	set_global_velocity(1,1,0,glosp);
-	set_velocity(1,1,0,losp);
-	update_local_setpoint(losp);
-	usleep(100);
-	update_global_setpoint(glosp);
-	usleep(400);
-	set_global_position(targetF->lat,targetF->lon,hight,glosp);
-	set_global_yaw(yaw,glosp);
-	update_global_setpoint(glosp);
-	int Targetnum = TargetNum;
-	TargetNum = targetF->num;
-	while(updateellipse)
-	{
-		mavlink_global_position_int_t current_global = current_messages.global_position_int;
-		float distan = Distance(current_global.lat,current_global.lon,current_global.relative_alt,targetF->lat,targetF->lon,hight*1000);
-		if(distan < 8)
-		{
-			sleep(1);
-			//updateellipse = false;
-			break;
-		}
-		else
-		{
-			update_global_setpoint(glosp);
-			usleep(200000);
-
-		}
-	}
-	stable = true;
-	int TF = 0;
-	while(stable)
-	{
-
-		sleep(1);
-		TF++;
-		if (TF==10)
-		{
-			int TplusF = target_ellipse_position[TargetNum].T_N + target_ellipse_position[TargetNum].F_N;
-			if(TplusF <= 5 )
-			{
-				break;
-			}
-			else
-			{
-				continue;
-			}
-		}
-		else
-		{
-			;
-		}
-
-	}
-	if (target_ellipse_position[TargetNum].T_N >= 50)
-    {
-        T = Throw(yaw,2);
-    }
-    else
-    {
-        //RTL
-        mavlink_command_long_t com3 = { 0 };
-        com3.target_system= 01;
-        com3.target_component = 01;
-        com3.command = 20;
-
-        mavlink_message_t message3;
-        mavlink_msg_command_long_encode(255, 190, &message3, &com3);
-        for (int i = 0; i < 3; ++i)
-        {
-            int len3 = write_message(message3);
-        }
-    }
-	TargetNum = Targetnum;
-	return T;
-}
-
-
 // ------------------------------------------------------------------------------
 //   Read Thread
 // ------------------------------------------------------------------------------
@@ -1652,11 +1538,8 @@ WL_write_thread()
 
     WL_writing = true;
 
-    while ( !time_to_exit )
-    {
-        usleep(250000);   // Stream at 4Hz
-//		write_setpoint();
-    }
+    // 按优先级发送队列中的消息、重发未确认的消息, 定时发心跳和 PING, 直到 stop()
+    wl_link.run();
 
     // signal end
     WL_writing = false;
@@ -1693,6 +1576,8 @@ start_WL_read_thread(void *args)
 	Autopilot_Interface *autopilot_interface = (Autopilot_Interface *)args;
 
 	autopilot_interface->start_WL_read();
+
+	return NULL;
 }
 
 
@@ -1723,20 +1608,14 @@ start_WL_write_thread(void *args)
 // ------------------------------------------------------------------------------
 //  将当前时刻看到的所有可能为目标的椭圆存放在容器中
 // ------------------------------------------------------------------------------
-void possible_ellipse(Autopilot_Interface& api, vector<coordinate>& ellipse_out, vector<target>& target_ellipse){
+void possible_ellipse(Autopilot_Interface& api, const Vision_Mode& mode, vector<coordinate>& ellipse_out, vector<target>& target_ellipse, uint64_t frame_usec){
     float dis = 7;//在室外的参数圆心相距9米内都算一个圆
 //	float dis = 0.05;//在室内测试用0.05
+    Frame_Pose pose = frame_pose(api, frame_usec);
+    camera_model.back_project(pose, ellipse_out);
     for (auto &p:ellipse_out) {
-    	float x_l, y_l, c_x, c_y, x_r, y_r;
-		uint16_t hdg;
-    	realtarget(api, p, x_l, y_l);
-    	p.locx = x_l;
-    	p.locy = y_l;
-		c_x = 180 - p.y;
-		c_y = p.x - 320;
-		hdg = api.current_messages.global_position_int.hdg;
-		x_r = c_x * cos(hdg * 3.1415926 / 180 / 100) - c_y * sin(hdg * 3.1415926 / 180 / 100);//单位是:像素
-		y_r = c_y * cos(hdg * 3.1415926 / 180 / 100) + c_x * sin(hdg * 3.1415926 / 180 / 100);
+    	float x_r, y_r;
+		camera_model.pixel_offset(pose, p, x_r, y_r);
     	if (target_ellipse.size() == 0) {
                 target t;
                 t.locx = p.locx;
@@ -1753,12 +1632,12 @@ void possible_ellipse(Autopilot_Interface& api, vector<coordinate>& ellipse_out,
                 target_ellipse.push_back(t);
                 continue;
             }
-            if(stable == true || updateellipse == true) {
+            if(mode.stable || mode.update) {
                 int temp;
-    	        if(target_ellipse.size() == TargetNum ){
-                    temp = TargetNum - 1;
+    	        if(target_ellipse.size() == mode.target_num ){
+                    temp = mode.target_num - 1;
                 } else{
-    	            temp = TargetNum;
+    	            temp = mode.target_num;
     	        }
     	        if(abs(p.locx - target_ellipse[temp].locx) < dis &&
                    abs(p.locy - target_ellipse[temp].locy) < dis){
@@ -1818,20 +1697,26 @@ void possible_ellipse(Autopilot_Interface& api, vector<coordinate>& ellipse_out,
 		}
 }
 
-void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_out, vector<target>& target_ellipse){
-    float dis = 5;//在室外的参数圆心相距9米内都算一个圆
+// 目标编号即 target_tracker 的编号, 表满之后不再增加新目标, 次数见 vision.targets_rejected
+static bool target_table_full(const vector<target>& target_ellipse){
+    static Metric_Counter &rejected = metrics.counter("vision.targets_rejected");
+    if (target_ellipse.size() < TRACKER_MAX_TARGETS)
+        return false;
+    if (rejected.get() == 0)
+        fprintf(stderr, "WARNING: target table full (%d), ignoring new targets\n", TRACKER_MAX_TARGETS);
+    rejected.add();
+    return true;
+}
+
+void possible_ellipse_r(Autopilot_Interface& api, const Vision_Mode& mode, vector<coordinate>& ellipse_out, vector<target>& target_ellipse, uint64_t frame_usec){
+    float dis = current_vision_config()->target.merge_dist;//在室外的参数圆心相距5米内都算一个圆, 见 config/uav.yml
 //	float dis = 0.05;//在室内测试用0.05
+    uint64_t now = frame_usec;
+    Frame_Pose pose = frame_pose(api, frame_usec);
+    camera_model.back_project(pose, ellipse_out);
     for (auto &p:ellipse_out) {
-        float x_l, y_l, c_x, c_y, x_r, y_r;
-        uint16_t hdg;
-        realtarget(api, p, x_l, y_l);
-        p.locx = x_l;
-        p.locy = y_l;
-        c_x = 180 - p.y;
-        c_y = p.x - 320;
-        hdg = api.current_messages.global_position_int.hdg;
-        x_r = c_x * cos(hdg * 3.1415926 / 180 / 100) - c_y * sin(hdg * 3.1415926 / 180 / 100);//单位是:像素
-        y_r = c_y * cos(hdg * 3.1415926 / 180 / 100) + c_x * sin(hdg * 3.1415926 / 180 / 100);
+        float x_r, y_r;
+        camera_model.pixel_offset(pose, p, x_r, y_r);
         if (target_ellipse.size() == 0) {
             target t;
             t.locx = p.locx;
@@ -1846,14 +1731,15 @@ void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_ou
             else {}
             t.possbile = (float) t.T_N / (float) (t.T_N + t.F_N + 0.001);
             target_ellipse.push_back(t);
+            target_tracker.update(target_ellipse.size() - 1, t.locx, t.locy, now);
             continue;
         }
-        if(stable == true || updateellipse == true) {
+        if(mode.stable || mode.update) {
             int temp;
-            if(target_ellipse.size() == TargetNum ){
-                temp = TargetNum - 1;
+            if(target_ellipse.size() == mode.target_num ){
+                temp = mode.target_num - 1;
             } else{
-                temp = TargetNum;
+                temp = mode.target_num;
             }
             if(abs(p.locx - target_ellipse[temp].locx) < dis &&
                abs(p.locy - target_ellipse[temp].locy) < dis) {
@@ -1873,6 +1759,7 @@ void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_ou
                 else{
                 target_ellipse[temp].locx = p.locx;
                 target_ellipse[temp].locy = p.locy;
+                target_tracker.update(temp, p.locx, p.locy, now);
                 target_ellipse[temp].a = p.a;
                 target_ellipse[temp].x = x_r;
                 target_ellipse[temp].y = y_r;
@@ -1894,6 +1781,7 @@ void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_ou
                     abs(p.locy - target_ellipse[i].locy) < dis) {
                     target_ellipse[i].locx = p.locx;
                     target_ellipse[i].locy = p.locy;
+                    target_tracker.update(i, p.locx, p.locy, now);
                     target_ellipse[i].a = p.a;
                     target_ellipse[i].x = x_r;
                     target_ellipse[i].y = y_r;
@@ -1909,6 +1797,8 @@ void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_ou
 
                 } else if (i != (target_ellipse.size() - 1)) {
                     continue;
+                } else if (target_table_full(target_ellipse)) {
+                    break;
                 } else {
                     target t;
                     t.locx = p.locx;
@@ -1923,6 +1813,7 @@ void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_ou
                     else {}
                     t.possbile = (float) t.T_N / (float) (t.T_N + t.F_N + 0.001);
                     target_ellipse.push_back(t);
+                    target_tracker.update(target_ellipse.size() - 1, t.locx, t.locy, now);
                     break;
 
                 }
@@ -1931,23 +1822,25 @@ void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_ou
 
     }
 }
-void resultTF(Autopilot_Interface& api, vector<target>& ellipse_in, vector<target>& ellipse_1, vector<target>& ellipse_0){
+bool resultTF(Autopilot_Interface& api, const Vision_Mode& mode, vector<target>& ellipse_in, vector<target>& ellipse_1, vector<target>& ellipse_0){
 //	float possobile = 0.5, dis = 0.05;//室内测试设置0.5，0.05， 室外待定
 //	uint32_t num = 10;//室内测试设置10，室外待定
-	float possobile = 0.4, dis = 5;//室外测试：识别概率大于0.4都算作T，两圆圆心相距9米内都算一个圆
-	uint32_t num = 50;//室外测试：识别次数大于50次即可进行TF判断。
+	Vision_Config_Ptr config = current_vision_config();//室外测试的参数见 config/uav.yml 的 target 一节
+	float possobile = config->target.t_possible, dis = config->target.merge_dist;//识别概率大于0.4都算作T，两圆圆心相距5米内都算一个圆
+	uint32_t num = config->target.min_votes;//识别次数大于50次即可进行TF判断。
 	int temp;
+	bool done = false;
 	if(ellipse_in.size() == 0){
 
 	} else {
-        if(ellipse_in.size() == TargetNum ){
-            temp = TargetNum - 1;
+        if(ellipse_in.size() == mode.target_num ){
+            temp = mode.target_num - 1;
         } else{
-            temp = TargetNum;
+            temp = mode.target_num;
         }
         target p = ellipse_in[temp];
         if (p.possbile > possobile && p.T_N > num) {
-            stable = false;
+            done = true;
             if (ellipse_1.size() == 0) {
                 p.lat = api.current_messages.global_position_int.lat;
                 p.lon = api.current_messages.global_position_int.lon;
@@ -1969,7 +1862,7 @@ void resultTF(Autopilot_Interface& api, vector<target>& ellipse_in, vector<targe
 
             }
         } else if (p.possbile < possobile && p.F_N > num) {
-            stable = false;
+            done = true;
             if (ellipse_0.size() == 0) {
                 p.lat = api.current_messages.global_position_int.lat;
                 p.lon = api.current_messages.global_position_int.lon;
@@ -1991,29 +1884,29 @@ void resultTF(Autopilot_Interface& api, vector<target>& ellipse_in, vector<targe
             }
         }
     }
+	return done;
 	}
 
 
-void getdroptarget(Autopilot_Interface& api, coordinate& droptarget, vector<coordinate>& ellipse_out) {
+bool getdroptarget(Autopilot_Interface& api, coordinate& droptarget, vector<coordinate>& ellipse_out, uint64_t frame_usec) {
+    bool found = false;
     if (ellipse_out.size() != 0){
-        float dis = 5;
+        float dis = current_vision_config()->target.drop_dist;
 		sort(ellipse_out.begin(),ellipse_out.end());
-		float e_x, e_y, locx, locy, c_x, c_y, x_r, y_r;
-		uint16_t hdg;
-		realtarget(api, ellipse_out[0], e_x, e_y);
-		locx = api.current_messages.local_position_ned.x;
-		locy = api.current_messages.local_position_ned.y;
-		c_x = 180 - ellipse_out[0].y;
-		c_y = ellipse_out[0].x - 320;
-		hdg = api.current_messages.global_position_int.hdg;
-		x_r = c_x * cos(hdg * 3.1415926 / 180 / 100) - c_y * sin(hdg * 3.1415926 / 180 / 100);//单位是:像素
-		y_r = c_y * cos(hdg * 3.1415926 / 180 / 100) + c_x * sin(hdg * 3.1415926 / 180 / 100);
+		float e_x, e_y, locx, locy, x_r, y_r;
+		Frame_Pose pose = frame_pose(api, frame_usec);
+		camera_model.back_project(pose, ellipse_out[0], e_x, e_y);
+		camera_model.pixel_offset(pose, ellipse_out[0], x_r, y_r);
+		locx = pose.x;
+		locy = pose.y;
 		if(abs(e_x - locx) < dis && abs(e_y - locy) < dis){
 			droptarget.locx = e_x;
 			droptarget.locy = e_y;
 			droptarget.a = ellipse_out[0].a;
 			droptarget.x = x_r;
 			droptarget.y = y_r;
+			target_tracker.update(TRACK_DROP, e_x, e_y, frame_usec);
+			found = true;
 			cout << "target_x" << droptarget.locx << endl;
 			cout << "target_y" << droptarget.locy << endl;
             cout << "cam_x" << droptarget.x << endl;
@@ -2026,27 +1919,66 @@ void getdroptarget(Autopilot_Interface& api, coordinate& droptarget, vector<coor
     	cout << "target_x" << droptarget.locx << endl;
         cout << "target_y" << droptarget.locy << endl;
     }
+    return found;
+}
+
+// ------------------------------------------------------------------------------
+//  相机到目标平面的高度
+// ------------------------------------------------------------------------------
+float target_height(float z){
+    float h_diff = -12;//目标高度比起飞高度低了5米
+//    return 25;//桌子高度0.74M
+    return -z + h_diff;
+}
+
+float target_height(Autopilot_Interface& api){
+    return target_height(api.current_messages.local_position_ned.z);
+}
+
+// ------------------------------------------------------------------------------
+//  跟踪器预测的目标相对飞机的偏移, 换算成像素以沿用原来的像素阈值
+// ------------------------------------------------------------------------------
+bool predicted_offset(Autopilot_Interface& api, int id, float& dx, float& dy){
+    float tx, ty;
+    if (!target_tracker.predict(id, get_time_usec(), tx, ty))
+        return false;
+    float h = target_height(api);
+    if (h < 1)
+        return false;
+    dx = (tx - api.current_messages.local_position_ned.x) * camera_model.fx / h;
+    dy = (ty - api.current_messages.local_position_ned.y) * camera_model.fy / h;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+//  图像采集时刻的飞机位姿, 位置/航向/姿态均由 state_history 插值到 frame_usec,
+//  旋转矩阵每帧只算一次.  缓冲区里没有该时刻附近的数据时退回到最新的消息,
+//  没有姿态数据时按相机垂直向下处理
+// ------------------------------------------------------------------------------
+Frame_Pose frame_pose(Autopilot_Interface& api, uint64_t frame_usec){
+    Position_Sample pos;
+    if (!state_history.position_at(frame_usec, pos)) {
+        pos.x = api.current_messages.local_position_ned.x;
+        pos.y = api.current_messages.local_position_ned.y;
+        pos.z = api.current_messages.local_position_ned.z;
+    }
+
+    float roll = 0, pitch = 0, yaw;
+    Attitude_Sample att;
+    if (state_history.attitude_at(frame_usec, att)) {
+        roll = att.roll;
+        pitch = att.pitch;
+        yaw = att.yaw;
+    } else if (!state_history.heading_at(frame_usec, yaw)) {
+        yaw = D2R(api.current_messages.global_position_int.hdg);
+    }
+//    yaw = 0;//设置机头方向为正北
+
+    return make_pose(pos.x, pos.y, target_height(pos.z), roll, pitch, yaw);
 }
 
 void realtarget(Autopilot_Interface& api, coordinate& cam, float& x_l, float& y_l){
-    int32_t h = -api.current_messages.local_position_ned.z;
-        int32_t h_diff = -12;//目标高度比起飞高度低了5米
-            h = h + h_diff;
-//        int32_t h = 25;//桌子高度0.74M
-    uint16_t hdg = api.current_messages.global_position_int.hdg;
-//        uint16_t hdg = 0;//设置机头方向为正北
-    float loc_x = api.current_messages.local_position_ned.x;
-    float loc_y = api.current_messages.local_position_ned.y;
-    /*在相机坐标系下椭圆圆心的坐标（相机坐标系正东为x，正北为y）*/
-    float x = (cam.x - cx) / fx * h;//单位为：m
-    float y = -(cam.y - cy) / fy * h;
-    //将相机坐标系坐标转换为以摄像头所在中心的导航坐标系下坐标（正东为y,正北为x）
-    float x_r = y * cos(hdg * 3.1415926 / 180 / 100) - x * sin(hdg * 3.1415926 / 180 / 100);//单位是:m
-    float y_r = x * cos(hdg * 3.1415926 / 180 / 100) + y * sin(hdg * 3.1415926 / 180 / 100);
-    x_l = x_r + loc_x;
-    y_l = y_r + loc_y;
-//	x_l = x_r;
-//	y_l = y_r;
+    camera_model.back_project(frame_pose(api, get_time_usec()), cam, x_l, y_l);
 }
 
 void OptimizEllipse(vector<Ellipse> &ellipse_out, vector<Ellipse> &ellipses_in){
@@ -2120,71 +2052,33 @@ void OptimizEllipse(vector<Ellipse> &ellipse_out, vector<Ellipse> &ellipses_in){
 	}
 
 }
-/*将得到的圆放入vector中，并对其中数量大于一定范围的圆进行下一步处理，以滤除偶然检测出的圆*/
-void filtellipse(Autopilot_Interface& api, vector<Ellipse>& ellipseok, vector<Ellipse>& ellipse_big){
+/*将得到的圆放入ellipse_history中，并对其中票数大于一定范围的圆进行下一步处理，以滤除偶然检测出的圆*/
+void filtellipse(Autopilot_Interface& api, vector<Ellipse>& ellipseok, vector<Ellipse>& ellipse_big, uint64_t frame_usec){
 
-	for(auto &p:ellipse_big){
-		float dis = 4;
+	uint64_t now = frame_usec;
+	ellipse_history.decay(now);
+
+	Frame_Pose pose = frame_pose(api, frame_usec);
+	vector<int> cell(ellipse_big.size());
+	for(auto i = 0; i < ellipse_big.size(); i++){
+		Ellipse &p = ellipse_big[i];
 		float locx, locy;
 		coordinate cam;
 		cam.x = p._xc;
 		cam.y = p._yc;
-		realtarget(api, cam, locx, locy);
-		cam.locx = locx;
-		cam.locy = locy;
-		if(ellipse_pre.size() == 0){
-			cam.num = 1;
-			ellipse_pre.push_back(cam);
-			continue;
-		}
-		for(auto i = 0; i < ellipse_pre.size(); i++){
-			if(abs(cam.locx - ellipse_pre[i].locx) < dis &&
-			   abs(cam.locy - ellipse_pre[i].locy) < dis){
-				ellipse_pre[i].locx = cam.locx;
-				ellipse_pre[i].locy = cam.locy;
-				ellipse_pre[i].x = cam.x;
-				ellipse_pre[i].y = cam.y;
-				ellipse_pre[i].num = ellipse_pre[i].num + 1;
-				break;
-			} else if(i != (ellipse_pre.size() - 1)){
-				continue;
-			} else{
-				cam.num = 1;
-				ellipse_pre.push_back(cam);
-				break;
-			}
-			}
-	}
-	uint16_t totle = 0;
-	for(auto &p: ellipse_pre){
-		totle = totle + p.num;
-//		cout<<"ellipse_pre_locx:"<<p.locx<<endl;
-//		cout<<"ellipse_pre_locy:"<<p.locy<<endl;
-//		cout<<"ellipse_pre_num:"<<ellipse_pre.size()<<endl;
+		camera_model.back_project(pose, cam, locx, locy);
+		cell[i] = ellipse_history.vote(locx, locy, cam.x, cam.y, now);
 	}
 
-	for(auto &p: ellipse_big){
-		for(auto &q: ellipse_pre){
-			q.possible = q.num / (totle + 0.0001);
-			float disx = (p._xc - q.x) / p._a;
-			float disy = (p._yc - q.y) / p._b;
-			float thresh = 0.9;//该值应小于1
-			if( (disx < thresh && disy < thresh) && (q.possible > 0.1 && q.num > 2)){
-				ellipseok.push_back(p);
-				break;
-			} else
-				continue;
+	for(auto i = 0; i < ellipse_big.size(); i++){
+		Ellipse &p = ellipse_big[i];
+		const History_Cell &q = ellipse_history.cell(cell[i]);
+		// 与该格子上一次投票时的像素位置比较, 本次投票已把 x, y 改成了这个椭圆自己的圆心
+		float disx = fabs(p._xc - q.prev_x) / p._a;
+		float disy = fabs(p._yc - q.prev_y) / p._b;
+		float thresh = 0.9;//该值应小于1
+		if( (disx < thresh && disy < thresh) && (ellipse_history.possible(cell[i]) > 0.1 && q.vote > 2)){
+			ellipseok.push_back(p);
 		}
-
 	}
-/*
-	for(auto &p:ellipse_pre){
-		cout<<"ellipse_pre_locx:"<<p.locx<<endl;
-		cout<<"ellipse_pre_locy:"<<p.locy<<endl;
-		cout<<"ellipse_pre_number:"<<p.num<<endl;
-		cout<<"ellipse_pre_possible:"<<p.possible<<endl;
-		cout<<"ellipse_pre_size:"<<ellipse_pre.size()<<endl;
-		cout<<"ellipse_ok_size:"<<ellipseok.size()<<endl;
-	}
-*/
 }
@@ -63,12 +63,20 @@
 #include <iostream>
 #include <fstream>
 #include "mavlink/common/mavlink.h"
+#include "mavlink_views.h"
 #include "ellipse/EllipseDetectorYaed.h"
-
-extern bool stable, updateellipse, getlocalposition, drop;
-extern int TargetNum;
-extern coordinate droptarget;
-extern vector<target> target_ellipse_position, ellipse_T, ellipse_F;
+#include "ellipse_history.h"
+#include "target_tracker.h"
+#include "camera_model.h"
+#include "state_history.h"
+#include "target_channel.h"
+#include "wl_link.h"
+#include "stream_rates.h"
+
+extern Ellipse_History ellipse_history;
+extern Target_Tracker target_tracker;
+extern Camera_Model camera_model;
+extern State_History state_history;
 
 // ------------------------------------------------------------------------------
 //   Defines
@@ -131,6 +139,7 @@ extern vector<target> target_ellipse_position, ellipse_T, ellipse_F;
 
 // helper functions
 uint64_t get_time_usec();
+void set_replay_time(uint64_t time_usec);
 void set_position(float x, float y, float z, mavlink_set_position_target_local_ned_t &sp);
 void set_velocity(float vx, float vy, float vz, mavlink_set_position_target_local_ned_t &sp);
 //void set_acceleration(float ax, float ay, float az, mavlink_set_position_target_local_ned_t &sp);
@@ -310,6 +319,8 @@ public:
     char WL_reading;
     char WL_writing;
     uint64_t WL_write_count;
+    Wl_Link wl_link;            // 机间链路: 寻址、发送队列、确认重发、各机状态
+    Stream_Rates stream_rates;  // 飞控数据流的期望频率, start() 时协商
 
 
     int system_id;
@@ -320,8 +331,6 @@ public:
     Mavlink_Messages Inter_message;
     mavlink_set_position_target_local_ned_t initial_position;
     mavlink_set_position_target_global_int_t initial_global_position;
-    mavlink_global_position_int_t global_position;
-    mavlink_local_position_ned_t local_position;
 
     //void update_setpoint(mavlink_set_position_target_local_ned_t setpoint);
     void update_local_setpoint(mavlink_set_position_target_local_ned_t setpoint);
@@ -331,10 +340,13 @@ public:
     int Servo_Control(float ServoId, float PWM_Value);
     void RTL(int sysnum);
     void read_messages();
+    void handle_message(const mavlink_message_t &message, Time_Stamps &this_timestamps);
     int  write_message(mavlink_message_t message);
 
+    bool open_tlog(const char *path);
+
     void WL_read_messages();
-    int  WL_write_message(mavlink_message_t message);
+    int  WL_write_message(mavlink_message_t message, uint8_t priority = WL_PRIORITY_NORMAL, bool reliable = false);
     int  Send_WL_Global_Position(int Target_machine,mavlink_global_position_int_t Target_Global_Position);
 
     void enable_offboard_control();
@@ -352,10 +364,6 @@ public:
 
     void handle_quit( int sig );
 
-    int Throw(float yaw,int TNum);
-//    int ThrowF(float yaw,int32_t lat,int32_t lon, int Num);
-    int ThrowF(float yaw,target* targetF);
-
 private:
 
     Serial_Port *serial_port;
@@ -363,6 +371,9 @@ private:
 
     bool time_to_exit;
 
+    FILE *tlog;     // 收到的消息原样记录, 供离线回放
+    void write_tlog(const mavlink_message_t &message);
+
     pthread_t read_tid;
     pthread_t write_tid;
 
@@ -390,13 +401,19 @@ private:
 };
 
 /*将当前时刻看到的所有可能为目标的椭圆存放在容器中*/
-void possible_ellipse(Autopilot_Interface& api, vector<coordinate>& ellipse_out, vector<target>& target_ellipse);
-void possible_ellipse_r(Autopilot_Interface& api, vector<coordinate>& ellipse_out, vector<target>& target_ellipse);
-void resultTF(Autopilot_Interface& api, vector<target>& ellipse_in, vector<target>& ellipse_1, vector<target>& ellipse_0);
-void getdroptarget(Autopilot_Interface& api, coordinate& droptarget, vector<coordinate>& ellipse_out);
+void possible_ellipse(Autopilot_Interface& api, const Vision_Mode& mode, vector<coordinate>& ellipse_out, vector<target>& target_ellipse, uint64_t frame_usec);
+void possible_ellipse_r(Autopilot_Interface& api, const Vision_Mode& mode, vector<coordinate>& ellipse_out, vector<target>& target_ellipse, uint64_t frame_usec);
+/*当前目标给出 T / F 结论时返回 true*/
+bool resultTF(Autopilot_Interface& api, const Vision_Mode& mode, vector<target>& ellipse_in, vector<target>& ellipse_1, vector<target>& ellipse_0);
+/*本帧找到投放点 (写入 droptarget) 时返回 true*/
+bool getdroptarget(Autopilot_Interface& api, coordinate& droptarget, vector<coordinate>& ellipse_out, uint64_t frame_usec);
 void realtarget(Autopilot_Interface& api, coordinate& cam, float& x, float& y);
+float target_height(float z);
+float target_height(Autopilot_Interface& api);
+Frame_Pose frame_pose(Autopilot_Interface& api, uint64_t frame_usec);
+bool predicted_offset(Autopilot_Interface& api, int id, float& dx, float& dy);
 void OptimizEllipse(vector<Ellipse>& ellipse_out, vector<Ellipse>& ellipses_in);
-void filtellipse(Autopilot_Interface& api, vector<Ellipse>& ellipseok, vector<Ellipse>& ellipse_big);
+void filtellipse(Autopilot_Interface& api, vector<Ellipse>& ellipseok, vector<Ellipse>& ellipse_big, uint64_t frame_usec);
 #endif // AUTOPILOT_INTERFACE_H_
 
 
@@ -0,0 +1,272 @@
+/**
+ * @file camera_capture.cpp
+ *
+ * @brief Camera / video-file frame source with a low-res detection stream and a lazy full-res still
+ *
+ */
+
+#include "camera_capture.h"
+#include "autopilot_interface.h"
+#include "metrics.h"
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+Camera_Capture::
+Camera_Capture()
+{
+    format = CAPTURE_BGR;
+    live = false;
+    full_ready = false;
+    end_of_file = false;
+    failures = 0;
+    last_latency_ms = 0;
+    mean_latency_ms = 0;
+    max_latency_ms = 0;
+    frames = 0;
+}
+
+Camera_Capture::
+~Camera_Capture()
+{
+    close();
+}
+
+
+// ------------------------------------------------------------------------------
+//   打开摄像头或文件
+// ------------------------------------------------------------------------------
+bool
+Camera_Capture::
+open(const Capture_Config &config_)
+{
+    config = config_;
+    full_size = config.full;
+    end_of_file = false;
+    failures = 0;
+    live = config.source.empty();
+    format = live ? config.format : CAPTURE_BGR;
+
+    if (live)
+        cap.open(config.device);
+    else
+        cap.open(config.source);
+
+    if (!cap.isOpened())
+    {
+        fprintf(stderr, "ERROR: could not open camera %s\n",
+                live ? std::to_string(config.device).c_str() : config.source.c_str());
+        return false;
+    }
+
+    if (live)
+    {
+        if (format == CAPTURE_MJPG)
+            cap.set(CAP_PROP_FOURCC, VideoWriter::fourcc('M', 'J', 'P', 'G'));
+        else if (format == CAPTURE_YUYV)
+            cap.set(CAP_PROP_FOURCC, VideoWriter::fourcc('Y', 'U', 'Y', 'V'));
+        cap.set(CAP_PROP_FRAME_WIDTH, config.full.width);
+        cap.set(CAP_PROP_FRAME_HEIGHT, config.full.height);
+        cap.set(CAP_PROP_AUTOFOCUS, 0);
+
+        // 取驱动给出的原始数据, 由本类决定解码哪些部分
+        if (format != CAPTURE_BGR)
+            cap.set(CAP_PROP_CONVERT_RGB, 0);
+
+        // 摄像头不支持请求的分辨率时会退回其他模式
+        cv::Size actual((int)cap.get(CAP_PROP_FRAME_WIDTH), (int)cap.get(CAP_PROP_FRAME_HEIGHT));
+        if (actual.width > 0 && actual.height > 0 && actual != config.full)
+        {
+            fprintf(stderr, "WARNING: camera gave %dx%d instead of %dx%d\n",
+                    actual.width, actual.height, config.full.width, config.full.height);
+            full_size = actual;
+        }
+    }
+
+    printf("CAMERA opened %s, %dx%d -> %dx%d, format %d\n",
+           live ? "device" : config.source.c_str(),
+           full_size.width, full_size.height,
+           config.work.width, config.work.height, format);
+    return true;
+}
+
+void
+Camera_Capture::
+close()
+{
+    if (cap.isOpened())
+        cap.release();
+}
+
+
+// ------------------------------------------------------------------------------
+//   采集时刻
+//   V4L2 后端的 CAP_PROP_POS_MSEC 是驱动填写的缓冲区时间戳 (CLOCK_MONOTONIC),
+//   换算到 gettimeofday 的时钟; 取不到时(如读视频文件)用 grab 返回的时刻
+// ------------------------------------------------------------------------------
+uint64_t
+Camera_Capture::
+stamp()
+{
+    uint64_t now = get_time_usec();
+    if (!live)
+        return now;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    double mono_ms = ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+    double buf_ms = cap.get(CAP_PROP_POS_MSEC);
+    double age_ms = mono_ms - buf_ms;
+    if (buf_ms > 0 && age_ms >= 0 && age_ms < 500)
+        now -= (uint64_t)(age_ms * 1000);
+    return now;
+}
+
+
+// ------------------------------------------------------------------------------
+//   读一帧, 只解码检测分辨率的图像
+// ------------------------------------------------------------------------------
+bool
+Camera_Capture::
+read(Capture_Frame &frame)
+{
+    if (!cap.grab())
+    {
+        end_of_file = !live;
+        failures++;
+        return false;
+    }
+    frame.time_usec = stamp();
+    frame.seq = frames;
+    full_ready = false;
+
+    if (!cap.retrieve(raw) || raw.empty())
+    {
+        failures++;
+        return false;
+    }
+
+    // 后端不支持原始数据时给出的就是 BGR 图
+    if (format != CAPTURE_BGR && raw.channels() == 3)
+    {
+        fprintf(stderr, "WARNING: camera backend ignored raw capture, falling back to BGR\n");
+        format = CAPTURE_BGR;
+    }
+
+    if (!decode_small(frame))
+    {
+        failures++;
+        return false;
+    }
+    failures = 0;
+    return true;
+}
+
+bool
+Camera_Capture::
+decode_small(Capture_Frame &frame)
+{
+    cv::Size work = config.work;
+
+    switch (format)
+    {
+        case CAPTURE_MJPG:
+        {
+            // JPEG 解码时按 2 的幂缩小, 只做 DCT 的低频部分, 再缩放到检测分辨率
+            int k = 1;
+            while (k < 8 && full_size.width / (k * 2) >= work.width && full_size.height / (k * 2) >= work.height)
+                k *= 2;
+            int flag = (k == 8) ? IMREAD_REDUCED_COLOR_8 :
+                       (k == 4) ? IMREAD_REDUCED_COLOR_4 :
+                       (k == 2) ? IMREAD_REDUCED_COLOR_2 : IMREAD_COLOR;
+            cv::Mat3b reduced = imdecode(raw, flag);
+            if (reduced.empty())
+                return false;
+            // 缩小后的尺寸为全分辨率除以 k 向上取整, 相差超过 k 时说明驱动给出的分辨率不同
+            if (abs(reduced.cols * k - full_size.width) >= k || abs(reduced.rows * k - full_size.height) >= k)
+                full_size = cv::Size(reduced.cols * k, reduced.rows * k);
+            if (reduced.size() != work)
+                resize(reduced, frame.small, work, 0, 0, INTER_AREA);
+            else
+                frame.small = reduced;
+            cvtColor(frame.small, frame.gray, COLOR_BGR2GRAY);
+            break;
+        }
+
+        case CAPTURE_YUYV:
+        {
+            // raw 为 CV_8UC2, 第 0 个通道即 Y, 灰度图不需要颜色转换
+            full_size = raw.size();
+            cv::Mat1b y;
+            extractChannel(raw, y, 0);
+            resize(y, frame.gray, work, 0, 0, INTER_AREA);
+
+            // 每两个像素 (Y0 U Y1 V) 看作一个 4 通道像素缩小, 仍是合法的 YUYV,
+            // 只在检测分辨率上做颜色转换 (检测分辨率的宽度须为偶数)
+            cv::Mat macro(raw.rows, raw.cols / 2, CV_8UC4, raw.data, raw.step);
+            cv::Mat small_macro;
+            resize(macro, small_macro, cv::Size(work.width / 2, work.height), 0, 0, INTER_AREA);
+            cv::Mat small_yuyv(small_macro.rows, small_macro.cols * 2, CV_8UC2, small_macro.data, small_macro.step);
+            cvtColor(small_yuyv, frame.small, COLOR_YUV2BGR_YUYV);
+            break;
+        }
+
+        default:
+        {
+            full_image = raw;
+            full_ready = true;
+            full_size = full_image.size();
+            if (full_image.size() != work)
+                resize(full_image, frame.small, work, 0, 0, INTER_LINEAR);
+            else
+                frame.small = full_image.clone();
+            cvtColor(frame.small, frame.gray, COLOR_BGR2GRAY);
+            break;
+        }
+    }
+
+    frames++;
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   全分辨率图, 只在识别需要时解码
+// ------------------------------------------------------------------------------
+const cv::Mat3b &
+Camera_Capture::
+full()
+{
+    if (!full_ready && format == CAPTURE_MJPG)
+    {
+        full_image = imdecode(raw, IMREAD_COLOR);
+        full_ready = true;
+        if (!full_image.empty())
+            full_size = full_image.size();
+    }
+    else if (!full_ready && format == CAPTURE_YUYV)
+    {
+        cvtColor(raw, full_image, COLOR_YUV2BGR_YUYV);
+        full_ready = true;
+    }
+    return full_image;
+}
+
+
+// ------------------------------------------------------------------------------
+//   延迟统计
+// ------------------------------------------------------------------------------
+void
+Camera_Capture::
+done(const Capture_Frame &frame)
+{
+    last_latency_ms = (get_time_usec() - frame.time_usec) / 1000.0;
+    if (last_latency_ms > max_latency_ms)
+        max_latency_ms = last_latency_ms;
+    mean_latency_ms += (last_latency_ms - mean_latency_ms) / (frames > 0 ? (frames < 100 ? frames : 100) : 1);
+
+    static Metric_Histogram &latency_us = metrics.histogram("vision.capture_latency_us");
+    latency_us.record((uint64_t)(last_latency_ms * 1000));
+}
@@ -0,0 +1,105 @@
+/**
+ * @file camera_capture.h
+ *
+ * @brief Camera / video-file frame source with a low-res detection stream and a lazy full-res still
+ *
+ * 摄像头按 Capture_Config 中的格式和分辨率打开:
+ *  - CAPTURE_MJPG: 取驱动给出的原始 JPEG 数据, 用 IMREAD_REDUCED_* 在解码时直接缩小,
+ *                  全分辨率图只在调用 full() 时才解码
+ *  - CAPTURE_YUYV: 取原始 YUYV 数据, 灰度图直接取 Y 分量, 彩色小图由缩小后的 YUYV 转换;
+ *                  全分辨率图同样只在调用 full() 时才转换
+ *  - CAPTURE_BGR : 由 OpenCV 解码成 BGR 后缩小 (视频文件和图片序列也走这条路)
+ * 每帧记录采集时刻, 检测结束后调用 done() 统计采集到检测结束的延迟.
+ * 摄像头不支持请求的分辨率时按驱动实际给出的分辨率计算 scale().
+ *
+ */
+
+#ifndef CAMERA_CAPTURE_H_
+#define CAMERA_CAPTURE_H_
+
+#include <string>
+#include <vector>
+#include <cv.h>
+#include <highgui.h>
+
+#include "ellipse/EllipseDetectorYaed.h"
+
+enum Capture_Format
+{
+    CAPTURE_MJPG,
+    CAPTURE_YUYV,
+    CAPTURE_BGR
+};
+
+struct Capture_Config
+{
+    int device;             // 摄像头编号, source 为空时使用
+    std::string source;     // 视频文件或图片序列 (如 "frames/%04d.png"), 用于离线测试
+    Capture_Format format;
+    cv::Size full;          // 摄像头输出分辨率
+    cv::Size work;          // 椭圆检测用的分辨率
+
+    Capture_Config() : device(0), format(CAPTURE_MJPG), full(1920, 1080), work(640, 360) {}
+};
+
+// 一帧图像, small/gray 为检测分辨率
+struct Capture_Frame
+{
+    cv::Mat3b small;
+    cv::Mat1b gray;
+    uint64_t time_usec;     // 采集时刻, 与 get_time_usec 同一时钟
+    uint64_t seq;
+};
+
+
+class Camera_Capture
+{
+
+public:
+
+    Camera_Capture();
+    ~Camera_Capture();
+
+    bool open(const Capture_Config &config);
+    void close();
+
+    bool read(Capture_Frame &frame);
+
+    // 最近一帧的全分辨率彩色图, 第一次调用时才解码
+    const cv::Mat3b &full();
+    bool has_full() const { return full_ready; }
+
+    // 全分辨率图相对检测图的倍数
+    float scale() const { return (float)full_size.width / config.work.width; }
+
+    // 视频文件已读完, 之后的 read 都会失败
+    bool ended() const { return end_of_file; }
+    int failures;           // 连续读失败的次数
+
+    // 检测结束时调用, 统计采集到检测结束的延迟
+    void done(const Capture_Frame &frame);
+
+    double last_latency_ms;
+    double mean_latency_ms;
+    double max_latency_ms;
+    uint64_t frames;
+
+private:
+
+    Capture_Config config;
+    Capture_Format format;  // 实际使用的格式, 后端不支持原始数据时退回 CAPTURE_BGR
+    cv::VideoCapture cap;
+    bool live;              // 摄像头 (而不是文件)
+
+    cv::Mat raw;            // 最近一帧驱动给出的原始数据
+    cv::Mat3b full_image;
+    bool full_ready;
+    cv::Size full_size;     // 实际的全分辨率, 以驱动给出的为准
+    bool end_of_file;
+
+    uint64_t stamp();
+    bool decode_small(Capture_Frame &frame);
+
+};
+
+#endif // CAMERA_CAPTURE_H_
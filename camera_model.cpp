@@ -0,0 +1,220 @@
+/**
+ * @file camera_model.cpp
+ *
+ * @brief Pinhole camera model with lens distortion and ground back-projection
+ *
+ */
+
+#include "camera_model.h"
+
+#include <math.h>
+#include <algorithm>
+#include <stdio.h>
+
+
+Frame_Pose
+make_pose(float x, float y, float h, float roll, float pitch, float yaw)
+{
+    Frame_Pose pose;
+    pose.x = x;
+    pose.y = y;
+    pose.h = h;
+
+    float cr = cosf(roll), sr = sinf(roll);
+    float cp = cosf(pitch), sp = sinf(pitch);
+    float cy = cosf(yaw), sy = sinf(yaw);
+
+    // R = Rz(yaw) * Ry(pitch) * Rx(roll)
+    pose.R[0][0] = cy * cp;
+    pose.R[0][1] = cy * sp * sr - sy * cr;
+    pose.R[0][2] = cy * sp * cr + sy * sr;
+    pose.R[1][0] = sy * cp;
+    pose.R[1][1] = sy * sp * sr + cy * cr;
+    pose.R[1][2] = sy * sp * cr - cy * sr;
+    pose.R[2][0] = -sp;
+    pose.R[2][1] = cp * sr;
+    pose.R[2][2] = cp * cr;
+    return pose;
+}
+
+
+Camera_Model::
+Camera_Model()
+{
+    set_default(cv::Size(640, 360));
+}
+
+
+// ------------------------------------------------------------------------------
+//   默认参数: c930E #4, 1920x1080 下标定, 未标定畸变
+// ------------------------------------------------------------------------------
+//  c525:     fx = 734.0686,  fy = 737.9659,  cx = 316.2778, cy = 232.4590 (640x480)
+//  c930E #1: fx = 1140.8604, fy = 1141.4534, cx = 920.9147, cy = 580.8716
+//  c930E #2: fx = 1152.1080, fy = 1153.6161, cx = 974.8427, cy = 566.9231
+//  c930E #3: fx = 1140.8956, fy = 1141.5722, cx = 952.2491, cy = 562.5637
+void
+Camera_Model::
+set_default(cv::Size working)
+{
+    calib_size = cv::Size(1920, 1080);
+    K = (cv::Mat1d(3, 3) << 1148.9655, 0, 949.7131,
+                            0, 1148.8481, 549.0170,
+                            0, 0, 1);
+    dist = cv::Mat1d::zeros(1, 5);
+    build_lut(working);
+}
+
+
+// ------------------------------------------------------------------------------
+//   读入标定文件 (camera_matrix, distortion_coefficients, image_width, image_height)
+// ------------------------------------------------------------------------------
+bool
+Camera_Model::
+load(const std::string &file, cv::Size working)
+{
+    cv::FileStorage fs(file, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        fprintf(stderr, "WARNING: could not open camera calibration %s, using defaults\n", file.c_str());
+        set_default(working);
+        return false;
+    }
+
+    cv::Mat k, d;
+    int w = 0, h = 0;
+    fs["camera_matrix"] >> k;
+    fs["distortion_coefficients"] >> d;
+    fs["image_width"] >> w;
+    fs["image_height"] >> h;
+
+    if (k.rows != 3 || k.cols != 3 || w <= 0 || h <= 0)
+    {
+        fprintf(stderr, "WARNING: bad camera calibration %s, using defaults\n", file.c_str());
+        set_default(working);
+        return false;
+    }
+
+    k.convertTo(K, CV_64F);
+    if (d.empty())
+        dist = cv::Mat1d::zeros(1, 5);
+    else
+        d.convertTo(dist, CV_64F);
+    calib_size = cv::Size(w, h);
+
+    build_lut(working);
+    printf("CAMERA %s: fx %.2f fy %.2f cx %.2f cy %.2f at %dx%d\n",
+           file.c_str(), fx, fy, cx, cy, size.width, size.height);
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   为检测分辨率下的每个像素计算去畸变后的归一化坐标
+// ------------------------------------------------------------------------------
+void
+Camera_Model::
+build_lut(cv::Size working)
+{
+    size = working;
+    double sx = (double)working.width / calib_size.width;
+    double sy = (double)working.height / calib_size.height;
+
+    fx = K(0, 0) * sx;
+    fy = K(1, 1) * sy;
+    cx = K(0, 2) * sx;
+    cy = K(1, 2) * sy;
+
+    cv::Mat1d Kw = (cv::Mat1d(3, 3) << fx, 0, cx,
+                                       0, fy, cy,
+                                       0, 0, 1);
+
+    std::vector<cv::Point2f> pixels;
+    pixels.reserve(working.area());
+    for (int v = 0; v < working.height; v++)
+        for (int u = 0; u < working.width; u++)
+            pixels.push_back(cv::Point2f(u, v));
+
+    lut.clear();
+    cv::undistortPoints(pixels, lut, Kw, dist);
+}
+
+
+// ------------------------------------------------------------------------------
+//   查表, 亚像素位置双线性插值
+// ------------------------------------------------------------------------------
+void
+Camera_Model::
+ray(float u, float v, float &xn, float &yn) const
+{
+    float uc = std::min(std::max(u, 0.0f), (float)(size.width - 1));
+    float vc = std::min(std::max(v, 0.0f), (float)(size.height - 1));
+    int u0 = std::min((int)uc, size.width - 2);
+    int v0 = std::min((int)vc, size.height - 2);
+    float a = uc - u0;
+    float b = vc - v0;
+
+    const cv::Point2f &p00 = lut[v0 * size.width + u0];
+    const cv::Point2f &p01 = lut[v0 * size.width + u0 + 1];
+    const cv::Point2f &p10 = lut[(v0 + 1) * size.width + u0];
+    const cv::Point2f &p11 = lut[(v0 + 1) * size.width + u0 + 1];
+
+    xn = (1 - b) * ((1 - a) * p00.x + a * p01.x) + b * ((1 - a) * p10.x + a * p11.x);
+    yn = (1 - b) * ((1 - a) * p00.y + a * p01.y) + b * ((1 - a) * p10.y + a * p11.y);
+
+    // 图像范围外按针孔模型线性外推
+    xn += (u - uc) / fx;
+    yn += (v - vc) / fy;
+}
+
+
+// ------------------------------------------------------------------------------
+//   反投影到目标平面
+//   图像 x 向右为机体右方, 图像 y 向下为机体后方, 光轴为机体下方
+//   射线旋转到导航系(北东地)后, 按单位深度归一化
+// ------------------------------------------------------------------------------
+void
+Camera_Model::
+ground_ray(const Frame_Pose &pose, const coordinate &cam, float &n, float &e) const
+{
+    float xn, yn;
+    ray(cam.x, cam.y, xn, yn);
+
+    float bf = -yn, br = xn;    // 机体系: 前, 右, 下(=1)
+    float rn = pose.R[0][0] * bf + pose.R[0][1] * br + pose.R[0][2];
+    float re = pose.R[1][0] * bf + pose.R[1][1] * br + pose.R[1][2];
+    float rd = pose.R[2][0] * bf + pose.R[2][1] * br + pose.R[2][2];
+
+    // 射线接近水平时不会与地面相交, 限制倾角
+    if (rd < 0.1f)
+        rd = 0.1f;
+    n = rn / rd;
+    e = re / rd;
+}
+
+void
+Camera_Model::
+back_project(const Frame_Pose &pose, const coordinate &cam, float &x_l, float &y_l) const
+{
+    float n, e;
+    ground_ray(pose, cam, n, e);
+    x_l = n * pose.h + pose.x;  //单位为：m
+    y_l = e * pose.h + pose.y;
+}
+
+void
+Camera_Model::
+back_project(const Frame_Pose &pose, std::vector<coordinate> &cams) const
+{
+    for (auto &p : cams)
+        back_project(pose, p, p.locx, p.locy);
+}
+
+void
+Camera_Model::
+pixel_offset(const Frame_Pose &pose, const coordinate &cam, float &x_r, float &y_r) const
+{
+    float n, e;
+    ground_ray(pose, cam, n, e);
+    x_r = n * fx;   //单位是:像素
+    y_r = e * fy;
+}
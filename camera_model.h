@@ -0,0 +1,76 @@
+/**
+ * @file camera_model.h
+ *
+ * @brief Pinhole camera model with lens distortion and ground back-projection
+ *
+ * 相机内参和畸变系数从标定文件(OpenCV FileStorage 格式)读入, 并换算到检测用的分辨率.
+ * 启动时为每个像素预先计算去畸变后的归一化坐标(LUT), 之后每次反投影只需查表.
+ * 姿态的旋转矩阵每帧只在 make_pose 中计算一次, 同一帧内所有椭圆共用.
+ * 相机垂直向下安装, 图像上方为机头方向; 反投影时将射线旋转到导航系后与目标平面求交,
+ * 飞机倾斜加速时目标位置不再跳变.
+ *
+ */
+
+#ifndef CAMERA_MODEL_H_
+#define CAMERA_MODEL_H_
+
+#include <string>
+#include <vector>
+#include <cv.h>
+
+#include "ellipse/EllipseDetectorYaed.h"
+
+#define CAMERA_CALIB_FILE "config/camera_c930e_4.yml"
+
+
+// 一帧图像对应的飞机位姿, 由 make_pose 生成
+struct Frame_Pose
+{
+    float x;        // 飞机局部坐标 x, 北 (m)
+    float y;        // 飞机局部坐标 y, 东 (m)
+    float h;        // 相机到目标平面的高度 (m)
+    float R[3][3];  // 机体系(前右下) -> 导航系(北东地)
+};
+
+// roll, pitch, yaw 单位为 rad
+Frame_Pose make_pose(float x, float y, float h, float roll, float pitch, float yaw);
+
+
+class Camera_Model
+{
+
+public:
+
+    Camera_Model();
+
+    // 检测分辨率下的内参
+    float fx, fy, cx, cy;
+    cv::Size size;
+
+    bool load(const std::string &file, cv::Size working);
+    void set_default(cv::Size working);
+
+    // 像素 -> 去畸变的归一化坐标 (x 向右, y 向下)
+    void ray(float u, float v, float &xn, float &yn) const;
+
+    // 椭圆圆心在局部坐标系下的位置 (m)
+    void back_project(const Frame_Pose &pose, const coordinate &cam, float &x_l, float &y_l) const;
+    void back_project(const Frame_Pose &pose, std::vector<coordinate> &cams) const;
+
+    // 椭圆圆心相对飞机的偏移, 旋转到北东方向, 换算到 1 米高度下的像素
+    void pixel_offset(const Frame_Pose &pose, const coordinate &cam, float &x_r, float &y_r) const;
+
+private:
+
+    cv::Mat1d K;        // 标定分辨率下的内参矩阵
+    cv::Mat1d dist;     // 畸变系数
+    cv::Size calib_size;
+
+    std::vector<cv::Point2f> lut;
+
+    void build_lut(cv::Size working);
+    void ground_ray(const Frame_Pose &pose, const coordinate &cam, float &n, float &e) const;
+
+};
+
+#endif // CAMERA_MODEL_H_
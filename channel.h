@@ -0,0 +1,123 @@
+/**
+ * @file channel.h
+ *
+ * @brief Typed publish / subscribe channel carrying immutable, versioned values
+ *
+ * 线程之间传递状态时, 发布者每次构造一个新的 T 并以 shared_ptr<const T> 发布,
+ * 之后不再修改; 读者通过 latest() 拿到某一版本的引用, 在持有期间内容不会变化,
+ * 也不会因为发布者的 push_back 重新分配而失效. 拿引用只在锁内复制一个 shared_ptr.
+ *
+ * 订阅者在发布者线程中被调用, 参数为上一个值和新值, 用来把状态变化转换成事件
+ * (例如投递到 mission_events). 订阅者应尽快返回, 且不能在回调中向同一个通道发布.
+ * unsubscribe 返回后该订阅者不会再被调用.
+ *
+ */
+
+#ifndef CHANNEL_H_
+#define CHANNEL_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <memory>
+#include <functional>
+#include <vector>
+#include <utility>
+
+
+template <typename T>
+class Channel
+{
+
+public:
+
+    typedef std::shared_ptr<const T> Ptr;
+    typedef std::function<void(const Ptr &prev, const Ptr &next)> Subscriber;
+
+    Channel() : current_version(0), next_id(1)
+    {
+        pthread_mutex_init(&lock, NULL);
+        pthread_mutex_init(&publish_lock, NULL);
+    }
+
+    ~Channel()
+    {
+        pthread_mutex_destroy(&publish_lock);
+        pthread_mutex_destroy(&lock);
+    }
+
+    // 发布一个新版本, 返回版本号 (从 1 开始)
+    uint64_t publish(const Ptr &value)
+    {
+        pthread_mutex_lock(&publish_lock);
+
+        pthread_mutex_lock(&lock);
+        Ptr prev = current;
+        current = value;
+        uint64_t version = ++current_version;
+        pthread_mutex_unlock(&lock);
+
+        for (size_t i = 0; i < subscribers.size(); i++)
+            subscribers[i].second(prev, value);
+
+        pthread_mutex_unlock(&publish_lock);
+        return version;
+    }
+
+    // 最新的值, 还没有发布过时为空
+    Ptr latest(uint64_t *version = NULL) const
+    {
+        pthread_mutex_lock(&lock);
+        Ptr value = current;
+        if (version)
+            *version = current_version;
+        pthread_mutex_unlock(&lock);
+        return value;
+    }
+
+    uint64_t version() const
+    {
+        pthread_mutex_lock(&lock);
+        uint64_t version = current_version;
+        pthread_mutex_unlock(&lock);
+        return version;
+    }
+
+    int subscribe(const Subscriber &subscriber)
+    {
+        pthread_mutex_lock(&publish_lock);
+        int id = next_id++;
+        subscribers.push_back(std::make_pair(id, subscriber));
+        pthread_mutex_unlock(&publish_lock);
+        return id;
+    }
+
+    void unsubscribe(int id)
+    {
+        pthread_mutex_lock(&publish_lock);
+        for (size_t i = 0; i < subscribers.size(); i++)
+        {
+            if (subscribers[i].first == id)
+            {
+                subscribers.erase(subscribers.begin() + i);
+                break;
+            }
+        }
+        pthread_mutex_unlock(&publish_lock);
+    }
+
+private:
+
+    mutable pthread_mutex_t lock;       // current / current_version
+    pthread_mutex_t publish_lock;       // 串行化发布, 保护 subscribers
+    Ptr current;
+    uint64_t current_version;
+    int next_id;
+    std::vector<std::pair<int, Subscriber> > subscribers;
+
+    Channel(const Channel &);
+    Channel &operator=(const Channel &);
+
+};
+
+
+#endif // CHANNEL_H_
@@ -22,7 +22,6 @@ last update: 23/12/2014
 #include "EllipseDetectorYaed.h"
 
 vector<float> white,color;
-vector<coordinate> ellipse_pre;
 
 CEllipseDetectorYaed::CEllipseDetectorYaed(void) : _times(6, 0.0), _timesHelper(6, 0.0)
 {
@@ -38,6 +37,8 @@ CEllipseDetectorYaed::CEllipseDetectorYaed(void) : _times(6, 0.0), _timesHelper(
 	_fMinScore = 0.4f;
 	_fMinReliability = 0.4f;
 	_uNs = 16;
+	_arcs[0] = _arcs[1] = _arcs[2] = _arcs[3] = 0;
+	_candidates = 0;
 
 	srand(unsigned(time(NULL)));
 }
@@ -74,6 +75,39 @@ void CEllipseDetectorYaed::SetParameters(Size	szPreProcessingGaussKernelSize,
 
 }
 
+// 机载程序使用的参数, 只有中心距离阈值随图像大小变化
+void CEllipseDetectorYaed::SetDefaultParameters(Size szImg)
+{
+	// Parameters Settings (Sect. 4.2)
+	int		iThLength = 16;
+	float	fThObb = 3.0f;
+	float	fThPos = 1.0f;
+	float	fTaoCenters = 0.05f;
+	int 	iNs = 16;
+	float	fMaxCenterDistance = sqrt(float(szImg.width*szImg.width + szImg.height*szImg.height)) * fTaoCenters;
+
+	float	fThScoreScore = 0.4f;
+
+	// Gaussian filter parameters, in pre-processing
+	Size	szPreProcessingGaussKernelSize = Size(5, 5);
+	double	dPreProcessingGaussSigma = 1.0;
+
+	float	fDistanceToEllipseContour = 0.1f;	// (Sect. 3.3.1 - Validation)
+	float	fMinReliability = 0.4f;	// Const parameters to discard bad ellipses
+
+	SetParameters(szPreProcessingGaussKernelSize,
+				  dPreProcessingGaussSigma,
+				  fThPos,
+				  fMaxCenterDistance,
+				  iThLength,
+				  fThObb,
+				  fDistanceToEllipseContour,
+				  fThScoreScore,
+				  fMinReliability,
+				  iNs
+	);
+}
+
 uint inline CEllipseDetectorYaed::GenerateKey(uchar pair, ushort u, ushort v)
 {
 	return (pair << 30) + (u << 15) + v;
@@ -1708,6 +1742,10 @@ void CEllipseDetectorYaed::Detect(Mat1b& I, vector<Ellipse>& ellipses)
 {
 	Tic(1); //prepare data structure
 
+	// estimation 和 validation 在分组过程中用 Tac 累加, 每帧从 0 开始
+	_times[3] = _times[4] = 0.0;
+	_timesHelper[3] = _timesHelper[4] = 0.0;
+
 	// Set the image size
 	_szImg = I.size();
 
@@ -1741,6 +1779,11 @@ void CEllipseDetectorYaed::Detect(Mat1b& I, vector<Ellipse>& ellipses)
 
 	Toc(1); //preprocessing
 
+	_arcs[0] = int(points_1.size());
+	_arcs[1] = int(points_2.size());
+	_arcs[2] = int(points_3.size());
+	_arcs[3] = int(points_4.size());
+
 
 	// DEBUG
 	Mat3b out(I.rows, I.cols, Vec3b(0,0,0));
@@ -1799,6 +1842,8 @@ void CEllipseDetectorYaed::Detect(Mat1b& I, vector<Ellipse>& ellipses)
 	delete[] accR;
 	delete[] accA;
 
+	_candidates = int(ellipses.size());
+
 	Tic(5);
 	// Cluster detections
 	ClusterEllipses(ellipses);
@@ -1914,6 +1959,8 @@ void CEllipseDetectorYaed::DrawDetectedEllipses(Mat3b& output, vector<coordinate
 		e_c.y = e._yc;
 		e_c.order = j;
 		e_c.a = e._a;
+		e_c.b = e._b;
+		e_c.rad = e._rad;
 		e_c.flag = 2;
 		ellipse_out.push_back(e_c);
 	}
@@ -1921,35 +1968,6 @@ void CEllipseDetectorYaed::DrawDetectedEllipses(Mat3b& output, vector<coordinate
 
 }
 
-void CEllipseDetectorYaed::extracrROI(Mat1b& image, vector<coordinate>& ellipse_out, vector<Mat1b>& img_roi){
-
-//	cvtColor(image, image, COLOR_RGB2GRAY);
-	GaussianBlur(image, image, Size(5, 5),0, 0);
-	static int number;
-	if(number == 0) {
-        threshold(image, image, 170, 255, CV_THRESH_BINARY);
-        number = 1;
-
-    } else{
-        threshold(image, image, 190, 255, CV_THRESH_BINARY);
-        number = 0;
-	}
-
-	for(auto &p:ellipse_out){
-		Mat1b ROI;
-		int r = 3 * p.a;
-		int x_l = 3 * p.x - r;
-		int y_l = 3 * p.y - r;
-		int width = 2 * r;
-		if((x_l>=0)&&(y_l>=0)&&((x_l+width)<=image.cols)&&((y_l+width)<=image.rows)){
-			ROI = image(Rect(x_l, y_l, width, width));
-//			imshow("ROI", ROI);
-			img_roi.push_back(ROI);
-		} else
-			continue;
-
-	}
-}
 void CEllipseDetectorYaed::big_vector(Mat3b& resultImage2, vector< Ellipse >& ellipse_in, vector< Ellipse >& ellipse_big)
 {
     CEllipseDetectorYaed* gv;
@@ -2077,82 +2095,157 @@ bool CEllipseDetectorYaed::computcolorpercentage(Mat3b& roi, Ellipse& ell_in)
 
 }
 
-void visual_rec(vector<Mat1b>& gray, vector<coordinate>& ellipse_out0, vector<coordinate>& ellipse_out00, vector< vector<Point> >& contours0){
-	float areanum = 0.215;
-//    threshold(gray, gray, 120, 255, CV_THRESH_BINARY);
-//  imshow("threshold", thresh);
-//  morphologyEx(gauss, gauss, MORPH_CLOSE, (5, 5) );
-//    Canny(thresh, canny, 50, 150, 3);
-	vector< vector<Point> > contours;
-
-	for(auto j = 0; j < gray.size(); j++) {
-		findContours(gray[j], contours, CV_RETR_LIST, CV_CHAIN_APPROX_NONE);
-		for (int i = 0; i < contours.size(); i++) {
-			//拟合出轮廓外侧最小的矩形
-			RotatedRect rotate_rect = minAreaRect(contours[i]);
-			Point2f *vertices = new Point2f[4];
-			rotate_rect.points(vertices);
-			float h1_s, h2_s, h3_s, h4, h1_b, h2_b, h3_b;
-			/*****************************************************************
-			 * 大圆的参数
-			*****************************************************************/
-			h1_b = 0.6 * ellipse_out0[j].a;//只要h1,h2的系数在0.68571429这个值范围内就行1.8
-			h2_b = 0.9 * ellipse_out0[j].a;//h1:0.5,h2:0.86
-			h3_b = 0.16 * gray[j].cols;//0.55
-			h4 = 0.5 * gray[j].cols;
-			/*****************************************************************
-			 * 小圆的参数
-			*****************************************************************/
-			h1_s = 1.8 * ellipse_out0[j].a;//只要h1,h2的系数在0.68571429这个值范围内就行1.8
-			h2_s = 3 * ellipse_out0[j].a;//h1:0.5,h2:0.86
-			h3_s = 0.55 * gray[j].cols;//0.55
-
-//			rotate_rect.size.height < h1_s || rotate_rect.size.height > h2_s || rotate_rect.size.width < h1_s ||
-//			rotate_rect.size.width > h2_s || abs(rotate_rect.center.x - h4) > h3_s || abs(rotate_rect.center.y - h4) > h3_s
-			if ((rotate_rect.size.height > h1_s && rotate_rect.size.height < h2_s && rotate_rect.size.width > h1_s &&
-				 rotate_rect.size.width < h2_s && abs(rotate_rect.center.x - h4) < h3_s &&
-				 abs(rotate_rect.center.y - h4) < h3_s)
-				|| (rotate_rect.size.height > h1_b && rotate_rect.size.height < h2_b && rotate_rect.size.width > h1_b &&
-					rotate_rect.size.width < h2_b && abs(rotate_rect.center.x - h4) < h3_b &&
-					abs(rotate_rect.center.y - h4) < h3_b)
-					){
-			float x12 = (vertices[1].x + vertices[2].x) / 2;
-			float y12 = (vertices[1].y + vertices[2].y) / 2;
-			float xt12 = areanum * (rotate_rect.center.x - x12) + x12;
-			float yt12 = y12 - areanum * (y12 - rotate_rect.center.y);
-
-			float x30 = (vertices[3].x + vertices[0].x) / 2;
-			float y30 = (vertices[3].y + vertices[0].y) / 2;
-			float yt30 = areanum * (rotate_rect.center.y - y30) + y30;
-			float xt30 = x30 - areanum * (x30 - rotate_rect.center.x);
-
-			float x23 = (vertices[2].x + vertices[3].x) / 2;
-			float y23 = (vertices[2].y + vertices[3].y) / 2;
-			float xt23 = areanum * (rotate_rect.center.x - x23) + x23;
-			float yt23 = y23 - areanum * (y23 - rotate_rect.center.y);
-
-			float x01 = (vertices[1].x + vertices[0].x) / 2;
-			float y01 = (vertices[1].y + vertices[0].y) / 2;
-			float yt01 = areanum * (rotate_rect.center.y - y01) + y01;
-			float xt01 = x01 - areanum * (x01 - rotate_rect.center.x);
-
-			if (abs((gray[j].at<uchar>(yt12, xt12) - gray[j].at<uchar>(yt30, xt30))) < 60
-				&& abs((gray[j].at<uchar>(yt23, xt23) - gray[j].at<uchar>(yt01, xt01))) < 60) {
-				ellipse_out0[j].flag = 1;
-			} else {
-				ellipse_out0[j].flag = 0;
+// ------------------------------------------------------------------------------
+//   T/F 快速识别
+//   1. 按椭圆的长短轴和角度做仿射变换, 把椭圆内部映射成 TF_PATCH x TF_PATCH 的圆,
+//      消除透视造成的压缩 (不分配内存, 小图放在栈上)
+//   2. 在内圆里用大津法求阈值, 亮的部分为字符
+//   3. 求字符的两条主轴, 将字符关于主轴做镜像, 与原字符重合的比例即对称度.
+//      T 的竖笔是对称轴, 对称度接近 1; F 没有对称轴
+//   整个过程与字符的朝向无关, 每个椭圆只需处理 32x32 个像素
+// ------------------------------------------------------------------------------
+#define TF_PATCH 32
+static const float TF_INNER = 0.8f;    // 只统计半径 0.8 以内, 去掉圆环边缘
+static const int TF_CONTRAST = 40;     // 字符与背景的灰度差低于该值为未识别
+
+static void
+tf_affine(float xc, float yc, float a, float b, float rad, double M[6])
+{
+	float c0 = (TF_PATCH - 1) * 0.5f;
+	float k = 2.0f / TF_PATCH;
+	float cs = cos(rad), sn = sin(rad);
+	M[0] = a * cs * k;  M[1] = -b * sn * k;  M[2] = xc - (M[0] + M[1]) * c0;
+	M[3] = a * sn * k;  M[4] = b * cs * k;   M[5] = yc - (M[3] + M[4]) * c0;
+}
+
+uchar classify_TF(const Mat3b& image, float xc, float yc, float a, float b, float rad, float sym_t, float& sym)
+{
+	sym = 0;
+	if (a < 2 || b < 2)
+		return 2;
+
+	// 只对 32x32 的彩色小图做灰度转换, 不需要整幅大图的灰度图
+	Vec3b cbuf[TF_PATCH * TF_PATCH];
+	uchar buf[TF_PATCH * TF_PATCH];
+	Mat3b cpatch(TF_PATCH, TF_PATCH, cbuf);
+	Mat1b patch(TF_PATCH, TF_PATCH, buf);
+	double M[6];
+	tf_affine(xc, yc, a, b, rad, M);
+	warpAffine(image, cpatch, Mat(2, 3, CV_64F, M), cpatch.size(), INTER_LINEAR | WARP_INVERSE_MAP, BORDER_REPLICATE);
+	cvtColor(cpatch, patch, COLOR_BGR2GRAY);
+
+	// 内圆里的灰度直方图
+	const float c0 = (TF_PATCH - 1) * 0.5f;
+	const float r2 = (TF_INNER * TF_PATCH * 0.5f) * (TF_INNER * TF_PATCH * 0.5f);
+	int hist[256] = {0};
+	int total = 0, lo = 255, hi = 0;
+	for (int v = 0; v < TF_PATCH; v++) {
+		for (int u = 0; u < TF_PATCH; u++) {
+			if ((u - c0) * (u - c0) + (v - c0) * (v - c0) > r2)
+				continue;
+			uchar g = buf[v * TF_PATCH + u];
+			hist[g]++;
+			total++;
+			lo = min(lo, (int)g);
+			hi = max(hi, (int)g);
+		}
+	}
+	if (hi - lo < TF_CONTRAST)
+		return 2;
+
+	// 大津法
+	double sum = 0;
+	for (int i = 0; i < 256; i++)
+		sum += i * hist[i];
+	double sumB = 0, best = -1;
+	int wB = 0, thr = lo;
+	for (int i = 0; i < 256; i++) {
+		wB += hist[i];
+		if (wB == 0)
+			continue;
+		int wF = total - wB;
+		if (wF == 0)
+			break;
+		sumB += i * hist[i];
+		double mB = sumB / wB, mF = (sum - sumB) / wF;
+		double between = (double)wB * wF * (mB - mF) * (mB - mF);
+		if (between > best) {
+			best = between;
+			thr = i;
+		}
+	}
+
+	// 字符掩码和矩
+	uchar mask[TF_PATCH * TF_PATCH];
+	int n = 0;
+	double mx = 0, my = 0;
+	for (int v = 0; v < TF_PATCH; v++) {
+		for (int u = 0; u < TF_PATCH; u++) {
+			int i = v * TF_PATCH + u;
+			mask[i] = ((u - c0) * (u - c0) + (v - c0) * (v - c0) <= r2) && buf[i] > thr;
+			if (mask[i]) {
+				n++;
+				mx += u;
+				my += v;
 			}
-			vector<Point> contour;
-			for (int i = 0; i < 4; i++) {
-				vertices[i].x = vertices[i].x + (3 * ellipse_out0[j].x - 3 * ellipse_out0[j].a);
-				vertices[i].y = vertices[i].y + (3 * ellipse_out0[j].y - 3 * ellipse_out0[j].a);
-				contour.push_back(vertices[i]);
+		}
+	}
+	if (n < 0.03 * total || n > 0.6 * total)
+		return 2;
+	mx /= n;
+	my /= n;
+
+	double mu20 = 0, mu02 = 0, mu11 = 0;
+	for (int v = 0; v < TF_PATCH; v++) {
+		for (int u = 0; u < TF_PATCH; u++) {
+			if (!mask[v * TF_PATCH + u])
+				continue;
+			double du = u - mx, dv = v - my;
+			mu20 += du * du;
+			mu02 += dv * dv;
+			mu11 += du * dv;
+		}
+	}
+	double theta = 0.5 * atan2(2 * mu11, mu20 - mu02);
+
+	// 关于两条主轴的镜像重合度, 取较大者
+	for (int axis = 0; axis < 2; axis++) {
+		double t = theta + axis * CV_PI / 2;
+		double dx = cos(t), dy = sin(t);
+		int hit = 0;
+		for (int v = 0; v < TF_PATCH; v++) {
+			for (int u = 0; u < TF_PATCH; u++) {
+				if (!mask[v * TF_PATCH + u])
+					continue;
+				double pu = u - mx, pv = v - my;
+				double d = pu * dx + pv * dy;
+				int ru = cvRound(mx + 2 * d * dx - pu);
+				int rv = cvRound(my + 2 * d * dy - pv);
+				if (ru >= 0 && ru < TF_PATCH && rv >= 0 && rv < TF_PATCH && mask[rv * TF_PATCH + ru])
+					hit++;
 			}
+		}
+		sym = max(sym, (float)hit / n);
+	}
+
+	return sym > sym_t ? 1 : 0;
+}
+
+void visual_rec_fast(const Mat3b& image, float scale, float sym_t, vector<coordinate>& ellipse_out0, vector<coordinate>& ellipse_out00, vector< vector<Point> >& contours0){
+	for (auto &p : ellipse_out0) {
+		float sym;
+		p.flag = classify_TF(image, scale * p.x, scale * p.y, scale * p.a, scale * p.b, p.rad, sym_t, sym);
+		if (p.flag != 2) {
+			double M[6];
+			tf_affine(scale * p.x, scale * p.y, scale * p.a, scale * p.b, p.rad, M);
+			float c[4][2] = {{0, 0}, {TF_PATCH - 1, 0}, {TF_PATCH - 1, TF_PATCH - 1}, {0, TF_PATCH - 1}};
+			vector<Point> contour;
+			for (int i = 0; i < 4; i++)
+				contour.push_back(Point(cvRound(M[0] * c[i][0] + M[1] * c[i][1] + M[2]),
+										cvRound(M[3] * c[i][0] + M[4] * c[i][1] + M[5])));
 			contours0.push_back(contour);
-		}else
-		continue;
 		}
-		ellipse_out00.push_back(ellipse_out0[j]);
+		ellipse_out00.push_back(p);
 	}
 }
 
@@ -2193,23 +2286,9 @@ bool CEllipseDetectorYaed::computetargetcolorpercentage(Mat3b& roi, Ellipse& ell
     Mat imageth_r, imageth_b;
 
     //红色为0°，绿色为120°,蓝色为240°。它们的补色是：黄色为60°，青色为180°,品红为300°；
-    //给出希望保留的hsv的取值范围
-    int iLowH_b = 0;//zwy:100;浅色圆：0；
-    int iHighH_b = 127.5;//张婉莹：125；浅色圆：239
-    int iLowS_b = 0;//张婉莹：15；浅色圆17
-    int iHighS_b = 255;//值越大，颜色越饱和张婉莹：240；浅色圆：145
-    int iLowV_b = 106;//值越小越黑张婉莹：20；浅色圆：0
-    int iHighV_b = 250;//张婉莹：255
-
-    //############################红色百分比##################################
-    //红色为0°，绿色为120°,蓝色为240°。它们的补色是：黄色为60°，青色为180°,品红为300°；
-    //给出希望保留的hsv的取值范围
-    int iLowH_r = 131.5;//0
-    int iHighH_r = 176;//224
-    int iLowS_r = 0;//29
-    int iHighS_r = 255;//值越大，颜色越饱和218
-    int iLowV_r = 106;//值越小越黑235
-    int iHighV_r = 250;//255
+    //希望保留的hsv的取值范围见 color (缺省值为: 蓝色 H 0~127, S 0~255, V 106~250; 红色 H 131~176, S 0~255, V 106~250),
+    //由 config/uav.yml 的 color 一节设置
+    const Target_Color &c = color;
 
 
     //计算像素总数,椭圆面积
@@ -2226,8 +2305,8 @@ bool CEllipseDetectorYaed::computetargetcolorpercentage(Mat3b& roi, Ellipse& ell
     cvtColor(roi, roi, COLOR_BGR2HSV);
 
     //按阈值分割
-    inRange(roi, Scalar(iLowH_b, iLowS_b, iLowV_b), Scalar(iHighH_b, iHighS_b, iHighV_b), imageth_b);//提取出的蓝色为白色部分
-    inRange(roi, Scalar(iLowH_r, iLowS_r, iLowV_r), Scalar(iHighH_r, iHighS_r, iHighV_r), imageth_r);//提取出的红色为黑色部分
+    inRange(roi, Scalar(c.blue_low[0], c.blue_low[1], c.blue_low[2]), Scalar(c.blue_high[0], c.blue_high[1], c.blue_high[2]), imageth_b);//提取出的蓝色为白色部分
+    inRange(roi, Scalar(c.red_low[0], c.red_low[1], c.red_low[2]), Scalar(c.red_high[0], c.red_high[1], c.red_high[2]), imageth_r);//提取出的红色为黑色部分
 
     float add_r = 0,add_b = 0;
     for(int i = 0;i < height_b; i++)
@@ -2282,8 +2361,8 @@ bool CEllipseDetectorYaed::computetargetcolorpercentage(Mat3b& roi, Ellipse& ell
 //	cout<<"彩色占大圆比例为："<<percentage_color<<"%"<<endl;
 //	cout<<"白色占圆比例为："<< percentage_white <<"%"<<endl;
 */
-    if(((percentage_blue>=61)&&(percentage_red>= 4)&&(percentage_blue<=95)&&(percentage_red<=28))
-       ||((percentage_blue>=5)&&(percentage_red>= 58)&&(percentage_blue<=46)&&(percentage_red<=96)))
+    if(((percentage_blue>=c.blue_target[0])&&(percentage_red>=c.blue_target[2])&&(percentage_blue<=c.blue_target[1])&&(percentage_red<=c.blue_target[3]))
+       ||((percentage_blue>=c.red_target[0])&&(percentage_red>=c.red_target[2])&&(percentage_blue<=c.red_target[1])&&(percentage_red<=c.red_target[3])))
     {
 
         return true;
@@ -49,20 +49,8 @@ using namespace cv;
 //#define DISCARD_CONSTRAINT_POSITION
 //#define DISCARD_CONSTRAINT_CENTER
 //const float high = 0.75;//桌子单位
-//const float fx = 734.0686, fy = 737.9659;//c525
-//const float cx = 316.2778, cy = 232.4590;
+//相机内参见 camera_model.h, 由标定文件读入
 
-//const float fx = 1140.8604 / 3, fy = 1141.4534 / 3;//c930E #1
-//const float cx = 920.9147 / 3 , cy = 580.8716 / 3;
-
-//const float fx = 1152.1080 / 3, fy = 1153.6161 / 3;//c930E #2
-//const float cx = 974.8427 / 3, cy = 566.9231 / 3;
-
-//const float fx = 1140.8956 / 3, fy = 1141.5722 / 3;//c930E #3
-//const float cx = 952.2491 / 3, cy = 562.5637 / 3;
-
-const float fx = 1148.9655 / 3, fy = 1148.8481 / 3;//c930E #4
-const float cx = 949.7131 / 3 , cy = 549.0170 / 3;
 
 extern vector<float> color, white;
 /////////////椭圆坐标类型
@@ -75,15 +63,29 @@ struct coordinate {
     float possible;
     int order;
     float a;
+    float b;
+    float rad;//椭圆长轴的角度
     uchar flag;//0为F，1为T, 2为未识别
-    coordinate() : x(0), y(0), locx(0), locy(0), num(0), possible(0), order(0), a(0), flag(0) {}
+    coordinate() : x(0), y(0), locx(0), locy(0), num(0), possible(0), order(0), a(0), b(0), rad(0), flag(0) {}
     bool operator<(const coordinate& other) const{
         float dis1 = locx * locx + locy * locy;
         float dis2 = other.locx * other.locx + other.locy * other.locy;
         return dis1 < dis2;
     }
 };
-extern vector<coordinate> ellipse_pre;
+
+/////////////目标颜色判定: 大圆 ROI 按 HSV 阈值分出蓝色和红色, 两者占椭圆外接矩形的百分比
+/////////////落在蓝色为主或红色为主的窗口内时认为是目标
+struct Target_Color {
+    int blue_low[3], blue_high[3];  // H, S, V
+    int red_low[3], red_high[3];
+    float blue_target[4];           // 蓝色为主: 蓝色占比 min, max, 红色占比 min, max
+    float red_target[4];            // 红色为主
+    Target_Color() :
+        blue_low{0, 0, 106}, blue_high{127, 255, 250},
+        red_low{131, 0, 106}, red_high{176, 255, 250},
+        blue_target{61, 95, 4, 28}, red_target{5, 46, 58, 96} {}
+};
 
 struct target{
     float_t x = 0;
@@ -171,6 +173,8 @@ class CEllipseDetectorYaed
 							// _times[3] : time for estimation
 							// _times[4] : time for validation
 							// _times[5] : time for clustering
+	int		_arcs[4];		// 每个凸性象限(1..4)检测到的弧段数
+	int		_candidates;	// 聚类前的椭圆数
 
 	int ACC_N_SIZE;			// size of accumulator N = B/A
 	int ACC_R_SIZE;			// size of accumulator R = rho = atan(K)
@@ -196,14 +200,12 @@ public:
 
 	//优化得到的椭圆
 
-	//提取ROI
-    void extracrROI(Mat1b& image, vector<coordinate>& ellipse_out, vector<Mat1b>& img_roi);
-
 	bool computcolorpercentage(Mat3b& roi, Ellipse& ell_in);
 
 	void targetcolor(Mat3b& resultImage2, vector< Ellipse >& ellipse_in, vector< Ellipse >& ellipse_big);
 
     bool computetargetcolorpercentage(Mat3b& roi, Ellipse& ell_in);
+    Target_Color color;     // computetargetcolorpercentage 的阈值, 见 runtime_config.h
 
 	void big_vector(Mat3b& resultImage2, vector< Ellipse >& ellipse_in, vector< Ellipse >& ellipse_big);
     //Set the parameters of the detector
@@ -219,9 +221,16 @@ public:
 							int     iNs
 						);
 
+	//按图像大小设置默认参数 (Sect. 4.2)
+	void SetDefaultParameters(Size szImg);
+
 	// Return the execution time
 	double GetExecTime() { return _times[0] + _times[1] + _times[2] + _times[3] + _times[4] + _times[5]; }
 	vector<double> GetTimes() { return _times; }
+
+	// 上一次 Detect 的统计: 每个象限的弧段数, 聚类前的候选椭圆数
+	int GetArcs(int quadrant) const { return _arcs[quadrant]; }
+	int GetCandidates() const { return _candidates; }
 	
 private:
 
@@ -320,9 +329,13 @@ private:
 
 };
 
-/*字符识别函数：前两个变量为输入，后两个为输出
- * 第一个变量为输入的灰度图
- * 第二个变量为灰度图中椭圆检测后得到的vector
- * 第三个变量为将输入的椭圆vector进行TF识别后，改变其flag，输出椭圆vector
- * 第四个变量为字符所在区域轮廓点集，方便后续显示在图像中*/
-void visual_rec(vector<Mat1b>& gray, vector<coordinate>& ellipse_out0, vector<coordinate>& ellipse_out00, vector< vector<Point> >& contours0);
+/*字符识别函数(快速): 不找轮廓, 按椭圆的长短轴和角度取一块归一化的小图, 用字符的镜像对称性区分T和F
+ * 第一个变量为输入的彩色图, 第二个变量为该图相对椭圆坐标的缩放倍数(大图为3), 只对椭圆内的小图转灰度,
+ * 不修改输入图像, 也不需要整幅图的模糊和二值化
+ * 第三个变量为判为 T 的对称度阈值 (vision_config 的 target.tf_symmetry)
+ * 第四个变量为检测图中的椭圆, 识别后改变其flag, 输出到第五个变量
+ * 第六个变量为字符所在区域的方框, 方便后续显示在图像中*/
+void visual_rec_fast(const Mat3b& image, float scale, float sym_t, vector<coordinate>& ellipse_out0, vector<coordinate>& ellipse_out00, vector< vector<Point> >& contours0);
+
+/*对单个椭圆做T/F识别, 对称度高于 sym_t 为T, 返回 flag (0为F, 1为T, 2为未识别), sym 输出字符的对称度*/
+uchar classify_TF(const Mat3b& image, float xc, float yc, float a, float b, float rad, float sym_t, float& sym);
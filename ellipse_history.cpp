@@ -0,0 +1,166 @@
+/**
+ * @file ellipse_history.cpp
+ *
+ * @brief Bounded, time-decayed history of ground positions of detected ellipses
+ *
+ */
+
+#include "ellipse_history.h"
+
+#include <math.h>
+
+// 票数低于该值的格子视为已经过期
+#define HISTORY_MIN_VOTE 0.05f
+
+
+Ellipse_History::
+Ellipse_History(float radius_, float half_life_)
+{
+    radius = radius_;
+    half_life = half_life_;
+    clear();
+}
+
+void
+Ellipse_History::
+clear()
+{
+    for (int i = 0; i < ELLIPSE_HISTORY_SIZE; i++)
+    {
+        cells[i].used = false;
+        cells[i].vote = 0;
+    }
+    total_vote = 0;
+    last_decay_usec = 0;
+}
+
+int
+Ellipse_History::
+size() const
+{
+    int n = 0;
+    for (int i = 0; i < ELLIPSE_HISTORY_SIZE; i++)
+        if (cells[i].used)
+            n++;
+    return n;
+}
+
+
+// ------------------------------------------------------------------------------
+//   衰减: 所有格子的票数乘以 2^(-dt/half_life), 同时重新累计总票数
+// ------------------------------------------------------------------------------
+void
+Ellipse_History::
+decay(uint64_t now_usec)
+{
+    if (last_decay_usec == 0 || now_usec <= last_decay_usec)
+    {
+        last_decay_usec = now_usec;
+        return;
+    }
+
+    float dt = (now_usec - last_decay_usec) / 1e6f;
+    float k = exp2f(-dt / half_life);
+    last_decay_usec = now_usec;
+
+    total_vote = 0;
+    for (int i = 0; i < ELLIPSE_HISTORY_SIZE; i++)
+    {
+        if (!cells[i].used)
+            continue;
+        cells[i].vote *= k;
+        if (cells[i].vote < HISTORY_MIN_VOTE)
+        {
+            cells[i].used = false;
+            cells[i].vote = 0;
+            continue;
+        }
+        total_vote += cells[i].vote;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   投票
+// ------------------------------------------------------------------------------
+int
+Ellipse_History::
+vote(float locx, float locy, float x, float y, uint64_t now_usec)
+{
+    int idx = find(locx, locy);
+    if (idx < 0)
+    {
+        idx = allocate();
+        total_vote -= cells[idx].vote;
+        cells[idx].used = true;
+        cells[idx].vote = 0;
+        cells[idx].locx = locx;
+        cells[idx].locy = locy;
+        cells[idx].prev_x = x;
+        cells[idx].prev_y = y;
+    }
+    else
+    {
+        // 格子的位置跟随最近的检测结果
+        cells[idx].locx = locx;
+        cells[idx].locy = locy;
+        cells[idx].prev_x = cells[idx].x;
+        cells[idx].prev_y = cells[idx].y;
+    }
+
+    cells[idx].x = x;
+    cells[idx].y = y;
+    cells[idx].vote += 1;
+    cells[idx].last_usec = now_usec;
+    total_vote += 1;
+
+    return idx;
+}
+
+float
+Ellipse_History::
+possible(int idx) const
+{
+    if (idx < 0 || !cells[idx].used)
+        return 0;
+    return cells[idx].vote / (total_vote + 0.0001f);
+}
+
+
+// ------------------------------------------------------------------------------
+//   查找 radius 米内票数最多的格子, 没有则返回 -1
+// ------------------------------------------------------------------------------
+int
+Ellipse_History::
+find(float locx, float locy) const
+{
+    int best = -1;
+    for (int i = 0; i < ELLIPSE_HISTORY_SIZE; i++)
+    {
+        if (!cells[i].used)
+            continue;
+        if (fabsf(locx - cells[i].locx) < radius &&
+            fabsf(locy - cells[i].locy) < radius)
+        {
+            if (best < 0 || cells[i].vote > cells[best].vote)
+                best = i;
+        }
+    }
+    return best;
+}
+
+// 优先使用空格子, 全部占满时覆盖票数最少的格子
+int
+Ellipse_History::
+allocate()
+{
+    int weakest = 0;
+    for (int i = 0; i < ELLIPSE_HISTORY_SIZE; i++)
+    {
+        if (!cells[i].used)
+            return i;
+        if (cells[i].vote < cells[weakest].vote)
+            weakest = i;
+    }
+    return weakest;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file ellipse_history.h
+ *
+ * @brief Bounded, time-decayed history of ground positions of detected ellipses
+ *
+ * filtellipse 用来滤除偶然检测出的圆.  每个格子对应地面上一个位置(局部坐标系, m),
+ * 每帧检测到的椭圆给最近的格子投票, 票数按指数规律随时间衰减.
+ * 格子数固定, 满了之后覆盖票数最少的格子, 所以内存有界, 每帧开销为常数.
+ *
+ */
+
+#ifndef ELLIPSE_HISTORY_H_
+#define ELLIPSE_HISTORY_H_
+
+#include <stdint.h>
+
+// 格子总数, 决定了每帧的最大开销
+#define ELLIPSE_HISTORY_SIZE 64
+
+
+struct History_Cell
+{
+    float locx;         // 局部坐标 x (m)
+    float locy;         // 局部坐标 y (m)
+    float x;            // 最近一次投票的像素坐标
+    float y;
+    float prev_x;       // 再上一次投票的像素坐标, 新格子与 x, y 相同
+    float prev_y;
+    float vote;         // 衰减后的票数
+    uint64_t last_usec; // 最近一次投票的时间
+    bool used;
+};
+
+
+class Ellipse_History
+{
+
+public:
+
+    Ellipse_History(float radius_ = 4.0f, float half_life_ = 5.0f);
+
+    float radius;       // 两次检测相距 radius 米内算作同一个格子
+    float half_life;    // 票数衰减一半所需的时间 (s)
+
+    // 按距离上次调用的时间衰减所有格子, 每帧调用一次
+    void decay(uint64_t now_usec);
+
+    // 给 (locx, locy) 所在的格子投一票, 返回格子序号
+    int vote(float locx, float locy, float x, float y, uint64_t now_usec);
+
+    // 格子票数占总票数的比例
+    float possible(int idx) const;
+
+    const History_Cell& cell(int idx) const { return cells[idx]; }
+    float total() const { return total_vote; }
+    int size() const;
+
+    void clear();
+
+private:
+
+    History_Cell cells[ELLIPSE_HISTORY_SIZE];
+    float total_vote;
+    uint64_t last_decay_usec;
+
+    int find(float locx, float locy) const;
+    int allocate();
+
+};
+
+#endif // ELLIPSE_HISTORY_H_
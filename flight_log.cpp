@@ -0,0 +1,505 @@
+/**
+ * @file flight_log.cpp
+ *
+ * @brief Asynchronous binary flight / vision log
+ *
+ */
+
+#include "flight_log.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+
+
+Flight_Log flight_log;
+
+
+// ------------------------------------------------------------------------------
+//   格式表
+// ------------------------------------------------------------------------------
+struct Log_Structure
+{
+    uint8_t type;
+    uint8_t length;
+    const char *name;
+    const char *format;
+    const char *labels;
+};
+
+// 字段类型字符与 ArduPilot 相同
+static constexpr int
+format_char_length(char c)
+{
+    return (c == 'b' || c == 'B' || c == 'M') ? 1 :
+           (c == 'h' || c == 'H') ? 2 :
+           (c == 'i' || c == 'I' || c == 'f' || c == 'L' || c == 'n') ? 4 :
+           (c == 'q' || c == 'Q' || c == 'd') ? 8 :
+           (c == 'N') ? 16 :
+           (c == 'Z') ? 64 : -1000;
+}
+
+static constexpr int
+format_length(const char *f)
+{
+    return *f ? format_char_length(*f) + format_length(f + 1) : 3;
+}
+
+#define LOG_FORMAT_FMT   "BBnNZ"
+#define LOG_VISION_FMT   "QIBBBBBff"
+#define LOG_VEHICLE_FMT  "QfffBBBbHBBB"
+#define LOG_TARGET_FMT   "QBBhffIIfLL"
+#define LOG_RADIUS_FMT   "Qff"
+#define LOG_SETPOINT_FMT "QHBffffffff"
+#define LOG_EVENT_FMT    "QZ"
+#define LOG_LOGGER_FMT   "QIIIB"
+#define LOG_MISSION_FMT  "QBBBII"
+#define LOG_CONTROL_FMT  "QBffffff"
+#define LOG_APPROACH_FMT "QBBIfffH"
+
+static_assert(sizeof(log_Format)   == format_length(LOG_FORMAT_FMT),   "log_Format does not match its format");
+static_assert(sizeof(log_Vision)   == format_length(LOG_VISION_FMT),   "log_Vision does not match its format");
+static_assert(sizeof(log_Vehicle)  == format_length(LOG_VEHICLE_FMT),  "log_Vehicle does not match its format");
+static_assert(sizeof(log_Target)   == format_length(LOG_TARGET_FMT),   "log_Target does not match its format");
+static_assert(sizeof(log_Radius)   == format_length(LOG_RADIUS_FMT),   "log_Radius does not match its format");
+static_assert(sizeof(log_Setpoint) == format_length(LOG_SETPOINT_FMT), "log_Setpoint does not match its format");
+static_assert(sizeof(log_Event)    == format_length(LOG_EVENT_FMT),    "log_Event does not match its format");
+static_assert(sizeof(log_Logger)   == format_length(LOG_LOGGER_FMT),   "log_Logger does not match its format");
+static_assert(sizeof(log_Mission)  == format_length(LOG_MISSION_FMT),  "log_Mission does not match its format");
+static_assert(sizeof(log_Control)  == format_length(LOG_CONTROL_FMT),  "log_Control does not match its format");
+static_assert(sizeof(log_Approach) == format_length(LOG_APPROACH_FMT), "log_Approach does not match its format");
+
+static const Log_Structure log_structure[] = {
+    {LOG_FORMAT_MSG, sizeof(log_Format), "FMT", LOG_FORMAT_FMT, "Type,Length,Name,Format,Columns"},
+    {LOG_VISION_MSG, sizeof(log_Vision), "VIS", LOG_VISION_FMT, "TimeUS,Seq,Det,Cand,Out,T,F,DetMs,TotMs"},
+    {LOG_VEHICLE_MSG, sizeof(log_Vehicle), "VEH", LOG_VEHICLE_FMT, "TimeUS,X,Y,Z,Stb,Upd,Drp,TNum,MSeq,Tgts,ET,EF"},
+    {LOG_TARGET_MSG, sizeof(log_Target), "TGT", LOG_TARGET_FMT, "TimeUS,List,Idx,Num,X,Y,TN,FN,Pos,Lat,Lng"},
+    {LOG_RADIUS_MSG, sizeof(log_Radius), "RAD", LOG_RADIUS_FMT, "TimeUS,A,Alt"},
+    {LOG_SETPOINT_MSG, sizeof(log_Setpoint), "SP", LOG_SETPOINT_FMT, "TimeUS,Mask,Frame,X,Y,Z,VX,VY,VZ,Yaw,YawR"},
+    {LOG_EVENT_MSG, sizeof(log_Event), "MSG", LOG_EVENT_FMT, "TimeUS,Message"},
+    {LOG_LOGGER_MSG, sizeof(log_Logger), "LOGS", LOG_LOGGER_FMT, "TimeUS,Drop,Wrtn,Pend,Thr"},
+    {LOG_MISSION_MSG, sizeof(log_Mission), "MIS", LOG_MISSION_FMT, "TimeUS,From,To,Ev,LatUS,DwellMs"},
+    {LOG_CONTROL_MSG, sizeof(log_Control), "CTL", LOG_CONTROL_FMT, "TimeUS,Ph,Ex,Ey,Vx,Vy,Alt,Kp"},
+    {LOG_APPROACH_MSG, sizeof(log_Approach), "APR", LOG_APPROACH_FMT, "TimeUS,Ph,Conv,DurMs,Err0,Over,PeakV,Upd"},
+};
+
+uint8_t
+flight_log_record_length(uint8_t type)
+{
+    for (size_t i = 0; i < sizeof(log_structure) / sizeof(log_structure[0]); i++)
+        if (log_structure[i].type == type)
+            return log_structure[i].length;
+    return 0;
+}
+
+static uint64_t
+log_time_usec()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Log_Ring
+// ------------------------------------------------------------------------------
+bool
+Log_Ring::
+push(const void *record, uint16_t size)
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (FLIGHT_LOG_RING_SIZE - (h - t) < size)
+        return false;
+
+    uint32_t pos = h & (FLIGHT_LOG_RING_SIZE - 1);
+    uint32_t first = FLIGHT_LOG_RING_SIZE - pos;
+    if (first >= size)
+        memcpy(buf + pos, record, size);
+    else
+    {
+        memcpy(buf + pos, record, first);
+        memcpy(buf, (const uint8_t *)record + first, size - first);
+    }
+
+    head.store(h + size, std::memory_order_release);
+    return true;
+}
+
+// 从 tail + offset 处拷出 size 字节, 不移动 tail
+bool
+Log_Ring::
+peek(uint32_t offset, void *out, uint16_t size) const
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) - t < offset + size)
+        return false;
+
+    uint32_t pos = (t + offset) & (FLIGHT_LOG_RING_SIZE - 1);
+    uint32_t first = FLIGHT_LOG_RING_SIZE - pos;
+    if (first >= size)
+        memcpy(out, buf + pos, size);
+    else
+    {
+        memcpy(out, buf + pos, first);
+        memcpy((uint8_t *)out + first, buf, size - first);
+    }
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Flight_Log::
+Flight_Log() : fd(-1), max_bytes_per_sec(FLIGHT_LOG_RATE), enabled(false), time_to_exit(false),
+               flush_tid(0), ring_count(0), drops(0), written(0)
+{
+    memset(rings, 0, sizeof(rings));
+    pthread_mutex_init(&ring_lock, NULL);
+}
+
+Flight_Log::
+~Flight_Log()
+{
+    stop();
+    for (int i = 0; i < FLIGHT_LOG_MAX_THREADS; i++)
+        delete rings[i];
+    pthread_mutex_destroy(&ring_lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Start / Stop
+// ------------------------------------------------------------------------------
+static void *
+start_flush_thread(void *args)
+{
+    ((Flight_Log *)args)->flush_thread();
+    return NULL;
+}
+
+bool
+Flight_Log::
+start(const char *path, uint32_t max_bytes_per_sec_)
+{
+    if (enabled)
+        return true;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "WARNING: could not open flight log %s\n", path);
+        return false;
+    }
+
+    max_bytes_per_sec = max_bytes_per_sec_;
+    if (!write_formats())
+    {
+        fprintf(stderr, "WARNING: could not write flight log %s\n", path);
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    time_to_exit = false;
+    if (pthread_create(&flush_tid, NULL, &start_flush_thread, this) != 0)
+    {
+        fprintf(stderr, "WARNING: could not start flight log thread\n");
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    enabled = true;
+    printf("FLIGHT LOG %s, at most %u bytes/s\n", path, max_bytes_per_sec);
+    return true;
+}
+
+void
+Flight_Log::
+stop()
+{
+    if (!enabled)
+        return;
+
+    enabled = false;
+    time_to_exit = true;
+    pthread_join(flush_tid, NULL);
+
+    close(fd);
+    fd = -1;
+}
+
+// FMT 的字符串字段定长, 不要求以 0 结尾; fmt 已清零, 短字符串后面补 0
+static void
+copy_field(char *dst, size_t size, const char *src)
+{
+    size_t len = strlen(src);
+    memcpy(dst, src, len < size ? len : size);
+}
+
+bool
+Flight_Log::
+write_formats()
+{
+    for (size_t i = 0; i < sizeof(log_structure) / sizeof(log_structure[0]); i++)
+    {
+        const Log_Structure &s = log_structure[i];
+        log_Format fmt;
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.head1 = LOG_HEAD_BYTE1;
+        fmt.head2 = LOG_HEAD_BYTE2;
+        fmt.msgid = LOG_FORMAT_MSG;
+        fmt.type = s.type;
+        fmt.length = s.length;
+        copy_field(fmt.name, sizeof(fmt.name), s.name);
+        copy_field(fmt.format, sizeof(fmt.format), s.format);
+        copy_field(fmt.labels, sizeof(fmt.labels), s.labels);
+        if (write_all(&fmt, sizeof(fmt)) != sizeof(fmt))
+            return false;
+    }
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   写记录 (调用线程)
+// ------------------------------------------------------------------------------
+// 每个线程第一次写日志时分配自己的缓冲区
+Log_Ring *
+Flight_Log::
+thread_ring()
+{
+    static thread_local Log_Ring *ring = NULL;
+    if (ring)
+        return ring;
+
+    pthread_mutex_lock(&ring_lock);
+    int n = ring_count.load();
+    if (n < FLIGHT_LOG_MAX_THREADS)
+    {
+        ring = new Log_Ring();
+        rings[n] = ring;
+        ring_count.store(n + 1, std::memory_order_release);
+    }
+    pthread_mutex_unlock(&ring_lock);
+    return ring;
+}
+
+bool
+Flight_Log::
+write(const void *record, uint16_t size)
+{
+    if (!enabled.load(std::memory_order_relaxed))
+        return false;
+
+    Log_Ring *ring = thread_ring();
+    if (!ring || !ring->push(record, size))
+    {
+        drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void
+Flight_Log::
+message(const char *fmt, ...)
+{
+    if (!enabled.load(std::memory_order_relaxed))
+        return;
+
+    log_Event rec;
+    rec.time_us = log_time_usec();
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(rec.text, sizeof(rec.text), fmt, ap);
+    va_end(ap);
+    write(&rec, sizeof(rec));
+}
+
+
+// ------------------------------------------------------------------------------
+//   写盘线程
+// ------------------------------------------------------------------------------
+// 从各缓冲区取出完整记录, 总量不超过 room 和 budget
+size_t
+Flight_Log::
+drain(uint8_t *out, size_t room, double &budget)
+{
+    static int start = 0;
+    size_t n = 0;
+    int count = ring_count.load(std::memory_order_acquire);
+    if (count == 0)
+        return 0;
+
+    // 轮流从不同的缓冲区开始, 限速时各线程的记录都有机会写盘
+    start = (start + 1) % count;
+    for (int k = 0; k < count; k++)
+    {
+        Log_Ring *ring = rings[(start + k) % count];
+        uint32_t taken = 0;
+        uint8_t header[3];
+        while (ring->peek(taken, header, 3))
+        {
+            uint8_t length = flight_log_record_length(header[2]);
+            if (header[0] != LOG_HEAD_BYTE1 || header[1] != LOG_HEAD_BYTE2 || length == 0)
+            {
+                // 不应出现: 调用者写了未登记的记录, 丢弃该缓冲区中剩余的内容
+                taken = ring->pending();
+                break;
+            }
+            if (length > budget || n + length > room)
+                break;
+            ring->peek(taken, out + n, length);
+            taken += length;
+            n += length;
+            budget -= length;
+        }
+        ring->tail.store(ring->tail.load(std::memory_order_relaxed) + taken, std::memory_order_release);
+    }
+    return n;
+}
+
+bool
+Flight_Log::
+write_stats(uint64_t time_us)
+{
+    log_Logger rec;
+    rec.time_us = time_us;
+    rec.dropped = (uint32_t)dropped();
+    rec.written = (uint32_t)written;
+    rec.pending = 0;
+    int count = ring_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++)
+        rec.pending += rings[i]->pending();
+    rec.threads = count;
+    size_t done = write_all(&rec, sizeof(rec));
+    if (done != sizeof(rec))
+        write_failed((const uint8_t *)&rec, sizeof(rec), done);
+
+    static Metric_Gauge &pending = metrics.gauge("log.pending_bytes");
+    static Metric_Gauge &dropped_records = metrics.gauge("log.dropped_records");
+    pending.set(rec.pending);
+    dropped_records.set(rec.dropped);
+    return done == sizeof(rec);
+}
+
+// 写完 n 个字节, 返回实际写出的字节数; 小于 n 说明出错 (如磁盘满)
+size_t
+Flight_Log::
+write_all(const void *data, size_t n)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    size_t done = 0;
+    while (done < n)
+    {
+        ssize_t result = ::write(fd, p + done, n - done);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            break;
+        done += result;
+    }
+    written += done;
+    return done;
+}
+
+// 只写出一半的记录会使之后所有记录错位, 所以出错后停止记录.
+// data 中没有完整写出的记录和各缓冲区中剩余的记录都计入 drops
+void
+Flight_Log::
+write_failed(const uint8_t *data, size_t n, size_t done)
+{
+    int error = errno;
+    uint64_t lost = 0;
+    for (size_t off = 0; off + 3 <= n; )
+    {
+        uint8_t length = flight_log_record_length(data[off + 2]);
+        if (length == 0)
+            break;
+        if (off + length > done)
+            lost++;
+        off += length;
+    }
+
+    enabled = false;
+    int count = ring_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++)
+    {
+        Log_Ring *ring = rings[i];
+        uint32_t taken = 0;
+        uint8_t header[3];
+        while (ring->peek(taken, header, 3))
+        {
+            uint8_t length = flight_log_record_length(header[2]);
+            if (length == 0)
+            {
+                taken = ring->pending();
+                break;
+            }
+            taken += length;
+            lost++;
+        }
+        ring->tail.store(ring->tail.load(std::memory_order_relaxed) + taken, std::memory_order_release);
+    }
+    drops.fetch_add(lost, std::memory_order_relaxed);
+
+    fprintf(stderr, "WARNING: flight log write failed after %llu bytes (%s), logging stopped, %llu records lost\n",
+            (unsigned long long)written, error ? strerror(error) : "short write", (unsigned long long)lost);
+}
+
+void
+Flight_Log::
+flush_thread()
+{
+    static uint8_t staging[FLIGHT_LOG_RING_SIZE];
+    double budget = 0;
+    uint64_t last = log_time_usec();
+    uint64_t last_stats = last;
+
+    while (true)
+    {
+        bool exiting = time_to_exit;
+        if (!exiting)
+            usleep(50000);
+
+        uint64_t now = log_time_usec();
+        budget += max_bytes_per_sec * (now - last) / 1e6;
+        if (budget > max_bytes_per_sec)
+            budget = max_bytes_per_sec;//最多积累 1 秒的额度
+        last = now;
+
+        // 退出时不再限速, 把缓冲区中剩余的记录全部写完
+        double unlimited = 1e18;
+        size_t n;
+        while ((n = drain(staging, sizeof(staging), exiting ? unlimited : budget)) > 0)
+        {
+            size_t done = write_all(staging, n);
+            if (done != n)
+            {
+                write_failed(staging, n, done);
+                return;
+            }
+            if (!exiting)
+                break;
+        }
+
+        if (now - last_stats >= 1000000 || exiting)
+        {
+            if (!write_stats(now))
+                return;
+            last_stats = now;
+        }
+
+        if (exiting)
+            break;
+    }
+}
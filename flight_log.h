@@ -0,0 +1,313 @@
+/**
+ * @file flight_log.h
+ *
+ * @brief Asynchronous binary flight / vision log
+ *
+ * 取代每帧用 endl 刷新的 target_r.txt / hight_and_r.txt / dropp.txt 和热路径上的 cout.
+ * 写日志的线程只把定长的二进制记录拷进自己的单生产者单消费者环形缓冲区, 不加锁也不做系统调用;
+ * 后台写盘线程每 50ms 把各缓冲区中的完整记录合并成一次 write(), 并按 max_bytes_per_sec 限制写盘速率.
+ * 缓冲区满 (写盘跟不上或被限速) 时新记录直接丢弃并计数, 不阻塞调用线程.
+ *
+ * 记录格式与 ArduPilot DataFlash (.bin) 相同: 每条记录以 0xA3 0x95 <type> 开头,
+ * 文件开头为各类型的 FMT 记录 (名称、字段类型字符和字段名), 因此 tools/log_decode
+ * 或 pymavlink 的 mavlogdump.py 都可以直接解码.
+ *
+ * 日志等级在编译时确定: 低于 FLIGHT_LOG_LEVEL 的记录连同填写记录的代码一起被编译器去掉,
+ * 例如 -DFLIGHT_LOG_LEVEL=LOG_LEVEL_INFO 时不再记录每帧的目标表和每个 setpoint.
+ *
+ */
+
+#ifndef FLIGHT_LOG_H_
+#define FLIGHT_LOG_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <atomic>
+
+
+// ------------------------------------------------------------------------------
+//   日志等级
+// ------------------------------------------------------------------------------
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_DEBUG 2
+
+#ifndef FLIGHT_LOG_LEVEL
+#define FLIGHT_LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// 编译期常量, 不满足时整个 if 块被去掉
+#define FLIGHT_LOG_ENABLED(level) ((level) <= FLIGHT_LOG_LEVEL)
+
+// 文本事件, 仅用于低频的任务流程事件
+#define FLIGHT_LOG_MSG(level, ...) \
+    do { if (FLIGHT_LOG_ENABLED(level)) flight_log.message(__VA_ARGS__); } while (0)
+
+
+// 每个线程的环形缓冲区大小, 须为 2 的幂
+#define FLIGHT_LOG_RING_SIZE   65536
+#define FLIGHT_LOG_MAX_THREADS 8
+// 缺省写盘速率上限 (字节/秒)
+#define FLIGHT_LOG_RATE        131072
+
+
+// ------------------------------------------------------------------------------
+//   记录格式
+// ------------------------------------------------------------------------------
+#define LOG_HEAD_BYTE1 0xA3
+#define LOG_HEAD_BYTE2 0x95
+#define LOG_PACKET_HEADER uint8_t head1, head2, msgid
+#define LOG_PACKET_HEADER_INIT(id) head1 = LOG_HEAD_BYTE1; head2 = LOG_HEAD_BYTE2; msgid = (id)
+
+enum Log_Msg_Type
+{
+    LOG_VISION_MSG = 1,
+    LOG_VEHICLE_MSG,
+    LOG_TARGET_MSG,
+    LOG_RADIUS_MSG,
+    LOG_SETPOINT_MSG,
+    LOG_EVENT_MSG,
+    LOG_LOGGER_MSG,
+    LOG_MISSION_MSG,
+    LOG_CONTROL_MSG,
+    LOG_APPROACH_MSG,
+    LOG_FORMAT_MSG = 128,
+};
+
+// TGT 记录中的目标表
+enum Log_Target_List
+{
+    LOG_TARGET_LIST_TARGETS = 0,   // Target_Snapshot::targets
+    LOG_TARGET_LIST_T,             // Target_Snapshot::T
+    LOG_TARGET_LIST_F,             // Target_Snapshot::F
+};
+
+#pragma pack(push, 1)
+
+struct log_Format
+{
+    LOG_PACKET_HEADER;
+    uint8_t type;
+    uint8_t length;
+    char name[4];
+    char format[16];
+    char labels[64];
+};
+
+// 每帧的检测结果和耗时
+struct log_Vision
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t seq;
+    uint8_t detected;
+    uint8_t candidates;
+    uint8_t out;
+    uint8_t t;
+    uint8_t f;
+    float detect_ms;
+    float total_ms;
+    log_Vision() { LOG_PACKET_HEADER_INIT(LOG_VISION_MSG); }
+};
+
+// 每帧的位置、任务标志和目标表大小
+struct log_Vehicle
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float x;
+    float y;
+    float z;
+    uint8_t stable;
+    uint8_t update;
+    uint8_t drop;
+    int8_t target_num;
+    uint16_t mission_seq;
+    uint8_t targets;
+    uint8_t ellipse_t;
+    uint8_t ellipse_f;
+    log_Vehicle() { LOG_PACKET_HEADER_INIT(LOG_VEHICLE_MSG); }
+};
+
+// 目标表中的一项
+struct log_Target
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t list;
+    uint8_t index;
+    int16_t num;
+    float locx;
+    float locy;
+    uint32_t t_n;
+    uint32_t f_n;
+    float possible;
+    int32_t lat;
+    int32_t lon;
+    log_Target() { LOG_PACKET_HEADER_INIT(LOG_TARGET_MSG); }
+};
+
+// 椭圆半径与当前高度
+struct log_Radius
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float a;
+    float alt;
+    log_Radius() { LOG_PACKET_HEADER_INIT(LOG_RADIUS_MSG); }
+};
+
+// 发给飞控的 SET_POSITION_TARGET_LOCAL_NED
+struct log_Setpoint
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint16_t type_mask;
+    uint8_t frame;
+    float x;
+    float y;
+    float z;
+    float vx;
+    float vy;
+    float vz;
+    float yaw;
+    float yaw_rate;
+    log_Setpoint() { LOG_PACKET_HEADER_INIT(LOG_SETPOINT_MSG); }
+};
+
+struct log_Event
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    char text[64];
+    log_Event() { LOG_PACKET_HEADER_INIT(LOG_EVENT_MSG); }
+};
+
+// 日志本身的统计, 写盘线程每秒一条
+struct log_Logger
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t dropped;
+    uint32_t written;
+    uint32_t pending;
+    uint8_t threads;
+    log_Logger() { LOG_PACKET_HEADER_INIT(LOG_LOGGER_MSG); }
+};
+
+// 任务状态切换, 状态和事件编号见 mission.h
+struct log_Mission
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t from;
+    uint8_t to;
+    uint8_t event;
+    uint32_t latency_us;    // 从事件投递到新状态的进入动作执行完
+    uint32_t dwell_ms;      // 在上一个状态停留的时间
+    log_Mission() { LOG_PACKET_HEADER_INIT(LOG_MISSION_MSG); }
+};
+
+// 逼近控制器的一次更新, 相位见 approach_controller.h
+struct log_Control
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t phase;
+    float ex;
+    float ey;
+    float vx;
+    float vy;
+    float alt;
+    float kp;
+    log_Control() { LOG_PACKET_HEADER_INIT(LOG_CONTROL_MSG); }
+};
+
+// 一次逼近的结果
+struct log_Approach
+{
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t phase;
+    uint8_t converged;
+    uint32_t duration_ms;   // 收敛用时, 未收敛时为逼近持续的时间
+    float initial_error;    // m
+    float overshoot;        // m
+    float peak_speed;       // m/s
+    uint16_t updates;
+    log_Approach() { LOG_PACKET_HEADER_INIT(LOG_APPROACH_MSG); }
+};
+
+#pragma pack(pop)
+
+
+// ------------------------------------------------------------------------------
+//   单生产者单消费者环形缓冲区
+// ------------------------------------------------------------------------------
+struct Log_Ring
+{
+    uint8_t buf[FLIGHT_LOG_RING_SIZE];
+    std::atomic<uint32_t> head;     // 生产者写入的字节总数
+    std::atomic<uint32_t> tail;     // 消费者取走的字节总数
+
+    Log_Ring() : head(0), tail(0) {}
+
+    bool push(const void *record, uint16_t size);
+    bool peek(uint32_t offset, void *out, uint16_t size) const;
+    uint32_t pending() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed); }
+};
+
+
+// ------------------------------------------------------------------------------
+//   Flight_Log
+// ------------------------------------------------------------------------------
+class Flight_Log
+{
+
+public:
+
+    Flight_Log();
+    ~Flight_Log();
+
+    bool start(const char *path, uint32_t max_bytes_per_sec = FLIGHT_LOG_RATE);
+    void stop();
+
+    // 写一条定长记录, 未 start 或缓冲区满时返回 false
+    bool write(const void *record, uint16_t size);
+    void message(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    uint64_t dropped() const { return drops.load(std::memory_order_relaxed); }
+
+    void flush_thread();
+
+private:
+
+    int fd;
+    uint32_t max_bytes_per_sec;
+    std::atomic<bool> enabled;
+    volatile bool time_to_exit;
+    pthread_t flush_tid;
+
+    Log_Ring *rings[FLIGHT_LOG_MAX_THREADS];
+    std::atomic<int> ring_count;
+    pthread_mutex_t ring_lock;
+
+    std::atomic<uint64_t> drops;
+    uint64_t written;
+
+    Log_Ring *thread_ring();
+    size_t write_all(const void *data, size_t n);
+    void write_failed(const uint8_t *data, size_t n, size_t done);
+    bool write_formats();
+    size_t drain(uint8_t *out, size_t room, double &budget);
+    bool write_stats(uint64_t time_us);
+
+};
+
+extern Flight_Log flight_log;
+
+uint8_t flight_log_record_length(uint8_t type);
+
+
+#endif // FLIGHT_LOG_H_
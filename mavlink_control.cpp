@@ -57,6 +57,13 @@
 #include <cv.h>
 #include "ellipse/EllipseDetectorYaed.h"
 #include "autopilot_interface.h"
+#include "camera_capture.h"
+#include "vision_pipeline.h"
+#include "flight_log.h"
+#include "metrics.h"
+#include "mission.h"
+#include "swarm_map.h"
+#include "runtime_config.h"
 #include <thread>//多线程
 #include <fstream>
 #include <cmath>
@@ -64,8 +71,6 @@
 using namespace cv;
 using namespace std;
 
-vector<target> target_ellipse_position, ellipse_T, ellipse_F;
-
 
 // ------------------------------------------------------------------------------
 //   TOP
@@ -93,6 +98,9 @@ top (int argc, char **argv)
     parse_commandline(argc, argv, uart_name, baudrate);
     parse_commandline(argc, argv, WL_uart, baudrate);
 
+    // 检测、目标和任务参数, 见 config/uav.yml. kill -HUP 重新载入视觉参数
+    load_runtime_config(RUNTIME_CONFIG_FILE);
+
 
     // --------------------------------------------------------------------------
     //   PORT and THREAD STARTUP
@@ -128,6 +136,9 @@ top (int argc, char **argv)
      *
      */
     Autopilot_Interface autopilot_interface(&serial_port, &WL_serial_port);
+    autopilot_interface.open_tlog("flight.tlog");//记录飞控消息, 与 little_e.avi 一起用于离线回放
+    flight_log.start("flight_log.bin");//视觉和任务日志, 用 tools/log_decode 解码
+    metrics.start();//运行指标, 见 /tmp/uav_metrics.json 或 socat - UNIX-CONNECT:/tmp/uav_metrics.sock
 
     /*
      * Setup interrupt signal handler
@@ -141,6 +152,7 @@ top (int argc, char **argv)
     serial_port_quit         = &WL_serial_port;
     autopilot_interface_quit = &autopilot_interface;
     signal(SIGINT,quit_handler);
+    signal(SIGHUP,config_reload_handler);
 
     /*
      * Start the port and autopilot_interface
@@ -152,6 +164,7 @@ top (int argc, char **argv)
     serial_port.start();
     WL_serial_port.start();
     autopilot_interface.start();
+    swarm_map.start(autopilot_interface);//与其他飞机同步目标地图, 见 swarm.* 指标
 
     // --------------------------------------------------------------------------
     //   RUN COMMANDS
@@ -173,9 +186,12 @@ top (int argc, char **argv)
     // --------------------------------------------------------------------------
     //  Now that we are done we can stop the threads and close the port
 
+    swarm_map.stop();
     autopilot_interface.stop();
     serial_port.stop();
     WL_serial_port.stop();
+    flight_log.stop();
+    metrics.stop();
 
 
     // --------------------------------------------------------------------------
@@ -195,521 +211,20 @@ top (int argc, char **argv)
 void
 commands(Autopilot_Interface &api)
 {
-    ofstream outf2;
-    outf2.open("dropp.txt");
-    mavlink_global_position_int_t gp;
-    float dist, distance, XYdis;
-    bool flag = true;
-    bool goback = true;
-    TargetNum = 0;
-    int TNum = 0;
-    stable = false;
-    updateellipse = false;
-    drop = false;
-    int detect = 0;
-    while(flag)
-    {
-        if((api.Inter_message.command_long.command == 400)&&(api.Inter_message.command_long.param1 == 1))
-        {
-            api.enable_offboard_control();
-            outf2<<"enable_offboard!"<<endl;
-            break;
-        }
-        else
-        {
-            usleep(200000);
+    // 任务流程见 mission.h, 由遥测和视觉事件驱动
+    Mission mission(api);
 
-        }
-    }
-    while (flag)
-    {
-        if(api.current_messages.mission_item_reached.seq == 6)
-        {
+    // 解锁并到达搜索起点后再打开相机
+    mission.run(MISSION_SEARCH);
 
-            outf2<<"api.current_messages.mission_item_reached.seq :"<<api.current_messages.mission_item_reached.seq<<endl;
-            break;
-        }
-        else
-        {
-            usleep(20000);
-        }
-    }
     //视觉定位线程,
     thread t1(videothread, ref(api));//ref可以使autopilot_interface引用被正确传递给videothread.
-    // --------------------------------------------------------------------------
-    //   START OFFBOARD MODE
-    //   设置guided（offboard）模式/解锁、起飞
-    // --------------------------------------------------------------------------
-    usleep(1000); // give some time to let it sink in
-
-    // --------------------------------------------------------------------------
-    //   SEND OFFBOARD COMMANDS
-    // --------------------------------------------------------------------------
-//sleep(100);
-    while(flag)
-    {
-        gp = api.global_position;
-        stable = false;
-        goback = true;
-        updateellipse = false;
-        float yaw;
-        //设置触发节点
-        if (target_ellipse_position.size() > TargetNum)
-        {
-            // --------------------------------------------------------------------------
-            // 设置guided模式
-            // --------------------------------------------------------------------------
-            sleep(1);
-            updateellipse = true;
-            api.Set_Mode(05);
-            usleep(100000);
-            api.Set_Mode(04);
-            usleep(100);
-//            updateellipse = false;
-//            sleep(2);
-//            设置成为只更新椭圆位置,不添加新的椭圆坐标
-//            updateellipse = true;
-            mavlink_set_position_target_local_ned_t sp;
-            //现在用当前高度,最终高度确定时使用
-            float local_alt = -gp.relative_alt / 1000.0;
-            sp.coordinate_frame = MAV_FRAME_LOCAL_NED;
-            yaw = D2R(gp.hdg);
-            while (goback)
-            {
-                // --------------------------------------------------------------------------
-                // 给定局部坐标(local_ned)位置，并执行
-                // --------------------------------------------------------------------------
-
-                // -------------------------------------------------------------------------
-                // 							设置位置/朝向
-                // -------------------------------------------------------------------------
-                set_position(target_ellipse_position[TargetNum].locx, // [m]
-                             target_ellipse_position[TargetNum].locy, // [m]
-                             local_alt, // [m]
-                             sp);
-                set_yaw(yaw, // [rad]
-                        sp);
-
-                // SEND THE COMMAND
-                api.update_local_setpoint(sp);
-                sleep(4);
-
-                mavlink_local_position_ned_t pos = api.current_messages.local_position_ned;
-                while((fabsf(api.current_messages.local_position_ned.x-target_ellipse_position[TargetNum].locx)>=1)||(fabsf(api.current_messages.local_position_ned.y-target_ellipse_position[TargetNum].locy)>=1))
-                {
-                    float Disx = target_ellipse_position[TargetNum].locx - pos.x;
-                    float Disy = target_ellipse_position[TargetNum].locy - pos.y;
-                    float Adisx = fabsf(Disx);
-                    float Adisy	= fabsf(Disy);
-                    float Disz = local_alt - pos.z;
-
-                    while(fabsf(Disz)>=0.5)
-                    {
-                        if(fabsf(Disz)<=0.2)
-                        {
-                            break;
-                        }
-                        set_velocity(0,0,Disz/(fabsf(Disz)),sp);
-                        api.update_local_setpoint(sp);
-                        usleep(200000);
-                        pos = api.current_messages.local_position_ned;
-                        Disz = local_alt - pos.z;
-
-                    }
-                    if(Adisx >= Adisy)
-                    {
-                        set_velocity(Disx/Adisx,Disy/Adisx,0,sp);
-                    }
-                    else
-                    {
-                        set_velocity(Disx/Adisy,Disy/Adisy,0,sp);
-                    }
-                    set_yaw(yaw,sp);
-                    api.update_local_setpoint(sp);
-                    usleep(50000);
-                    pos = api.current_messages.local_position_ned;
-                }
-
-                    float Elocx = target_ellipse_position[TargetNum].x;
-                    float Elocy = target_ellipse_position[TargetNum].y;
-
-                    float Alocx = fabsf(Elocx);
-                    float Alocy = fabsf(Elocy);
-
-                    int j = 0;
-
-                    while ((Alocy > 10) || (Alocx > 10))
-                    {
-                        if (Alocx >= Alocy)
-                        {
-                            set_velocity(0.5 * (Elocx / Alocx), 0.5 * (Elocy / Alocx), 0, sp);
-                        }
-                        else
-                        {
-                            set_velocity(0.5 * (Elocx / Alocy), 0.5 * (Elocy / Alocy), 0, sp);
-                        }
-                        set_yaw(yaw,sp);
-                        api.update_local_setpoint(sp);
-                        usleep(200000);
-                        Elocx = target_ellipse_position[TargetNum].x;
-                        Elocy = target_ellipse_position[TargetNum].y;
-                        Alocx = fabsf(Elocx);
-                        Alocy = fabsf(Elocy);
-                        outf2<<"Elocx: "<<Elocx<<endl<<"Elocy: "<<Elocy<<endl;
-
-                        j = j + 1;
-                        if(j >= 20)
-                        {
-                            j = 0;
-                            break;
-                        }
-
-                    }
-
-                    local_alt = -30;
-                    set_velocity(0, 0, 1, sp);
-//
-                    while (goback)
-                    {
-                        if (api.current_messages.local_position_ned.z - local_alt + 0.5 > 0)
-                        {
-                            int TF = 0;
-                            stable = true;
-                            set_velocity(0, 0, 0, sp);
-                            api.update_local_setpoint(sp);
-                            usleep(2000);
-                            set_velocity(0, 0, 0, sp);
-                            api.update_local_setpoint(sp);
-                            //------------------------------------------------------------------------------
-                            //    调用判断T/F的函数
-                            //    若为T则将当前全局坐标系发送给从机[TagetNum+1]
-                            //------------------------------------------------------------------------------
-                            // 需添加固定时间内未检测到任何东西直接break
-                            while (stable)
-                            {
-                                TF++;
-                                if (TF == 10)
-                                {
-                                    int TplusF = target_ellipse_position[TargetNum].T_N +
-                                                 target_ellipse_position[TargetNum].F_N;
-                                    if (TplusF <= 10)
-                                    {
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        continue;
-                                    }
-                                }
-                                else
-                                {
-                                    sleep(1);
-                                    Elocx = target_ellipse_position[TargetNum].x;
-                                    Elocy = target_ellipse_position[TargetNum].y;
-                                    Alocx = fabsf(Elocx);
-                                    Alocy = fabsf(Elocy);
-                                    while ((Alocy > 10) || (Alocx > 10))
-                                    {
-                                        if (Alocx >= Alocy)
-                                        {
-                                            set_velocity(0.3 * (Elocx / Alocx), 0.3 * (Elocy / Alocx), 0, sp);
-                                        }
-                                        else
-                                        {
-                                            set_velocity(0.3 * (Elocx / Alocy), 0.3 * (Elocy / Alocy), 0, sp);
-                                        }
-                                        set_yaw(yaw,sp);
-                                        api.update_local_setpoint(sp);
-                                        usleep(200000);
-                                        Elocx = target_ellipse_position[TargetNum].x;
-                                        Elocy = target_ellipse_position[TargetNum].y;
-                                        Alocx = fabsf(Elocx);
-                                        Alocy = fabsf(Elocy);
-
-                                        j = j + 1;
-                                        if(j >= 5)
-                                        {
-                                            j = 0;
-                                            break;
-                                        }
-
-                                    }
-                                }
-                            }
-                            //检测T\F
-                            if (ellipse_T.size() > TNum)
-                            {
-                                if ((ellipse_T.size() == 1) || (ellipse_T.size()  == 2))
-                                {
-                                    TNum = api.Throw(yaw, TNum);
-                                    mavlink_global_position_int_t Target_Global_Position;
-                                    Target_Global_Position = api.current_messages.global_position_int;
-                                    outf2<<"Targetposition_lat: "<<Target_Global_Position.lat<<endl
-                                         <<"Targetposition_lon: "<<Target_Global_Position.lon<<endl
-                                         <<"machine_num:"<<TNum<<endl;
-                                    outf2<<"Throw "<<endl;
-//                                    int Globallen = api.Send_WL_Global_Position(TNum + 40, Target_Global_Position);
-                                    int targetnum = TargetNum;
-                                    TargetNum = TargetNum + 1;
-                                    if (TargetNum <= targetnum)
-                                    {
-                                        TargetNum = targetnum + 1;
-                                    }
-                                    else
-                                    {
-                                        ;
-                                    }
-                                    detect = 1;
-
-                                }
-                                else
-                                {
-                                    mavlink_global_position_int_t Target_Global_Position;
-                                    Target_Global_Position = api.current_messages.global_position_int;
-                                    if (Target_Global_Position.lat < 10000)
-                                    {
-                                        Target_Global_Position = api.current_messages.global_position_int;
-                                    }
-
-                                    int Globallen = api.Send_WL_Global_Position(TNum + 40, Target_Global_Position);
-                                    outf2<<"Targetposition_lat: "<<Target_Global_Position.lat<<endl
-                                         <<"Targetposition_lon: "<<Target_Global_Position.lon<<endl
-                                         <<"machine_num:"<<TNum<<endl;
-
-                                    TNum = TNum + 1;
-                                    TargetNum = TargetNum + 1;
-                                    detect = 1;
-
-                                }
-
-                            }
-                            else
-                            {
-                                TargetNum = TargetNum + 1;
-
-                                detect = 1;
-                            }
-                            stable = false;
-                            drop = false;
-                        }
-                        else
-                        {
-
-
-                            api.update_local_setpoint(sp);
-                            usleep(20000);
-
-                        }
-
-                        if(detect==1)
-                        {
-                            if (TNum == 3)
-                            {
-//                                api.Set_Mode(03);
-//                                sleep(2);
-//                                api.Set_Mode(03);
-//                                sleep(1);
-                                goback = false;
-                                flag = false;
-                                break;
-                            }
-                            else
-                            {
-                                //判定是否执行完已有目标
-                                if (target_ellipse_position.size() <= TargetNum)
-                                {
-                                    goback = false;
-                                    TargetNum = target_ellipse_position.size();
-                                    usleep(100);
-                                    outf2<<"goback: "<<goback<<endl;
-                                }
-                                else
-                                {
-                                    goback = true;
-                                    usleep(100);
-                                    outf2<<"goback: "<<goback<<endl;
-                                    break;
-                                }
-                            }
-                            detect = 0;
-                        }
-
-
-                    }
-
-                printf("\n");
-
-                if (goback == false)
-                {
-                    // -------------------------------------------------------------------------
-                    // --------------- 全局坐标系下设置目标位置坐标 -------------------------------
-                    // -------------------------------------------------------------------------
-                    mavlink_set_position_target_global_int_t gsp;
-                    mavlink_global_position_int_t ggsp = gp; //api.global_position;
-                    mavlink_set_position_target_global_int_t global_int_pos;
-                    global_int_pos.lat_int = ggsp.lat;
-                    global_int_pos.lon_int = ggsp.lon;
-                    global_int_pos.alt = ggsp.alt;
-                    global_int_pos.vx = ggsp.vx;
-                    global_int_pos.vy = ggsp.vy;
-                    global_int_pos.vz = ggsp.vz;
-                    float gyaw = D2R(ggsp.hdg);
-                    global_int_pos.yaw = gyaw;
-                    gsp.time_boot_ms = (uint32_t) (get_time_usec() / 1000);
-                    gsp.coordinate_frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
-
-                    // ------------------------------------------------------------------------
-                    //			配置设定巡视高度
-                    // ------------------------------------------------------------------------
-                    int32_t High = 33;
-                    //set global_point 经度，纬度，相对home高度
-                    set_global_position(global_int_pos.lat_int,
-                                        global_int_pos.lon_int,
-                                        High,
-                                        gsp);
-//				set_global_yaw(gyaw,
-//						       gsp);
-
-                    api.update_global_setpoint(gsp);
-                    while (updateellipse)
-                    {
-                        mavlink_global_position_int_t current_global = api.global_position;
-                        float distan = Distance(current_global.lat, current_global.lon, gp.relative_alt,
-                                                gp.lat, gp.lon, gp.relative_alt);
-                        if (distan < 5)
-                        {
-                            usleep(200);
-//                            goback = true;
-                            api.Set_Mode(03);
-                            usleep(100);
-                            api.Set_Mode(03);
-                            sleep(1);
-                            updateellipse = false;
-                            outf2<<"back to sp"<<endl;
-                            break;
-                        }
-                        else
-                        {
-                            api.update_global_setpoint(gsp);
-                            usleep(200000);
-                        }
-                    }
-
-                }
-
-            }
-        }
-        else
-        {
-
-            if(TNum == 3)
-            {
-                flag = false;
-            }
-            else
-            {
-                usleep(10000);
-            }
-            if((api.current_messages.mission_item_reached.seq == 11 ))
-            {
-                flag = false;
-                outf2<<"drop F"<<endl;
-                updateellipse = true;
-                switch (ellipse_F.size())
-                {
-                    case 0:
-                    {
-                        flag = false;
-                        break;
-                    }
-                    case 1:
-                    {
-                        //send RTL to all UAVs
-
-//                        ellipse_F[0].T_N = ellipse_F[0].F_N = ellipse_F[0].possbile = 0;
-//                        target_ellipse_position[ellipse_F[0].num].F_N = target_ellipse_position[ellipse_F[0].num].T_N = 0;
-//                        api.ThrowF(yaw,&ellipse_F[0]);
-                        flag = false;
-//                        api.RTL(40);
-                        break;
-                    }
-                    default:
-                    {
-                        sort(ellipse_F.begin(),ellipse_F.end());
-                        if(TNum == 1)
-                        {
-                            //将F中识别出来的T概率最高的点发送给从机[TNum+1]
-
-                            mavlink_global_position_int_t Target_Global_Position;
-                            Target_Global_Position.lat = ellipse_F[0].lat;
-                            Target_Global_Position.lon = ellipse_F[0].lon;
-                            uint16_t hdg1= R2D(yaw);
-                            Target_Global_Position.hdg = hdg1;
-//                            int Globallen=  api.Send_WL_Global_Position(TNum + 41, Target_Global_Position);
-                            usleep(2000);
-                            //设置成guided模式,到达F中T的概率第二高的位置,到达指定位置后,再次确定T||F,决定投或者不投
-//                            target_ellipse_position[ellipse_F[1].num].T_N = target_ellipse_position[ellipse_F[1].num].F_N = 0;
-//                            ellipse_F[1].F_N = ellipse_F[1].T_N = 0;
-//                            api.ThrowF(yaw,&ellipse_F[1]);
-                            TNum = TNum + 1;
-                            Target_Global_Position.lat = ellipse_F[1].lat;
-                            Target_Global_Position.lon = ellipse_F[1].lon;
-//                            uint16_t hdg1= R2D(yaw);
-                            Target_Global_Position.hdg = hdg1;
-//                            Globallen=  api.Send_WL_Global_Position(TNum + 41, Target_Global_Position);
-                            TNum = TNum + 1;
-                            flag = false;
-                        }
-                        else if(TNum == 2)
-                        {
-
-                            //设置成guided模式,到达F中T的概率第二高的位置,到达指定位置后,再次确定T||F,决定投或者不投
-//                            ellipse_F[0].T_N = ellipse_F[0].F_N = ellipse_F[0].possbile = 0;
-//                            target_ellipse_position[ellipse_F[0].num].F_N = target_ellipse_position[ellipse_F[0].num].T_N = 0;
-//                            api.ThrowF(yaw,&ellipse_F[0]);
-//                            api.RTL();
-                            mavlink_global_position_int_t Target_Global_Position;
-                            Target_Global_Position.lat = ellipse_F[0].lat;
-                            Target_Global_Position.lon = ellipse_F[0].lon;
-                            uint16_t hdg1= R2D(yaw);
-                            Target_Global_Position.hdg = hdg1;
-//                            int Globallen=  api.Send_WL_Global_Position(TNum + 41, Target_Global_Position);
-                            flag = false;
-                        }
-                        else
-                        {
-                            flag = false;
-                            updateellipse = true;
-                        }
-                        break;
-                    }
-                }
-            }
-        }
-
-        printf("\n");
-
-    }
-
-    // --------------------------------------------------------------------------
-    // RETURN Home 以及
-    //
-    // STOP OFFBOARD MODE
-    // --------------------------------------------------------------------------
-//    sleep(2);
-    outf2<<"return to launch!"<<endl;
-
-    //返航
 
-    for (int i = 0; i < 5; ++i)
-    {
-        api.Set_Mode(06);
-        usleep(200);
-    }
+    // 搜索、识别、投放, 直到返航
+    mission.run();
 
     t1.detach();
-    outf2<<"close video!"<<endl;
-    // now pixhawk isn't listening to setpoint commands
+    FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "close video!");
 
     // --------------------------------------------------------------------------
     //   END OF COMMANDS
@@ -781,6 +296,8 @@ quit_handler( int sig )
     printf("TERMINATING AT USER REQUEST\n");
     printf("\n");
 
+    swarm_map.stop();
+
     // autopilot interface
     try {
         autopilot_interface_quit->handle_quit(sig);
@@ -793,182 +310,146 @@ quit_handler( int sig )
     }
     catch (int error){}
 
+    // 把缓冲区中的日志写完
+    flight_log.stop();
+    metrics.stop();
+
     // end program here
     exit(0);
 
 }
 
+// ------------------------------------------------------------------------------
+//   每帧的视觉日志
+// ------------------------------------------------------------------------------
+// 目标表和每个椭圆的记录量较大, 放在 DEBUG 等级, 以 INFO 编译时只保留 VIS / VEH
+static void
+log_target_list(uint64_t time_us, uint8_t list, const vector<target> &targets)
+{
+    for (size_t i = 0; i < targets.size(); ++i) {
+        log_Target rec;
+        rec.time_us = time_us;
+        rec.list = list;
+        rec.index = i;
+        rec.num = targets[i].num;
+        rec.locx = targets[i].locx;
+        rec.locy = targets[i].locy;
+        rec.t_n = targets[i].T_N;
+        rec.f_n = targets[i].F_N;
+        rec.possible = targets[i].possbile;
+        rec.lat = targets[i].lat;
+        rec.lon = targets[i].lon;
+        flight_log.write(&rec, sizeof(rec));
+    }
+}
+
+static void
+log_vision_frame(Autopilot_Interface &api, const Vision_Result &result)
+{
+    uint64_t time_us = get_time_usec();
+    Target_Snapshot_Ptr snapshot = target_channel.latest();
+    Vision_Mode_Ptr mode = vision_mode.latest();
+    if (!snapshot || !mode)
+        return;
+
+    if (FLIGHT_LOG_ENABLED(LOG_LEVEL_INFO)) {
+        log_Vision vis;
+        vis.time_us = time_us;
+        vis.seq = result.seq;
+        vis.detected = result.detected;
+        vis.candidates = result.candidates;
+        vis.out = result.ellipses.size();
+        vis.t = result.T;
+        vis.f = result.F;
+        vis.detect_ms = result.detect_ms;
+        vis.total_ms = result.total_ms;
+        flight_log.write(&vis, sizeof(vis));
+
+        const mavlink_local_position_ned_t &pos = api.current_messages.local_position_ned;
+        log_Vehicle veh;
+        veh.time_us = time_us;
+        veh.x = pos.x;
+        veh.y = pos.y;
+        veh.z = pos.z;
+        veh.stable = mode->stable && !snapshot->classified;
+        veh.update = mode->update;
+        veh.drop = mode->drop;
+        veh.target_num = mode->target_num;
+        veh.mission_seq = api.current_messages.mission_item_reached.seq;
+        veh.targets = snapshot->targets.size();
+        veh.ellipse_t = snapshot->T.size();
+        veh.ellipse_f = snapshot->F.size();
+        flight_log.write(&veh, sizeof(veh));
+    }
+
+    if (FLIGHT_LOG_ENABLED(LOG_LEVEL_DEBUG)) {
+        log_target_list(time_us, LOG_TARGET_LIST_TARGETS, snapshot->targets);
+        log_target_list(time_us, LOG_TARGET_LIST_T, snapshot->T);
+        log_target_list(time_us, LOG_TARGET_LIST_F, snapshot->F);
+
+        for (auto &p : result.ellipses) {
+            log_Radius rad;
+            rad.time_us = time_us;
+            rad.a = p.a;
+            rad.alt = -api.current_messages.local_position_ned.z;
+            flight_log.write(&rad, sizeof(rad));
+        }
+    }
+}
+
 ///////////////视觉定位线程
 void videothread(Autopilot_Interface& api){
 
-    VideoCapture cap(0);
-//    VideoCapture cap;
-//    cap.open("T_rotation.avi");
-//    cap.open("F.avi");
-//    cap.open("T.avi");
-    if(!cap.isOpened()) return;
-    int width = 640;
-    int height = 360;
-    cap.set(CV_CAP_PROP_FRAME_WIDTH, 1920);
-    cap.set(CV_CAP_PROP_FRAME_HEIGHT, 1080);
-    cap.set(CAP_PROP_AUTOFOCUS,0);
-
-
-//	 Parameters Settings (Sect. 4.2)
-    int		iThLength = 16;
-    float	fThObb = 3.0f;
-    float	fThPos = 1.0f;
-    float	fTaoCenters = 0.05f;
-    int 	iNs = 16;
-    float	fMaxCenterDistance = sqrt(float(width*width + height*height)) * fTaoCenters;
-
-    float	fThScoreScore = 0.4f;
-
-    // Other constant parameters settings.
-
-    // Gaussian filter parameters, in pre-processing
-    Size	szPreProcessingGaussKernelSize = Size(5, 5);
-    double	dPreProcessingGaussSigma = 1.0;
-
-    float	fDistanceToEllipseContour = 0.1f;	// (Sect. 3.3.1 - Validation)
-    float	fMinReliability = 0.4f;	// Const parameters to discard bad ellipses
-
-
-    // Initialize Detector with selected parameters
-    CEllipseDetectorYaed* yaed = new CEllipseDetectorYaed();
-    yaed->SetParameters(szPreProcessingGaussKernelSize,
-                        dPreProcessingGaussSigma,
-                        fThPos,
-                        fMaxCenterDistance,
-                        iThLength,
-                        fThObb,
-                        fDistanceToEllipseContour,
-                        fThScoreScore,
-                        fMinReliability,
-                        iNs
-    );
-
-Mat1b gray, gray_big;
-ofstream outf, outf1;
-outf.open("hight_and_r.txt");
-outf1.open("target_r.txt");
-VideoWriter writer1("little_e.avi", CV_FOURCC('M', 'J', 'P', 'G'), 5.0, Size(640, 360));
-VideoWriter writer2("big_e.avi", CV_FOURCC('M', 'J', 'P', 'G'), 5.0, Size(1920, 1080));
+    Capture_Config capture_config;
+//    capture_config.source = "T_rotation.avi";
+//    capture_config.source = "F.avi";
+//    capture_config.source = "T.avi";
+    Camera_Capture camera;
+    if(!camera.open(capture_config)) return;
+    camera_model.load(runtime_config.calib_file, capture_config.work);
+
+    Vision_Pipeline pipeline;
+    pipeline.setup(capture_config.work);
+
+ofstream frame_log;
+frame_log.open("little_e.csv");//每帧的采集时刻, 供离线回放使用
+VideoWriter writer1("little_e.avi", CV_FOURCC('M', 'J', 'P', 'G'), 5.0, capture_config.work);//未标注的检测图, 供离线回放
+VideoWriter writer3("result_e.avi", CV_FOURCC('M', 'J', 'P', 'G'), 5.0, capture_config.work);//画出椭圆和字符区域的检测图
+VideoWriter writer2("big_e.avi", CV_FOURCC('M', 'J', 'P', 'G'), 5.0, capture_config.full);
 	while(true) {
 
-        Mat3b image, image_r;
-        cap >> image;
-        resize(image, image_r, Size(640, 360), 0, 0, CV_INTER_LINEAR);
-        cvtColor(image_r, gray, COLOR_BGR2GRAY);
-        cvtColor(image, gray_big, COLOR_BGR2GRAY);
-
-        vector<Ellipse> ellsYaed, ellipse_in, ellipse_big, ellipseok;
-        vector<Mat1b> img_roi;
-        yaed->Detect(gray, ellsYaed);
-        Mat3b resultImage = image_r.clone();
-        Mat3b resultImage2 = image_r.clone();
-        vector<coordinate> ellipse_out, ellipse_TF, ellipse_out1;
-        if(getlocalposition){
-            OptimizEllipse(ellipse_in, ellsYaed);//对椭圆检测部分得到的椭圆进行预处理，输出仅有大圆的vector
-            if (!drop) {
-//            yaed->big_vector(resultImage2, ellipse_in, ellipse_big);
-                yaed->targetcolor(resultImage2, ellipse_in, ellipse_big);
-//            filtellipse(api, ellipseok, ellipse_big);
-            yaed->DrawDetectedEllipses(resultImage, ellipse_out, ellipse_big);//绘制检测到的椭圆
-            vector<vector<Point> > contours;
-            if (stable) {
-                yaed->extracrROI(gray_big, ellipse_out, img_roi);
-                visual_rec(img_roi, ellipse_out, ellipse_TF, contours);//T和F的检测程序
-                ellipse_out1 = ellipse_TF;
-            } else
-                ellipse_out1 = ellipse_out;
-            for (auto &p:contours) {
-                vector<vector<Point> > contours1;
-                contours1.push_back(p);
-                drawContours(image, contours1, 0, Scalar(255, 255, 0), 1);
-            }
-//            possible_ellipse(api, ellipse_out1, target_ellipse_position);
-            possible_ellipse_r(api, ellipse_out1, target_ellipse_position);//修改后的椭圆更新函数
-            if(stable) {
-                resultTF(api, target_ellipse_position, ellipse_T, ellipse_F);
+        Capture_Frame frame;
+        if (!camera.read(frame)) {
+            if (camera.ended()) {
+                printf("VISION end of %s\n", capture_config.source.c_str());
+                break;
             }
-
-          } else {
-                yaed->targetcolor(resultImage2, ellipse_in, ellipse_big);
-//                filtellipse(api, ellipseok, ellipse_big);
-                yaed->DrawDetectedEllipses(resultImage, ellipse_out, ellipse_big);//绘制检测到的椭圆
-                getdroptarget(api, droptarget, ellipse_out);
-//                outf1<<"target_r:"<<droptarget.a<<endl;
-//                outf1<<"cam_coordinate:"<<droptarget.x<<" "<<droptarget.y<<endl;
-//                outf1<<"real_coordinate:"<<droptarget.locx<<" "<<droptarget.locy<<endl;
-        }
-    }
-        cout << "target_ellipse.size = " << target_ellipse_position.size() << endl;
-        outf1 << "target_ellipse.size = " << target_ellipse_position.size() << endl;
-        for (int i = 0; i < target_ellipse_position.size(); ++i) {
-            cout << "x = " << target_ellipse_position[i].locx << endl
-                 << "y = " << target_ellipse_position[i].locy << endl
-                 << "T = " << target_ellipse_position[i].T_N << endl
-                 << "F = " << target_ellipse_position[i].F_N << endl
-                 << "flag = " << target_ellipse_position[i].possbile << endl;
-            outf1 << "x = " << target_ellipse_position[i].locx << endl
-                 << "y = " << target_ellipse_position[i].locy << endl
-                 << "T = " << target_ellipse_position[i].T_N << endl
-                 << "F = " << target_ellipse_position[i].F_N << endl
-                 << "flag = " << target_ellipse_position[i].possbile << endl;
-        }
-        cout << "ellipse_T.size = " << ellipse_T.size() << endl;
-        outf1 << "ellipse_T.size = " << ellipse_T.size() << endl;
-        for (int i = 0; i < ellipse_T.size(); ++i) {
-            cout << "x = " << ellipse_T[i].locx << endl
-                 << "y = " << ellipse_T[i].locy << endl
-                 << "possbile = " << ellipse_T[i].possbile << endl
-                 << "lat:" << ellipse_T[i].lat << "lon:" << ellipse_T[i].lon << endl
-                 <<"No.:"<<ellipse_T[i].num<<endl;
-            outf1 << "x = " << ellipse_T[i].locx << endl
-                 << "y = " << ellipse_T[i].locy << endl
-                 << "possbile = " << ellipse_T[i].possbile << endl
-                 << "lat:" << ellipse_T[i].lat << "lon:" << ellipse_T[i].lon << endl
-                 <<"No.:"<<ellipse_T[i].num<<endl;
-        }
-        cout << "ellipse_F.size = " << ellipse_F.size() << endl;
-        outf1 << "ellipse_F.size = " << ellipse_F.size() << endl;
-        for (int i = 0; i < ellipse_F.size(); ++i) {
-            cout << "x = " << ellipse_F[i].locx << endl
-                 << "y = " << ellipse_F[i].locy << endl
-                 << "possbile = " << ellipse_F[i].possbile << endl
-                 << "lat:" << ellipse_F[i].lat << "lon:" << ellipse_F[i].lon << endl
-                 <<"No.:"<<ellipse_F[i].num<<endl;
-            outf1 << "x = " << ellipse_F[i].locx << endl
-                 << "y = " << ellipse_F[i].locy << endl
-                 << "possbile = " << ellipse_F[i].possbile << endl
-                 << "lat:" << ellipse_F[i].lat << "lon:" << ellipse_F[i].lon << endl
-                 <<"No.:"<<ellipse_F[i].num<<endl;
-        }
-        cout<<"local_position.x:"<<api.current_messages.local_position_ned.x<<endl
-            <<"local_position.y:"<<api.current_messages.local_position_ned.y<<endl
-            <<"local_position.z:"<<api.current_messages.local_position_ned.z<<endl;
-        cout<<"stable:"<<stable<<endl<<"updateellipise:"<<updateellipse<<endl<<"drop:"<<drop<<endl;
-        cout<<"target_Num:"<<TargetNum<<endl;
-        outf1<<"local_position.x:"<<api.current_messages.local_position_ned.x<<endl
-            <<"local_position.y:"<<api.current_messages.local_position_ned.y<<endl
-            <<"local_position.z:"<<api.current_messages.local_position_ned.z<<endl;
-        outf1<<"stable:"<<stable<<endl<<"updateellipise:"<<updateellipse<<endl<<"drop:"<<drop<<endl;
-        outf1<<"target_Num:"<<TargetNum<<endl;
-        outf1<<"api.current_messages.mission_item_reached.seq :"<<api.current_messages.mission_item_reached.seq<<endl;
-        for(auto &p:ellipse_out1){
-            outf<<"椭圆半径:"<<p.a<<endl;
-            outf<<"当前高度:"<<-api.current_messages.local_position_ned.z<<endl;
+            // 摄像头出错时退避, 最长 0.5 s, 不空转占满 CPU
+            usleep(std::min(camera.failures, 50) * 10000);
+            continue;
         }
+        Vision_Result result;
+        pipeline.process(api, camera, frame, result);//发布目标表快照, 任务线程由订阅收到事件
+        camera.done(frame);
+        log_vision_frame(api, result);
 //		namedWindow("原图",1);
 //		imshow("原图", image);
 //		namedWindow("缩小",1);
 //		imshow("缩小", resultImage);
-		writer1.write(resultImage);
-        writer2.write(image);
-        ellipse_out.clear();
+        if (frame.seq % 100 == 0) {
+            Target_Snapshot_Ptr snapshot = target_channel.latest();
+            printf("CAPTURE latency %.1f ms (mean %.1f, max %.1f)\n",
+                   camera.last_latency_ms, camera.mean_latency_ms, camera.max_latency_ms);
+            printf("VISION targets %lu, T %lu, F %lu, swarm %d, log records dropped %llu\n",
+                   (unsigned long)snapshot->targets.size(), (unsigned long)snapshot->T.size(),
+                   (unsigned long)snapshot->F.size(), swarm_map.size(), (unsigned long long)flight_log.dropped());
+        }
+		writer1.write(frame.small);
+		writer3.write(pipeline.resultImage);
+        frame_log << frame.seq << "," << frame.time_usec << "," << camera.has_full() << "\n";
+        if (camera.has_full())//只记录解码过的大图
+            writer2.write(camera.full());
 		waitKey(10);
-		ellipse_out1.clear();
 //		usleep(100000);
 	}
 }
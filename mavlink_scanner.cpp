@@ -0,0 +1,149 @@
+/**
+ * @file mavlink_scanner.cpp
+ *
+ * @brief Batch MAVLink v1 frame scanner over a byte buffer
+ *
+ */
+
+#include "mavlink_scanner.h"
+
+#include <string.h>
+
+
+static const uint8_t message_lengths[256] = MAVLINK_MESSAGE_LENGTHS;
+static const uint8_t message_crcs[256] = MAVLINK_MESSAGE_CRCS;
+
+
+Mavlink_Scanner::
+Mavlink_Scanner()
+{
+    reset();
+}
+
+void
+Mavlink_Scanner::
+reset()
+{
+    head = 0;
+    tail = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+
+// ------------------------------------------------------------------------------
+//   写入
+// ------------------------------------------------------------------------------
+uint8_t *
+Mavlink_Scanner::
+write_ptr(size_t &room)
+{
+    if (tail == sizeof(buf))
+        compact();
+    room = sizeof(buf) - tail;
+    return buf + tail;
+}
+
+void
+Mavlink_Scanner::
+commit(size_t n)
+{
+    tail += n;
+}
+
+size_t
+Mavlink_Scanner::
+push(const uint8_t *data, size_t len)
+{
+    size_t room;
+    uint8_t *p = write_ptr(room);
+    if (len > room)
+        len = room;
+    memcpy(p, data, len);
+    commit(len);
+    return len;
+}
+
+// 把残留的半帧移到缓冲区开头
+void
+Mavlink_Scanner::
+compact()
+{
+    if (head == 0)
+        return;
+    memmove(buf, buf + head, tail - head);
+    tail -= head;
+    head = 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   取下一帧
+// ------------------------------------------------------------------------------
+bool
+Mavlink_Scanner::
+next(mavlink_message_t &message)
+{
+    while (head < tail)
+    {
+        const uint8_t *p = buf + head;
+        size_t avail = tail - head;
+
+        if (p[0] != MAVLINK_STX)
+        {
+            const uint8_t *stx = (const uint8_t *)memchr(p, MAVLINK_STX, avail);
+            size_t skip = stx ? (size_t)(stx - p) : avail;
+            stats.bytes_skipped += skip;
+            head += skip;
+            continue;
+        }
+
+        if (avail < MAVLINK_NUM_HEADER_BYTES)
+            break;
+
+        // 长度字节与消息表不符的不可能是有效帧, 不必等整帧到齐
+        uint8_t len = p[1];
+        uint8_t msgid = p[5];
+        if (len != message_lengths[msgid])
+        {
+            stats.length_errors++;
+            stats.bytes_skipped++;
+            head++;
+            continue;
+        }
+
+        size_t frame_len = len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        if (avail < frame_len)
+            break;
+
+        // 头部 5 字节和负载在缓冲区中是连续的, 一次算完
+        uint16_t crc = crc_calculate(p + 1, MAVLINK_CORE_HEADER_LEN + len);
+        crc_accumulate(message_crcs[msgid], &crc);
+        const uint8_t *ck = p + MAVLINK_NUM_HEADER_BYTES + len;
+        if (ck[0] != (crc & 0xFF) || ck[1] != (crc >> 8))
+        {
+            stats.crc_errors++;
+            stats.bytes_skipped++;
+            head++;
+            continue;
+        }
+
+        message.magic = MAVLINK_STX;
+        message.len = len;
+        message.seq = p[2];
+        message.sysid = p[3];
+        message.compid = p[4];
+        message.msgid = msgid;
+        message.checksum = crc;
+        // 与 mavlink_parse_char 一样, 校验字节跟在负载后面
+        memcpy(_MAV_PAYLOAD_NON_CONST(&message), p + MAVLINK_NUM_HEADER_BYTES, len + MAVLINK_NUM_CHECKSUM_BYTES);
+
+        head += frame_len;
+        stats.frames++;
+        if (head == tail)
+            head = tail = 0;
+        return true;
+    }
+
+    compact();
+    return false;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file mavlink_scanner.h
+ *
+ * @brief Batch MAVLink v1 frame scanner over a byte buffer
+ *
+ * mavlink_parse_char 是逐字节状态机, 每个字节都要走一遍 switch 并累加一次 CRC.
+ * 串口改为成块读取后, 由 Mavlink_Scanner 在缓冲区中直接找帧:
+ *  - memchr 跳到下一个 STX (0xFE);
+ *  - 先用消息表核对长度字节和 msgid, 不符的 STX 直接跳过, 不等待也不算 CRC;
+ *  - 整帧到齐后用 crc_calculate (slice-by-8 查表) 对连续的头部和负载一次算完, 再加 crc_extra;
+ *  - CRC 错误时只跳过该 STX 一个字节重新找帧, 坏帧内部的完整帧仍能收到.
+ * 不完整的帧留在缓冲区中, 等下一次读入的字节补齐.
+ *
+ * 每个实例有自己的缓冲区, 不使用 mavlink_parse_char 的全局通道状态, 因此多个串口互不干扰.
+ * 非线程安全, 由调用者 (Serial_Port 的读线程) 独占使用.
+ *
+ */
+
+#ifndef MAVLINK_SCANNER_H_
+#define MAVLINK_SCANNER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mavlink/common/mavlink.h"
+
+// 缓冲区大小, 残留的半帧之外至少还能一次读入 3 帧左右
+#define MAVLINK_SCANNER_BUFFER_SIZE 1024
+
+
+struct Scanner_Stats
+{
+    uint64_t frames;            // 校验通过的帧
+    uint64_t crc_errors;        // 长度正确但 CRC 错误
+    uint64_t length_errors;     // 长度字节与 msgid 不符, 或未知 msgid
+    uint64_t bytes_skipped;     // 找 STX 时丢弃的字节
+};
+
+
+class Mavlink_Scanner
+{
+
+public:
+
+    Mavlink_Scanner();
+
+    Scanner_Stats stats;
+
+    // 直接读入缓冲区: write_ptr 返回可写位置和剩余空间, 读入后用 commit 提交字节数
+    uint8_t *write_ptr(size_t &room);
+    void commit(size_t n);
+
+    // 复制一段字节到缓冲区, 返回实际接受的字节数 (缓冲区满时少于 len)
+    size_t push(const uint8_t *data, size_t len);
+
+    // 从缓冲区中取出下一帧, 没有完整帧时返回 false
+    bool next(mavlink_message_t &message);
+
+    size_t pending() const { return tail - head; }
+    void reset();
+
+private:
+
+    uint8_t buf[MAVLINK_SCANNER_BUFFER_SIZE];
+    size_t head;    // 下一个未扫描的字节
+    size_t tail;    // 有效数据的末尾
+
+    void compact();
+};
+
+
+#endif // MAVLINK_SCANNER_H_
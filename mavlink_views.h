@@ -0,0 +1,2199 @@
+/**
+ * @file mavlink_views.h
+ *
+ * @brief Typed read-only views over received MAVLink messages
+ *
+ * 由 tools/gen_mavlink_views.py 根据 mavlink/common 生成, 不要手工修改.
+ * 视图只保存消息指针, 字段直接从负载中读取, 不先 decode 成结构体;
+ * 视图的有效期不能超过它所指向的 mavlink_message_t.
+ *
+ */
+
+#ifndef MAVLINK_VIEWS_H_
+#define MAVLINK_VIEWS_H_
+
+#include "mavlink/common/mavlink.h"
+
+struct Actuator_Control_Target_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ACTUATOR_CONTROL_TARGET;
+    const mavlink_message_t *msg;
+    explicit Actuator_Control_Target_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_actuator_control_target_t &out) const { mavlink_msg_actuator_control_target_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_actuator_control_target_get_time_usec(msg); }
+    static const uint16_t controls_len = 8;
+    uint16_t controls(float *out) const { return mavlink_msg_actuator_control_target_get_controls(msg, out); }
+    uint8_t group_mlx() const { return mavlink_msg_actuator_control_target_get_group_mlx(msg); }
+};
+
+struct Adsb_Vehicle_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ADSB_VEHICLE;
+    const mavlink_message_t *msg;
+    explicit Adsb_Vehicle_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_adsb_vehicle_t &out) const { mavlink_msg_adsb_vehicle_decode(msg, &out); }
+    uint32_t ICAO_address() const { return mavlink_msg_adsb_vehicle_get_ICAO_address(msg); }
+    int32_t lat() const { return mavlink_msg_adsb_vehicle_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_adsb_vehicle_get_lon(msg); }
+    int32_t altitude() const { return mavlink_msg_adsb_vehicle_get_altitude(msg); }
+    uint16_t heading() const { return mavlink_msg_adsb_vehicle_get_heading(msg); }
+    uint16_t hor_velocity() const { return mavlink_msg_adsb_vehicle_get_hor_velocity(msg); }
+    int16_t ver_velocity() const { return mavlink_msg_adsb_vehicle_get_ver_velocity(msg); }
+    uint16_t flags() const { return mavlink_msg_adsb_vehicle_get_flags(msg); }
+    uint16_t squawk() const { return mavlink_msg_adsb_vehicle_get_squawk(msg); }
+    uint8_t altitude_type() const { return mavlink_msg_adsb_vehicle_get_altitude_type(msg); }
+    static const uint16_t callsign_len = 9;
+    const char *callsign() const { return (const char *)(_MAV_PAYLOAD(msg) + 27); }
+    uint8_t emitter_type() const { return mavlink_msg_adsb_vehicle_get_emitter_type(msg); }
+    uint8_t tslc() const { return mavlink_msg_adsb_vehicle_get_tslc(msg); }
+};
+
+struct Altitude_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ALTITUDE;
+    const mavlink_message_t *msg;
+    explicit Altitude_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_altitude_t &out) const { mavlink_msg_altitude_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_altitude_get_time_usec(msg); }
+    float altitude_monotonic() const { return mavlink_msg_altitude_get_altitude_monotonic(msg); }
+    float altitude_amsl() const { return mavlink_msg_altitude_get_altitude_amsl(msg); }
+    float altitude_local() const { return mavlink_msg_altitude_get_altitude_local(msg); }
+    float altitude_relative() const { return mavlink_msg_altitude_get_altitude_relative(msg); }
+    float altitude_terrain() const { return mavlink_msg_altitude_get_altitude_terrain(msg); }
+    float bottom_clearance() const { return mavlink_msg_altitude_get_bottom_clearance(msg); }
+};
+
+struct Att_Pos_Mocap_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ATT_POS_MOCAP;
+    const mavlink_message_t *msg;
+    explicit Att_Pos_Mocap_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_att_pos_mocap_t &out) const { mavlink_msg_att_pos_mocap_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_att_pos_mocap_get_time_usec(msg); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_att_pos_mocap_get_q(msg, out); }
+    float x() const { return mavlink_msg_att_pos_mocap_get_x(msg); }
+    float y() const { return mavlink_msg_att_pos_mocap_get_y(msg); }
+    float z() const { return mavlink_msg_att_pos_mocap_get_z(msg); }
+};
+
+struct Attitude_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ATTITUDE;
+    const mavlink_message_t *msg;
+    explicit Attitude_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_attitude_t &out) const { mavlink_msg_attitude_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_attitude_get_time_boot_ms(msg); }
+    float roll() const { return mavlink_msg_attitude_get_roll(msg); }
+    float pitch() const { return mavlink_msg_attitude_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_attitude_get_yaw(msg); }
+    float rollspeed() const { return mavlink_msg_attitude_get_rollspeed(msg); }
+    float pitchspeed() const { return mavlink_msg_attitude_get_pitchspeed(msg); }
+    float yawspeed() const { return mavlink_msg_attitude_get_yawspeed(msg); }
+};
+
+struct Attitude_Quaternion_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ATTITUDE_QUATERNION;
+    const mavlink_message_t *msg;
+    explicit Attitude_Quaternion_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_attitude_quaternion_t &out) const { mavlink_msg_attitude_quaternion_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_attitude_quaternion_get_time_boot_ms(msg); }
+    float q1() const { return mavlink_msg_attitude_quaternion_get_q1(msg); }
+    float q2() const { return mavlink_msg_attitude_quaternion_get_q2(msg); }
+    float q3() const { return mavlink_msg_attitude_quaternion_get_q3(msg); }
+    float q4() const { return mavlink_msg_attitude_quaternion_get_q4(msg); }
+    float rollspeed() const { return mavlink_msg_attitude_quaternion_get_rollspeed(msg); }
+    float pitchspeed() const { return mavlink_msg_attitude_quaternion_get_pitchspeed(msg); }
+    float yawspeed() const { return mavlink_msg_attitude_quaternion_get_yawspeed(msg); }
+};
+
+struct Attitude_Quaternion_Cov_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ATTITUDE_QUATERNION_COV;
+    const mavlink_message_t *msg;
+    explicit Attitude_Quaternion_Cov_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_attitude_quaternion_cov_t &out) const { mavlink_msg_attitude_quaternion_cov_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_attitude_quaternion_cov_get_time_usec(msg); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_attitude_quaternion_cov_get_q(msg, out); }
+    float rollspeed() const { return mavlink_msg_attitude_quaternion_cov_get_rollspeed(msg); }
+    float pitchspeed() const { return mavlink_msg_attitude_quaternion_cov_get_pitchspeed(msg); }
+    float yawspeed() const { return mavlink_msg_attitude_quaternion_cov_get_yawspeed(msg); }
+    static const uint16_t covariance_len = 9;
+    uint16_t covariance(float *out) const { return mavlink_msg_attitude_quaternion_cov_get_covariance(msg, out); }
+};
+
+struct Attitude_Target_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ATTITUDE_TARGET;
+    const mavlink_message_t *msg;
+    explicit Attitude_Target_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_attitude_target_t &out) const { mavlink_msg_attitude_target_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_attitude_target_get_time_boot_ms(msg); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_attitude_target_get_q(msg, out); }
+    float body_roll_rate() const { return mavlink_msg_attitude_target_get_body_roll_rate(msg); }
+    float body_pitch_rate() const { return mavlink_msg_attitude_target_get_body_pitch_rate(msg); }
+    float body_yaw_rate() const { return mavlink_msg_attitude_target_get_body_yaw_rate(msg); }
+    float thrust() const { return mavlink_msg_attitude_target_get_thrust(msg); }
+    uint8_t type_mask() const { return mavlink_msg_attitude_target_get_type_mask(msg); }
+};
+
+struct Auth_Key_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_AUTH_KEY;
+    const mavlink_message_t *msg;
+    explicit Auth_Key_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_auth_key_t &out) const { mavlink_msg_auth_key_decode(msg, &out); }
+    static const uint16_t key_len = 32;
+    const char *key() const { return (const char *)(_MAV_PAYLOAD(msg) + 0); }
+};
+
+struct Autopilot_Version_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_AUTOPILOT_VERSION;
+    const mavlink_message_t *msg;
+    explicit Autopilot_Version_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_autopilot_version_t &out) const { mavlink_msg_autopilot_version_decode(msg, &out); }
+    uint64_t capabilities() const { return mavlink_msg_autopilot_version_get_capabilities(msg); }
+    uint64_t uid() const { return mavlink_msg_autopilot_version_get_uid(msg); }
+    uint32_t flight_sw_version() const { return mavlink_msg_autopilot_version_get_flight_sw_version(msg); }
+    uint32_t middleware_sw_version() const { return mavlink_msg_autopilot_version_get_middleware_sw_version(msg); }
+    uint32_t os_sw_version() const { return mavlink_msg_autopilot_version_get_os_sw_version(msg); }
+    uint32_t board_version() const { return mavlink_msg_autopilot_version_get_board_version(msg); }
+    uint16_t vendor_id() const { return mavlink_msg_autopilot_version_get_vendor_id(msg); }
+    uint16_t product_id() const { return mavlink_msg_autopilot_version_get_product_id(msg); }
+    static const uint16_t flight_custom_version_len = 8;
+    const uint8_t *flight_custom_version() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 36); }
+    static const uint16_t middleware_custom_version_len = 8;
+    const uint8_t *middleware_custom_version() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 44); }
+    static const uint16_t os_custom_version_len = 8;
+    const uint8_t *os_custom_version() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 52); }
+};
+
+struct Battery_Status_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_BATTERY_STATUS;
+    const mavlink_message_t *msg;
+    explicit Battery_Status_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_battery_status_t &out) const { mavlink_msg_battery_status_decode(msg, &out); }
+    int32_t current_consumed() const { return mavlink_msg_battery_status_get_current_consumed(msg); }
+    int32_t energy_consumed() const { return mavlink_msg_battery_status_get_energy_consumed(msg); }
+    int16_t temperature() const { return mavlink_msg_battery_status_get_temperature(msg); }
+    static const uint16_t voltages_len = 10;
+    uint16_t voltages(uint16_t *out) const { return mavlink_msg_battery_status_get_voltages(msg, out); }
+    int16_t current_battery() const { return mavlink_msg_battery_status_get_current_battery(msg); }
+    uint8_t id() const { return mavlink_msg_battery_status_get_id(msg); }
+    uint8_t battery_function() const { return mavlink_msg_battery_status_get_battery_function(msg); }
+    uint8_t type() const { return mavlink_msg_battery_status_get_type(msg); }
+    int8_t battery_remaining() const { return mavlink_msg_battery_status_get_battery_remaining(msg); }
+};
+
+struct Camera_Trigger_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_CAMERA_TRIGGER;
+    const mavlink_message_t *msg;
+    explicit Camera_Trigger_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_camera_trigger_t &out) const { mavlink_msg_camera_trigger_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_camera_trigger_get_time_usec(msg); }
+    uint32_t seq() const { return mavlink_msg_camera_trigger_get_seq(msg); }
+};
+
+struct Change_Operator_Control_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL;
+    const mavlink_message_t *msg;
+    explicit Change_Operator_Control_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_change_operator_control_t &out) const { mavlink_msg_change_operator_control_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_change_operator_control_get_target_system(msg); }
+    uint8_t control_request() const { return mavlink_msg_change_operator_control_get_control_request(msg); }
+    uint8_t version() const { return mavlink_msg_change_operator_control_get_version(msg); }
+    static const uint16_t passkey_len = 25;
+    const char *passkey() const { return (const char *)(_MAV_PAYLOAD(msg) + 3); }
+};
+
+struct Change_Operator_Control_Ack_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK;
+    const mavlink_message_t *msg;
+    explicit Change_Operator_Control_Ack_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_change_operator_control_ack_t &out) const { mavlink_msg_change_operator_control_ack_decode(msg, &out); }
+    uint8_t gcs_system_id() const { return mavlink_msg_change_operator_control_ack_get_gcs_system_id(msg); }
+    uint8_t control_request() const { return mavlink_msg_change_operator_control_ack_get_control_request(msg); }
+    uint8_t ack() const { return mavlink_msg_change_operator_control_ack_get_ack(msg); }
+};
+
+struct Collision_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_COLLISION;
+    const mavlink_message_t *msg;
+    explicit Collision_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_collision_t &out) const { mavlink_msg_collision_decode(msg, &out); }
+    uint32_t id() const { return mavlink_msg_collision_get_id(msg); }
+    float time_to_minimum_delta() const { return mavlink_msg_collision_get_time_to_minimum_delta(msg); }
+    float altitude_minimum_delta() const { return mavlink_msg_collision_get_altitude_minimum_delta(msg); }
+    float horizontal_minimum_delta() const { return mavlink_msg_collision_get_horizontal_minimum_delta(msg); }
+    uint8_t src() const { return mavlink_msg_collision_get_src(msg); }
+    uint8_t action() const { return mavlink_msg_collision_get_action(msg); }
+    uint8_t threat_level() const { return mavlink_msg_collision_get_threat_level(msg); }
+};
+
+struct Command_Ack_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_COMMAND_ACK;
+    const mavlink_message_t *msg;
+    explicit Command_Ack_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_command_ack_t &out) const { mavlink_msg_command_ack_decode(msg, &out); }
+    uint16_t command() const { return mavlink_msg_command_ack_get_command(msg); }
+    uint8_t result() const { return mavlink_msg_command_ack_get_result(msg); }
+};
+
+struct Command_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_COMMAND_INT;
+    const mavlink_message_t *msg;
+    explicit Command_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_command_int_t &out) const { mavlink_msg_command_int_decode(msg, &out); }
+    float param1() const { return mavlink_msg_command_int_get_param1(msg); }
+    float param2() const { return mavlink_msg_command_int_get_param2(msg); }
+    float param3() const { return mavlink_msg_command_int_get_param3(msg); }
+    float param4() const { return mavlink_msg_command_int_get_param4(msg); }
+    int32_t x() const { return mavlink_msg_command_int_get_x(msg); }
+    int32_t y() const { return mavlink_msg_command_int_get_y(msg); }
+    float z() const { return mavlink_msg_command_int_get_z(msg); }
+    uint16_t command() const { return mavlink_msg_command_int_get_command(msg); }
+    uint8_t target_system() const { return mavlink_msg_command_int_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_command_int_get_target_component(msg); }
+    uint8_t frame() const { return mavlink_msg_command_int_get_frame(msg); }
+    uint8_t current() const { return mavlink_msg_command_int_get_current(msg); }
+    uint8_t autocontinue() const { return mavlink_msg_command_int_get_autocontinue(msg); }
+};
+
+struct Command_Long_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_COMMAND_LONG;
+    const mavlink_message_t *msg;
+    explicit Command_Long_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_command_long_t &out) const { mavlink_msg_command_long_decode(msg, &out); }
+    float param1() const { return mavlink_msg_command_long_get_param1(msg); }
+    float param2() const { return mavlink_msg_command_long_get_param2(msg); }
+    float param3() const { return mavlink_msg_command_long_get_param3(msg); }
+    float param4() const { return mavlink_msg_command_long_get_param4(msg); }
+    float param5() const { return mavlink_msg_command_long_get_param5(msg); }
+    float param6() const { return mavlink_msg_command_long_get_param6(msg); }
+    float param7() const { return mavlink_msg_command_long_get_param7(msg); }
+    uint16_t command() const { return mavlink_msg_command_long_get_command(msg); }
+    uint8_t target_system() const { return mavlink_msg_command_long_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_command_long_get_target_component(msg); }
+    uint8_t confirmation() const { return mavlink_msg_command_long_get_confirmation(msg); }
+};
+
+struct Control_System_State_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_CONTROL_SYSTEM_STATE;
+    const mavlink_message_t *msg;
+    explicit Control_System_State_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_control_system_state_t &out) const { mavlink_msg_control_system_state_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_control_system_state_get_time_usec(msg); }
+    float x_acc() const { return mavlink_msg_control_system_state_get_x_acc(msg); }
+    float y_acc() const { return mavlink_msg_control_system_state_get_y_acc(msg); }
+    float z_acc() const { return mavlink_msg_control_system_state_get_z_acc(msg); }
+    float x_vel() const { return mavlink_msg_control_system_state_get_x_vel(msg); }
+    float y_vel() const { return mavlink_msg_control_system_state_get_y_vel(msg); }
+    float z_vel() const { return mavlink_msg_control_system_state_get_z_vel(msg); }
+    float x_pos() const { return mavlink_msg_control_system_state_get_x_pos(msg); }
+    float y_pos() const { return mavlink_msg_control_system_state_get_y_pos(msg); }
+    float z_pos() const { return mavlink_msg_control_system_state_get_z_pos(msg); }
+    float airspeed() const { return mavlink_msg_control_system_state_get_airspeed(msg); }
+    static const uint16_t vel_variance_len = 3;
+    uint16_t vel_variance(float *out) const { return mavlink_msg_control_system_state_get_vel_variance(msg, out); }
+    static const uint16_t pos_variance_len = 3;
+    uint16_t pos_variance(float *out) const { return mavlink_msg_control_system_state_get_pos_variance(msg, out); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_control_system_state_get_q(msg, out); }
+    float roll_rate() const { return mavlink_msg_control_system_state_get_roll_rate(msg); }
+    float pitch_rate() const { return mavlink_msg_control_system_state_get_pitch_rate(msg); }
+    float yaw_rate() const { return mavlink_msg_control_system_state_get_yaw_rate(msg); }
+};
+
+struct Data_Stream_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_DATA_STREAM;
+    const mavlink_message_t *msg;
+    explicit Data_Stream_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_data_stream_t &out) const { mavlink_msg_data_stream_decode(msg, &out); }
+    uint16_t message_rate() const { return mavlink_msg_data_stream_get_message_rate(msg); }
+    uint8_t stream_id() const { return mavlink_msg_data_stream_get_stream_id(msg); }
+    uint8_t on_off() const { return mavlink_msg_data_stream_get_on_off(msg); }
+};
+
+struct Data_Transmission_Handshake_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE;
+    const mavlink_message_t *msg;
+    explicit Data_Transmission_Handshake_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_data_transmission_handshake_t &out) const { mavlink_msg_data_transmission_handshake_decode(msg, &out); }
+    uint32_t size() const { return mavlink_msg_data_transmission_handshake_get_size(msg); }
+    uint16_t width() const { return mavlink_msg_data_transmission_handshake_get_width(msg); }
+    uint16_t height() const { return mavlink_msg_data_transmission_handshake_get_height(msg); }
+    uint16_t packets() const { return mavlink_msg_data_transmission_handshake_get_packets(msg); }
+    uint8_t type() const { return mavlink_msg_data_transmission_handshake_get_type(msg); }
+    uint8_t payload() const { return mavlink_msg_data_transmission_handshake_get_payload(msg); }
+    uint8_t jpg_quality() const { return mavlink_msg_data_transmission_handshake_get_jpg_quality(msg); }
+};
+
+struct Debug_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_DEBUG;
+    const mavlink_message_t *msg;
+    explicit Debug_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_debug_t &out) const { mavlink_msg_debug_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_debug_get_time_boot_ms(msg); }
+    float value() const { return mavlink_msg_debug_get_value(msg); }
+    uint8_t ind() const { return mavlink_msg_debug_get_ind(msg); }
+};
+
+struct Debug_Vect_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_DEBUG_VECT;
+    const mavlink_message_t *msg;
+    explicit Debug_Vect_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_debug_vect_t &out) const { mavlink_msg_debug_vect_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_debug_vect_get_time_usec(msg); }
+    float x() const { return mavlink_msg_debug_vect_get_x(msg); }
+    float y() const { return mavlink_msg_debug_vect_get_y(msg); }
+    float z() const { return mavlink_msg_debug_vect_get_z(msg); }
+    static const uint16_t name_len = 10;
+    const char *name() const { return (const char *)(_MAV_PAYLOAD(msg) + 20); }
+};
+
+struct Distance_Sensor_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_DISTANCE_SENSOR;
+    const mavlink_message_t *msg;
+    explicit Distance_Sensor_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_distance_sensor_t &out) const { mavlink_msg_distance_sensor_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_distance_sensor_get_time_boot_ms(msg); }
+    uint16_t min_distance() const { return mavlink_msg_distance_sensor_get_min_distance(msg); }
+    uint16_t max_distance() const { return mavlink_msg_distance_sensor_get_max_distance(msg); }
+    uint16_t current_distance() const { return mavlink_msg_distance_sensor_get_current_distance(msg); }
+    uint8_t type() const { return mavlink_msg_distance_sensor_get_type(msg); }
+    uint8_t id() const { return mavlink_msg_distance_sensor_get_id(msg); }
+    uint8_t orientation() const { return mavlink_msg_distance_sensor_get_orientation(msg); }
+    uint8_t covariance() const { return mavlink_msg_distance_sensor_get_covariance(msg); }
+};
+
+struct Encapsulated_Data_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ENCAPSULATED_DATA;
+    const mavlink_message_t *msg;
+    explicit Encapsulated_Data_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_encapsulated_data_t &out) const { mavlink_msg_encapsulated_data_decode(msg, &out); }
+    uint16_t seqnr() const { return mavlink_msg_encapsulated_data_get_seqnr(msg); }
+    static const uint16_t data_len = 253;
+    const uint8_t *data() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 2); }
+};
+
+struct Estimator_Status_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_ESTIMATOR_STATUS;
+    const mavlink_message_t *msg;
+    explicit Estimator_Status_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_estimator_status_t &out) const { mavlink_msg_estimator_status_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_estimator_status_get_time_usec(msg); }
+    float vel_ratio() const { return mavlink_msg_estimator_status_get_vel_ratio(msg); }
+    float pos_horiz_ratio() const { return mavlink_msg_estimator_status_get_pos_horiz_ratio(msg); }
+    float pos_vert_ratio() const { return mavlink_msg_estimator_status_get_pos_vert_ratio(msg); }
+    float mag_ratio() const { return mavlink_msg_estimator_status_get_mag_ratio(msg); }
+    float hagl_ratio() const { return mavlink_msg_estimator_status_get_hagl_ratio(msg); }
+    float tas_ratio() const { return mavlink_msg_estimator_status_get_tas_ratio(msg); }
+    float pos_horiz_accuracy() const { return mavlink_msg_estimator_status_get_pos_horiz_accuracy(msg); }
+    float pos_vert_accuracy() const { return mavlink_msg_estimator_status_get_pos_vert_accuracy(msg); }
+    uint16_t flags() const { return mavlink_msg_estimator_status_get_flags(msg); }
+};
+
+struct Extended_Sys_State_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_EXTENDED_SYS_STATE;
+    const mavlink_message_t *msg;
+    explicit Extended_Sys_State_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_extended_sys_state_t &out) const { mavlink_msg_extended_sys_state_decode(msg, &out); }
+    uint8_t vtol_state() const { return mavlink_msg_extended_sys_state_get_vtol_state(msg); }
+    uint8_t landed_state() const { return mavlink_msg_extended_sys_state_get_landed_state(msg); }
+};
+
+struct File_Transfer_Protocol_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL;
+    const mavlink_message_t *msg;
+    explicit File_Transfer_Protocol_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_file_transfer_protocol_t &out) const { mavlink_msg_file_transfer_protocol_decode(msg, &out); }
+    uint8_t target_network() const { return mavlink_msg_file_transfer_protocol_get_target_network(msg); }
+    uint8_t target_system() const { return mavlink_msg_file_transfer_protocol_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_file_transfer_protocol_get_target_component(msg); }
+    static const uint16_t payload_len = 251;
+    const uint8_t *payload() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 3); }
+};
+
+struct Follow_Target_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_FOLLOW_TARGET;
+    const mavlink_message_t *msg;
+    explicit Follow_Target_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_follow_target_t &out) const { mavlink_msg_follow_target_decode(msg, &out); }
+    uint64_t timestamp() const { return mavlink_msg_follow_target_get_timestamp(msg); }
+    uint64_t custom_state() const { return mavlink_msg_follow_target_get_custom_state(msg); }
+    int32_t lat() const { return mavlink_msg_follow_target_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_follow_target_get_lon(msg); }
+    float alt() const { return mavlink_msg_follow_target_get_alt(msg); }
+    static const uint16_t vel_len = 3;
+    uint16_t vel(float *out) const { return mavlink_msg_follow_target_get_vel(msg, out); }
+    static const uint16_t acc_len = 3;
+    uint16_t acc(float *out) const { return mavlink_msg_follow_target_get_acc(msg, out); }
+    static const uint16_t attitude_q_len = 4;
+    uint16_t attitude_q(float *out) const { return mavlink_msg_follow_target_get_attitude_q(msg, out); }
+    static const uint16_t rates_len = 3;
+    uint16_t rates(float *out) const { return mavlink_msg_follow_target_get_rates(msg, out); }
+    static const uint16_t position_cov_len = 3;
+    uint16_t position_cov(float *out) const { return mavlink_msg_follow_target_get_position_cov(msg, out); }
+    uint8_t est_capabilities() const { return mavlink_msg_follow_target_get_est_capabilities(msg); }
+};
+
+struct Global_Position_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GLOBAL_POSITION_INT;
+    const mavlink_message_t *msg;
+    explicit Global_Position_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_global_position_int_t &out) const { mavlink_msg_global_position_int_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_global_position_int_get_time_boot_ms(msg); }
+    int32_t lat() const { return mavlink_msg_global_position_int_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_global_position_int_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_global_position_int_get_alt(msg); }
+    int32_t relative_alt() const { return mavlink_msg_global_position_int_get_relative_alt(msg); }
+    int16_t vx() const { return mavlink_msg_global_position_int_get_vx(msg); }
+    int16_t vy() const { return mavlink_msg_global_position_int_get_vy(msg); }
+    int16_t vz() const { return mavlink_msg_global_position_int_get_vz(msg); }
+    uint16_t hdg() const { return mavlink_msg_global_position_int_get_hdg(msg); }
+};
+
+struct Global_Position_Int_Cov_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GLOBAL_POSITION_INT_COV;
+    const mavlink_message_t *msg;
+    explicit Global_Position_Int_Cov_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_global_position_int_cov_t &out) const { mavlink_msg_global_position_int_cov_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_global_position_int_cov_get_time_usec(msg); }
+    int32_t lat() const { return mavlink_msg_global_position_int_cov_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_global_position_int_cov_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_global_position_int_cov_get_alt(msg); }
+    int32_t relative_alt() const { return mavlink_msg_global_position_int_cov_get_relative_alt(msg); }
+    float vx() const { return mavlink_msg_global_position_int_cov_get_vx(msg); }
+    float vy() const { return mavlink_msg_global_position_int_cov_get_vy(msg); }
+    float vz() const { return mavlink_msg_global_position_int_cov_get_vz(msg); }
+    static const uint16_t covariance_len = 36;
+    uint16_t covariance(float *out) const { return mavlink_msg_global_position_int_cov_get_covariance(msg, out); }
+    uint8_t estimator_type() const { return mavlink_msg_global_position_int_cov_get_estimator_type(msg); }
+};
+
+struct Global_Vision_Position_Estimate_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE;
+    const mavlink_message_t *msg;
+    explicit Global_Vision_Position_Estimate_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_global_vision_position_estimate_t &out) const { mavlink_msg_global_vision_position_estimate_decode(msg, &out); }
+    uint64_t usec() const { return mavlink_msg_global_vision_position_estimate_get_usec(msg); }
+    float x() const { return mavlink_msg_global_vision_position_estimate_get_x(msg); }
+    float y() const { return mavlink_msg_global_vision_position_estimate_get_y(msg); }
+    float z() const { return mavlink_msg_global_vision_position_estimate_get_z(msg); }
+    float roll() const { return mavlink_msg_global_vision_position_estimate_get_roll(msg); }
+    float pitch() const { return mavlink_msg_global_vision_position_estimate_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_global_vision_position_estimate_get_yaw(msg); }
+};
+
+struct Gps2_Raw_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS2_RAW;
+    const mavlink_message_t *msg;
+    explicit Gps2_Raw_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps2_raw_t &out) const { mavlink_msg_gps2_raw_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_gps2_raw_get_time_usec(msg); }
+    int32_t lat() const { return mavlink_msg_gps2_raw_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_gps2_raw_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_gps2_raw_get_alt(msg); }
+    uint32_t dgps_age() const { return mavlink_msg_gps2_raw_get_dgps_age(msg); }
+    uint16_t eph() const { return mavlink_msg_gps2_raw_get_eph(msg); }
+    uint16_t epv() const { return mavlink_msg_gps2_raw_get_epv(msg); }
+    uint16_t vel() const { return mavlink_msg_gps2_raw_get_vel(msg); }
+    uint16_t cog() const { return mavlink_msg_gps2_raw_get_cog(msg); }
+    uint8_t fix_type() const { return mavlink_msg_gps2_raw_get_fix_type(msg); }
+    uint8_t satellites_visible() const { return mavlink_msg_gps2_raw_get_satellites_visible(msg); }
+    uint8_t dgps_numch() const { return mavlink_msg_gps2_raw_get_dgps_numch(msg); }
+};
+
+struct Gps2_Rtk_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS2_RTK;
+    const mavlink_message_t *msg;
+    explicit Gps2_Rtk_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps2_rtk_t &out) const { mavlink_msg_gps2_rtk_decode(msg, &out); }
+    uint32_t time_last_baseline_ms() const { return mavlink_msg_gps2_rtk_get_time_last_baseline_ms(msg); }
+    uint32_t tow() const { return mavlink_msg_gps2_rtk_get_tow(msg); }
+    int32_t baseline_a_mm() const { return mavlink_msg_gps2_rtk_get_baseline_a_mm(msg); }
+    int32_t baseline_b_mm() const { return mavlink_msg_gps2_rtk_get_baseline_b_mm(msg); }
+    int32_t baseline_c_mm() const { return mavlink_msg_gps2_rtk_get_baseline_c_mm(msg); }
+    uint32_t accuracy() const { return mavlink_msg_gps2_rtk_get_accuracy(msg); }
+    int32_t iar_num_hypotheses() const { return mavlink_msg_gps2_rtk_get_iar_num_hypotheses(msg); }
+    uint16_t wn() const { return mavlink_msg_gps2_rtk_get_wn(msg); }
+    uint8_t rtk_receiver_id() const { return mavlink_msg_gps2_rtk_get_rtk_receiver_id(msg); }
+    uint8_t rtk_health() const { return mavlink_msg_gps2_rtk_get_rtk_health(msg); }
+    uint8_t rtk_rate() const { return mavlink_msg_gps2_rtk_get_rtk_rate(msg); }
+    uint8_t nsats() const { return mavlink_msg_gps2_rtk_get_nsats(msg); }
+    uint8_t baseline_coords_type() const { return mavlink_msg_gps2_rtk_get_baseline_coords_type(msg); }
+};
+
+struct Gps_Global_Origin_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN;
+    const mavlink_message_t *msg;
+    explicit Gps_Global_Origin_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_global_origin_t &out) const { mavlink_msg_gps_global_origin_decode(msg, &out); }
+    int32_t latitude() const { return mavlink_msg_gps_global_origin_get_latitude(msg); }
+    int32_t longitude() const { return mavlink_msg_gps_global_origin_get_longitude(msg); }
+    int32_t altitude() const { return mavlink_msg_gps_global_origin_get_altitude(msg); }
+};
+
+struct Gps_Inject_Data_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_INJECT_DATA;
+    const mavlink_message_t *msg;
+    explicit Gps_Inject_Data_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_inject_data_t &out) const { mavlink_msg_gps_inject_data_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_gps_inject_data_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_gps_inject_data_get_target_component(msg); }
+    uint8_t len() const { return mavlink_msg_gps_inject_data_get_len(msg); }
+    static const uint16_t data_len = 110;
+    const uint8_t *data() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 3); }
+};
+
+struct Gps_Input_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_INPUT;
+    const mavlink_message_t *msg;
+    explicit Gps_Input_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_input_t &out) const { mavlink_msg_gps_input_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_gps_input_get_time_usec(msg); }
+    uint32_t time_week_ms() const { return mavlink_msg_gps_input_get_time_week_ms(msg); }
+    int32_t lat() const { return mavlink_msg_gps_input_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_gps_input_get_lon(msg); }
+    float alt() const { return mavlink_msg_gps_input_get_alt(msg); }
+    float hdop() const { return mavlink_msg_gps_input_get_hdop(msg); }
+    float vdop() const { return mavlink_msg_gps_input_get_vdop(msg); }
+    float vn() const { return mavlink_msg_gps_input_get_vn(msg); }
+    float ve() const { return mavlink_msg_gps_input_get_ve(msg); }
+    float vd() const { return mavlink_msg_gps_input_get_vd(msg); }
+    float speed_accuracy() const { return mavlink_msg_gps_input_get_speed_accuracy(msg); }
+    float horiz_accuracy() const { return mavlink_msg_gps_input_get_horiz_accuracy(msg); }
+    float vert_accuracy() const { return mavlink_msg_gps_input_get_vert_accuracy(msg); }
+    uint16_t ignore_flags() const { return mavlink_msg_gps_input_get_ignore_flags(msg); }
+    uint16_t time_week() const { return mavlink_msg_gps_input_get_time_week(msg); }
+    uint8_t gps_id() const { return mavlink_msg_gps_input_get_gps_id(msg); }
+    uint8_t fix_type() const { return mavlink_msg_gps_input_get_fix_type(msg); }
+    uint8_t satellites_visible() const { return mavlink_msg_gps_input_get_satellites_visible(msg); }
+};
+
+struct Gps_Raw_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_RAW_INT;
+    const mavlink_message_t *msg;
+    explicit Gps_Raw_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_raw_int_t &out) const { mavlink_msg_gps_raw_int_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_gps_raw_int_get_time_usec(msg); }
+    int32_t lat() const { return mavlink_msg_gps_raw_int_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_gps_raw_int_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_gps_raw_int_get_alt(msg); }
+    uint16_t eph() const { return mavlink_msg_gps_raw_int_get_eph(msg); }
+    uint16_t epv() const { return mavlink_msg_gps_raw_int_get_epv(msg); }
+    uint16_t vel() const { return mavlink_msg_gps_raw_int_get_vel(msg); }
+    uint16_t cog() const { return mavlink_msg_gps_raw_int_get_cog(msg); }
+    uint8_t fix_type() const { return mavlink_msg_gps_raw_int_get_fix_type(msg); }
+    uint8_t satellites_visible() const { return mavlink_msg_gps_raw_int_get_satellites_visible(msg); }
+};
+
+struct Gps_Rtcm_Data_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_RTCM_DATA;
+    const mavlink_message_t *msg;
+    explicit Gps_Rtcm_Data_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_rtcm_data_t &out) const { mavlink_msg_gps_rtcm_data_decode(msg, &out); }
+    uint8_t flags() const { return mavlink_msg_gps_rtcm_data_get_flags(msg); }
+    uint8_t len() const { return mavlink_msg_gps_rtcm_data_get_len(msg); }
+    static const uint16_t data_len = 180;
+    const uint8_t *data() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 2); }
+};
+
+struct Gps_Rtk_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_RTK;
+    const mavlink_message_t *msg;
+    explicit Gps_Rtk_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_rtk_t &out) const { mavlink_msg_gps_rtk_decode(msg, &out); }
+    uint32_t time_last_baseline_ms() const { return mavlink_msg_gps_rtk_get_time_last_baseline_ms(msg); }
+    uint32_t tow() const { return mavlink_msg_gps_rtk_get_tow(msg); }
+    int32_t baseline_a_mm() const { return mavlink_msg_gps_rtk_get_baseline_a_mm(msg); }
+    int32_t baseline_b_mm() const { return mavlink_msg_gps_rtk_get_baseline_b_mm(msg); }
+    int32_t baseline_c_mm() const { return mavlink_msg_gps_rtk_get_baseline_c_mm(msg); }
+    uint32_t accuracy() const { return mavlink_msg_gps_rtk_get_accuracy(msg); }
+    int32_t iar_num_hypotheses() const { return mavlink_msg_gps_rtk_get_iar_num_hypotheses(msg); }
+    uint16_t wn() const { return mavlink_msg_gps_rtk_get_wn(msg); }
+    uint8_t rtk_receiver_id() const { return mavlink_msg_gps_rtk_get_rtk_receiver_id(msg); }
+    uint8_t rtk_health() const { return mavlink_msg_gps_rtk_get_rtk_health(msg); }
+    uint8_t rtk_rate() const { return mavlink_msg_gps_rtk_get_rtk_rate(msg); }
+    uint8_t nsats() const { return mavlink_msg_gps_rtk_get_nsats(msg); }
+    uint8_t baseline_coords_type() const { return mavlink_msg_gps_rtk_get_baseline_coords_type(msg); }
+};
+
+struct Gps_Status_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_GPS_STATUS;
+    const mavlink_message_t *msg;
+    explicit Gps_Status_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_gps_status_t &out) const { mavlink_msg_gps_status_decode(msg, &out); }
+    uint8_t satellites_visible() const { return mavlink_msg_gps_status_get_satellites_visible(msg); }
+    static const uint16_t satellite_prn_len = 20;
+    const uint8_t *satellite_prn() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 1); }
+    static const uint16_t satellite_used_len = 20;
+    const uint8_t *satellite_used() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 21); }
+    static const uint16_t satellite_elevation_len = 20;
+    const uint8_t *satellite_elevation() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 41); }
+    static const uint16_t satellite_azimuth_len = 20;
+    const uint8_t *satellite_azimuth() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 61); }
+    static const uint16_t satellite_snr_len = 20;
+    const uint8_t *satellite_snr() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 81); }
+};
+
+struct Heartbeat_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HEARTBEAT;
+    const mavlink_message_t *msg;
+    explicit Heartbeat_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_heartbeat_t &out) const { mavlink_msg_heartbeat_decode(msg, &out); }
+    uint32_t custom_mode() const { return mavlink_msg_heartbeat_get_custom_mode(msg); }
+    uint8_t type() const { return mavlink_msg_heartbeat_get_type(msg); }
+    uint8_t autopilot() const { return mavlink_msg_heartbeat_get_autopilot(msg); }
+    uint8_t base_mode() const { return mavlink_msg_heartbeat_get_base_mode(msg); }
+    uint8_t system_status() const { return mavlink_msg_heartbeat_get_system_status(msg); }
+    uint8_t mavlink_version() const { return mavlink_msg_heartbeat_get_mavlink_version(msg); }
+};
+
+struct High_Latency_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIGH_LATENCY;
+    const mavlink_message_t *msg;
+    explicit High_Latency_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_high_latency_t &out) const { mavlink_msg_high_latency_decode(msg, &out); }
+    uint32_t custom_mode() const { return mavlink_msg_high_latency_get_custom_mode(msg); }
+    int32_t latitude() const { return mavlink_msg_high_latency_get_latitude(msg); }
+    int32_t longitude() const { return mavlink_msg_high_latency_get_longitude(msg); }
+    int16_t roll() const { return mavlink_msg_high_latency_get_roll(msg); }
+    int16_t pitch() const { return mavlink_msg_high_latency_get_pitch(msg); }
+    uint16_t heading() const { return mavlink_msg_high_latency_get_heading(msg); }
+    int16_t heading_sp() const { return mavlink_msg_high_latency_get_heading_sp(msg); }
+    int16_t altitude_amsl() const { return mavlink_msg_high_latency_get_altitude_amsl(msg); }
+    int16_t altitude_sp() const { return mavlink_msg_high_latency_get_altitude_sp(msg); }
+    uint16_t wp_distance() const { return mavlink_msg_high_latency_get_wp_distance(msg); }
+    uint8_t base_mode() const { return mavlink_msg_high_latency_get_base_mode(msg); }
+    uint8_t landed_state() const { return mavlink_msg_high_latency_get_landed_state(msg); }
+    int8_t throttle() const { return mavlink_msg_high_latency_get_throttle(msg); }
+    uint8_t airspeed() const { return mavlink_msg_high_latency_get_airspeed(msg); }
+    uint8_t airspeed_sp() const { return mavlink_msg_high_latency_get_airspeed_sp(msg); }
+    uint8_t groundspeed() const { return mavlink_msg_high_latency_get_groundspeed(msg); }
+    int8_t climb_rate() const { return mavlink_msg_high_latency_get_climb_rate(msg); }
+    uint8_t gps_nsat() const { return mavlink_msg_high_latency_get_gps_nsat(msg); }
+    uint8_t gps_fix_type() const { return mavlink_msg_high_latency_get_gps_fix_type(msg); }
+    uint8_t battery_remaining() const { return mavlink_msg_high_latency_get_battery_remaining(msg); }
+    int8_t temperature() const { return mavlink_msg_high_latency_get_temperature(msg); }
+    int8_t temperature_air() const { return mavlink_msg_high_latency_get_temperature_air(msg); }
+    uint8_t failsafe() const { return mavlink_msg_high_latency_get_failsafe(msg); }
+    uint8_t wp_num() const { return mavlink_msg_high_latency_get_wp_num(msg); }
+};
+
+struct High_Latency2_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIGH_LATENCY2;
+    const mavlink_message_t *msg;
+    explicit High_Latency2_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_high_latency2_t &out) const { mavlink_msg_high_latency2_decode(msg, &out); }
+    uint32_t timestamp() const { return mavlink_msg_high_latency2_get_timestamp(msg); }
+    int32_t latitude() const { return mavlink_msg_high_latency2_get_latitude(msg); }
+    int32_t longitude() const { return mavlink_msg_high_latency2_get_longitude(msg); }
+    uint16_t custom_mode() const { return mavlink_msg_high_latency2_get_custom_mode(msg); }
+    int16_t altitude() const { return mavlink_msg_high_latency2_get_altitude(msg); }
+    int16_t target_altitude() const { return mavlink_msg_high_latency2_get_target_altitude(msg); }
+    uint16_t target_distance() const { return mavlink_msg_high_latency2_get_target_distance(msg); }
+    uint16_t wp_num() const { return mavlink_msg_high_latency2_get_wp_num(msg); }
+    uint16_t failure_flags() const { return mavlink_msg_high_latency2_get_failure_flags(msg); }
+    uint8_t type() const { return mavlink_msg_high_latency2_get_type(msg); }
+    uint8_t autopilot() const { return mavlink_msg_high_latency2_get_autopilot(msg); }
+    uint8_t heading() const { return mavlink_msg_high_latency2_get_heading(msg); }
+    uint8_t target_heading() const { return mavlink_msg_high_latency2_get_target_heading(msg); }
+    uint8_t throttle() const { return mavlink_msg_high_latency2_get_throttle(msg); }
+    uint8_t airspeed() const { return mavlink_msg_high_latency2_get_airspeed(msg); }
+    uint8_t airspeed_sp() const { return mavlink_msg_high_latency2_get_airspeed_sp(msg); }
+    uint8_t groundspeed() const { return mavlink_msg_high_latency2_get_groundspeed(msg); }
+    uint8_t windspeed() const { return mavlink_msg_high_latency2_get_windspeed(msg); }
+    uint8_t wind_heading() const { return mavlink_msg_high_latency2_get_wind_heading(msg); }
+    uint8_t eph() const { return mavlink_msg_high_latency2_get_eph(msg); }
+    uint8_t epv() const { return mavlink_msg_high_latency2_get_epv(msg); }
+    int8_t temperature_air() const { return mavlink_msg_high_latency2_get_temperature_air(msg); }
+    int8_t climb_rate() const { return mavlink_msg_high_latency2_get_climb_rate(msg); }
+    int8_t battery() const { return mavlink_msg_high_latency2_get_battery(msg); }
+    int8_t custom0() const { return mavlink_msg_high_latency2_get_custom0(msg); }
+    int8_t custom1() const { return mavlink_msg_high_latency2_get_custom1(msg); }
+    int8_t custom2() const { return mavlink_msg_high_latency2_get_custom2(msg); }
+};
+
+struct Highres_Imu_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIGHRES_IMU;
+    const mavlink_message_t *msg;
+    explicit Highres_Imu_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_highres_imu_t &out) const { mavlink_msg_highres_imu_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_highres_imu_get_time_usec(msg); }
+    float xacc() const { return mavlink_msg_highres_imu_get_xacc(msg); }
+    float yacc() const { return mavlink_msg_highres_imu_get_yacc(msg); }
+    float zacc() const { return mavlink_msg_highres_imu_get_zacc(msg); }
+    float xgyro() const { return mavlink_msg_highres_imu_get_xgyro(msg); }
+    float ygyro() const { return mavlink_msg_highres_imu_get_ygyro(msg); }
+    float zgyro() const { return mavlink_msg_highres_imu_get_zgyro(msg); }
+    float xmag() const { return mavlink_msg_highres_imu_get_xmag(msg); }
+    float ymag() const { return mavlink_msg_highres_imu_get_ymag(msg); }
+    float zmag() const { return mavlink_msg_highres_imu_get_zmag(msg); }
+    float abs_pressure() const { return mavlink_msg_highres_imu_get_abs_pressure(msg); }
+    float diff_pressure() const { return mavlink_msg_highres_imu_get_diff_pressure(msg); }
+    float pressure_alt() const { return mavlink_msg_highres_imu_get_pressure_alt(msg); }
+    float temperature() const { return mavlink_msg_highres_imu_get_temperature(msg); }
+    uint16_t fields_updated() const { return mavlink_msg_highres_imu_get_fields_updated(msg); }
+};
+
+struct Hil_Actuator_Controls_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS;
+    const mavlink_message_t *msg;
+    explicit Hil_Actuator_Controls_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_actuator_controls_t &out) const { mavlink_msg_hil_actuator_controls_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_actuator_controls_get_time_usec(msg); }
+    uint64_t flags() const { return mavlink_msg_hil_actuator_controls_get_flags(msg); }
+    static const uint16_t controls_len = 16;
+    uint16_t controls(float *out) const { return mavlink_msg_hil_actuator_controls_get_controls(msg, out); }
+    uint8_t mode() const { return mavlink_msg_hil_actuator_controls_get_mode(msg); }
+};
+
+struct Hil_Controls_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_CONTROLS;
+    const mavlink_message_t *msg;
+    explicit Hil_Controls_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_controls_t &out) const { mavlink_msg_hil_controls_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_controls_get_time_usec(msg); }
+    float roll_ailerons() const { return mavlink_msg_hil_controls_get_roll_ailerons(msg); }
+    float pitch_elevator() const { return mavlink_msg_hil_controls_get_pitch_elevator(msg); }
+    float yaw_rudder() const { return mavlink_msg_hil_controls_get_yaw_rudder(msg); }
+    float throttle() const { return mavlink_msg_hil_controls_get_throttle(msg); }
+    float aux1() const { return mavlink_msg_hil_controls_get_aux1(msg); }
+    float aux2() const { return mavlink_msg_hil_controls_get_aux2(msg); }
+    float aux3() const { return mavlink_msg_hil_controls_get_aux3(msg); }
+    float aux4() const { return mavlink_msg_hil_controls_get_aux4(msg); }
+    uint8_t mode() const { return mavlink_msg_hil_controls_get_mode(msg); }
+    uint8_t nav_mode() const { return mavlink_msg_hil_controls_get_nav_mode(msg); }
+};
+
+struct Hil_Gps_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_GPS;
+    const mavlink_message_t *msg;
+    explicit Hil_Gps_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_gps_t &out) const { mavlink_msg_hil_gps_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_gps_get_time_usec(msg); }
+    int32_t lat() const { return mavlink_msg_hil_gps_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_hil_gps_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_hil_gps_get_alt(msg); }
+    uint16_t eph() const { return mavlink_msg_hil_gps_get_eph(msg); }
+    uint16_t epv() const { return mavlink_msg_hil_gps_get_epv(msg); }
+    uint16_t vel() const { return mavlink_msg_hil_gps_get_vel(msg); }
+    int16_t vn() const { return mavlink_msg_hil_gps_get_vn(msg); }
+    int16_t ve() const { return mavlink_msg_hil_gps_get_ve(msg); }
+    int16_t vd() const { return mavlink_msg_hil_gps_get_vd(msg); }
+    uint16_t cog() const { return mavlink_msg_hil_gps_get_cog(msg); }
+    uint8_t fix_type() const { return mavlink_msg_hil_gps_get_fix_type(msg); }
+    uint8_t satellites_visible() const { return mavlink_msg_hil_gps_get_satellites_visible(msg); }
+};
+
+struct Hil_Optical_Flow_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_OPTICAL_FLOW;
+    const mavlink_message_t *msg;
+    explicit Hil_Optical_Flow_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_optical_flow_t &out) const { mavlink_msg_hil_optical_flow_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_optical_flow_get_time_usec(msg); }
+    uint32_t integration_time_us() const { return mavlink_msg_hil_optical_flow_get_integration_time_us(msg); }
+    float integrated_x() const { return mavlink_msg_hil_optical_flow_get_integrated_x(msg); }
+    float integrated_y() const { return mavlink_msg_hil_optical_flow_get_integrated_y(msg); }
+    float integrated_xgyro() const { return mavlink_msg_hil_optical_flow_get_integrated_xgyro(msg); }
+    float integrated_ygyro() const { return mavlink_msg_hil_optical_flow_get_integrated_ygyro(msg); }
+    float integrated_zgyro() const { return mavlink_msg_hil_optical_flow_get_integrated_zgyro(msg); }
+    uint32_t time_delta_distance_us() const { return mavlink_msg_hil_optical_flow_get_time_delta_distance_us(msg); }
+    float distance() const { return mavlink_msg_hil_optical_flow_get_distance(msg); }
+    int16_t temperature() const { return mavlink_msg_hil_optical_flow_get_temperature(msg); }
+    uint8_t sensor_id() const { return mavlink_msg_hil_optical_flow_get_sensor_id(msg); }
+    uint8_t quality() const { return mavlink_msg_hil_optical_flow_get_quality(msg); }
+};
+
+struct Hil_Rc_Inputs_Raw_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW;
+    const mavlink_message_t *msg;
+    explicit Hil_Rc_Inputs_Raw_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_rc_inputs_raw_t &out) const { mavlink_msg_hil_rc_inputs_raw_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_rc_inputs_raw_get_time_usec(msg); }
+    uint16_t chan1_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan1_raw(msg); }
+    uint16_t chan2_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan2_raw(msg); }
+    uint16_t chan3_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan3_raw(msg); }
+    uint16_t chan4_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan4_raw(msg); }
+    uint16_t chan5_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan5_raw(msg); }
+    uint16_t chan6_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan6_raw(msg); }
+    uint16_t chan7_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan7_raw(msg); }
+    uint16_t chan8_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan8_raw(msg); }
+    uint16_t chan9_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan9_raw(msg); }
+    uint16_t chan10_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan10_raw(msg); }
+    uint16_t chan11_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan11_raw(msg); }
+    uint16_t chan12_raw() const { return mavlink_msg_hil_rc_inputs_raw_get_chan12_raw(msg); }
+    uint8_t rssi() const { return mavlink_msg_hil_rc_inputs_raw_get_rssi(msg); }
+};
+
+struct Hil_Sensor_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_SENSOR;
+    const mavlink_message_t *msg;
+    explicit Hil_Sensor_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_sensor_t &out) const { mavlink_msg_hil_sensor_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_sensor_get_time_usec(msg); }
+    float xacc() const { return mavlink_msg_hil_sensor_get_xacc(msg); }
+    float yacc() const { return mavlink_msg_hil_sensor_get_yacc(msg); }
+    float zacc() const { return mavlink_msg_hil_sensor_get_zacc(msg); }
+    float xgyro() const { return mavlink_msg_hil_sensor_get_xgyro(msg); }
+    float ygyro() const { return mavlink_msg_hil_sensor_get_ygyro(msg); }
+    float zgyro() const { return mavlink_msg_hil_sensor_get_zgyro(msg); }
+    float xmag() const { return mavlink_msg_hil_sensor_get_xmag(msg); }
+    float ymag() const { return mavlink_msg_hil_sensor_get_ymag(msg); }
+    float zmag() const { return mavlink_msg_hil_sensor_get_zmag(msg); }
+    float abs_pressure() const { return mavlink_msg_hil_sensor_get_abs_pressure(msg); }
+    float diff_pressure() const { return mavlink_msg_hil_sensor_get_diff_pressure(msg); }
+    float pressure_alt() const { return mavlink_msg_hil_sensor_get_pressure_alt(msg); }
+    float temperature() const { return mavlink_msg_hil_sensor_get_temperature(msg); }
+    uint32_t fields_updated() const { return mavlink_msg_hil_sensor_get_fields_updated(msg); }
+};
+
+struct Hil_State_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_STATE;
+    const mavlink_message_t *msg;
+    explicit Hil_State_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_state_t &out) const { mavlink_msg_hil_state_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_state_get_time_usec(msg); }
+    float roll() const { return mavlink_msg_hil_state_get_roll(msg); }
+    float pitch() const { return mavlink_msg_hil_state_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_hil_state_get_yaw(msg); }
+    float rollspeed() const { return mavlink_msg_hil_state_get_rollspeed(msg); }
+    float pitchspeed() const { return mavlink_msg_hil_state_get_pitchspeed(msg); }
+    float yawspeed() const { return mavlink_msg_hil_state_get_yawspeed(msg); }
+    int32_t lat() const { return mavlink_msg_hil_state_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_hil_state_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_hil_state_get_alt(msg); }
+    int16_t vx() const { return mavlink_msg_hil_state_get_vx(msg); }
+    int16_t vy() const { return mavlink_msg_hil_state_get_vy(msg); }
+    int16_t vz() const { return mavlink_msg_hil_state_get_vz(msg); }
+    int16_t xacc() const { return mavlink_msg_hil_state_get_xacc(msg); }
+    int16_t yacc() const { return mavlink_msg_hil_state_get_yacc(msg); }
+    int16_t zacc() const { return mavlink_msg_hil_state_get_zacc(msg); }
+};
+
+struct Hil_State_Quaternion_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HIL_STATE_QUATERNION;
+    const mavlink_message_t *msg;
+    explicit Hil_State_Quaternion_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_hil_state_quaternion_t &out) const { mavlink_msg_hil_state_quaternion_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_hil_state_quaternion_get_time_usec(msg); }
+    static const uint16_t attitude_quaternion_len = 4;
+    uint16_t attitude_quaternion(float *out) const { return mavlink_msg_hil_state_quaternion_get_attitude_quaternion(msg, out); }
+    float rollspeed() const { return mavlink_msg_hil_state_quaternion_get_rollspeed(msg); }
+    float pitchspeed() const { return mavlink_msg_hil_state_quaternion_get_pitchspeed(msg); }
+    float yawspeed() const { return mavlink_msg_hil_state_quaternion_get_yawspeed(msg); }
+    int32_t lat() const { return mavlink_msg_hil_state_quaternion_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_hil_state_quaternion_get_lon(msg); }
+    int32_t alt() const { return mavlink_msg_hil_state_quaternion_get_alt(msg); }
+    int16_t vx() const { return mavlink_msg_hil_state_quaternion_get_vx(msg); }
+    int16_t vy() const { return mavlink_msg_hil_state_quaternion_get_vy(msg); }
+    int16_t vz() const { return mavlink_msg_hil_state_quaternion_get_vz(msg); }
+    uint16_t ind_airspeed() const { return mavlink_msg_hil_state_quaternion_get_ind_airspeed(msg); }
+    uint16_t true_airspeed() const { return mavlink_msg_hil_state_quaternion_get_true_airspeed(msg); }
+    int16_t xacc() const { return mavlink_msg_hil_state_quaternion_get_xacc(msg); }
+    int16_t yacc() const { return mavlink_msg_hil_state_quaternion_get_yacc(msg); }
+    int16_t zacc() const { return mavlink_msg_hil_state_quaternion_get_zacc(msg); }
+};
+
+struct Home_Position_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_HOME_POSITION;
+    const mavlink_message_t *msg;
+    explicit Home_Position_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_home_position_t &out) const { mavlink_msg_home_position_decode(msg, &out); }
+    int32_t latitude() const { return mavlink_msg_home_position_get_latitude(msg); }
+    int32_t longitude() const { return mavlink_msg_home_position_get_longitude(msg); }
+    int32_t altitude() const { return mavlink_msg_home_position_get_altitude(msg); }
+    float x() const { return mavlink_msg_home_position_get_x(msg); }
+    float y() const { return mavlink_msg_home_position_get_y(msg); }
+    float z() const { return mavlink_msg_home_position_get_z(msg); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_home_position_get_q(msg, out); }
+    float approach_x() const { return mavlink_msg_home_position_get_approach_x(msg); }
+    float approach_y() const { return mavlink_msg_home_position_get_approach_y(msg); }
+    float approach_z() const { return mavlink_msg_home_position_get_approach_z(msg); }
+};
+
+struct Landing_Target_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LANDING_TARGET;
+    const mavlink_message_t *msg;
+    explicit Landing_Target_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_landing_target_t &out) const { mavlink_msg_landing_target_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_landing_target_get_time_usec(msg); }
+    float angle_x() const { return mavlink_msg_landing_target_get_angle_x(msg); }
+    float angle_y() const { return mavlink_msg_landing_target_get_angle_y(msg); }
+    float distance() const { return mavlink_msg_landing_target_get_distance(msg); }
+    float size_x() const { return mavlink_msg_landing_target_get_size_x(msg); }
+    float size_y() const { return mavlink_msg_landing_target_get_size_y(msg); }
+    uint8_t target_num() const { return mavlink_msg_landing_target_get_target_num(msg); }
+    uint8_t frame() const { return mavlink_msg_landing_target_get_frame(msg); }
+};
+
+struct Local_Position_Ned_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOCAL_POSITION_NED;
+    const mavlink_message_t *msg;
+    explicit Local_Position_Ned_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_local_position_ned_t &out) const { mavlink_msg_local_position_ned_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_local_position_ned_get_time_boot_ms(msg); }
+    float x() const { return mavlink_msg_local_position_ned_get_x(msg); }
+    float y() const { return mavlink_msg_local_position_ned_get_y(msg); }
+    float z() const { return mavlink_msg_local_position_ned_get_z(msg); }
+    float vx() const { return mavlink_msg_local_position_ned_get_vx(msg); }
+    float vy() const { return mavlink_msg_local_position_ned_get_vy(msg); }
+    float vz() const { return mavlink_msg_local_position_ned_get_vz(msg); }
+};
+
+struct Local_Position_Ned_Cov_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOCAL_POSITION_NED_COV;
+    const mavlink_message_t *msg;
+    explicit Local_Position_Ned_Cov_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_local_position_ned_cov_t &out) const { mavlink_msg_local_position_ned_cov_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_local_position_ned_cov_get_time_usec(msg); }
+    float x() const { return mavlink_msg_local_position_ned_cov_get_x(msg); }
+    float y() const { return mavlink_msg_local_position_ned_cov_get_y(msg); }
+    float z() const { return mavlink_msg_local_position_ned_cov_get_z(msg); }
+    float vx() const { return mavlink_msg_local_position_ned_cov_get_vx(msg); }
+    float vy() const { return mavlink_msg_local_position_ned_cov_get_vy(msg); }
+    float vz() const { return mavlink_msg_local_position_ned_cov_get_vz(msg); }
+    float ax() const { return mavlink_msg_local_position_ned_cov_get_ax(msg); }
+    float ay() const { return mavlink_msg_local_position_ned_cov_get_ay(msg); }
+    float az() const { return mavlink_msg_local_position_ned_cov_get_az(msg); }
+    static const uint16_t covariance_len = 45;
+    uint16_t covariance(float *out) const { return mavlink_msg_local_position_ned_cov_get_covariance(msg, out); }
+    uint8_t estimator_type() const { return mavlink_msg_local_position_ned_cov_get_estimator_type(msg); }
+};
+
+struct Local_Position_Ned_System_Global_Offset_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET;
+    const mavlink_message_t *msg;
+    explicit Local_Position_Ned_System_Global_Offset_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_local_position_ned_system_global_offset_t &out) const { mavlink_msg_local_position_ned_system_global_offset_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_local_position_ned_system_global_offset_get_time_boot_ms(msg); }
+    float x() const { return mavlink_msg_local_position_ned_system_global_offset_get_x(msg); }
+    float y() const { return mavlink_msg_local_position_ned_system_global_offset_get_y(msg); }
+    float z() const { return mavlink_msg_local_position_ned_system_global_offset_get_z(msg); }
+    float roll() const { return mavlink_msg_local_position_ned_system_global_offset_get_roll(msg); }
+    float pitch() const { return mavlink_msg_local_position_ned_system_global_offset_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_local_position_ned_system_global_offset_get_yaw(msg); }
+};
+
+struct Log_Data_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOG_DATA;
+    const mavlink_message_t *msg;
+    explicit Log_Data_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_log_data_t &out) const { mavlink_msg_log_data_decode(msg, &out); }
+    uint32_t ofs() const { return mavlink_msg_log_data_get_ofs(msg); }
+    uint16_t id() const { return mavlink_msg_log_data_get_id(msg); }
+    uint8_t count() const { return mavlink_msg_log_data_get_count(msg); }
+    static const uint16_t data_len = 90;
+    const uint8_t *data() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 7); }
+};
+
+struct Log_Entry_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOG_ENTRY;
+    const mavlink_message_t *msg;
+    explicit Log_Entry_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_log_entry_t &out) const { mavlink_msg_log_entry_decode(msg, &out); }
+    uint32_t time_utc() const { return mavlink_msg_log_entry_get_time_utc(msg); }
+    uint32_t size() const { return mavlink_msg_log_entry_get_size(msg); }
+    uint16_t id() const { return mavlink_msg_log_entry_get_id(msg); }
+    uint16_t num_logs() const { return mavlink_msg_log_entry_get_num_logs(msg); }
+    uint16_t last_log_num() const { return mavlink_msg_log_entry_get_last_log_num(msg); }
+};
+
+struct Log_Erase_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOG_ERASE;
+    const mavlink_message_t *msg;
+    explicit Log_Erase_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_log_erase_t &out) const { mavlink_msg_log_erase_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_log_erase_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_log_erase_get_target_component(msg); }
+};
+
+struct Log_Request_Data_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOG_REQUEST_DATA;
+    const mavlink_message_t *msg;
+    explicit Log_Request_Data_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_log_request_data_t &out) const { mavlink_msg_log_request_data_decode(msg, &out); }
+    uint32_t ofs() const { return mavlink_msg_log_request_data_get_ofs(msg); }
+    uint32_t count() const { return mavlink_msg_log_request_data_get_count(msg); }
+    uint16_t id() const { return mavlink_msg_log_request_data_get_id(msg); }
+    uint8_t target_system() const { return mavlink_msg_log_request_data_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_log_request_data_get_target_component(msg); }
+};
+
+struct Log_Request_End_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOG_REQUEST_END;
+    const mavlink_message_t *msg;
+    explicit Log_Request_End_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_log_request_end_t &out) const { mavlink_msg_log_request_end_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_log_request_end_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_log_request_end_get_target_component(msg); }
+};
+
+struct Log_Request_List_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_LOG_REQUEST_LIST;
+    const mavlink_message_t *msg;
+    explicit Log_Request_List_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_log_request_list_t &out) const { mavlink_msg_log_request_list_decode(msg, &out); }
+    uint16_t start() const { return mavlink_msg_log_request_list_get_start(msg); }
+    uint16_t end() const { return mavlink_msg_log_request_list_get_end(msg); }
+    uint8_t target_system() const { return mavlink_msg_log_request_list_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_log_request_list_get_target_component(msg); }
+};
+
+struct Manual_Control_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MANUAL_CONTROL;
+    const mavlink_message_t *msg;
+    explicit Manual_Control_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_manual_control_t &out) const { mavlink_msg_manual_control_decode(msg, &out); }
+    int16_t x() const { return mavlink_msg_manual_control_get_x(msg); }
+    int16_t y() const { return mavlink_msg_manual_control_get_y(msg); }
+    int16_t z() const { return mavlink_msg_manual_control_get_z(msg); }
+    int16_t r() const { return mavlink_msg_manual_control_get_r(msg); }
+    uint16_t buttons() const { return mavlink_msg_manual_control_get_buttons(msg); }
+    uint8_t target() const { return mavlink_msg_manual_control_get_target(msg); }
+};
+
+struct Manual_Setpoint_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MANUAL_SETPOINT;
+    const mavlink_message_t *msg;
+    explicit Manual_Setpoint_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_manual_setpoint_t &out) const { mavlink_msg_manual_setpoint_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_manual_setpoint_get_time_boot_ms(msg); }
+    float roll() const { return mavlink_msg_manual_setpoint_get_roll(msg); }
+    float pitch() const { return mavlink_msg_manual_setpoint_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_manual_setpoint_get_yaw(msg); }
+    float thrust() const { return mavlink_msg_manual_setpoint_get_thrust(msg); }
+    uint8_t mode_switch() const { return mavlink_msg_manual_setpoint_get_mode_switch(msg); }
+    uint8_t manual_override_switch() const { return mavlink_msg_manual_setpoint_get_manual_override_switch(msg); }
+};
+
+struct Memory_Vect_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MEMORY_VECT;
+    const mavlink_message_t *msg;
+    explicit Memory_Vect_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_memory_vect_t &out) const { mavlink_msg_memory_vect_decode(msg, &out); }
+    uint16_t address() const { return mavlink_msg_memory_vect_get_address(msg); }
+    uint8_t ver() const { return mavlink_msg_memory_vect_get_ver(msg); }
+    uint8_t type() const { return mavlink_msg_memory_vect_get_type(msg); }
+    static const uint16_t value_len = 32;
+    const int8_t *value() const { return (const int8_t *)(_MAV_PAYLOAD(msg) + 4); }
+};
+
+struct Message_Interval_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MESSAGE_INTERVAL;
+    const mavlink_message_t *msg;
+    explicit Message_Interval_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_message_interval_t &out) const { mavlink_msg_message_interval_decode(msg, &out); }
+    int32_t interval_us() const { return mavlink_msg_message_interval_get_interval_us(msg); }
+    uint16_t message_id() const { return mavlink_msg_message_interval_get_message_id(msg); }
+};
+
+struct Mission_Ack_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_ACK;
+    const mavlink_message_t *msg;
+    explicit Mission_Ack_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_ack_t &out) const { mavlink_msg_mission_ack_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_mission_ack_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_ack_get_target_component(msg); }
+    uint8_t type() const { return mavlink_msg_mission_ack_get_type(msg); }
+};
+
+struct Mission_Clear_All_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_CLEAR_ALL;
+    const mavlink_message_t *msg;
+    explicit Mission_Clear_All_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_clear_all_t &out) const { mavlink_msg_mission_clear_all_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_mission_clear_all_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_clear_all_get_target_component(msg); }
+};
+
+struct Mission_Count_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_COUNT;
+    const mavlink_message_t *msg;
+    explicit Mission_Count_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_count_t &out) const { mavlink_msg_mission_count_decode(msg, &out); }
+    uint16_t count() const { return mavlink_msg_mission_count_get_count(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_count_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_count_get_target_component(msg); }
+};
+
+struct Mission_Current_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_CURRENT;
+    const mavlink_message_t *msg;
+    explicit Mission_Current_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_current_t &out) const { mavlink_msg_mission_current_decode(msg, &out); }
+    uint16_t seq() const { return mavlink_msg_mission_current_get_seq(msg); }
+};
+
+struct Mission_Item_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_ITEM;
+    const mavlink_message_t *msg;
+    explicit Mission_Item_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_item_t &out) const { mavlink_msg_mission_item_decode(msg, &out); }
+    float param1() const { return mavlink_msg_mission_item_get_param1(msg); }
+    float param2() const { return mavlink_msg_mission_item_get_param2(msg); }
+    float param3() const { return mavlink_msg_mission_item_get_param3(msg); }
+    float param4() const { return mavlink_msg_mission_item_get_param4(msg); }
+    float x() const { return mavlink_msg_mission_item_get_x(msg); }
+    float y() const { return mavlink_msg_mission_item_get_y(msg); }
+    float z() const { return mavlink_msg_mission_item_get_z(msg); }
+    uint16_t seq() const { return mavlink_msg_mission_item_get_seq(msg); }
+    uint16_t command() const { return mavlink_msg_mission_item_get_command(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_item_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_item_get_target_component(msg); }
+    uint8_t frame() const { return mavlink_msg_mission_item_get_frame(msg); }
+    uint8_t current() const { return mavlink_msg_mission_item_get_current(msg); }
+    uint8_t autocontinue() const { return mavlink_msg_mission_item_get_autocontinue(msg); }
+};
+
+struct Mission_Item_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_ITEM_INT;
+    const mavlink_message_t *msg;
+    explicit Mission_Item_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_item_int_t &out) const { mavlink_msg_mission_item_int_decode(msg, &out); }
+    float param1() const { return mavlink_msg_mission_item_int_get_param1(msg); }
+    float param2() const { return mavlink_msg_mission_item_int_get_param2(msg); }
+    float param3() const { return mavlink_msg_mission_item_int_get_param3(msg); }
+    float param4() const { return mavlink_msg_mission_item_int_get_param4(msg); }
+    int32_t x() const { return mavlink_msg_mission_item_int_get_x(msg); }
+    int32_t y() const { return mavlink_msg_mission_item_int_get_y(msg); }
+    float z() const { return mavlink_msg_mission_item_int_get_z(msg); }
+    uint16_t seq() const { return mavlink_msg_mission_item_int_get_seq(msg); }
+    uint16_t command() const { return mavlink_msg_mission_item_int_get_command(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_item_int_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_item_int_get_target_component(msg); }
+    uint8_t frame() const { return mavlink_msg_mission_item_int_get_frame(msg); }
+    uint8_t current() const { return mavlink_msg_mission_item_int_get_current(msg); }
+    uint8_t autocontinue() const { return mavlink_msg_mission_item_int_get_autocontinue(msg); }
+};
+
+struct Mission_Item_Reached_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_ITEM_REACHED;
+    const mavlink_message_t *msg;
+    explicit Mission_Item_Reached_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_item_reached_t &out) const { mavlink_msg_mission_item_reached_decode(msg, &out); }
+    uint16_t seq() const { return mavlink_msg_mission_item_reached_get_seq(msg); }
+};
+
+struct Mission_Request_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_REQUEST;
+    const mavlink_message_t *msg;
+    explicit Mission_Request_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_request_t &out) const { mavlink_msg_mission_request_decode(msg, &out); }
+    uint16_t seq() const { return mavlink_msg_mission_request_get_seq(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_request_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_request_get_target_component(msg); }
+};
+
+struct Mission_Request_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_REQUEST_INT;
+    const mavlink_message_t *msg;
+    explicit Mission_Request_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_request_int_t &out) const { mavlink_msg_mission_request_int_decode(msg, &out); }
+    uint16_t seq() const { return mavlink_msg_mission_request_int_get_seq(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_request_int_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_request_int_get_target_component(msg); }
+};
+
+struct Mission_Request_List_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_REQUEST_LIST;
+    const mavlink_message_t *msg;
+    explicit Mission_Request_List_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_request_list_t &out) const { mavlink_msg_mission_request_list_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_mission_request_list_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_request_list_get_target_component(msg); }
+};
+
+struct Mission_Request_Partial_List_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST;
+    const mavlink_message_t *msg;
+    explicit Mission_Request_Partial_List_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_request_partial_list_t &out) const { mavlink_msg_mission_request_partial_list_decode(msg, &out); }
+    int16_t start_index() const { return mavlink_msg_mission_request_partial_list_get_start_index(msg); }
+    int16_t end_index() const { return mavlink_msg_mission_request_partial_list_get_end_index(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_request_partial_list_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_request_partial_list_get_target_component(msg); }
+};
+
+struct Mission_Set_Current_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_SET_CURRENT;
+    const mavlink_message_t *msg;
+    explicit Mission_Set_Current_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_set_current_t &out) const { mavlink_msg_mission_set_current_decode(msg, &out); }
+    uint16_t seq() const { return mavlink_msg_mission_set_current_get_seq(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_set_current_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_set_current_get_target_component(msg); }
+};
+
+struct Mission_Write_Partial_List_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST;
+    const mavlink_message_t *msg;
+    explicit Mission_Write_Partial_List_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_mission_write_partial_list_t &out) const { mavlink_msg_mission_write_partial_list_decode(msg, &out); }
+    int16_t start_index() const { return mavlink_msg_mission_write_partial_list_get_start_index(msg); }
+    int16_t end_index() const { return mavlink_msg_mission_write_partial_list_get_end_index(msg); }
+    uint8_t target_system() const { return mavlink_msg_mission_write_partial_list_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_mission_write_partial_list_get_target_component(msg); }
+};
+
+struct Named_Value_Float_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_NAMED_VALUE_FLOAT;
+    const mavlink_message_t *msg;
+    explicit Named_Value_Float_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_named_value_float_t &out) const { mavlink_msg_named_value_float_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_named_value_float_get_time_boot_ms(msg); }
+    float value() const { return mavlink_msg_named_value_float_get_value(msg); }
+    static const uint16_t name_len = 10;
+    const char *name() const { return (const char *)(_MAV_PAYLOAD(msg) + 8); }
+};
+
+struct Named_Value_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_NAMED_VALUE_INT;
+    const mavlink_message_t *msg;
+    explicit Named_Value_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_named_value_int_t &out) const { mavlink_msg_named_value_int_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_named_value_int_get_time_boot_ms(msg); }
+    int32_t value() const { return mavlink_msg_named_value_int_get_value(msg); }
+    static const uint16_t name_len = 10;
+    const char *name() const { return (const char *)(_MAV_PAYLOAD(msg) + 8); }
+};
+
+struct Nav_Controller_Output_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT;
+    const mavlink_message_t *msg;
+    explicit Nav_Controller_Output_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_nav_controller_output_t &out) const { mavlink_msg_nav_controller_output_decode(msg, &out); }
+    float nav_roll() const { return mavlink_msg_nav_controller_output_get_nav_roll(msg); }
+    float nav_pitch() const { return mavlink_msg_nav_controller_output_get_nav_pitch(msg); }
+    float alt_error() const { return mavlink_msg_nav_controller_output_get_alt_error(msg); }
+    float aspd_error() const { return mavlink_msg_nav_controller_output_get_aspd_error(msg); }
+    float xtrack_error() const { return mavlink_msg_nav_controller_output_get_xtrack_error(msg); }
+    int16_t nav_bearing() const { return mavlink_msg_nav_controller_output_get_nav_bearing(msg); }
+    int16_t target_bearing() const { return mavlink_msg_nav_controller_output_get_target_bearing(msg); }
+    uint16_t wp_dist() const { return mavlink_msg_nav_controller_output_get_wp_dist(msg); }
+};
+
+struct Optical_Flow_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_OPTICAL_FLOW;
+    const mavlink_message_t *msg;
+    explicit Optical_Flow_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_optical_flow_t &out) const { mavlink_msg_optical_flow_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_optical_flow_get_time_usec(msg); }
+    float flow_comp_m_x() const { return mavlink_msg_optical_flow_get_flow_comp_m_x(msg); }
+    float flow_comp_m_y() const { return mavlink_msg_optical_flow_get_flow_comp_m_y(msg); }
+    float ground_distance() const { return mavlink_msg_optical_flow_get_ground_distance(msg); }
+    int16_t flow_x() const { return mavlink_msg_optical_flow_get_flow_x(msg); }
+    int16_t flow_y() const { return mavlink_msg_optical_flow_get_flow_y(msg); }
+    uint8_t sensor_id() const { return mavlink_msg_optical_flow_get_sensor_id(msg); }
+    uint8_t quality() const { return mavlink_msg_optical_flow_get_quality(msg); }
+};
+
+struct Optical_Flow_Rad_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_OPTICAL_FLOW_RAD;
+    const mavlink_message_t *msg;
+    explicit Optical_Flow_Rad_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_optical_flow_rad_t &out) const { mavlink_msg_optical_flow_rad_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_optical_flow_rad_get_time_usec(msg); }
+    uint32_t integration_time_us() const { return mavlink_msg_optical_flow_rad_get_integration_time_us(msg); }
+    float integrated_x() const { return mavlink_msg_optical_flow_rad_get_integrated_x(msg); }
+    float integrated_y() const { return mavlink_msg_optical_flow_rad_get_integrated_y(msg); }
+    float integrated_xgyro() const { return mavlink_msg_optical_flow_rad_get_integrated_xgyro(msg); }
+    float integrated_ygyro() const { return mavlink_msg_optical_flow_rad_get_integrated_ygyro(msg); }
+    float integrated_zgyro() const { return mavlink_msg_optical_flow_rad_get_integrated_zgyro(msg); }
+    uint32_t time_delta_distance_us() const { return mavlink_msg_optical_flow_rad_get_time_delta_distance_us(msg); }
+    float distance() const { return mavlink_msg_optical_flow_rad_get_distance(msg); }
+    int16_t temperature() const { return mavlink_msg_optical_flow_rad_get_temperature(msg); }
+    uint8_t sensor_id() const { return mavlink_msg_optical_flow_rad_get_sensor_id(msg); }
+    uint8_t quality() const { return mavlink_msg_optical_flow_rad_get_quality(msg); }
+};
+
+struct Param_Map_Rc_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_PARAM_MAP_RC;
+    const mavlink_message_t *msg;
+    explicit Param_Map_Rc_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_param_map_rc_t &out) const { mavlink_msg_param_map_rc_decode(msg, &out); }
+    float param_value0() const { return mavlink_msg_param_map_rc_get_param_value0(msg); }
+    float scale() const { return mavlink_msg_param_map_rc_get_scale(msg); }
+    float param_value_min() const { return mavlink_msg_param_map_rc_get_param_value_min(msg); }
+    float param_value_max() const { return mavlink_msg_param_map_rc_get_param_value_max(msg); }
+    int16_t param_index() const { return mavlink_msg_param_map_rc_get_param_index(msg); }
+    uint8_t target_system() const { return mavlink_msg_param_map_rc_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_param_map_rc_get_target_component(msg); }
+    static const uint16_t param_id_len = 16;
+    const char *param_id() const { return (const char *)(_MAV_PAYLOAD(msg) + 20); }
+    uint8_t parameter_rc_channel_index() const { return mavlink_msg_param_map_rc_get_parameter_rc_channel_index(msg); }
+};
+
+struct Param_Request_List_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_PARAM_REQUEST_LIST;
+    const mavlink_message_t *msg;
+    explicit Param_Request_List_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_param_request_list_t &out) const { mavlink_msg_param_request_list_decode(msg, &out); }
+    uint8_t target_system() const { return mavlink_msg_param_request_list_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_param_request_list_get_target_component(msg); }
+};
+
+struct Param_Request_Read_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_PARAM_REQUEST_READ;
+    const mavlink_message_t *msg;
+    explicit Param_Request_Read_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_param_request_read_t &out) const { mavlink_msg_param_request_read_decode(msg, &out); }
+    int16_t param_index() const { return mavlink_msg_param_request_read_get_param_index(msg); }
+    uint8_t target_system() const { return mavlink_msg_param_request_read_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_param_request_read_get_target_component(msg); }
+    static const uint16_t param_id_len = 16;
+    const char *param_id() const { return (const char *)(_MAV_PAYLOAD(msg) + 4); }
+};
+
+struct Param_Set_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_PARAM_SET;
+    const mavlink_message_t *msg;
+    explicit Param_Set_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_param_set_t &out) const { mavlink_msg_param_set_decode(msg, &out); }
+    float param_value() const { return mavlink_msg_param_set_get_param_value(msg); }
+    uint8_t target_system() const { return mavlink_msg_param_set_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_param_set_get_target_component(msg); }
+    static const uint16_t param_id_len = 16;
+    const char *param_id() const { return (const char *)(_MAV_PAYLOAD(msg) + 6); }
+    uint8_t param_type() const { return mavlink_msg_param_set_get_param_type(msg); }
+};
+
+struct Param_Value_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_PARAM_VALUE;
+    const mavlink_message_t *msg;
+    explicit Param_Value_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_param_value_t &out) const { mavlink_msg_param_value_decode(msg, &out); }
+    float param_value() const { return mavlink_msg_param_value_get_param_value(msg); }
+    uint16_t param_count() const { return mavlink_msg_param_value_get_param_count(msg); }
+    uint16_t param_index() const { return mavlink_msg_param_value_get_param_index(msg); }
+    static const uint16_t param_id_len = 16;
+    const char *param_id() const { return (const char *)(_MAV_PAYLOAD(msg) + 8); }
+    uint8_t param_type() const { return mavlink_msg_param_value_get_param_type(msg); }
+};
+
+struct Ping_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_PING;
+    const mavlink_message_t *msg;
+    explicit Ping_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_ping_t &out) const { mavlink_msg_ping_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_ping_get_time_usec(msg); }
+    uint32_t seq() const { return mavlink_msg_ping_get_seq(msg); }
+    uint8_t target_system() const { return mavlink_msg_ping_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_ping_get_target_component(msg); }
+};
+
+struct Position_Target_Global_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT;
+    const mavlink_message_t *msg;
+    explicit Position_Target_Global_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_position_target_global_int_t &out) const { mavlink_msg_position_target_global_int_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_position_target_global_int_get_time_boot_ms(msg); }
+    int32_t lat_int() const { return mavlink_msg_position_target_global_int_get_lat_int(msg); }
+    int32_t lon_int() const { return mavlink_msg_position_target_global_int_get_lon_int(msg); }
+    float alt() const { return mavlink_msg_position_target_global_int_get_alt(msg); }
+    float vx() const { return mavlink_msg_position_target_global_int_get_vx(msg); }
+    float vy() const { return mavlink_msg_position_target_global_int_get_vy(msg); }
+    float vz() const { return mavlink_msg_position_target_global_int_get_vz(msg); }
+    float afx() const { return mavlink_msg_position_target_global_int_get_afx(msg); }
+    float afy() const { return mavlink_msg_position_target_global_int_get_afy(msg); }
+    float afz() const { return mavlink_msg_position_target_global_int_get_afz(msg); }
+    float yaw() const { return mavlink_msg_position_target_global_int_get_yaw(msg); }
+    float yaw_rate() const { return mavlink_msg_position_target_global_int_get_yaw_rate(msg); }
+    uint16_t type_mask() const { return mavlink_msg_position_target_global_int_get_type_mask(msg); }
+    uint8_t coordinate_frame() const { return mavlink_msg_position_target_global_int_get_coordinate_frame(msg); }
+};
+
+struct Position_Target_Local_Ned_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED;
+    const mavlink_message_t *msg;
+    explicit Position_Target_Local_Ned_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_position_target_local_ned_t &out) const { mavlink_msg_position_target_local_ned_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_position_target_local_ned_get_time_boot_ms(msg); }
+    float x() const { return mavlink_msg_position_target_local_ned_get_x(msg); }
+    float y() const { return mavlink_msg_position_target_local_ned_get_y(msg); }
+    float z() const { return mavlink_msg_position_target_local_ned_get_z(msg); }
+    float vx() const { return mavlink_msg_position_target_local_ned_get_vx(msg); }
+    float vy() const { return mavlink_msg_position_target_local_ned_get_vy(msg); }
+    float vz() const { return mavlink_msg_position_target_local_ned_get_vz(msg); }
+    float afx() const { return mavlink_msg_position_target_local_ned_get_afx(msg); }
+    float afy() const { return mavlink_msg_position_target_local_ned_get_afy(msg); }
+    float afz() const { return mavlink_msg_position_target_local_ned_get_afz(msg); }
+    float yaw() const { return mavlink_msg_position_target_local_ned_get_yaw(msg); }
+    float yaw_rate() const { return mavlink_msg_position_target_local_ned_get_yaw_rate(msg); }
+    uint16_t type_mask() const { return mavlink_msg_position_target_local_ned_get_type_mask(msg); }
+    uint8_t coordinate_frame() const { return mavlink_msg_position_target_local_ned_get_coordinate_frame(msg); }
+};
+
+struct Power_Status_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_POWER_STATUS;
+    const mavlink_message_t *msg;
+    explicit Power_Status_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_power_status_t &out) const { mavlink_msg_power_status_decode(msg, &out); }
+    uint16_t Vcc() const { return mavlink_msg_power_status_get_Vcc(msg); }
+    uint16_t Vservo() const { return mavlink_msg_power_status_get_Vservo(msg); }
+    uint16_t flags() const { return mavlink_msg_power_status_get_flags(msg); }
+};
+
+struct Radio_Status_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RADIO_STATUS;
+    const mavlink_message_t *msg;
+    explicit Radio_Status_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_radio_status_t &out) const { mavlink_msg_radio_status_decode(msg, &out); }
+    uint16_t rxerrors() const { return mavlink_msg_radio_status_get_rxerrors(msg); }
+    uint16_t fixed() const { return mavlink_msg_radio_status_get_fixed(msg); }
+    uint8_t rssi() const { return mavlink_msg_radio_status_get_rssi(msg); }
+    uint8_t remrssi() const { return mavlink_msg_radio_status_get_remrssi(msg); }
+    uint8_t txbuf() const { return mavlink_msg_radio_status_get_txbuf(msg); }
+    uint8_t noise() const { return mavlink_msg_radio_status_get_noise(msg); }
+    uint8_t remnoise() const { return mavlink_msg_radio_status_get_remnoise(msg); }
+};
+
+struct Raw_Imu_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RAW_IMU;
+    const mavlink_message_t *msg;
+    explicit Raw_Imu_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_raw_imu_t &out) const { mavlink_msg_raw_imu_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_raw_imu_get_time_usec(msg); }
+    int16_t xacc() const { return mavlink_msg_raw_imu_get_xacc(msg); }
+    int16_t yacc() const { return mavlink_msg_raw_imu_get_yacc(msg); }
+    int16_t zacc() const { return mavlink_msg_raw_imu_get_zacc(msg); }
+    int16_t xgyro() const { return mavlink_msg_raw_imu_get_xgyro(msg); }
+    int16_t ygyro() const { return mavlink_msg_raw_imu_get_ygyro(msg); }
+    int16_t zgyro() const { return mavlink_msg_raw_imu_get_zgyro(msg); }
+    int16_t xmag() const { return mavlink_msg_raw_imu_get_xmag(msg); }
+    int16_t ymag() const { return mavlink_msg_raw_imu_get_ymag(msg); }
+    int16_t zmag() const { return mavlink_msg_raw_imu_get_zmag(msg); }
+};
+
+struct Raw_Pressure_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RAW_PRESSURE;
+    const mavlink_message_t *msg;
+    explicit Raw_Pressure_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_raw_pressure_t &out) const { mavlink_msg_raw_pressure_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_raw_pressure_get_time_usec(msg); }
+    int16_t press_abs() const { return mavlink_msg_raw_pressure_get_press_abs(msg); }
+    int16_t press_diff1() const { return mavlink_msg_raw_pressure_get_press_diff1(msg); }
+    int16_t press_diff2() const { return mavlink_msg_raw_pressure_get_press_diff2(msg); }
+    int16_t temperature() const { return mavlink_msg_raw_pressure_get_temperature(msg); }
+};
+
+struct Rc_Channels_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RC_CHANNELS;
+    const mavlink_message_t *msg;
+    explicit Rc_Channels_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_rc_channels_t &out) const { mavlink_msg_rc_channels_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_rc_channels_get_time_boot_ms(msg); }
+    uint16_t chan1_raw() const { return mavlink_msg_rc_channels_get_chan1_raw(msg); }
+    uint16_t chan2_raw() const { return mavlink_msg_rc_channels_get_chan2_raw(msg); }
+    uint16_t chan3_raw() const { return mavlink_msg_rc_channels_get_chan3_raw(msg); }
+    uint16_t chan4_raw() const { return mavlink_msg_rc_channels_get_chan4_raw(msg); }
+    uint16_t chan5_raw() const { return mavlink_msg_rc_channels_get_chan5_raw(msg); }
+    uint16_t chan6_raw() const { return mavlink_msg_rc_channels_get_chan6_raw(msg); }
+    uint16_t chan7_raw() const { return mavlink_msg_rc_channels_get_chan7_raw(msg); }
+    uint16_t chan8_raw() const { return mavlink_msg_rc_channels_get_chan8_raw(msg); }
+    uint16_t chan9_raw() const { return mavlink_msg_rc_channels_get_chan9_raw(msg); }
+    uint16_t chan10_raw() const { return mavlink_msg_rc_channels_get_chan10_raw(msg); }
+    uint16_t chan11_raw() const { return mavlink_msg_rc_channels_get_chan11_raw(msg); }
+    uint16_t chan12_raw() const { return mavlink_msg_rc_channels_get_chan12_raw(msg); }
+    uint16_t chan13_raw() const { return mavlink_msg_rc_channels_get_chan13_raw(msg); }
+    uint16_t chan14_raw() const { return mavlink_msg_rc_channels_get_chan14_raw(msg); }
+    uint16_t chan15_raw() const { return mavlink_msg_rc_channels_get_chan15_raw(msg); }
+    uint16_t chan16_raw() const { return mavlink_msg_rc_channels_get_chan16_raw(msg); }
+    uint16_t chan17_raw() const { return mavlink_msg_rc_channels_get_chan17_raw(msg); }
+    uint16_t chan18_raw() const { return mavlink_msg_rc_channels_get_chan18_raw(msg); }
+    uint8_t chancount() const { return mavlink_msg_rc_channels_get_chancount(msg); }
+    uint8_t rssi() const { return mavlink_msg_rc_channels_get_rssi(msg); }
+};
+
+struct Rc_Channels_Override_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE;
+    const mavlink_message_t *msg;
+    explicit Rc_Channels_Override_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_rc_channels_override_t &out) const { mavlink_msg_rc_channels_override_decode(msg, &out); }
+    uint16_t chan1_raw() const { return mavlink_msg_rc_channels_override_get_chan1_raw(msg); }
+    uint16_t chan2_raw() const { return mavlink_msg_rc_channels_override_get_chan2_raw(msg); }
+    uint16_t chan3_raw() const { return mavlink_msg_rc_channels_override_get_chan3_raw(msg); }
+    uint16_t chan4_raw() const { return mavlink_msg_rc_channels_override_get_chan4_raw(msg); }
+    uint16_t chan5_raw() const { return mavlink_msg_rc_channels_override_get_chan5_raw(msg); }
+    uint16_t chan6_raw() const { return mavlink_msg_rc_channels_override_get_chan6_raw(msg); }
+    uint16_t chan7_raw() const { return mavlink_msg_rc_channels_override_get_chan7_raw(msg); }
+    uint16_t chan8_raw() const { return mavlink_msg_rc_channels_override_get_chan8_raw(msg); }
+    uint8_t target_system() const { return mavlink_msg_rc_channels_override_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_rc_channels_override_get_target_component(msg); }
+};
+
+struct Rc_Channels_Raw_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RC_CHANNELS_RAW;
+    const mavlink_message_t *msg;
+    explicit Rc_Channels_Raw_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_rc_channels_raw_t &out) const { mavlink_msg_rc_channels_raw_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_rc_channels_raw_get_time_boot_ms(msg); }
+    uint16_t chan1_raw() const { return mavlink_msg_rc_channels_raw_get_chan1_raw(msg); }
+    uint16_t chan2_raw() const { return mavlink_msg_rc_channels_raw_get_chan2_raw(msg); }
+    uint16_t chan3_raw() const { return mavlink_msg_rc_channels_raw_get_chan3_raw(msg); }
+    uint16_t chan4_raw() const { return mavlink_msg_rc_channels_raw_get_chan4_raw(msg); }
+    uint16_t chan5_raw() const { return mavlink_msg_rc_channels_raw_get_chan5_raw(msg); }
+    uint16_t chan6_raw() const { return mavlink_msg_rc_channels_raw_get_chan6_raw(msg); }
+    uint16_t chan7_raw() const { return mavlink_msg_rc_channels_raw_get_chan7_raw(msg); }
+    uint16_t chan8_raw() const { return mavlink_msg_rc_channels_raw_get_chan8_raw(msg); }
+    uint8_t port() const { return mavlink_msg_rc_channels_raw_get_port(msg); }
+    uint8_t rssi() const { return mavlink_msg_rc_channels_raw_get_rssi(msg); }
+};
+
+struct Rc_Channels_Scaled_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RC_CHANNELS_SCALED;
+    const mavlink_message_t *msg;
+    explicit Rc_Channels_Scaled_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_rc_channels_scaled_t &out) const { mavlink_msg_rc_channels_scaled_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_rc_channels_scaled_get_time_boot_ms(msg); }
+    int16_t chan1_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan1_scaled(msg); }
+    int16_t chan2_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan2_scaled(msg); }
+    int16_t chan3_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan3_scaled(msg); }
+    int16_t chan4_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan4_scaled(msg); }
+    int16_t chan5_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan5_scaled(msg); }
+    int16_t chan6_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan6_scaled(msg); }
+    int16_t chan7_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan7_scaled(msg); }
+    int16_t chan8_scaled() const { return mavlink_msg_rc_channels_scaled_get_chan8_scaled(msg); }
+    uint8_t port() const { return mavlink_msg_rc_channels_scaled_get_port(msg); }
+    uint8_t rssi() const { return mavlink_msg_rc_channels_scaled_get_rssi(msg); }
+};
+
+struct Request_Data_Stream_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_REQUEST_DATA_STREAM;
+    const mavlink_message_t *msg;
+    explicit Request_Data_Stream_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_request_data_stream_t &out) const { mavlink_msg_request_data_stream_decode(msg, &out); }
+    uint16_t req_message_rate() const { return mavlink_msg_request_data_stream_get_req_message_rate(msg); }
+    uint8_t target_system() const { return mavlink_msg_request_data_stream_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_request_data_stream_get_target_component(msg); }
+    uint8_t req_stream_id() const { return mavlink_msg_request_data_stream_get_req_stream_id(msg); }
+    uint8_t start_stop() const { return mavlink_msg_request_data_stream_get_start_stop(msg); }
+};
+
+struct Resource_Request_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_RESOURCE_REQUEST;
+    const mavlink_message_t *msg;
+    explicit Resource_Request_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_resource_request_t &out) const { mavlink_msg_resource_request_decode(msg, &out); }
+    uint8_t request_id() const { return mavlink_msg_resource_request_get_request_id(msg); }
+    uint8_t uri_type() const { return mavlink_msg_resource_request_get_uri_type(msg); }
+    static const uint16_t uri_len = 120;
+    const uint8_t *uri() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 2); }
+    uint8_t transfer_type() const { return mavlink_msg_resource_request_get_transfer_type(msg); }
+    static const uint16_t storage_len = 120;
+    const uint8_t *storage() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 123); }
+};
+
+struct Safety_Allowed_Area_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA;
+    const mavlink_message_t *msg;
+    explicit Safety_Allowed_Area_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_safety_allowed_area_t &out) const { mavlink_msg_safety_allowed_area_decode(msg, &out); }
+    float p1x() const { return mavlink_msg_safety_allowed_area_get_p1x(msg); }
+    float p1y() const { return mavlink_msg_safety_allowed_area_get_p1y(msg); }
+    float p1z() const { return mavlink_msg_safety_allowed_area_get_p1z(msg); }
+    float p2x() const { return mavlink_msg_safety_allowed_area_get_p2x(msg); }
+    float p2y() const { return mavlink_msg_safety_allowed_area_get_p2y(msg); }
+    float p2z() const { return mavlink_msg_safety_allowed_area_get_p2z(msg); }
+    uint8_t frame() const { return mavlink_msg_safety_allowed_area_get_frame(msg); }
+};
+
+struct Safety_Set_Allowed_Area_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA;
+    const mavlink_message_t *msg;
+    explicit Safety_Set_Allowed_Area_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_safety_set_allowed_area_t &out) const { mavlink_msg_safety_set_allowed_area_decode(msg, &out); }
+    float p1x() const { return mavlink_msg_safety_set_allowed_area_get_p1x(msg); }
+    float p1y() const { return mavlink_msg_safety_set_allowed_area_get_p1y(msg); }
+    float p1z() const { return mavlink_msg_safety_set_allowed_area_get_p1z(msg); }
+    float p2x() const { return mavlink_msg_safety_set_allowed_area_get_p2x(msg); }
+    float p2y() const { return mavlink_msg_safety_set_allowed_area_get_p2y(msg); }
+    float p2z() const { return mavlink_msg_safety_set_allowed_area_get_p2z(msg); }
+    uint8_t target_system() const { return mavlink_msg_safety_set_allowed_area_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_safety_set_allowed_area_get_target_component(msg); }
+    uint8_t frame() const { return mavlink_msg_safety_set_allowed_area_get_frame(msg); }
+};
+
+struct Scaled_Imu_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SCALED_IMU;
+    const mavlink_message_t *msg;
+    explicit Scaled_Imu_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_scaled_imu_t &out) const { mavlink_msg_scaled_imu_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_scaled_imu_get_time_boot_ms(msg); }
+    int16_t xacc() const { return mavlink_msg_scaled_imu_get_xacc(msg); }
+    int16_t yacc() const { return mavlink_msg_scaled_imu_get_yacc(msg); }
+    int16_t zacc() const { return mavlink_msg_scaled_imu_get_zacc(msg); }
+    int16_t xgyro() const { return mavlink_msg_scaled_imu_get_xgyro(msg); }
+    int16_t ygyro() const { return mavlink_msg_scaled_imu_get_ygyro(msg); }
+    int16_t zgyro() const { return mavlink_msg_scaled_imu_get_zgyro(msg); }
+    int16_t xmag() const { return mavlink_msg_scaled_imu_get_xmag(msg); }
+    int16_t ymag() const { return mavlink_msg_scaled_imu_get_ymag(msg); }
+    int16_t zmag() const { return mavlink_msg_scaled_imu_get_zmag(msg); }
+};
+
+struct Scaled_Imu2_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SCALED_IMU2;
+    const mavlink_message_t *msg;
+    explicit Scaled_Imu2_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_scaled_imu2_t &out) const { mavlink_msg_scaled_imu2_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_scaled_imu2_get_time_boot_ms(msg); }
+    int16_t xacc() const { return mavlink_msg_scaled_imu2_get_xacc(msg); }
+    int16_t yacc() const { return mavlink_msg_scaled_imu2_get_yacc(msg); }
+    int16_t zacc() const { return mavlink_msg_scaled_imu2_get_zacc(msg); }
+    int16_t xgyro() const { return mavlink_msg_scaled_imu2_get_xgyro(msg); }
+    int16_t ygyro() const { return mavlink_msg_scaled_imu2_get_ygyro(msg); }
+    int16_t zgyro() const { return mavlink_msg_scaled_imu2_get_zgyro(msg); }
+    int16_t xmag() const { return mavlink_msg_scaled_imu2_get_xmag(msg); }
+    int16_t ymag() const { return mavlink_msg_scaled_imu2_get_ymag(msg); }
+    int16_t zmag() const { return mavlink_msg_scaled_imu2_get_zmag(msg); }
+};
+
+struct Scaled_Imu3_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SCALED_IMU3;
+    const mavlink_message_t *msg;
+    explicit Scaled_Imu3_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_scaled_imu3_t &out) const { mavlink_msg_scaled_imu3_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_scaled_imu3_get_time_boot_ms(msg); }
+    int16_t xacc() const { return mavlink_msg_scaled_imu3_get_xacc(msg); }
+    int16_t yacc() const { return mavlink_msg_scaled_imu3_get_yacc(msg); }
+    int16_t zacc() const { return mavlink_msg_scaled_imu3_get_zacc(msg); }
+    int16_t xgyro() const { return mavlink_msg_scaled_imu3_get_xgyro(msg); }
+    int16_t ygyro() const { return mavlink_msg_scaled_imu3_get_ygyro(msg); }
+    int16_t zgyro() const { return mavlink_msg_scaled_imu3_get_zgyro(msg); }
+    int16_t xmag() const { return mavlink_msg_scaled_imu3_get_xmag(msg); }
+    int16_t ymag() const { return mavlink_msg_scaled_imu3_get_ymag(msg); }
+    int16_t zmag() const { return mavlink_msg_scaled_imu3_get_zmag(msg); }
+};
+
+struct Scaled_Pressure_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SCALED_PRESSURE;
+    const mavlink_message_t *msg;
+    explicit Scaled_Pressure_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_scaled_pressure_t &out) const { mavlink_msg_scaled_pressure_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_scaled_pressure_get_time_boot_ms(msg); }
+    float press_abs() const { return mavlink_msg_scaled_pressure_get_press_abs(msg); }
+    float press_diff() const { return mavlink_msg_scaled_pressure_get_press_diff(msg); }
+    int16_t temperature() const { return mavlink_msg_scaled_pressure_get_temperature(msg); }
+};
+
+struct Scaled_Pressure2_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SCALED_PRESSURE2;
+    const mavlink_message_t *msg;
+    explicit Scaled_Pressure2_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_scaled_pressure2_t &out) const { mavlink_msg_scaled_pressure2_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_scaled_pressure2_get_time_boot_ms(msg); }
+    float press_abs() const { return mavlink_msg_scaled_pressure2_get_press_abs(msg); }
+    float press_diff() const { return mavlink_msg_scaled_pressure2_get_press_diff(msg); }
+    int16_t temperature() const { return mavlink_msg_scaled_pressure2_get_temperature(msg); }
+};
+
+struct Scaled_Pressure3_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SCALED_PRESSURE3;
+    const mavlink_message_t *msg;
+    explicit Scaled_Pressure3_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_scaled_pressure3_t &out) const { mavlink_msg_scaled_pressure3_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_scaled_pressure3_get_time_boot_ms(msg); }
+    float press_abs() const { return mavlink_msg_scaled_pressure3_get_press_abs(msg); }
+    float press_diff() const { return mavlink_msg_scaled_pressure3_get_press_diff(msg); }
+    int16_t temperature() const { return mavlink_msg_scaled_pressure3_get_temperature(msg); }
+};
+
+struct Serial_Control_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SERIAL_CONTROL;
+    const mavlink_message_t *msg;
+    explicit Serial_Control_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_serial_control_t &out) const { mavlink_msg_serial_control_decode(msg, &out); }
+    uint32_t baudrate() const { return mavlink_msg_serial_control_get_baudrate(msg); }
+    uint16_t timeout() const { return mavlink_msg_serial_control_get_timeout(msg); }
+    uint8_t device() const { return mavlink_msg_serial_control_get_device(msg); }
+    uint8_t flags() const { return mavlink_msg_serial_control_get_flags(msg); }
+    uint8_t count() const { return mavlink_msg_serial_control_get_count(msg); }
+    static const uint16_t data_len = 70;
+    const uint8_t *data() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 9); }
+};
+
+struct Servo_Output_Raw_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SERVO_OUTPUT_RAW;
+    const mavlink_message_t *msg;
+    explicit Servo_Output_Raw_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_servo_output_raw_t &out) const { mavlink_msg_servo_output_raw_decode(msg, &out); }
+    uint32_t time_usec() const { return mavlink_msg_servo_output_raw_get_time_usec(msg); }
+    uint16_t servo1_raw() const { return mavlink_msg_servo_output_raw_get_servo1_raw(msg); }
+    uint16_t servo2_raw() const { return mavlink_msg_servo_output_raw_get_servo2_raw(msg); }
+    uint16_t servo3_raw() const { return mavlink_msg_servo_output_raw_get_servo3_raw(msg); }
+    uint16_t servo4_raw() const { return mavlink_msg_servo_output_raw_get_servo4_raw(msg); }
+    uint16_t servo5_raw() const { return mavlink_msg_servo_output_raw_get_servo5_raw(msg); }
+    uint16_t servo6_raw() const { return mavlink_msg_servo_output_raw_get_servo6_raw(msg); }
+    uint16_t servo7_raw() const { return mavlink_msg_servo_output_raw_get_servo7_raw(msg); }
+    uint16_t servo8_raw() const { return mavlink_msg_servo_output_raw_get_servo8_raw(msg); }
+    uint8_t port() const { return mavlink_msg_servo_output_raw_get_port(msg); }
+};
+
+struct Set_Actuator_Control_Target_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_ACTUATOR_CONTROL_TARGET;
+    const mavlink_message_t *msg;
+    explicit Set_Actuator_Control_Target_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_actuator_control_target_t &out) const { mavlink_msg_set_actuator_control_target_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_set_actuator_control_target_get_time_usec(msg); }
+    static const uint16_t controls_len = 8;
+    uint16_t controls(float *out) const { return mavlink_msg_set_actuator_control_target_get_controls(msg, out); }
+    uint8_t group_mlx() const { return mavlink_msg_set_actuator_control_target_get_group_mlx(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_actuator_control_target_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_set_actuator_control_target_get_target_component(msg); }
+};
+
+struct Set_Attitude_Target_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_ATTITUDE_TARGET;
+    const mavlink_message_t *msg;
+    explicit Set_Attitude_Target_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_attitude_target_t &out) const { mavlink_msg_set_attitude_target_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_set_attitude_target_get_time_boot_ms(msg); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_set_attitude_target_get_q(msg, out); }
+    float body_roll_rate() const { return mavlink_msg_set_attitude_target_get_body_roll_rate(msg); }
+    float body_pitch_rate() const { return mavlink_msg_set_attitude_target_get_body_pitch_rate(msg); }
+    float body_yaw_rate() const { return mavlink_msg_set_attitude_target_get_body_yaw_rate(msg); }
+    float thrust() const { return mavlink_msg_set_attitude_target_get_thrust(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_attitude_target_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_set_attitude_target_get_target_component(msg); }
+    uint8_t type_mask() const { return mavlink_msg_set_attitude_target_get_type_mask(msg); }
+};
+
+struct Set_Gps_Global_Origin_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN;
+    const mavlink_message_t *msg;
+    explicit Set_Gps_Global_Origin_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_gps_global_origin_t &out) const { mavlink_msg_set_gps_global_origin_decode(msg, &out); }
+    int32_t latitude() const { return mavlink_msg_set_gps_global_origin_get_latitude(msg); }
+    int32_t longitude() const { return mavlink_msg_set_gps_global_origin_get_longitude(msg); }
+    int32_t altitude() const { return mavlink_msg_set_gps_global_origin_get_altitude(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_gps_global_origin_get_target_system(msg); }
+};
+
+struct Set_Home_Position_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_HOME_POSITION;
+    const mavlink_message_t *msg;
+    explicit Set_Home_Position_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_home_position_t &out) const { mavlink_msg_set_home_position_decode(msg, &out); }
+    int32_t latitude() const { return mavlink_msg_set_home_position_get_latitude(msg); }
+    int32_t longitude() const { return mavlink_msg_set_home_position_get_longitude(msg); }
+    int32_t altitude() const { return mavlink_msg_set_home_position_get_altitude(msg); }
+    float x() const { return mavlink_msg_set_home_position_get_x(msg); }
+    float y() const { return mavlink_msg_set_home_position_get_y(msg); }
+    float z() const { return mavlink_msg_set_home_position_get_z(msg); }
+    static const uint16_t q_len = 4;
+    uint16_t q(float *out) const { return mavlink_msg_set_home_position_get_q(msg, out); }
+    float approach_x() const { return mavlink_msg_set_home_position_get_approach_x(msg); }
+    float approach_y() const { return mavlink_msg_set_home_position_get_approach_y(msg); }
+    float approach_z() const { return mavlink_msg_set_home_position_get_approach_z(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_home_position_get_target_system(msg); }
+};
+
+struct Set_Mode_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_MODE;
+    const mavlink_message_t *msg;
+    explicit Set_Mode_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_mode_t &out) const { mavlink_msg_set_mode_decode(msg, &out); }
+    uint32_t custom_mode() const { return mavlink_msg_set_mode_get_custom_mode(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_mode_get_target_system(msg); }
+    uint8_t base_mode() const { return mavlink_msg_set_mode_get_base_mode(msg); }
+};
+
+struct Set_Position_Target_Global_Int_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT;
+    const mavlink_message_t *msg;
+    explicit Set_Position_Target_Global_Int_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_position_target_global_int_t &out) const { mavlink_msg_set_position_target_global_int_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_set_position_target_global_int_get_time_boot_ms(msg); }
+    int32_t lat_int() const { return mavlink_msg_set_position_target_global_int_get_lat_int(msg); }
+    int32_t lon_int() const { return mavlink_msg_set_position_target_global_int_get_lon_int(msg); }
+    float alt() const { return mavlink_msg_set_position_target_global_int_get_alt(msg); }
+    float vx() const { return mavlink_msg_set_position_target_global_int_get_vx(msg); }
+    float vy() const { return mavlink_msg_set_position_target_global_int_get_vy(msg); }
+    float vz() const { return mavlink_msg_set_position_target_global_int_get_vz(msg); }
+    float afx() const { return mavlink_msg_set_position_target_global_int_get_afx(msg); }
+    float afy() const { return mavlink_msg_set_position_target_global_int_get_afy(msg); }
+    float afz() const { return mavlink_msg_set_position_target_global_int_get_afz(msg); }
+    float yaw() const { return mavlink_msg_set_position_target_global_int_get_yaw(msg); }
+    float yaw_rate() const { return mavlink_msg_set_position_target_global_int_get_yaw_rate(msg); }
+    uint16_t type_mask() const { return mavlink_msg_set_position_target_global_int_get_type_mask(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_position_target_global_int_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_set_position_target_global_int_get_target_component(msg); }
+    uint8_t coordinate_frame() const { return mavlink_msg_set_position_target_global_int_get_coordinate_frame(msg); }
+};
+
+struct Set_Position_Target_Local_Ned_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED;
+    const mavlink_message_t *msg;
+    explicit Set_Position_Target_Local_Ned_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_set_position_target_local_ned_t &out) const { mavlink_msg_set_position_target_local_ned_decode(msg, &out); }
+    uint32_t time_boot_ms() const { return mavlink_msg_set_position_target_local_ned_get_time_boot_ms(msg); }
+    float x() const { return mavlink_msg_set_position_target_local_ned_get_x(msg); }
+    float y() const { return mavlink_msg_set_position_target_local_ned_get_y(msg); }
+    float z() const { return mavlink_msg_set_position_target_local_ned_get_z(msg); }
+    float vx() const { return mavlink_msg_set_position_target_local_ned_get_vx(msg); }
+    float vy() const { return mavlink_msg_set_position_target_local_ned_get_vy(msg); }
+    float vz() const { return mavlink_msg_set_position_target_local_ned_get_vz(msg); }
+    float afx() const { return mavlink_msg_set_position_target_local_ned_get_afx(msg); }
+    float afy() const { return mavlink_msg_set_position_target_local_ned_get_afy(msg); }
+    float afz() const { return mavlink_msg_set_position_target_local_ned_get_afz(msg); }
+    float yaw() const { return mavlink_msg_set_position_target_local_ned_get_yaw(msg); }
+    float yaw_rate() const { return mavlink_msg_set_position_target_local_ned_get_yaw_rate(msg); }
+    uint16_t type_mask() const { return mavlink_msg_set_position_target_local_ned_get_type_mask(msg); }
+    uint8_t target_system() const { return mavlink_msg_set_position_target_local_ned_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_set_position_target_local_ned_get_target_component(msg); }
+    uint8_t coordinate_frame() const { return mavlink_msg_set_position_target_local_ned_get_coordinate_frame(msg); }
+};
+
+struct Sim_State_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SIM_STATE;
+    const mavlink_message_t *msg;
+    explicit Sim_State_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_sim_state_t &out) const { mavlink_msg_sim_state_decode(msg, &out); }
+    float q1() const { return mavlink_msg_sim_state_get_q1(msg); }
+    float q2() const { return mavlink_msg_sim_state_get_q2(msg); }
+    float q3() const { return mavlink_msg_sim_state_get_q3(msg); }
+    float q4() const { return mavlink_msg_sim_state_get_q4(msg); }
+    float roll() const { return mavlink_msg_sim_state_get_roll(msg); }
+    float pitch() const { return mavlink_msg_sim_state_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_sim_state_get_yaw(msg); }
+    float xacc() const { return mavlink_msg_sim_state_get_xacc(msg); }
+    float yacc() const { return mavlink_msg_sim_state_get_yacc(msg); }
+    float zacc() const { return mavlink_msg_sim_state_get_zacc(msg); }
+    float xgyro() const { return mavlink_msg_sim_state_get_xgyro(msg); }
+    float ygyro() const { return mavlink_msg_sim_state_get_ygyro(msg); }
+    float zgyro() const { return mavlink_msg_sim_state_get_zgyro(msg); }
+    float lat() const { return mavlink_msg_sim_state_get_lat(msg); }
+    float lon() const { return mavlink_msg_sim_state_get_lon(msg); }
+    float alt() const { return mavlink_msg_sim_state_get_alt(msg); }
+    float std_dev_horz() const { return mavlink_msg_sim_state_get_std_dev_horz(msg); }
+    float std_dev_vert() const { return mavlink_msg_sim_state_get_std_dev_vert(msg); }
+    float vn() const { return mavlink_msg_sim_state_get_vn(msg); }
+    float ve() const { return mavlink_msg_sim_state_get_ve(msg); }
+    float vd() const { return mavlink_msg_sim_state_get_vd(msg); }
+};
+
+struct Statustext_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_STATUSTEXT;
+    const mavlink_message_t *msg;
+    explicit Statustext_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_statustext_t &out) const { mavlink_msg_statustext_decode(msg, &out); }
+    uint8_t severity() const { return mavlink_msg_statustext_get_severity(msg); }
+    static const uint16_t text_len = 50;
+    const char *text() const { return (const char *)(_MAV_PAYLOAD(msg) + 1); }
+};
+
+struct Sys_Status_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SYS_STATUS;
+    const mavlink_message_t *msg;
+    explicit Sys_Status_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_sys_status_t &out) const { mavlink_msg_sys_status_decode(msg, &out); }
+    uint32_t onboard_control_sensors_present() const { return mavlink_msg_sys_status_get_onboard_control_sensors_present(msg); }
+    uint32_t onboard_control_sensors_enabled() const { return mavlink_msg_sys_status_get_onboard_control_sensors_enabled(msg); }
+    uint32_t onboard_control_sensors_health() const { return mavlink_msg_sys_status_get_onboard_control_sensors_health(msg); }
+    uint16_t load() const { return mavlink_msg_sys_status_get_load(msg); }
+    uint16_t voltage_battery() const { return mavlink_msg_sys_status_get_voltage_battery(msg); }
+    int16_t current_battery() const { return mavlink_msg_sys_status_get_current_battery(msg); }
+    uint16_t drop_rate_comm() const { return mavlink_msg_sys_status_get_drop_rate_comm(msg); }
+    uint16_t errors_comm() const { return mavlink_msg_sys_status_get_errors_comm(msg); }
+    uint16_t errors_count1() const { return mavlink_msg_sys_status_get_errors_count1(msg); }
+    uint16_t errors_count2() const { return mavlink_msg_sys_status_get_errors_count2(msg); }
+    uint16_t errors_count3() const { return mavlink_msg_sys_status_get_errors_count3(msg); }
+    uint16_t errors_count4() const { return mavlink_msg_sys_status_get_errors_count4(msg); }
+    int8_t battery_remaining() const { return mavlink_msg_sys_status_get_battery_remaining(msg); }
+};
+
+struct System_Time_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_SYSTEM_TIME;
+    const mavlink_message_t *msg;
+    explicit System_Time_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_system_time_t &out) const { mavlink_msg_system_time_decode(msg, &out); }
+    uint64_t time_unix_usec() const { return mavlink_msg_system_time_get_time_unix_usec(msg); }
+    uint32_t time_boot_ms() const { return mavlink_msg_system_time_get_time_boot_ms(msg); }
+};
+
+struct Terrain_Check_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_TERRAIN_CHECK;
+    const mavlink_message_t *msg;
+    explicit Terrain_Check_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_terrain_check_t &out) const { mavlink_msg_terrain_check_decode(msg, &out); }
+    int32_t lat() const { return mavlink_msg_terrain_check_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_terrain_check_get_lon(msg); }
+};
+
+struct Terrain_Data_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_TERRAIN_DATA;
+    const mavlink_message_t *msg;
+    explicit Terrain_Data_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_terrain_data_t &out) const { mavlink_msg_terrain_data_decode(msg, &out); }
+    int32_t lat() const { return mavlink_msg_terrain_data_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_terrain_data_get_lon(msg); }
+    uint16_t grid_spacing() const { return mavlink_msg_terrain_data_get_grid_spacing(msg); }
+    static const uint16_t data_len = 16;
+    uint16_t data(int16_t *out) const { return mavlink_msg_terrain_data_get_data(msg, out); }
+    uint8_t gridbit() const { return mavlink_msg_terrain_data_get_gridbit(msg); }
+};
+
+struct Terrain_Report_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_TERRAIN_REPORT;
+    const mavlink_message_t *msg;
+    explicit Terrain_Report_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_terrain_report_t &out) const { mavlink_msg_terrain_report_decode(msg, &out); }
+    int32_t lat() const { return mavlink_msg_terrain_report_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_terrain_report_get_lon(msg); }
+    float terrain_height() const { return mavlink_msg_terrain_report_get_terrain_height(msg); }
+    float current_height() const { return mavlink_msg_terrain_report_get_current_height(msg); }
+    uint16_t spacing() const { return mavlink_msg_terrain_report_get_spacing(msg); }
+    uint16_t pending() const { return mavlink_msg_terrain_report_get_pending(msg); }
+    uint16_t loaded() const { return mavlink_msg_terrain_report_get_loaded(msg); }
+};
+
+struct Terrain_Request_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_TERRAIN_REQUEST;
+    const mavlink_message_t *msg;
+    explicit Terrain_Request_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_terrain_request_t &out) const { mavlink_msg_terrain_request_decode(msg, &out); }
+    uint64_t mask() const { return mavlink_msg_terrain_request_get_mask(msg); }
+    int32_t lat() const { return mavlink_msg_terrain_request_get_lat(msg); }
+    int32_t lon() const { return mavlink_msg_terrain_request_get_lon(msg); }
+    uint16_t grid_spacing() const { return mavlink_msg_terrain_request_get_grid_spacing(msg); }
+};
+
+struct Timesync_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_TIMESYNC;
+    const mavlink_message_t *msg;
+    explicit Timesync_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_timesync_t &out) const { mavlink_msg_timesync_decode(msg, &out); }
+    int64_t tc1() const { return mavlink_msg_timesync_get_tc1(msg); }
+    int64_t ts1() const { return mavlink_msg_timesync_get_ts1(msg); }
+};
+
+struct V2_Extension_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_V2_EXTENSION;
+    const mavlink_message_t *msg;
+    explicit V2_Extension_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_v2_extension_t &out) const { mavlink_msg_v2_extension_decode(msg, &out); }
+    uint16_t message_type() const { return mavlink_msg_v2_extension_get_message_type(msg); }
+    uint8_t target_network() const { return mavlink_msg_v2_extension_get_target_network(msg); }
+    uint8_t target_system() const { return mavlink_msg_v2_extension_get_target_system(msg); }
+    uint8_t target_component() const { return mavlink_msg_v2_extension_get_target_component(msg); }
+    static const uint16_t payload_len = 249;
+    const uint8_t *payload() const { return (const uint8_t *)(_MAV_PAYLOAD(msg) + 5); }
+};
+
+struct Vfr_Hud_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_VFR_HUD;
+    const mavlink_message_t *msg;
+    explicit Vfr_Hud_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_vfr_hud_t &out) const { mavlink_msg_vfr_hud_decode(msg, &out); }
+    float airspeed() const { return mavlink_msg_vfr_hud_get_airspeed(msg); }
+    float groundspeed() const { return mavlink_msg_vfr_hud_get_groundspeed(msg); }
+    float alt() const { return mavlink_msg_vfr_hud_get_alt(msg); }
+    float climb() const { return mavlink_msg_vfr_hud_get_climb(msg); }
+    int16_t heading() const { return mavlink_msg_vfr_hud_get_heading(msg); }
+    uint16_t throttle() const { return mavlink_msg_vfr_hud_get_throttle(msg); }
+};
+
+struct Vibration_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_VIBRATION;
+    const mavlink_message_t *msg;
+    explicit Vibration_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_vibration_t &out) const { mavlink_msg_vibration_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_vibration_get_time_usec(msg); }
+    float vibration_x() const { return mavlink_msg_vibration_get_vibration_x(msg); }
+    float vibration_y() const { return mavlink_msg_vibration_get_vibration_y(msg); }
+    float vibration_z() const { return mavlink_msg_vibration_get_vibration_z(msg); }
+    uint32_t clipping_0() const { return mavlink_msg_vibration_get_clipping_0(msg); }
+    uint32_t clipping_1() const { return mavlink_msg_vibration_get_clipping_1(msg); }
+    uint32_t clipping_2() const { return mavlink_msg_vibration_get_clipping_2(msg); }
+};
+
+struct Vicon_Position_Estimate_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE;
+    const mavlink_message_t *msg;
+    explicit Vicon_Position_Estimate_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_vicon_position_estimate_t &out) const { mavlink_msg_vicon_position_estimate_decode(msg, &out); }
+    uint64_t usec() const { return mavlink_msg_vicon_position_estimate_get_usec(msg); }
+    float x() const { return mavlink_msg_vicon_position_estimate_get_x(msg); }
+    float y() const { return mavlink_msg_vicon_position_estimate_get_y(msg); }
+    float z() const { return mavlink_msg_vicon_position_estimate_get_z(msg); }
+    float roll() const { return mavlink_msg_vicon_position_estimate_get_roll(msg); }
+    float pitch() const { return mavlink_msg_vicon_position_estimate_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_vicon_position_estimate_get_yaw(msg); }
+};
+
+struct Vision_Position_Estimate_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE;
+    const mavlink_message_t *msg;
+    explicit Vision_Position_Estimate_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_vision_position_estimate_t &out) const { mavlink_msg_vision_position_estimate_decode(msg, &out); }
+    uint64_t usec() const { return mavlink_msg_vision_position_estimate_get_usec(msg); }
+    float x() const { return mavlink_msg_vision_position_estimate_get_x(msg); }
+    float y() const { return mavlink_msg_vision_position_estimate_get_y(msg); }
+    float z() const { return mavlink_msg_vision_position_estimate_get_z(msg); }
+    float roll() const { return mavlink_msg_vision_position_estimate_get_roll(msg); }
+    float pitch() const { return mavlink_msg_vision_position_estimate_get_pitch(msg); }
+    float yaw() const { return mavlink_msg_vision_position_estimate_get_yaw(msg); }
+};
+
+struct Vision_Speed_Estimate_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE;
+    const mavlink_message_t *msg;
+    explicit Vision_Speed_Estimate_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_vision_speed_estimate_t &out) const { mavlink_msg_vision_speed_estimate_decode(msg, &out); }
+    uint64_t usec() const { return mavlink_msg_vision_speed_estimate_get_usec(msg); }
+    float x() const { return mavlink_msg_vision_speed_estimate_get_x(msg); }
+    float y() const { return mavlink_msg_vision_speed_estimate_get_y(msg); }
+    float z() const { return mavlink_msg_vision_speed_estimate_get_z(msg); }
+};
+
+struct Wind_Cov_View
+{
+    static const uint8_t MSG_ID = MAVLINK_MSG_ID_WIND_COV;
+    const mavlink_message_t *msg;
+    explicit Wind_Cov_View(const mavlink_message_t &message) : msg(&message) {}
+    void decode(mavlink_wind_cov_t &out) const { mavlink_msg_wind_cov_decode(msg, &out); }
+    uint64_t time_usec() const { return mavlink_msg_wind_cov_get_time_usec(msg); }
+    float wind_x() const { return mavlink_msg_wind_cov_get_wind_x(msg); }
+    float wind_y() const { return mavlink_msg_wind_cov_get_wind_y(msg); }
+    float wind_z() const { return mavlink_msg_wind_cov_get_wind_z(msg); }
+    float var_horiz() const { return mavlink_msg_wind_cov_get_var_horiz(msg); }
+    float var_vert() const { return mavlink_msg_wind_cov_get_var_vert(msg); }
+    float wind_alt() const { return mavlink_msg_wind_cov_get_wind_alt(msg); }
+    float horiz_accuracy() const { return mavlink_msg_wind_cov_get_horiz_accuracy(msg); }
+    float vert_accuracy() const { return mavlink_msg_wind_cov_get_vert_accuracy(msg); }
+};
+
+#endif // MAVLINK_VIEWS_H_
@@ -0,0 +1,413 @@
+/**
+ * @file metrics.cpp
+ *
+ * @brief Runtime counters, gauges and latency histograms for all threads
+ *
+ */
+
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "mavlink/common/mavlink.h"
+
+
+Metrics metrics;
+
+
+uint64_t
+metrics_now_usec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Metric_Histogram
+// ------------------------------------------------------------------------------
+Metric_Histogram::
+Metric_Histogram() : count(0), sum(0), max(0)
+{
+    for (int i = 0; i < METRIC_HIST_BUCKETS; i++)
+        buckets[i].store(0, std::memory_order_relaxed);
+}
+
+// 小于 2*SUB 的值各占一个桶; 其余按最高位所在的 2 的幂区间分组, 组内按其后 SUB_BITS 位线性分桶
+int
+Metric_Histogram::
+bucket_of(uint64_t v)
+{
+    if (v < 2 * METRIC_HIST_SUB)
+        return (int)v;
+    int msb = 63 - __builtin_clzll(v);
+    int shift = msb - METRIC_HIST_SUB_BITS;
+    int index = 2 * METRIC_HIST_SUB + (msb - METRIC_HIST_SUB_BITS - 1) * METRIC_HIST_SUB
+                + (int)(v >> shift) - METRIC_HIST_SUB;
+    return index < METRIC_HIST_BUCKETS ? index : METRIC_HIST_BUCKETS - 1;
+}
+
+uint64_t
+Metric_Histogram::
+bucket_high(int index)
+{
+    if (index < 2 * METRIC_HIST_SUB)
+        return index;
+    int group = (index - 2 * METRIC_HIST_SUB) / METRIC_HIST_SUB;
+    int msb = group + METRIC_HIST_SUB_BITS + 1;
+    uint64_t m = METRIC_HIST_SUB + (index - 2 * METRIC_HIST_SUB) % METRIC_HIST_SUB;
+    int shift = msb - METRIC_HIST_SUB_BITS;
+    return ((m + 1) << shift) - 1;
+}
+
+void
+Metric_Histogram::
+record(uint64_t v)
+{
+    buckets[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(v, std::memory_order_relaxed);
+    uint64_t m = max.load(std::memory_order_relaxed);
+    while (v > m && !max.compare_exchange_weak(m, v, std::memory_order_relaxed))
+        ;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Metrics::
+Metrics() : n_counters(0), n_gauges(0), n_histograms(0), n_ages(0), last_usec(0),
+            period_ms(1000), listen_fd(-1), time_to_exit(false), running(false), snapshot_tid(0)
+{
+    pthread_mutex_init(&lock, NULL);
+    memset(last_counters, 0, sizeof(last_counters));
+    memset(last_mavlink_rx, 0, sizeof(last_mavlink_rx));
+}
+
+Metrics::
+~Metrics()
+{
+    stop();
+    pthread_mutex_destroy(&lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   登记
+// ------------------------------------------------------------------------------
+// 登记时拷贝名字, 调用处可以传入临时字符串; 已登记的名字不再修改, 快照线程在锁外读取
+template <typename T>
+static T &
+find_or_add(pthread_mutex_t &lock, const char *name, std::string *names, T *items, int &n, int capacity)
+{
+    pthread_mutex_lock(&lock);
+    int i;
+    for (i = 0; i < n; i++)
+        if (names[i] == name)
+            break;
+    if (i == n && n < capacity)
+        names[n++] = name;
+    pthread_mutex_unlock(&lock);
+    // 超出容量时返回最后一个备用项, 它不出现在快照中
+    return items[i < capacity ? i : capacity];
+}
+
+Metric_Counter &
+Metrics::
+counter(const char *name)
+{
+    return find_or_add(lock, name, counter_names, counters, n_counters, METRICS_MAX_COUNTERS);
+}
+
+Metric_Gauge &
+Metrics::
+gauge(const char *name)
+{
+    return find_or_add(lock, name, gauge_names, gauges, n_gauges, METRICS_MAX_GAUGES);
+}
+
+Metric_Histogram &
+Metrics::
+histogram(const char *name)
+{
+    return find_or_add(lock, name, histogram_names, histograms, n_histograms, METRICS_MAX_HISTOGRAMS);
+}
+
+Metric_Age &
+Metrics::
+age(const char *name)
+{
+    return find_or_add(lock, name, age_names, ages, n_ages, METRICS_MAX_AGES);
+}
+
+
+// ------------------------------------------------------------------------------
+//   快照
+// ------------------------------------------------------------------------------
+static void
+append(std::string &out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void
+append(std::string &out, const char *fmt, ...)
+{
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    out += buf;
+}
+
+static uint64_t
+histogram_percentile(const uint32_t *counts, uint64_t total, uint64_t max, double p)
+{
+    uint64_t rank = (uint64_t)(p / 100.0 * total + 0.5);
+    if (rank == 0)
+        rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < METRIC_HIST_BUCKETS; i++)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            // 桶上界不超过实际最大值
+            uint64_t high = Metric_Histogram::bucket_high(i);
+            return high < max ? high : max;
+        }
+    }
+    return 0;
+}
+
+const char *
+mavlink_message_name(uint8_t msgid)
+{
+    struct Message_Name
+    {
+        const char *name;
+        uint32_t msgid;
+    };
+    static const Message_Name message_names[] = MAVLINK_MESSAGE_NAMES;
+    static const char *names_by_id[256];
+    if (!names_by_id[0])
+        for (size_t i = 0; i < sizeof(message_names) / sizeof(message_names[0]); i++)
+            names_by_id[message_names[i].msgid & 0xff] = message_names[i].name;
+    return names_by_id[msgid];
+}
+
+std::string
+Metrics::
+snapshot()
+{
+    uint64_t now = metrics_now_usec();
+    double dt = last_usec ? (now - last_usec) / 1e6 : 0;
+    last_usec = now;
+
+    pthread_mutex_lock(&lock);
+    int nc = n_counters, ng = n_gauges, nh = n_histograms, na = n_ages;
+    pthread_mutex_unlock(&lock);
+
+    std::string out;
+    append(out, "{\n  \"time_usec\": %llu,\n  \"interval_s\": %.3f,\n", (unsigned long long)now, dt);
+
+    out += "  \"counters\": {";
+    for (int i = 0; i < nc; i++)
+    {
+        uint64_t v = counters[i].get();
+        append(out, "%s\n    \"%s\": {\"total\": %llu, \"rate\": %.2f}", i ? "," : "", counter_names[i].c_str(),
+               (unsigned long long)v, dt > 0 ? (v - last_counters[i]) / dt : 0.0);
+        last_counters[i] = v;
+    }
+    out += "\n  },\n  \"mavlink_rx\": {";
+    bool first = true;
+    for (int id = 0; id < 256; id++)
+    {
+        uint64_t v = mavlink_rx[id].get();
+        if (v == 0)
+            continue;
+        if (mavlink_message_name(id))
+            append(out, "%s\n    \"%s\": {\"total\": %llu, \"rate\": %.2f}", first ? "" : ",", mavlink_message_name(id),
+                   (unsigned long long)v, dt > 0 ? (v - last_mavlink_rx[id]) / dt : 0.0);
+        else
+            append(out, "%s\n    \"%d\": {\"total\": %llu, \"rate\": %.2f}", first ? "" : ",", id,
+                   (unsigned long long)v, dt > 0 ? (v - last_mavlink_rx[id]) / dt : 0.0);
+        last_mavlink_rx[id] = v;
+        first = false;
+    }
+    out += "\n  },\n  \"gauges\": {";
+    for (int i = 0; i < ng; i++)
+        append(out, "%s\n    \"%s\": %g", i ? "," : "", gauge_names[i].c_str(), gauges[i].get());
+    out += "\n  },\n  \"ages_ms\": {";
+    for (int i = 0; i < na; i++)
+    {
+        uint64_t last = ages[i].last_usec.load(std::memory_order_relaxed);
+        if (last)
+            append(out, "%s\n    \"%s\": %.1f", i ? "," : "", age_names[i].c_str(), now > last ? (now - last) / 1e3 : 0.0);
+        else
+            append(out, "%s\n    \"%s\": null", i ? "," : "", age_names[i].c_str());
+    }
+    out += "\n  },\n  \"histograms\": {";
+    for (int i = 0; i < nh; i++)
+    {
+        Metric_Histogram &h = histograms[i];
+        // 先拷出各桶, 分位数在同一份数据上计算
+        uint32_t counts[METRIC_HIST_BUCKETS];
+        uint64_t total = 0;
+        for (int k = 0; k < METRIC_HIST_BUCKETS; k++)
+        {
+            counts[k] = h.buckets[k].load(std::memory_order_relaxed);
+            total += counts[k];
+        }
+        uint64_t sum = h.sum.load(std::memory_order_relaxed);
+        uint64_t max = h.max.load(std::memory_order_relaxed);
+        append(out, "%s\n    \"%s\": {\"count\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p90\": %llu, "
+                    "\"p99\": %llu, \"max\": %llu}",
+               i ? "," : "", histogram_names[i].c_str(), (unsigned long long)total, total ? (double)sum / total : 0.0,
+               (unsigned long long)histogram_percentile(counts, total, max, 50),
+               (unsigned long long)histogram_percentile(counts, total, max, 90),
+               (unsigned long long)histogram_percentile(counts, total, max, 99),
+               (unsigned long long)max);
+    }
+    out += "\n  }\n}\n";
+    return out;
+}
+
+
+// ------------------------------------------------------------------------------
+//   输出: 快照文件和 UNIX socket
+// ------------------------------------------------------------------------------
+void
+Metrics::
+write_file(const std::string &json)
+{
+    if (snapshot_path.empty())
+        return;
+    std::string tmp = snapshot_path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "w");
+    if (!f)
+        return;
+    fwrite(json.data(), 1, json.size(), f);
+    fclose(f);
+    rename(tmp.c_str(), snapshot_path.c_str());//读者总是看到完整的一份
+}
+
+void
+Metrics::
+serve_clients(const std::string &json)
+{
+    if (listen_fd < 0)
+        return;
+    int client;
+    while ((client = accept(listen_fd, NULL, NULL)) >= 0)
+    {
+        const char *p = json.data();
+        size_t left = json.size();
+        while (left > 0)
+        {
+            ssize_t n = send(client, p, left, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            p += n;
+            left -= n;
+        }
+        close(client);
+    }
+}
+
+static void *
+start_snapshot_thread(void *args)
+{
+    ((Metrics *)args)->snapshot_thread();
+    return NULL;
+}
+
+bool
+Metrics::
+start(const char *snapshot_path_, const char *socket_path_, int period_ms_)
+{
+    if (running)
+        return true;
+
+    snapshot_path = snapshot_path_ ? snapshot_path_ : "";
+    socket_path = socket_path_ ? socket_path_ : "";
+    period_ms = period_ms_ > 0 ? period_ms_ : 1000;
+
+    if (!socket_path.empty())
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(socket_path.c_str());
+
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listen_fd < 0 || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+            listen(listen_fd, 4) < 0)
+        {
+            fprintf(stderr, "WARNING: could not listen on metrics socket %s (%s)\n", socket_path.c_str(),
+                    strerror(errno));
+            if (listen_fd >= 0)
+                close(listen_fd);
+            listen_fd = -1;
+        }
+    }
+
+    time_to_exit = false;
+    if (pthread_create(&snapshot_tid, NULL, &start_snapshot_thread, this) != 0)
+    {
+        fprintf(stderr, "WARNING: could not start metrics thread\n");
+        return false;
+    }
+    running = true;
+    printf("METRICS snapshot %s every %d ms, socket %s\n", snapshot_path.c_str(), period_ms,
+           listen_fd >= 0 ? socket_path.c_str() : "(none)");
+    return true;
+}
+
+void
+Metrics::
+stop()
+{
+    if (!running)
+        return;
+    time_to_exit = true;
+    pthread_join(snapshot_tid, NULL);
+    running = false;
+
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        listen_fd = -1;
+        unlink(socket_path.c_str());
+    }
+}
+
+void
+Metrics::
+snapshot_thread()
+{
+    std::string json = snapshot();
+    uint64_t next = metrics_now_usec() + period_ms * 1000ULL;
+
+    // 每 50ms 检查一次新连接, 每个周期更新一次快照
+    while (!time_to_exit)
+    {
+        usleep(50000);
+        if (metrics_now_usec() >= next)
+        {
+            json = snapshot();
+            write_file(json);
+            next += period_ms * 1000ULL;
+        }
+        serve_clients(json);
+    }
+}
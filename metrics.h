@@ -0,0 +1,158 @@
+/**
+ * @file metrics.h
+ *
+ * @brief Runtime counters, gauges and latency histograms for all threads
+ *
+ * 各线程在热路径上只做一次 relaxed 原子加或存, 不加锁、不做系统调用;
+ * 后台线程每隔 period_ms 生成一份 JSON 快照 (计数器附带两次快照之间的速率,
+ * 直方图给出 count / mean / p50 / p90 / p99 / max), 写到快照文件 (先写临时文件再 rename),
+ * 并通过本地 UNIX socket 提供: 每个连接收到最新一份快照后即被关闭, 例如
+ *
+ *     socat - UNIX-CONNECT:/tmp/uav_metrics.sock
+ *     ssh uav 'socat - UNIX-CONNECT:/tmp/uav_metrics.sock'    # 地面站轮询
+ *
+ * 指标在第一次使用时按名字登记, 调用处用函数内的 static 引用缓存, 之后不再查找:
+ *
+ *     static Metric_Counter &frames = metrics.counter("vision.frames");
+ *     frames.add();
+ *
+ * 直方图为 HDR 式的对数-线性分桶, 每个 2 的幂区间分 8 个桶, 相对误差不超过 12.5%,
+ * 记录单位由名字后缀约定 (_us 为微秒).
+ *
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include <string>
+
+#define METRICS_MAX_COUNTERS   64
+#define METRICS_MAX_GAUGES     32
+#define METRICS_MAX_HISTOGRAMS 32
+#define METRICS_MAX_AGES       16
+
+#define METRICS_SNAPSHOT_FILE  "/tmp/uav_metrics.json"
+#define METRICS_SOCKET_PATH    "/tmp/uav_metrics.sock"
+
+
+// 单调时钟 (us), 只用于求时间差
+uint64_t metrics_now_usec();
+
+
+// ------------------------------------------------------------------------------
+//   指标类型
+// ------------------------------------------------------------------------------
+struct Metric_Counter
+{
+    std::atomic<uint64_t> value;
+    Metric_Counter() : value(0) {}
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct Metric_Gauge
+{
+    std::atomic<double> value;
+    Metric_Gauge() : value(0) {}
+    void set(double v) { value.store(v, std::memory_order_relaxed); }
+    double get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// 最近一次更新距今的时间, 快照中输出为 age_ms
+struct Metric_Age
+{
+    std::atomic<uint64_t> last_usec;
+    Metric_Age() : last_usec(0) {}
+    void touch() { last_usec.store(metrics_now_usec(), std::memory_order_relaxed); }
+};
+
+#define METRIC_HIST_SUB_BITS 3
+#define METRIC_HIST_SUB      (1 << METRIC_HIST_SUB_BITS)
+// 0..15 单独成桶, 之后每个 2 的幂区间 8 个桶, 最大到 2^40 (us 计约 12 天)
+#define METRIC_HIST_BUCKETS  (2 * METRIC_HIST_SUB + (40 - METRIC_HIST_SUB_BITS - 1) * METRIC_HIST_SUB)
+
+struct Metric_Histogram
+{
+    std::atomic<uint32_t> buckets[METRIC_HIST_BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+
+    Metric_Histogram();
+    void record(uint64_t v);
+
+    static int bucket_of(uint64_t v);
+    static uint64_t bucket_high(int index);    // 桶内最大值, 分位数取桶上界
+};
+
+
+// ------------------------------------------------------------------------------
+//   登记与快照
+// ------------------------------------------------------------------------------
+class Metrics
+{
+
+public:
+
+    Metrics();
+    ~Metrics();
+
+    // 按名字取指标, 不存在时登记 (保存名字的副本); 超出容量时返回一个不输出的备用指标
+    Metric_Counter &counter(const char *name);
+    Metric_Gauge &gauge(const char *name);
+    Metric_Histogram &histogram(const char *name);
+    Metric_Age &age(const char *name);
+
+    // 各 MAVLink msgid 的接收计数, 快照中按消息名输出非零项
+    Metric_Counter mavlink_rx[256];
+
+    bool start(const char *snapshot_path = METRICS_SNAPSHOT_FILE,
+               const char *socket_path = METRICS_SOCKET_PATH, int period_ms = 1000);
+    void stop();
+
+    std::string snapshot();
+
+    void snapshot_thread();
+
+private:
+
+    pthread_mutex_t lock;
+
+    int n_counters, n_gauges, n_histograms, n_ages;
+    std::string counter_names[METRICS_MAX_COUNTERS];
+    std::string gauge_names[METRICS_MAX_GAUGES];
+    std::string histogram_names[METRICS_MAX_HISTOGRAMS];
+    std::string age_names[METRICS_MAX_AGES];
+    Metric_Counter counters[METRICS_MAX_COUNTERS + 1];
+    Metric_Gauge gauges[METRICS_MAX_GAUGES + 1];
+    Metric_Histogram histograms[METRICS_MAX_HISTOGRAMS + 1];
+    Metric_Age ages[METRICS_MAX_AGES + 1];
+
+    // 上一次快照时的计数, 用于求速率
+    uint64_t last_counters[METRICS_MAX_COUNTERS];
+    uint64_t last_mavlink_rx[256];
+    uint64_t last_usec;
+
+    std::string snapshot_path;
+    std::string socket_path;
+    int period_ms;
+    int listen_fd;
+    volatile bool time_to_exit;
+    bool running;
+    pthread_t snapshot_tid;
+
+    void write_file(const std::string &json);
+    void serve_clients(const std::string &json);
+
+};
+
+extern Metrics metrics;
+
+// MAVLink 消息名, 未知的 msgid 返回 NULL
+const char *mavlink_message_name(uint8_t msgid);
+
+
+#endif // METRICS_H_
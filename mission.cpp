@@ -0,0 +1,961 @@
+/**
+ * @file mission.cpp
+ *
+ * @brief Event-driven mission state machine
+ *
+ */
+
+#include "mission.h"
+#include "flight_log.h"
+#include "metrics.h"
+#include "swarm_map.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+
+
+Mission_Events mission_events;
+
+
+// ------------------------------------------------------------------------------
+//   Mission_Events
+// ------------------------------------------------------------------------------
+Mission_Events::
+Mission_Events()
+{
+    pthread_mutex_init(&lock, NULL);
+
+    // 超时按单调时钟计算, 不受系统对时影响
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+Mission_Events::
+~Mission_Events()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+void
+Mission_Events::
+post(uint8_t type, uint32_t value)
+{
+    static Metric_Counter &dropped = metrics.counter("mission.events_dropped");
+
+    uint64_t now = metrics_now_usec();
+    pthread_mutex_lock(&lock);
+
+    bool merged = false;
+    if (type == MISSION_EVENT_LOCAL_POSITION || type == MISSION_EVENT_GLOBAL_POSITION || type == MISSION_EVENT_VISION)
+    {
+        // 保留最早的投递时刻, 切换延迟从信息第一次可用时算起
+        for (auto &e : queue)
+            if (e.type == type)
+            {
+                e.value = value;
+                merged = true;
+                break;
+            }
+    }
+
+    if (!merged)
+    {
+        if (queue.size() >= MISSION_EVENT_QUEUE_SIZE)
+        {
+            queue.pop_front();
+            dropped.add();
+        }
+        Mission_Event e;
+        e.type = type;
+        e.value = value;
+        e.time_usec = now;
+        queue.push_back(e);
+    }
+
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+bool
+Mission_Events::
+wait(Mission_Event &event, uint64_t deadline_usec)
+{
+    pthread_mutex_lock(&lock);
+    while (queue.empty())
+    {
+        if (deadline_usec == 0)
+        {
+            pthread_cond_wait(&cond, &lock);
+            continue;
+        }
+
+        struct timespec ts;
+        ts.tv_sec = deadline_usec / 1000000;
+        ts.tv_nsec = (deadline_usec % 1000000) * 1000;
+        if (pthread_cond_timedwait(&cond, &lock, &ts) == ETIMEDOUT && queue.empty())
+        {
+            pthread_mutex_unlock(&lock);
+            return false;
+        }
+    }
+
+    event = queue.front();
+    queue.pop_front();
+    pthread_mutex_unlock(&lock);
+    return true;
+}
+
+void
+Mission_Events::
+clear()
+{
+    pthread_mutex_lock(&lock);
+    queue.clear();
+    pthread_mutex_unlock(&lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   状态表
+// ------------------------------------------------------------------------------
+static const char *state_names[MISSION_STATES] = {
+    "WAIT_OFFBOARD", "WAIT_MISSION", "SEARCH", "APPROACH", "CENTER", "DESCEND", "CLASSIFY",
+    "DROP_CLIMB", "DROP_ACQUIRE", "DROP_ALIGN", "DROP_RELEASE", "RESUME", "RETURN", "DONE",
+};
+
+static const uint32_t state_timeout_ms[MISSION_STATES] = {
+    0, 0, 0,
+    MISSION_TIMEOUT_APPROACH_MS, MISSION_TIMEOUT_CENTER_MS, MISSION_TIMEOUT_DESCEND_MS, MISSION_TIMEOUT_CLASSIFY_MS,
+    MISSION_TIMEOUT_CLIMB_MS, MISSION_TIMEOUT_ACQUIRE_MS, MISSION_TIMEOUT_ALIGN_MS, 0,
+    MISSION_TIMEOUT_RESUME_MS, 0, 0,
+};
+
+static const char *event_names[MISSION_EVENT_TYPES] = {
+    "check", "local_position", "global_position", "mission_item", "command", "vision", "target", "classified", "drop_target", "control", "timer", "timeout",
+};
+
+const char *
+mission_state_name(int state)
+{
+    return (state >= 0 && state < MISSION_STATES) ? state_names[state] : "?";
+}
+
+
+// 目标相对飞机的偏移(像素), 优先使用跟踪器预测的当前位置
+static void
+target_offset(Autopilot_Interface &api, const Target_Snapshot &snapshot, int id, float &ex, float &ey)
+{
+    if (!predicted_offset(api, id, ex, ey))
+    {
+        ex = snapshot.targets[id].x;
+        ey = snapshot.targets[id].y;
+    }
+}
+
+// 在视频线程中调用, 把快照的变化转换成任务事件
+static void
+post_vision_events(const Target_Snapshot_Ptr &prev, const Target_Snapshot_Ptr &next)
+{
+    size_t known = prev ? prev->targets.size() : 0;
+    bool same_epoch = prev && prev->mode_epoch == next->mode_epoch;
+
+    if (next->targets.size() > known)
+        mission_events.post(MISSION_EVENT_TARGET, next->targets.size());
+    if (next->classified && !(same_epoch && prev->classified))
+        mission_events.post(MISSION_EVENT_CLASSIFIED, next->mode_epoch);
+    if (next->drop_found && !(same_epoch && prev->drop_found))
+        mission_events.post(MISSION_EVENT_DROP_TARGET, next->mode_epoch);
+    mission_events.post(MISSION_EVENT_VISION, next->frame_seq);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Mission::
+Mission(Autopilot_Interface &api_) : api(api_), config(runtime_config.mission)
+{
+    current = MISSION_WAIT_OFFBOARD;
+    entered_usec = metrics_now_usec();
+    timer_usec = 0;
+    timeout_usec = 0;
+    step = 0;
+
+    TNum = 0;
+    TargetNum = 0;
+    yaw = 0;
+    approach_alt = 0;
+    resume_position = mavlink_global_position_int_t();
+    sp = mavlink_set_position_target_local_ned_t();
+    gsp = mavlink_set_position_target_global_int_t();
+
+    control_usec = 0;
+    target_usec = 0;
+
+    snapshot = target_channel.latest();
+    if (!snapshot)
+        snapshot = std::make_shared<Target_Snapshot>();
+    subscription = target_channel.subscribe(post_vision_events);
+    publish_vision();
+}
+
+Mission::
+~Mission()
+{
+    target_channel.unsubscribe(subscription);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Run
+// ------------------------------------------------------------------------------
+void
+Mission::
+run(Mission_State until)
+{
+    static Metric_Counter &timeouts = metrics.counter("mission.timeouts");
+
+    // 进入前已经发生的事件 (例如先收到了解锁命令) 也要检查一次
+    Mission_Event event;
+    event.type = MISSION_EVENT_NONE;
+    event.value = 0;
+    event.time_usec = metrics_now_usec();
+    dispatch(event, until);
+
+    while (current != until && current != MISSION_DONE)
+    {
+        // 事件不断到来时 wait 不会超时, 所以先检查定时器
+        uint64_t now = metrics_now_usec();
+        if (timeout_usec && now >= timeout_usec)
+        {
+            event.type = MISSION_EVENT_TIMEOUT;
+            event.value = 0;
+            event.time_usec = timeout_usec;
+            timeout_usec = 0;
+            timeouts.add();
+            FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "mission %s timeout", mission_state_name(current));
+        }
+        else if (timer_usec && now >= timer_usec)
+        {
+            event.type = MISSION_EVENT_TIMER;
+            event.value = step;
+            event.time_usec = timer_usec;
+            timer_usec = 0;
+        }
+        else if (control_usec && now >= control_usec)
+        {
+            event.type = MISSION_EVENT_CONTROL;
+            event.value = 0;
+            event.time_usec = control_usec;
+            // 处理跟不上时不补发
+            control_usec += 1000000 / APPROACH_CONTROL_HZ;
+            if (control_usec <= now)
+                control_usec = now + 1000000 / APPROACH_CONTROL_HZ;
+        }
+        else
+        {
+            uint64_t deadline = timer_usec;
+            if (timeout_usec && (!deadline || timeout_usec < deadline))
+                deadline = timeout_usec;
+            if (control_usec && (!deadline || control_usec < deadline))
+                deadline = control_usec;
+            if (!mission_events.wait(event, deadline))
+                continue;
+        }
+
+        dispatch(event, until);
+    }
+}
+
+// 切换后新状态的条件可能已经满足 (例如解锁时航点已到), 不必等下一个事件;
+// 重新检查时不再带定时器 / 超时, 延迟仍从原事件算起
+void
+Mission::
+dispatch(Mission_Event event, Mission_State until)
+{
+    // 快照只在视觉事件时更新, 状态机看到的目标表变化与触发事件一致
+    if (event.type >= MISSION_EVENT_VISION && event.type <= MISSION_EVENT_DROP_TARGET)
+    {
+        Target_Snapshot_Ptr latest = target_channel.latest();
+        if (latest)
+            snapshot = latest;
+    }
+
+    for (int i = 0; i < MISSION_STATES && current != until; i++)
+    {
+        Mission_State before = current;
+        handle(event);
+        if (current == before)
+            break;
+        event.type = MISSION_EVENT_NONE;
+    }
+}
+
+void
+Mission::
+set_timer(uint64_t delay_ms)
+{
+    timer_usec = metrics_now_usec() + delay_ms * 1000;
+}
+
+// 视觉在下一帧开始时按新的工作方式处理, 之前的识别结论和投放点作废
+void
+Mission::
+publish_vision()
+{
+    vision.target_num = TargetNum;
+    vision.epoch = vision_mode.version() + 1;
+    vision_mode.publish(std::make_shared<Vision_Mode>(vision));
+}
+
+
+// ------------------------------------------------------------------------------
+//   Transition
+// ------------------------------------------------------------------------------
+void
+Mission::
+transition(Mission_State next, const Mission_Event &trigger)
+{
+    static Metric_Histogram &transition_us = metrics.histogram("mission.transition_us");
+    static Metric_Gauge &state_gauge = metrics.gauge("mission.state");
+
+    uint64_t now = metrics_now_usec();
+    Mission_State prev = current;
+    uint64_t dwell_ms = (now - entered_usec) / 1000;
+
+    current = next;
+    entered_usec = now;
+    timer_usec = 0;
+    timeout_usec = state_timeout_ms[next] ? now + (uint64_t)state_timeout_ms[next] * 1000 : 0;
+    step = 0;
+    if (control_usec)
+    {
+        controller.finish(now);
+        control_usec = 0;
+    }
+
+    enter(prev);
+
+    // 从事件投递 (或定时器到期) 到新状态的进入动作执行完
+    uint64_t done = metrics_now_usec();
+    uint64_t latency = done > trigger.time_usec ? done - trigger.time_usec : 0;
+    transition_us.record(latency);
+    state_gauge.set(current);
+
+    if (FLIGHT_LOG_ENABLED(LOG_LEVEL_INFO))
+    {
+        log_Mission rec;
+        rec.time_us = get_time_usec();
+        rec.from = prev;
+        rec.to = next;
+        rec.event = trigger.type;
+        rec.latency_us = latency;
+        rec.dwell_ms = dwell_ms;
+        flight_log.write(&rec, sizeof(rec));
+    }
+    printf("MISSION %s -> %s on %s, %.1f ms after event, %.1f s in %s\n",
+           mission_state_name(prev), mission_state_name(next), event_names[trigger.type],
+           latency / 1000.0, dwell_ms / 1000.0, mission_state_name(prev));
+}
+
+// 进入动作, prev 为上一个状态
+void
+Mission::
+enter(Mission_State prev)
+{
+    switch (current)
+    {
+        case MISSION_WAIT_MISSION:
+        {
+            api.enable_offboard_control();
+            FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "enable_offboard!");
+            break;
+        }
+
+        case MISSION_SEARCH:
+        {
+            vision.stable = false;
+            vision.update = false;
+            publish_vision();
+            break;
+        }
+
+        case MISSION_APPROACH:
+        {
+            target_usec = entered_usec;
+            // 从航线上离开时先切 loiter 再切 guided, 两次之间留 100ms
+            if (prev == MISSION_SEARCH)
+            {
+                vision.update = true;
+                publish_vision();
+                api.Set_Mode(05);
+                set_timer(100);
+                break;
+            }
+            set_position(snapshot->targets[TargetNum].locx, // [m]
+                         snapshot->targets[TargetNum].locy, // [m]
+                         approach_alt, // [m]
+                         sp);
+            set_yaw(yaw, sp);
+            api.update_local_setpoint(sp);
+            // 先按位置 setpoint 飞, 4s 后仍未到达再改用速度逼近
+            step = 1;
+            set_timer(4000);
+            break;
+        }
+
+        case MISSION_CENTER:
+        {
+            start_control(APPROACH_PHASE_CENTER, 10);
+            break;
+        }
+
+        case MISSION_DESCEND:
+        {
+            approach_alt = config.classify_alt;
+            set_velocity(0, 0, 1, sp);
+            api.update_local_setpoint(sp);
+            break;
+        }
+
+        case MISSION_CLASSIFY:
+        {
+            // 视觉在 stable 时累计 T / F 计数, 给出结论后发布 classified 的快照
+            vision.stable = true;
+            publish_vision();
+            set_velocity(0, 0, 0, sp);
+            api.update_local_setpoint(sp);
+            start_control(APPROACH_PHASE_HOLD, 10);
+            set_timer(10000);
+            break;
+        }
+
+        case MISSION_DROP_CLIMB:
+        {
+            set_velocity(0, 0, 0.5, sp);
+            set_yaw(yaw, sp);
+            sp.z = config.drop_alt;
+            api.update_local_setpoint(sp);
+            break;
+        }
+
+        case MISSION_DROP_ACQUIRE:
+        {
+            target_tracker.reset(TRACK_DROP);
+            vision.drop = true;
+            publish_vision();
+            break;
+        }
+
+        case MISSION_DROP_ALIGN:
+        {
+            start_control(APPROACH_PHASE_DROP, 5);
+            break;
+        }
+
+        case MISSION_DROP_RELEASE:
+        {
+            api.Set_Mode(05);
+            set_timer(10);
+            break;
+        }
+
+        case MISSION_RESUME:
+        {
+            // 回到离开航线时的位置和巡视高度
+            gsp.time_boot_ms = (uint32_t) (get_time_usec() / 1000);
+            gsp.coordinate_frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+            set_global_position(resume_position.lat,
+                                resume_position.lon,
+                                config.cruise_alt,
+                                gsp);
+            api.update_global_setpoint(gsp);
+            break;
+        }
+
+        case MISSION_RETURN:
+        {
+            FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "return to launch!");
+            for (int i = 0; i < 5; ++i)
+            {
+                api.Set_Mode(06);
+            }
+            set_timer(0);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   逼近控制
+// ------------------------------------------------------------------------------
+// 收敛半径按原来的像素阈值在当前高度换算成米
+void
+Mission::
+start_control(uint8_t phase, float tolerance_px)
+{
+    float tolerance, unused, h;
+    image_error(tolerance_px, 0, tolerance, unused, h);
+    uint64_t now = metrics_now_usec();
+    controller.reset(phase, tolerance, now);
+    control_usec = now;
+}
+
+// 像素偏移换算成目标相对飞机的水平位置 (m), h 为目标上方高度
+void
+Mission::
+image_error(float px, float py, float &ex, float &ey, float &h)
+{
+    h = target_height(api);
+    if (h < 1)
+        h = 1;
+    ex = px * h / camera_model.fx;
+    ey = py * h / camera_model.fy;
+}
+
+void
+Mission::
+send_velocity(float vx, float vy)
+{
+    set_velocity(vx, vy, 0, sp);
+    set_yaw(yaw, sp);
+    api.update_local_setpoint(sp);
+}
+
+
+// ------------------------------------------------------------------------------
+//   识别 / 投放之后
+// ------------------------------------------------------------------------------
+Mission_State
+Mission::
+next_target()
+{
+    Mission_State next = MISSION_APPROACH;
+    skip_swarm_targets();
+    if (TNum >= config.max_drops)
+        next = MISSION_RETURN;
+    //判定是否执行完已有目标
+    else if (snapshot->targets.size() <= (size_t)TargetNum)
+    {
+        TargetNum = snapshot->targets.size();
+        next = MISSION_RESUME;
+    }
+
+    vision.stable = false;
+    vision.drop = false;
+    publish_vision();
+    return next;
+}
+
+// 其他飞机已经判定过的目标不再飞过去识别
+void
+Mission::
+skip_swarm_targets()
+{
+    while (snapshot->targets.size() > (size_t)TargetNum)
+    {
+        const target &t = snapshot->targets[TargetNum];
+        int32_t lat, lon;
+        uint8_t by;
+        int decision;
+        if (!local_to_global(api, t.locx, t.locy, lat, lon) || !swarm_map.classified_near(lat, lon, by, decision))
+            break;
+        FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "skip target %d, classified %c by swarm target of %d",
+                       TargetNum, decision ? 'T' : 'F', by);
+        TargetNum = TargetNum + 1;
+    }
+}
+
+Mission_State
+Mission::
+finish_classify()
+{
+    //检测T\F
+    size_t T = snapshot->T.size();
+    if (T > (size_t)TNum)
+    {
+        if ((T == 1) || (T == 2))
+            return MISSION_DROP_CLIMB;
+
+        // 已经投放过的机器不再投, 把位置发给从机
+        mavlink_global_position_int_t Target_Global_Position = api.current_messages.global_position_int;
+        api.Send_WL_Global_Position(TNum + 40, Target_Global_Position);
+        FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "Targetposition lat: %d lon: %d machine_num: %d",
+                       Target_Global_Position.lat, Target_Global_Position.lon, TNum);
+        TNum = TNum + 1;
+    }
+    TargetNum = TargetNum + 1;
+    return next_target();
+}
+
+// 航线走完 (航点 11) 时 F 表中的候选, 按 T 的概率排序后记录
+void
+Mission::
+drop_F_targets()
+{
+    FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "drop F");
+    vision.update = true;
+    publish_vision();
+    if (snapshot->F.size() < 2)
+        return;
+
+    vector<target> F = snapshot->F;
+    sort(F.begin(), F.end());
+    for (int i = 0; TNum + i < config.max_drops && i < (int)F.size(); i++)
+        FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "F candidate %d lat: %d lon: %d machine_num: %d",
+                       i, F[i].lat, F[i].lon, TNum + i + 41);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Handle Event
+// ------------------------------------------------------------------------------
+void
+Mission::
+handle(const Mission_Event &event)
+{
+    const uint8_t type = event.type;
+    const bool timeout = type == MISSION_EVENT_TIMEOUT;
+    const bool timer = type == MISSION_EVENT_TIMER;
+
+    switch (current)
+    {
+        case MISSION_WAIT_OFFBOARD:
+        {
+            if ((api.Inter_message.command_long.command == 400) && (api.Inter_message.command_long.param1 == 1))
+                transition(MISSION_WAIT_MISSION, event);
+            break;
+        }
+
+        case MISSION_WAIT_MISSION:
+        {
+            if (api.current_messages.mission_item_reached.seq == 6)
+            {
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "mission_item_reached.seq: %u", api.current_messages.mission_item_reached.seq);
+                transition(MISSION_SEARCH, event);
+            }
+            break;
+        }
+
+        case MISSION_SEARCH:
+        {
+            //设置触发节点
+            skip_swarm_targets();
+            if (snapshot->targets.size() > (size_t)TargetNum)
+            {
+                resume_position = api.current_messages.global_position_int;
+                //现在用当前高度,最终高度确定时使用
+                approach_alt = -resume_position.relative_alt / 1000.0;
+                yaw = D2R(resume_position.hdg);
+                transition(MISSION_APPROACH, event);
+            }
+            else if (TNum >= config.max_drops)
+            {
+                transition(MISSION_RETURN, event);
+            }
+            else if (api.current_messages.mission_item_reached.seq == 11)
+            {
+                drop_F_targets();
+                transition(MISSION_RETURN, event);
+            }
+            break;
+        }
+
+        case MISSION_APPROACH:
+        {
+            if (timeout)
+            {
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "skip target %d", TargetNum);
+                TargetNum = TargetNum + 1;
+                transition(next_target(), event);
+                break;
+            }
+            if (timer && step == 0)
+            {
+                api.Set_Mode(04);
+                set_position(snapshot->targets[TargetNum].locx, // [m]
+                             snapshot->targets[TargetNum].locy, // [m]
+                             approach_alt, // [m]
+                             sp);
+                set_yaw(yaw, sp);
+                api.update_local_setpoint(sp);
+                step = 1;
+                set_timer(4000);
+                break;
+            }
+            // 4s 后仍未到达时改用控制器按位置误差给速度, 收敛半径 1m
+            if (timer && step == 1)
+            {
+                step = 2;
+                uint64_t now = metrics_now_usec();
+                controller.reset(APPROACH_PHASE_WAYPOINT, 1, now);
+                control_usec = now;
+                break;
+            }
+
+            mavlink_local_position_ned_t pos = api.current_messages.local_position_ned;
+            float Disx = snapshot->targets[TargetNum].locx - pos.x;
+            float Disy = snapshot->targets[TargetNum].locy - pos.y;
+            if (step == 1 && type == MISSION_EVENT_LOCAL_POSITION)
+            {
+                if ((fabsf(Disx) < 1) && (fabsf(Disy) < 1))
+                    transition(MISSION_CENTER, event);
+                break;
+            }
+            if (step != 2 || type != MISSION_EVENT_CONTROL)
+                break;
+
+            // 高度偏差大时先修正高度
+            float Disz = approach_alt - pos.z;
+            if (fabsf(Disz) >= 0.5)
+            {
+                set_velocity(0, 0, Disz / fabsf(Disz), sp);
+                api.update_local_setpoint(sp);
+                break;
+            }
+            float vx, vy;
+            controller.update(Disx, Disy, target_height(api), 0, 0, metrics_now_usec(), vx, vy);
+            if (controller.converged())
+                transition(MISSION_CENTER, event);
+            else
+                send_velocity(vx, vy);
+            break;
+        }
+
+        case MISSION_CENTER:
+        {
+            if (timeout)
+            {
+                transition(MISSION_DESCEND, event);
+                break;
+            }
+            if (type != MISSION_EVENT_CONTROL)
+                break;
+
+            float Elocx, Elocy, ex, ey, h, vx, vy, tvx = 0, tvy = 0;
+            target_offset(api, *snapshot, TargetNum, Elocx, Elocy);
+            image_error(Elocx, Elocy, ex, ey, h);
+            target_tracker.velocity(TargetNum, tvx, tvy);
+            controller.update(ex, ey, h, tvx, tvy, metrics_now_usec(), vx, vy);
+            if (controller.converged())
+                transition(MISSION_DESCEND, event);
+            else
+                send_velocity(vx, vy);
+            break;
+        }
+
+        case MISSION_DESCEND:
+        {
+            if (timeout)
+            {
+                transition(MISSION_CLASSIFY, event);
+                break;
+            }
+            if (type != MISSION_EVENT_LOCAL_POSITION)
+                break;
+
+            if (api.current_messages.local_position_ned.z - approach_alt + 0.5 > 0)
+                transition(MISSION_CLASSIFY, event);
+            else
+                api.update_local_setpoint(sp);
+            break;
+        }
+
+        case MISSION_CLASSIFY:
+        {
+            // 10s 内累计的观测太少时不再等待结论
+            if (timer)
+            {
+                int TplusF = snapshot->targets[TargetNum].T_N +
+                             snapshot->targets[TargetNum].F_N;
+                if (TplusF <= 10)
+                    transition(finish_classify(), event);
+                break;
+            }
+            if (timeout)
+            {
+                transition(finish_classify(), event);
+                break;
+            }
+            if (snapshot->classified && current_epoch(snapshot->mode_epoch))
+            {
+                transition(finish_classify(), event);
+                break;
+            }
+            if (type != MISSION_EVENT_CONTROL)
+                break;
+
+            // 识别期间保持对正
+            float Elocx, Elocy, ex, ey, h, vx, vy, tvx = 0, tvy = 0;
+            target_offset(api, *snapshot, TargetNum, Elocx, Elocy);
+            image_error(Elocx, Elocy, ex, ey, h);
+            target_tracker.velocity(TargetNum, tvx, tvy);
+            controller.update(ex, ey, h, tvx, tvy, metrics_now_usec(), vx, vy);
+            send_velocity(vx, vy);
+            break;
+        }
+
+        case MISSION_DROP_CLIMB:
+        {
+            if (timeout)
+            {
+                transition(MISSION_DROP_ACQUIRE, event);
+                break;
+            }
+            if (type != MISSION_EVENT_LOCAL_POSITION)
+                break;
+
+            if ((api.current_messages.local_position_ned.z + 0.5 - config.drop_alt) >= 0)
+            {
+                set_velocity(0, 0, 0, sp);
+                set_yaw(yaw, sp);
+                api.update_local_setpoint(sp);
+                transition(MISSION_DROP_ACQUIRE, event);
+            }
+            else
+                api.update_local_setpoint(sp);
+            break;
+        }
+
+        case MISSION_DROP_ACQUIRE:
+        {
+            if (timeout)
+            {
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "drop target not found");
+                TargetNum = TargetNum + 1;
+                transition(next_target(), event);
+                break;
+            }
+            //给响应时间识别小圆
+            if (snapshot->drop_found && current_epoch(snapshot->mode_epoch))
+                transition(MISSION_DROP_ALIGN, event);
+            break;
+        }
+
+        case MISSION_DROP_ALIGN:
+        {
+            if (timeout)
+            {
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "drop target not aligned");
+                TargetNum = TargetNum + 1;
+                transition(next_target(), event);
+                break;
+            }
+            if (type != MISSION_EVENT_CONTROL)
+                break;
+
+            float locx, locy, ex, ey, h, vx, vy, tvx = 0, tvy = 0;
+            //优先使用跟踪器预测的当前位置, 跟踪丢失时退回到最近一帧的结果
+            if (!predicted_offset(api, TRACK_DROP, locx, locy))
+            {
+                locx = snapshot->drop_target.x;
+                locy = snapshot->drop_target.y;
+            }
+            image_error(locx, locy, ex, ey, h);
+            target_tracker.velocity(TRACK_DROP, tvx, tvy);
+            controller.update(ex, ey, h, tvx, tvy, metrics_now_usec(), vx, vy);
+            if (controller.converged())
+                transition(MISSION_DROP_RELEASE, event);
+            else
+                send_velocity(vx, vy);
+            break;
+        }
+
+        case MISSION_DROP_RELEASE:
+        {
+            if (!timer)
+                break;
+
+            // loiter -> guided 后悬停 1s 再开舵机, 开舵机后再等 1s
+            if (step == 0)
+            {
+                api.Set_Mode(04);
+                printf("input drop process!!!\n");
+                step = 1;
+                set_timer(1000);
+            }
+            else if (step == 1)
+            {
+                // ------------------------------------------------------------------------------
+                //	驱动舵机：<PWM_Value:1100-1900> 打开：1700、关闭：1250
+                //	ServoId：AUX_OUT1-6 对应148-153/9-14
+                // ------------------------------------------------------------------------------
+                api.Servo_Control(11 + TNum, 1700);
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "droptarget_a: %.3f", snapshot->drop_target.a);
+
+                // 从开始逼近目标到打开舵机
+                static Metric_Histogram &time_to_drop = metrics.histogram("mission.time_to_drop_ms");
+                uint64_t drop_ms = (metrics_now_usec() - target_usec) / 1000;
+                time_to_drop.record(drop_ms);
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "time to drop: %.1f s", drop_ms / 1000.0);
+                TNum = TNum + 1;
+                step = 2;
+                set_timer(1000);
+            }
+            else
+            {
+                mavlink_global_position_int_t Target_Global_Position = api.current_messages.global_position_int;
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "Targetposition lat: %d lon: %d machine_num: %d",
+                               Target_Global_Position.lat, Target_Global_Position.lon, TNum);
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "Throw");
+                TargetNum = TargetNum + 1;
+                transition(next_target(), event);
+            }
+            break;
+        }
+
+        case MISSION_RESUME:
+        {
+            if (timeout)
+            {
+                api.Set_Mode(03);
+                transition(MISSION_SEARCH, event);
+                break;
+            }
+            // 切回 auto 后留 1s 再开始搜索
+            if (timer)
+            {
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "back to sp");
+                transition(MISSION_SEARCH, event);
+                break;
+            }
+            if (type != MISSION_EVENT_GLOBAL_POSITION || step != 0)
+                break;
+
+            const mavlink_global_position_int_t &current_global = api.current_messages.global_position_int;
+            float distan = Distance(current_global.lat, current_global.lon, resume_position.relative_alt,
+                                    resume_position.lat, resume_position.lon, resume_position.relative_alt);
+            if (distan < 5)
+            {
+                api.Set_Mode(03);
+                api.Set_Mode(03);
+                step = 1;
+                set_timer(1000);
+            }
+            else
+                api.update_global_setpoint(gsp);
+            break;
+        }
+
+        case MISSION_RETURN:
+        {
+            if (timer)
+                transition(MISSION_DONE, event);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,191 @@
+/**
+ * @file mission.h
+ *
+ * @brief Event-driven mission state machine
+ *
+ * 取代 commands() / Throw() / ThrowF() 中轮询全局变量的嵌套 while 循环和 sleep(4) / usleep(200000).
+ * 读线程收到位置、航点和地面站命令时, 视觉发布新的目标表快照 (target_channel.h) 时, 各向 mission_events
+ * 投递事件; 快照中出现新目标、当前目标给出 T / F 结论、找到投放点时另有单独的事件.
+ * 任务线程阻塞在事件队列上, 收到事件 (或本状态的定时器 / 超时到期) 时立即处理, 反应时间只取决于
+ * 遥测和视觉的更新频率, 不再是几百毫秒到几秒的睡眠粒度.
+ *
+ *   WAIT_OFFBOARD -> WAIT_MISSION -> SEARCH -> APPROACH -> CENTER -> DESCEND -> CLASSIFY
+ *        CLASSIFY -> DROP_CLIMB -> DROP_ACQUIRE -> DROP_ALIGN -> DROP_RELEASE   (判为 T 时投放)
+ *        -> 下一个目标 APPROACH / RESUME (回到离开航线处) -> SEARCH / RETURN
+ *
+ * 每个状态有超时, 超时后按表中的处理继续任务而不是卡死在某个循环里.
+ * 逼近、对正和投放对准由 Approach_Controller 按固定的控制周期给出速度设定点.
+ * 选择下一个目标时跳过其他飞机已经判定过的目标 (swarm_map.h).
+ * 每次状态切换写一条 MIS 日志记录 (触发事件、切换延迟、在上一状态停留的时间),
+ * 切换延迟 (从事件投递到新状态的进入动作执行完) 同时计入 mission.transition_us 直方图.
+ *
+ */
+
+#ifndef MISSION_H_
+#define MISSION_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <deque>
+
+#include "autopilot_interface.h"
+#include "approach_controller.h"
+#include "target_channel.h"
+#include "runtime_config.h"
+
+
+// ------------------------------------------------------------------------------
+//   事件
+// ------------------------------------------------------------------------------
+enum Mission_Event_Type
+{
+    MISSION_EVENT_NONE = 0,
+    MISSION_EVENT_LOCAL_POSITION,   // LOCAL_POSITION_NED
+    MISSION_EVENT_GLOBAL_POSITION,  // GLOBAL_POSITION_INT
+    MISSION_EVENT_MISSION_ITEM,     // MISSION_ITEM_REACHED, value 为 seq
+    MISSION_EVENT_COMMAND,          // 机间链路上的 COMMAND_LONG, value 为 command
+    MISSION_EVENT_VISION,           // 视觉发布了新的目标表快照, value 为帧号
+    MISSION_EVENT_TARGET,           // 快照中出现新目标, value 为目标数
+    MISSION_EVENT_CLASSIFIED,       // 当前目标给出 T / F 结论, value 为 vision_mode 的 epoch
+    MISSION_EVENT_DROP_TARGET,      // 找到投放点, value 为 vision_mode 的 epoch
+    MISSION_EVENT_CONTROL,          // 控制周期 (APPROACH_CONTROL_HZ, 不进队列)
+    MISSION_EVENT_TIMER,            // 本状态的定时器到期 (不进队列)
+    MISSION_EVENT_TIMEOUT,          // 本状态超时 (不进队列)
+    MISSION_EVENT_TYPES,
+};
+
+struct Mission_Event
+{
+    uint8_t type;
+    uint32_t value;
+    uint64_t time_usec;     // 投递时刻, metrics_now_usec()
+};
+
+#define MISSION_EVENT_QUEUE_SIZE 64
+
+class Mission_Events
+{
+
+public:
+
+    Mission_Events();
+    ~Mission_Events();
+
+    // 投递一个事件. 位置和视觉事件只关心最新状态, 队列中已有同类事件时合并为一个
+    void post(uint8_t type, uint32_t value = 0);
+
+    // 等待下一个事件, 到 deadline_usec (单调时钟) 仍没有事件时返回 false
+    bool wait(Mission_Event &event, uint64_t deadline_usec);
+
+    void clear();
+
+private:
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    std::deque<Mission_Event> queue;
+
+};
+
+extern Mission_Events mission_events;
+
+
+// ------------------------------------------------------------------------------
+//   状态机
+// ------------------------------------------------------------------------------
+enum Mission_State
+{
+    MISSION_WAIT_OFFBOARD = 0,  // 等待地面站的解锁命令 (COMMAND_LONG 400, param1 = 1)
+    MISSION_WAIT_MISSION,       // 等待航线到达搜索起点 (航点 6)
+    MISSION_SEARCH,             // 沿航线飞行, 等待视觉发现新目标
+    MISSION_APPROACH,           // guided 模式飞到目标的局部坐标
+    MISSION_CENTER,             // 按图像偏移对正目标
+    MISSION_DESCEND,            // 下降到识别高度
+    MISSION_CLASSIFY,           // 悬停对正, 等待视觉给出 T / F
+    MISSION_DROP_CLIMB,         // 到投放高度
+    MISSION_DROP_ACQUIRE,       // 等待小圆 (投放点) 出现
+    MISSION_DROP_ALIGN,         // 对正小圆
+    MISSION_DROP_RELEASE,       // 打开舵机
+    MISSION_RESUME,             // 回到离开航线的位置, 恢复 auto 模式
+    MISSION_RETURN,             // 返航
+    MISSION_DONE,
+    MISSION_STATES,
+};
+
+const char *mission_state_name(int state);
+
+// 各状态的超时 (ms), 0 为不超时
+#define MISSION_TIMEOUT_APPROACH_MS  60000
+#define MISSION_TIMEOUT_CENTER_MS     4000
+#define MISSION_TIMEOUT_DESCEND_MS   20000
+#define MISSION_TIMEOUT_CLASSIFY_MS  30000
+#define MISSION_TIMEOUT_CLIMB_MS     20000
+#define MISSION_TIMEOUT_ACQUIRE_MS   10000
+#define MISSION_TIMEOUT_ALIGN_MS     20000
+#define MISSION_TIMEOUT_RESUME_MS    60000
+
+// 识别 / 投放 / 巡航高度和投放数量见 Mission_Config (config/uav.yml 的 mission 一节)
+
+class Mission
+{
+
+public:
+
+    Mission(Autopilot_Interface &api);
+    ~Mission();
+
+    // 处理事件直到进入 until 状态 (或 MISSION_DONE)
+    void run(Mission_State until = MISSION_DONE);
+
+    Mission_State state() const { return current; }
+
+private:
+
+    Autopilot_Interface &api;
+    Mission_Config config;      // 启动时读入的 runtime_config.mission
+
+    Mission_State current;
+    uint64_t entered_usec;      // 进入当前状态的时刻
+    uint64_t timer_usec;        // 本状态定时器, 0 为未设置
+    uint64_t timeout_usec;      // 本状态超时时刻, 0 为不超时
+    int step;                   // 状态内的步骤, 由定时器推进
+
+    int TNum;                   // 已投放的数量
+    int TargetNum;              // 当前目标在快照 targets 中的下标
+    float yaw;
+    float approach_alt;
+    mavlink_global_position_int_t resume_position;     // 离开航线时的位置
+
+    mavlink_set_position_target_local_ned_t sp;
+    mavlink_set_position_target_global_int_t gsp;
+
+    Vision_Mode vision;             // 最近一次发布给视觉的工作方式
+    Target_Snapshot_Ptr snapshot;   // 处理每个事件前取最新的快照
+    int subscription;
+
+    Approach_Controller controller;
+    uint64_t control_usec;      // 下一个控制周期, 0 为控制器未运行
+    uint64_t target_usec;       // 开始逼近当前目标的时刻, 用来统计投放用时
+
+    void transition(Mission_State next, const Mission_Event &trigger);
+    void enter(Mission_State prev);
+    void handle(const Mission_Event &event);
+    void dispatch(Mission_Event event, Mission_State until);
+    void set_timer(uint64_t delay_ms);
+    void publish_vision();
+    bool current_epoch(uint32_t epoch) const { return epoch == vision.epoch; }
+
+    // 识别或投放结束后选择下一个目标
+    Mission_State next_target();
+    void skip_swarm_targets();
+    Mission_State finish_classify();
+    void drop_F_targets();
+
+    void start_control(uint8_t phase, float tolerance_px);
+    void image_error(float px, float py, float &ex, float &ey, float &h);
+    void send_velocity(float vx, float vy);
+
+};
+
+
+#endif // MISSION_H_
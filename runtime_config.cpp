@@ -0,0 +1,218 @@
+/**
+ * @file runtime_config.cpp
+ *
+ * @brief Runtime configuration file for detector, tracker and mission parameters
+ *
+ */
+
+#include "runtime_config.h"
+#include "flight_log.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <signal.h>
+#include <math.h>
+
+
+Runtime_Config runtime_config;
+Channel<Vision_Config> vision_config;
+
+static volatile sig_atomic_t reload_requested = 0;
+
+
+// ------------------------------------------------------------------------------
+//   检测参数
+// ------------------------------------------------------------------------------
+void
+Detector_Config::
+apply(CEllipseDetectorYaed &yaed, cv::Size work) const
+{
+    float max_center_distance = sqrt(float(work.width*work.width + work.height*work.height)) * tao_centers;
+    yaed.SetParameters(cv::Size(gauss_kernel, gauss_kernel), gauss_sigma, th_pos, max_center_distance,
+                       th_length, th_obb, distance_to_contour, th_score, min_reliability, ns);
+}
+
+
+// ------------------------------------------------------------------------------
+//   读取
+// ------------------------------------------------------------------------------
+// 没有这一项时保留缺省值, 类型不对时给出警告
+template<class T>
+static void
+read_value(const cv::FileNode &node, const char *section, const char *key, T &value)
+{
+    cv::FileNode n = node[key];
+    if (n.empty() || n.isNone())
+        return;
+    if (!n.isInt() && !n.isReal())
+    {
+        fprintf(stderr, "WARNING: config %s.%s is not a number, keeping %g\n", section, key, (double)value);
+        return;
+    }
+    value = (T)(double)n;
+}
+
+template<class T>
+static void
+read_array(const cv::FileNode &node, const char *section, const char *key, T *values, int count)
+{
+    cv::FileNode n = node[key];
+    if (n.empty() || n.isNone())
+        return;
+    if (!n.isSeq() || (int)n.size() != count)
+    {
+        fprintf(stderr, "WARNING: config %s.%s should be a list of %d numbers, keeping defaults\n", section, key, count);
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (!n[i].isInt() && !n[i].isReal())
+        {
+            fprintf(stderr, "WARNING: config %s.%s[%d] is not a number, keeping defaults\n", section, key, i);
+            return;
+        }
+    }
+    for (int i = 0; i < count; i++)
+        values[i] = (T)(double)n[i];
+}
+
+static void
+read_vision(const cv::FileStorage &fs, Vision_Config &vision)
+{
+    cv::FileNode d = fs["detector"];
+    Detector_Config &det = vision.detector;
+    read_value(d, "detector", "th_length", det.th_length);
+    read_value(d, "detector", "th_obb", det.th_obb);
+    read_value(d, "detector", "th_pos", det.th_pos);
+    read_value(d, "detector", "tao_centers", det.tao_centers);
+    read_value(d, "detector", "ns", det.ns);
+    read_value(d, "detector", "th_score", det.th_score);
+    read_value(d, "detector", "min_reliability", det.min_reliability);
+    read_value(d, "detector", "distance_to_contour", det.distance_to_contour);
+    read_value(d, "detector", "gauss_kernel", det.gauss_kernel);
+    read_value(d, "detector", "gauss_sigma", det.gauss_sigma);
+    if (det.gauss_kernel < 1 || det.gauss_kernel % 2 == 0)
+    {
+        fprintf(stderr, "WARNING: config detector.gauss_kernel %d must be odd, using 5\n", det.gauss_kernel);
+        det.gauss_kernel = 5;
+    }
+
+    cv::FileNode c = fs["color"];
+    Target_Color &color = vision.color;
+    read_array(c, "color", "blue_low", color.blue_low, 3);
+    read_array(c, "color", "blue_high", color.blue_high, 3);
+    read_array(c, "color", "red_low", color.red_low, 3);
+    read_array(c, "color", "red_high", color.red_high, 3);
+    read_array(c, "color", "blue_target", color.blue_target, 4);
+    read_array(c, "color", "red_target", color.red_target, 4);
+
+    cv::FileNode t = fs["target"];
+    Target_Config &target = vision.target;
+    read_value(t, "target", "merge_dist", target.merge_dist);
+    read_value(t, "target", "t_possible", target.t_possible);
+    read_value(t, "target", "min_votes", target.min_votes);
+    read_value(t, "target", "drop_dist", target.drop_dist);
+    read_value(t, "target", "tf_symmetry", target.tf_symmetry);
+}
+
+static bool
+read_config(const std::string &path, Runtime_Config &config)
+{
+    cv::FileStorage fs;
+    try {
+        if (!fs.open(path, cv::FileStorage::READ) || !fs.isOpened())
+            return false;
+    }
+    catch (cv::Exception &e) {
+        fprintf(stderr, "WARNING: could not parse config %s: %s\n", path.c_str(), e.what());
+        return false;
+    }
+
+    cv::FileNode calib = fs["calib_file"];
+    if (calib.isString())
+        config.calib_file = (std::string)calib;
+
+    read_vision(fs, config.vision);
+
+    cv::FileNode m = fs["mission"];
+    Mission_Config &mission = config.mission;
+    read_value(m, "mission", "classify_alt", mission.classify_alt);
+    read_value(m, "mission", "drop_alt", mission.drop_alt);
+    read_value(m, "mission", "cruise_alt", mission.cruise_alt);
+    read_value(m, "mission", "max_drops", mission.max_drops);
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   启动时读入
+// ------------------------------------------------------------------------------
+bool
+load_runtime_config(const char *path)
+{
+    Runtime_Config config;
+    config.path = path;
+    bool ok = read_config(config.path, config);
+    if (!ok)
+        fprintf(stderr, "WARNING: could not open config %s, using defaults\n", path);
+
+    runtime_config = config;
+    vision_config.publish(std::make_shared<Vision_Config>(config.vision));
+
+    const Mission_Config &m = config.mission;
+    printf("CONFIG %s: calib %s, classify %.1f m, drop %.1f m, cruise %.1f m, max drops %d\n",
+           path, config.calib_file.c_str(), m.classify_alt, m.drop_alt, m.cruise_alt, m.max_drops);
+    FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "config %s loaded %d", path, ok);
+    return ok;
+}
+
+Vision_Config_Ptr
+current_vision_config()
+{
+    static const Vision_Config_Ptr defaults = std::make_shared<Vision_Config>();
+    Vision_Config_Ptr config = vision_config.latest();
+    return config ? config : defaults;
+}
+
+
+// ------------------------------------------------------------------------------
+//   SIGHUP 重新载入
+// ------------------------------------------------------------------------------
+void
+config_reload_handler(int sig)
+{
+    reload_requested = 1;
+}
+
+bool
+config_poll_reload()
+{
+    if (!reload_requested)
+        return false;
+    reload_requested = 0;
+
+    static Metric_Counter &reloads = metrics.counter("config.reloads");
+    static Metric_Counter &errors = metrics.counter("config.reload_errors");
+
+    // 与启动时一样从缺省值开始, 文件中删掉的项恢复缺省值
+    Runtime_Config config;
+    config.path = runtime_config.path;
+    if (!read_config(config.path, config))
+    {
+        errors.add();
+        fprintf(stderr, "WARNING: could not reload config %s, keeping current parameters\n", config.path.c_str());
+        FLIGHT_LOG_MSG(LOG_LEVEL_ERROR, "config %s reload failed", config.path.c_str());
+        return false;
+    }
+
+    vision_config.publish(std::make_shared<Vision_Config>(config.vision));
+    reloads.add();
+
+    const Detector_Config &d = config.vision.detector;
+    const Target_Config &t = config.vision.target;
+    printf("CONFIG reloaded %s: th_length %d, th_obb %.2f, tao_centers %.3f, ns %d, th_score %.2f, "
+           "merge %.1f m, possible %.2f, votes %d\n", config.path.c_str(), d.th_length, d.th_obb,
+           d.tao_centers, d.ns, d.th_score, t.merge_dist, t.t_possible, t.min_votes);
+    FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "config %s reloaded", config.path.c_str());
+    return true;
+}
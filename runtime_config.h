@@ -0,0 +1,115 @@
+/**
+ * @file runtime_config.h
+ *
+ * @brief Runtime configuration file for detector, tracker and mission parameters
+ *
+ * 原来椭圆检测参数 (SetDefaultParameters)、颜色阈值 (computetargetcolorpercentage)、目标更新和
+ * T / F 判定的阈值 (classify_TF, possible_ellipse_r, resultTF, getdroptarget)、任务高度和标定文件名都写在代码里,
+ * 外场换一次场地或光照要重新编译. 现在由 config/uav.yml 给出, 格式与相机标定文件相同
+ * (OpenCV FileStorage YAML), 文件中没有的项保持下面的缺省值, 缺省值与原来代码中的一致.
+ *
+ *   启动时     load_runtime_config 读入全部参数: calib_file 和 mission 只在启动时使用,
+ *              视觉参数发布到 vision_config.
+ *   SIGHUP     config_reload_handler 只置标志; 视觉线程在下一帧开始时调用 config_poll_reload
+ *              重新读文件, 只发布视觉参数 (detector, color, target), 任务和标定参数需重启生效.
+ *              kill -HUP <pid> 即可在飞行中调整颜色阈值.
+ *
+ * 读取失败时保留上一次的参数, 见 config.reloads / config.reload_errors 指标.
+ *
+ */
+
+#ifndef RUNTIME_CONFIG_H_
+#define RUNTIME_CONFIG_H_
+
+#include <string>
+
+#include "channel.h"
+#include "camera_model.h"
+#include "ellipse/EllipseDetectorYaed.h"
+
+
+#define RUNTIME_CONFIG_FILE "config/uav.yml"
+
+
+// 椭圆检测参数, 含义见 CEllipseDetectorYaed::SetParameters
+struct Detector_Config
+{
+    int th_length;              // 弧段最短长度 (像素)
+    float th_obb;               // 弧段外接矩形的最小长宽比
+    float th_pos;               // 弧段相对位置检验
+    float tao_centers;          // 圆心最大距离, 检测图对角线的比例
+    int ns;                     // 圆心估计的弦数
+    float th_score;             // 椭圆得分阈值
+    float min_reliability;
+    float distance_to_contour;  // 点到椭圆的距离阈值
+    int gauss_kernel;           // 高斯核 (奇数)
+    double gauss_sigma;
+
+    Detector_Config() : th_length(16), th_obb(3.0f), th_pos(1.0f), tao_centers(0.05f), ns(16),
+                        th_score(0.4f), min_reliability(0.4f), distance_to_contour(0.1f),
+                        gauss_kernel(5), gauss_sigma(1.0) {}
+
+    // 按检测分辨率设置到检测器, 与 SetDefaultParameters 相同
+    void apply(CEllipseDetectorYaed &yaed, cv::Size work) const;
+};
+
+// 目标更新和 T / F 判定
+struct Target_Config
+{
+    float merge_dist;           // 同一个圆的南北 / 东西距离 (m), possible_ellipse_r, swarm_map
+    float t_possible;           // T 票占比高于它判为 T, 低于它判为 F
+    int min_votes;              // 判定前 T 或 F 至少的票数
+    float drop_dist;            // getdroptarget: 投放点与飞机的南北 / 东西距离 (m)
+    float tf_symmetry;          // classify_TF: 字符镜像对称度高于它判为 T
+
+    Target_Config() : merge_dist(5), t_possible(0.4f), min_votes(50), drop_dist(5), tf_symmetry(0.8f) {}
+};
+
+// SIGHUP 可重新载入的视觉参数
+struct Vision_Config
+{
+    Detector_Config detector;
+    Target_Color color;
+    Target_Config target;
+};
+
+// 任务参数, 只在启动时读入
+struct Mission_Config
+{
+    float classify_alt;         // 识别高度 (local NED z, m)
+    float drop_alt;             // 投放高度 (local NED z, m)
+    float cruise_alt;           // 回到航线时的相对高度 (m)
+    int max_drops;
+
+    Mission_Config() : classify_alt(-30), drop_alt(-22), cruise_alt(33), max_drops(3) {}
+};
+
+struct Runtime_Config
+{
+    std::string path;
+    std::string calib_file;
+    Vision_Config vision;
+    Mission_Config mission;
+
+    Runtime_Config() : path(RUNTIME_CONFIG_FILE), calib_file(CAMERA_CALIB_FILE) {}
+};
+
+typedef Channel<Vision_Config>::Ptr Vision_Config_Ptr;
+
+extern Runtime_Config runtime_config;       // 启动时读入的参数
+extern Channel<Vision_Config> vision_config;
+
+// 读入 path 并发布视觉参数; 文件不存在时使用缺省值并返回 false
+bool load_runtime_config(const char *path = RUNTIME_CONFIG_FILE);
+
+// 最新的视觉参数, 还没有发布过时为缺省值
+Vision_Config_Ptr current_vision_config();
+
+// SIGHUP 处理函数, 只置标志
+void config_reload_handler(int sig);
+
+// 收到过 SIGHUP 时重新读文件并发布视觉参数, 发布了新参数时返回 true
+bool config_poll_reload();
+
+
+#endif // RUNTIME_CONFIG_H_
@@ -54,6 +54,8 @@
 
 #include "serial_port.h"
 
+#include <string.h>
+
 
 // ----------------------------------------------------------------------------------
 //   Serial Port Manager Class
@@ -80,6 +82,7 @@ Serial_Port::
 ~Serial_Port()
 {
 	// destroy mutex
+	pthread_mutex_destroy(&read_lock);
 	pthread_mutex_destroy(&lock);
 }
 
@@ -95,8 +98,18 @@ initialize_defaults()
 	uart_name = (char*)"/dev/ttyUSB0";
 	baudrate  = 57600;
 
+	// open_serial 之前的读写计入不输出的备用指标
+	static Metric_Counter   unused_counter;
+	static Metric_Gauge     unused_gauge;
+	static Metric_Histogram unused_histogram;
+	m_rx_bytes = m_tx_bytes = m_rx_frames = m_rx_errors = &unused_counter;
+	m_rx_pending = &unused_gauge;
+	m_write_us = &unused_histogram;
+
 	// Start mutex
 	int result = pthread_mutex_init(&lock, NULL);
+	if ( result == 0 )
+		result = pthread_mutex_init(&read_lock, NULL);
 	if ( result != 0 )
 	{
 		printf("\n mutex init failed\n");
@@ -112,41 +125,54 @@ int
 Serial_Port::
 read_message(mavlink_message_t &message)
 {
-	uint8_t          cp;
-	mavlink_status_t status;
 	uint8_t          msgReceived = false;
 
 	// --------------------------------------------------------------------------
-	//   READ FROM PORT
+	//   PARSE BUFFERED BYTES
 	// --------------------------------------------------------------------------
 
-	// this function locks the port during read
-	int result = _read_port(cp);
-
+	// 上一次读入的字节中可能还有完整的帧, 先取完再读串口
+	msgReceived = scanner.next(message);
 
 	// --------------------------------------------------------------------------
-	//   PARSE MESSAGE
+	//   READ FROM PORT
 	// --------------------------------------------------------------------------
-	if (result > 0)
+	if (!msgReceived)
 	{
-		// the parsing
-		msgReceived = mavlink_parse_char(MAVLINK_COMM_1, cp, &message, &status);
+		size_t room;
+		uint8_t *p = scanner.write_ptr(room);
+
+		// this function locks the port during read
+		int result = _read_port(p, room);
 
-		// check for dropped packets
-		if ( (lastStatus.packet_rx_drop_count != status.packet_rx_drop_count) && debug )
+		if (result > 0)
 		{
-			printf("ERROR: DROPPED %d PACKETS\n", status.packet_rx_drop_count);
-			unsigned char v=cp;
-			fprintf(stderr,"%02x ", v);
+			m_rx_bytes->add(result);
+			scanner.commit(result);
+			msgReceived = scanner.next(message);
+		}
+
+		// Couldn't read from port
+		else
+		{
+//			fprintf(stderr, "ERROR: Could not read from fd %d\n", fd);
 		}
-		lastStatus = status;
 	}
 
-	// Couldn't read from port
-	else
+	// check for corrupt frames
+	uint64_t errors = scanner.stats.crc_errors - lastStats.crc_errors +
+	                  scanner.stats.length_errors - lastStats.length_errors;
+	if ( errors )
 	{
-//		fprintf(stderr, "ERROR: Could not read from fd %d\n", fd);
+		m_rx_errors->add(errors);
+		if ( debug )
+			printf("ERROR: DROPPED %llu CORRUPT FRAMES (%llu bytes skipped)\n", (unsigned long long)errors,
+			       (unsigned long long)(scanner.stats.bytes_skipped - lastStats.bytes_skipped));
 	}
+	lastStats = scanner.stats;
+	if ( msgReceived )
+		m_rx_frames->add();
+	m_rx_pending->set(scanner.pending());
 
 	// --------------------------------------------------------------------------
 	//   DEBUGGING REPORTS
@@ -198,7 +224,11 @@ write_message(const mavlink_message_t &message)
 	unsigned len = mavlink_msg_to_send_buffer((uint8_t*)buf, &message);
 
 	// Write buffer to serial port, locks port while writing
+	uint64_t t0 = metrics_now_usec();
 	int bytesWritten = _write_port(buf,len);
+	m_write_us->record(metrics_now_usec() - t0);//含等锁和 tcdrain
+	if ( bytesWritten > 0 )
+		m_tx_bytes->add(bytesWritten);
 
 	return bytesWritten;
 }
@@ -252,7 +282,9 @@ open_serial()
 	//   CONNECTED!
 	// --------------------------------------------------------------------------
 	printf("Connected to %s with %d baud, 8 data bits, no parity, 1 stop bit (8N1)\n", uart_name, baudrate);
-	lastStatus.packet_rx_drop_count = 0;
+	scanner.reset();
+	lastStats = scanner.stats;
+	register_metrics();
 
 	status = true;
 
@@ -497,21 +529,42 @@ _setup_port(int baud, int data_bits, int stop_bits, bool parity, bool hardware_c
 
 
 
+// ------------------------------------------------------------------------------
+//   Metrics
+// ------------------------------------------------------------------------------
+// 指标名为 serial.<设备名>.*, 如 serial.ttyUSB0.rx_bytes
+void
+Serial_Port::
+register_metrics()
+{
+	const char *slash = strrchr(uart_name, '/');
+	std::string prefix = std::string("serial.") + (slash ? slash + 1 : uart_name) + ".";
+
+	m_rx_bytes   = &metrics.counter((prefix + "rx_bytes").c_str());
+	m_tx_bytes   = &metrics.counter((prefix + "tx_bytes").c_str());
+	m_rx_frames  = &metrics.counter((prefix + "rx_frames").c_str());
+	m_rx_errors  = &metrics.counter((prefix + "rx_errors").c_str());
+	m_rx_pending = &metrics.gauge((prefix + "rx_pending_bytes").c_str());
+	m_write_us   = &metrics.histogram((prefix + "write_us").c_str());
+}
+
+
 // ------------------------------------------------------------------------------
 //   Read Port with Lock
 // ------------------------------------------------------------------------------
 int
 Serial_Port::
-_read_port(uint8_t &cp)
+_read_port(uint8_t *buf, size_t len)
 {
 
 	// Lock
-	pthread_mutex_lock(&lock);
+	pthread_mutex_lock(&read_lock);
 
-	int result = read(fd, &cp, 1);
+	// VMIN=0, VTIME>0: 有数据时立即返回已到的字节, 不必逐字节读
+	int result = read(fd, buf, len);
 
 	// Unlock
-	pthread_mutex_unlock(&lock);
+	pthread_mutex_unlock(&read_lock);
 
 	return result;
 }
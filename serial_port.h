@@ -63,6 +63,8 @@
 #include <signal.h>
 
 #include "mavlink/common/mavlink.h"
+#include "mavlink_scanner.h"
+#include "metrics.h"
 
 
 // ------------------------------------------------------------------------------
@@ -135,12 +137,20 @@ public:
 private:
 
 	int  fd;
-	mavlink_status_t lastStatus;
-	pthread_mutex_t  lock;
+	Mavlink_Scanner  scanner;
+	Scanner_Stats    lastStats;
+	pthread_mutex_t  lock;          // 写
+	pthread_mutex_t  read_lock;     // 读. 与写分开, 阻塞的读 (最多 VTIME) 不耽误另一个线程写
+
+	// 运行指标, open_serial 时按串口名登记
+	Metric_Counter   *m_rx_bytes, *m_tx_bytes, *m_rx_frames, *m_rx_errors;
+	Metric_Gauge     *m_rx_pending;
+	Metric_Histogram *m_write_us;
+	void register_metrics();
 
 	int  _open_port(const char* port);
 	bool _setup_port(int baud, int data_bits, int stop_bits, bool parity, bool hardware_control);
-	int  _read_port(uint8_t &cp);
+	int  _read_port(uint8_t *buf, size_t len);
 	int _write_port(char *buf, unsigned len);
 
 };
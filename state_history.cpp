@@ -0,0 +1,184 @@
+/**
+ * @file state_history.cpp
+ *
+ * @brief Short timestamped history of vehicle state for aligning telemetry with camera frames
+ *
+ */
+
+#include "state_history.h"
+
+#include <math.h>
+
+
+static float
+wrap_pi(float a)
+{
+    while (a > (float)M_PI)
+        a -= 2 * (float)M_PI;
+    while (a < -(float)M_PI)
+        a += 2 * (float)M_PI;
+    return a;
+}
+
+
+// ------------------------------------------------------------------------------
+//   State_Ring
+// ------------------------------------------------------------------------------
+void
+State_Ring::
+push(uint64_t t, float a, float b, float c)
+{
+    time_usec[head] = t;
+    v[head][0] = a;
+    v[head][1] = b;
+    v[head][2] = c;
+    head = (head + 1) % STATE_HISTORY_SIZE;
+    if (count < STATE_HISTORY_SIZE)
+        count++;
+}
+
+// 插值到 t 时刻, 超出缓冲区范围时取最近的一个采样
+bool
+State_Ring::
+at(uint64_t t, float max_gap, const bool angle[3], float out[3]) const
+{
+    if (count == 0)
+        return false;
+
+    // 从最新的采样往回找第一个不晚于 t 的采样
+    int newer = -1, older = -1;
+    for (int i = 1; i <= count; i++)
+    {
+        int idx = (head - i + STATE_HISTORY_SIZE) % STATE_HISTORY_SIZE;
+        if (time_usec[idx] <= t)
+        {
+            older = idx;
+            break;
+        }
+        newer = idx;
+    }
+
+    if (older < 0 || newer < 0)
+    {
+        int idx = (older < 0) ? newer : older;
+        uint64_t gap = (older < 0) ? time_usec[idx] - t : t - time_usec[idx];
+        for (int k = 0; k < 3; k++)
+            out[k] = v[idx][k];
+        return gap / 1e6f < max_gap;
+    }
+
+    float r = (float)(t - time_usec[older]) / (float)(time_usec[newer] - time_usec[older]);
+    for (int k = 0; k < 3; k++)
+    {
+        if (angle[k])
+            out[k] = wrap_pi(v[older][k] + r * wrap_pi(v[newer][k] - v[older][k]));
+        else
+            out[k] = v[older][k] + r * (v[newer][k] - v[older][k]);
+    }
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   State_History
+// ------------------------------------------------------------------------------
+State_History::
+State_History()
+{
+    max_gap = 0.5f;
+    attitude.head = attitude.count = 0;
+    position.head = position.count = 0;
+    heading.head = heading.count = 0;
+    pthread_mutex_init(&lock, NULL);
+}
+
+State_History::
+~State_History()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void
+State_History::
+clear()
+{
+    pthread_mutex_lock(&lock);
+    attitude.head = attitude.count = 0;
+    position.head = position.count = 0;
+    heading.head = heading.count = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+State_History::
+push_attitude(uint64_t time_usec, const mavlink_attitude_t &att)
+{
+    pthread_mutex_lock(&lock);
+    attitude.push(time_usec, att.roll, att.pitch, att.yaw);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+State_History::
+push_position(uint64_t time_usec, const mavlink_local_position_ned_t &pos)
+{
+    pthread_mutex_lock(&lock);
+    position.push(time_usec, pos.x, pos.y, pos.z);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+State_History::
+push_heading(uint64_t time_usec, uint16_t hdg)
+{
+    if (hdg == UINT16_MAX)  // 航向未知
+        return;
+    pthread_mutex_lock(&lock);
+    heading.push(time_usec, wrap_pi(hdg * (float)M_PI / 18000.0f), 0, 0);
+    pthread_mutex_unlock(&lock);
+}
+
+bool
+State_History::
+attitude_at(uint64_t time_usec, Attitude_Sample &out)
+{
+    static const bool angle[3] = {true, true, true};
+    float v[3] = {0, 0, 0};
+    pthread_mutex_lock(&lock);
+    bool ok = attitude.at(time_usec, max_gap, angle, v);
+    pthread_mutex_unlock(&lock);
+    out.time_usec = time_usec;
+    out.roll = v[0];
+    out.pitch = v[1];
+    out.yaw = v[2];
+    return ok;
+}
+
+bool
+State_History::
+position_at(uint64_t time_usec, Position_Sample &out)
+{
+    static const bool angle[3] = {false, false, false};
+    float v[3] = {0, 0, 0};
+    pthread_mutex_lock(&lock);
+    bool ok = position.at(time_usec, max_gap, angle, v);
+    pthread_mutex_unlock(&lock);
+    out.time_usec = time_usec;
+    out.x = v[0];
+    out.y = v[1];
+    out.z = v[2];
+    return ok;
+}
+
+bool
+State_History::
+heading_at(uint64_t time_usec, float &yaw)
+{
+    static const bool angle[3] = {true, false, false};
+    float v[3] = {0, 0, 0};
+    pthread_mutex_lock(&lock);
+    bool ok = heading.at(time_usec, max_gap, angle, v);
+    pthread_mutex_unlock(&lock);
+    yaw = v[0];
+    return ok;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file state_history.h
+ *
+ * @brief Short timestamped history of vehicle state for aligning telemetry with camera frames
+ *
+ * 读线程每收到一条 ATTITUDE / LOCAL_POSITION_NED / GLOBAL_POSITION_INT 就存入对应的环形缓冲区,
+ * 时间戳为收到时的 get_time_usec().  视觉线程用图像的采集时刻查询, 在前后两个采样之间线性插值,
+ * 这样反投影用的是拍照瞬间的位置和姿态, 而不是检测结束时最新的一条消息.
+ *
+ */
+
+#ifndef STATE_HISTORY_H_
+#define STATE_HISTORY_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mavlink/common/mavlink.h"
+
+// 每种状态保存的采样数, 按 50Hz 约 1.3 秒
+#define STATE_HISTORY_SIZE 64
+
+
+struct Attitude_Sample
+{
+    uint64_t time_usec;
+    float roll;     // rad
+    float pitch;    // rad
+    float yaw;      // rad, [-pi, pi]
+};
+
+struct Position_Sample
+{
+    uint64_t time_usec;
+    float x;        // 局部坐标, 北东地 (m)
+    float y;
+    float z;
+};
+
+
+// 单一状态的环形缓冲区, 每个采样最多 3 个分量, angle 中为 true 的分量按角度插值
+struct State_Ring
+{
+    uint64_t time_usec[STATE_HISTORY_SIZE];
+    float v[STATE_HISTORY_SIZE][3];
+    int head;       // 下一个写入位置
+    int count;
+
+    void push(uint64_t t, float a, float b, float c);
+    bool at(uint64_t t, float max_gap, const bool angle[3], float out[3]) const;
+};
+
+
+class State_History
+{
+
+public:
+
+    State_History();
+    ~State_History();
+
+    float max_gap;      // 查询时刻离最近的采样超过该值则认为没有数据 (s)
+
+    void push_attitude(uint64_t time_usec, const mavlink_attitude_t &att);
+    void push_position(uint64_t time_usec, const mavlink_local_position_ned_t &pos);
+    void push_heading(uint64_t time_usec, uint16_t hdg);
+
+    bool attitude_at(uint64_t time_usec, Attitude_Sample &out);
+    bool position_at(uint64_t time_usec, Position_Sample &out);
+    bool heading_at(uint64_t time_usec, float &yaw);
+
+    void clear();
+
+private:
+
+    State_Ring attitude;
+    State_Ring position;
+    State_Ring heading;     // global_position_int.hdg, 换算为 rad
+
+    pthread_mutex_t lock;
+
+};
+
+#endif // STATE_HISTORY_H_
@@ -0,0 +1,267 @@
+/**
+ * @file stream_rates.cpp
+ *
+ * @brief Startup negotiation of the autopilot's telemetry stream rates
+ *
+ */
+
+#include "stream_rates.h"
+#include "autopilot_interface.h"
+#include "flight_log.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <string>
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Stream_Rates::
+Stream_Rates()
+{
+    suppress_others = true;
+    ack_timeout_ms = 300;
+    attempts = 3;
+    verify_ms = 2000;
+    n_requests = 0;
+    memset(requests, 0, sizeof(requests));
+
+    // 任务和控制用到的遥测; 控制周期为 APPROACH_CONTROL_HZ
+    set(MAVLINK_MSG_ID_LOCAL_POSITION_NED, 20, MAV_DATA_STREAM_POSITION);
+    set(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 10, MAV_DATA_STREAM_POSITION);
+    set(MAVLINK_MSG_ID_ATTITUDE, 20, MAV_DATA_STREAM_EXTRA1);
+    set(MAVLINK_MSG_ID_SYS_STATUS, 1, MAV_DATA_STREAM_EXTENDED_STATUS);
+}
+
+void
+Stream_Rates::
+set(uint8_t msgid, float hz, uint8_t stream)
+{
+    for (int i = 0; i < n_requests; i++)
+    {
+        if (requests[i].msgid != msgid)
+            continue;
+        if (hz > 0)
+        {
+            requests[i].hz = hz;
+            requests[i].stream = stream;
+        }
+        else
+            requests[i] = requests[--n_requests];
+        return;
+    }
+    if (hz <= 0 || n_requests >= STREAM_RATES_MAX)
+        return;
+
+    Stream_Request &r = requests[n_requests++];
+    memset(&r, 0, sizeof(r));
+    r.msgid = msgid;
+    r.hz = hz;
+    r.stream = stream;
+}
+
+
+// ------------------------------------------------------------------------------
+//   发送请求
+// ------------------------------------------------------------------------------
+
+// 发一条 SET_MESSAGE_INTERVAL, 等待 COMMAND_ACK. 被接受时返回 true
+bool
+Stream_Rates::
+set_interval(Autopilot_Interface &api, const Stream_Request &r)
+{
+    mavlink_command_long_t com = { 0 };
+    com.target_system = api.system_id;
+    com.target_component = api.autopilot_id;
+    com.command = MAV_CMD_SET_MESSAGE_INTERVAL;
+    com.param1 = r.msgid;
+    com.param2 = 1e6f / r.hz;       // 间隔 (us)
+
+    mavlink_message_t message;
+    mavlink_msg_command_long_encode(255, 190, &message, &com);
+
+    for (int attempt = 0; attempt < attempts; attempt++)
+    {
+        uint64_t sent = get_time_usec();
+        api.write_message(message);
+
+        for (int waited = 0; waited < ack_timeout_ms; waited += 10)
+        {
+            usleep(10000);
+            if (api.current_messages.time_stamps.command_ack < sent ||
+                api.current_messages.command_ack.command != MAV_CMD_SET_MESSAGE_INTERVAL)
+                continue;
+            return api.current_messages.command_ack.result == MAV_RESULT_ACCEPTED;
+        }
+    }
+    return false;
+}
+
+void
+Stream_Rates::
+request_stream(Autopilot_Interface &api, uint8_t stream, float hz, bool start)
+{
+    mavlink_request_data_stream_t com = { 0 };
+    com.target_system = api.system_id;
+    com.target_component = api.autopilot_id;
+    com.req_stream_id = stream;
+    com.req_message_rate = (uint16_t)ceilf(hz);
+    com.start_stop = start;
+
+    mavlink_message_t message;
+    mavlink_msg_request_data_stream_encode(255, 190, &message, &com);
+    api.write_message(message);
+    usleep(1000);
+}
+
+// 退回 REQUEST_DATA_STREAM 的消息按数据流合并, 每个数据流请求一次, 频率取最高的
+void
+Stream_Rates::
+request_fallback(Autopilot_Interface &api, bool all)
+{
+    float stream_hz[MAV_DATA_STREAM_EXTRA3 + 1] = { 0 };
+    for (int i = 0; i < n_requests; i++)
+    {
+        const Stream_Request &r = requests[i];
+        if (r.stream > MAV_DATA_STREAM_EXTRA3 || (!all && r.method != STREAM_METHOD_DATA_STREAM))
+            continue;
+        if (r.hz > stream_hz[r.stream])
+            stream_hz[r.stream] = r.hz;
+    }
+    for (int s = 0; s <= MAV_DATA_STREAM_EXTRA3; s++)
+        if (stream_hz[s] > 0)
+            request_stream(api, s, stream_hz[s], true);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Negotiate
+// ------------------------------------------------------------------------------
+bool
+Stream_Rates::
+negotiate(Autopilot_Interface &api)
+{
+    printf("NEGOTIATE STREAM RATES\n");
+
+    if (suppress_others)
+        request_stream(api, MAV_DATA_STREAM_ALL, 0, false);
+
+    for (int i = 0; i < n_requests; i++)
+    {
+        Stream_Request &r = requests[i];
+        r.method = set_interval(api, r) ? STREAM_METHOD_INTERVAL : STREAM_METHOD_DATA_STREAM;
+    }
+    request_fallback(api, false);
+
+    if (verify())
+        return true;
+
+    // 飞控接受了 SET_MESSAGE_INTERVAL 但频率不够 (例如被 SRx_ 参数限制) 时, 按数据流再请求一次
+    bool retry = false;
+    for (int i = 0; i < n_requests; i++)
+    {
+        Stream_Request &r = requests[i];
+        if (r.achieved_hz < r.hz / 2 && r.method == STREAM_METHOD_INTERVAL)
+        {
+            r.method = STREAM_METHOD_DATA_STREAM;
+            retry = true;
+        }
+    }
+    if (!retry)
+        return false;
+    request_fallback(api, false);
+    return verify();
+}
+
+void
+Stream_Rates::
+apply(Autopilot_Interface &api)
+{
+    if (suppress_others)
+        request_stream(api, MAV_DATA_STREAM_ALL, 0, false);
+
+    for (int i = 0; i < n_requests; i++)
+    {
+        const Stream_Request &r = requests[i];
+        if (r.method != STREAM_METHOD_INTERVAL)
+            continue;
+        mavlink_command_long_t com = { 0 };
+        com.target_system = api.system_id;
+        com.target_component = api.autopilot_id;
+        com.command = MAV_CMD_SET_MESSAGE_INTERVAL;
+        com.param1 = r.msgid;
+        com.param2 = 1e6f / r.hz;
+        mavlink_message_t message;
+        mavlink_msg_command_long_encode(255, 190, &message, &com);
+        api.write_message(message);
+    }
+
+    // 还没有协商过时全部按数据流请求
+    bool negotiated = false;
+    for (int i = 0; i < n_requests; i++)
+        if (requests[i].method != STREAM_METHOD_NONE)
+            negotiated = true;
+    request_fallback(api, !negotiated);
+}
+
+// 按 metrics.mavlink_rx 统计 verify_ms 内各消息的接收频率
+bool
+Stream_Rates::
+verify()
+{
+    static Metric_Gauge &unrequested = metrics.gauge("stream.unrequested_hz");
+
+    // 等新的设置生效, 前一次的消息从缓冲区中读完
+    usleep(500000);
+
+    uint64_t before[256];
+    for (int id = 0; id < 256; id++)
+        before[id] = metrics.mavlink_rx[id].get();
+    uint64_t t0 = metrics_now_usec();
+    usleep(verify_ms * 1000);
+    double dt = (metrics_now_usec() - t0) / 1e6;
+
+    bool ok = true;
+    bool requested[256] = { false };
+    for (int i = 0; i < n_requests; i++)
+    {
+        Stream_Request &r = requests[i];
+        requested[r.msgid] = true;
+        r.achieved_hz = (metrics.mavlink_rx[r.msgid].get() - before[r.msgid]) / dt;
+        if (r.achieved_hz < r.hz / 2)
+            ok = false;
+
+        const char *name = mavlink_message_name(r.msgid);
+        std::string label = name ? name : std::to_string(r.msgid);
+        std::string gauge = "stream." + label + "_hz";
+        metrics.gauge(gauge.c_str()).set(r.achieved_hz);
+
+        printf("STREAM %-20s requested %5.1f Hz, achieved %5.1f Hz (%s)\n", label.c_str(),
+               r.hz, r.achieved_hz, r.method == STREAM_METHOD_INTERVAL ? "SET_MESSAGE_INTERVAL" : "REQUEST_DATA_STREAM");
+        FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "stream %d requested %.1f Hz achieved %.1f Hz method %d",
+                       r.msgid, r.hz, r.achieved_hz, r.method);
+    }
+
+    // 仍在接收的其他消息 (HEARTBEAT 除外)
+    double other = 0;
+    for (int id = 0; id < 256; id++)
+    {
+        if (requested[id] || id == MAVLINK_MSG_ID_HEARTBEAT)
+            continue;
+        double hz = (metrics.mavlink_rx[id].get() - before[id]) / dt;
+        if (hz <= 0)
+            continue;
+        other += hz;
+        const char *name = mavlink_message_name(id);
+        std::string label = name ? name : std::to_string(id);
+        printf("STREAM %-20s unrequested %5.1f Hz\n", label.c_str(), hz);
+    }
+    unrequested.set(other);
+    printf("\n");
+
+    return ok;
+}
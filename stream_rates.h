@@ -0,0 +1,87 @@
+/**
+ * @file stream_rates.h
+ *
+ * @brief Startup negotiation of the autopilot's telemetry stream rates
+ *
+ * 原来 start() 收到任意一条消息后就直接使用飞控缺省的数据流, 链路上有大量没有人解码的消息
+ * (handle_message 的 default 分支), 占用串口带宽, 设定点和需要的遥测都要在它们后面排队.
+ * 启动时按下面的步骤协商:
+ *
+ *   1. REQUEST_DATA_STREAM(MAV_DATA_STREAM_ALL, start_stop = 0) 关闭所有数据流
+ *   2. 对每条需要的消息发 COMMAND_LONG MAV_CMD_SET_MESSAGE_INTERVAL (511), 等 COMMAND_ACK;
+ *      拒绝、不支持或超时的消息改用 REQUEST_DATA_STREAM 打开它所在的数据流 (同一数据流取最高频率)
+ *   3. 按 metrics.mavlink_rx 的计数统计 verify_ms 内实际的接收频率, 低于一半的再用
+ *      REQUEST_DATA_STREAM 请求一次; 结果写入 stream.<消息名>_hz 和 stream.unrequested_hz
+ *
+ * HEARTBEAT 不受数据流控制, 不需要请求.
+ *
+ */
+
+#ifndef STREAM_RATES_H_
+#define STREAM_RATES_H_
+
+#include <stdint.h>
+
+#include "mavlink/common/mavlink.h"
+
+class Autopilot_Interface;
+
+
+#define STREAM_RATES_MAX 16
+
+enum Stream_Method
+{
+    STREAM_METHOD_NONE = 0,
+    STREAM_METHOD_INTERVAL,     // SET_MESSAGE_INTERVAL 被接受
+    STREAM_METHOD_DATA_STREAM,  // 退回 REQUEST_DATA_STREAM
+};
+
+struct Stream_Request
+{
+    uint8_t msgid;
+    float hz;
+    uint8_t stream;             // 退回时使用的 MAV_DATA_STREAM_*
+    uint8_t method;             // Stream_Method
+    float achieved_hz;          // 验证时测得的频率
+};
+
+
+class Stream_Rates
+{
+
+public:
+
+    Stream_Rates();
+
+    bool suppress_others;       // 先关闭所有数据流
+    int ack_timeout_ms;
+    int attempts;               // 每条 SET_MESSAGE_INTERVAL 最多发几次
+    int verify_ms;              // 统计实际频率的时长
+
+    // 设置一条消息的期望频率, hz <= 0 时不再请求
+    void set(uint8_t msgid, float hz, uint8_t stream);
+
+    // 在读线程运行、system_id 已知之后调用, 阻塞到协商和验证结束.
+    // 所有消息都达到期望频率的一半以上时返回 true
+    bool negotiate(Autopilot_Interface &api);
+
+    // 按协商的结果重发请求, 不等待确认. 飞控的数据流被重新设置过 (例如切换模式前) 之后调用
+    void apply(Autopilot_Interface &api);
+
+    int count() const { return n_requests; }
+    const Stream_Request &request(int i) const { return requests[i]; }
+
+private:
+
+    Stream_Request requests[STREAM_RATES_MAX];
+    int n_requests;
+
+    bool set_interval(Autopilot_Interface &api, const Stream_Request &r);
+    void request_stream(Autopilot_Interface &api, uint8_t stream, float hz, bool start);
+    void request_fallback(Autopilot_Interface &api, bool all);
+    bool verify();
+
+};
+
+
+#endif // STREAM_RATES_H_
@@ -0,0 +1,598 @@
+/**
+ * @file swarm_map.cpp
+ *
+ * @brief Swarm-wide target map replicated over the WL link
+ *
+ */
+
+#include "swarm_map.h"
+#include "autopilot_interface.h"
+#include "flight_log.h"
+#include "metrics.h"
+#include "runtime_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+Swarm_Map swarm_map;
+
+#define EARTH_RADIUS 6378137.0
+#define DEGE7_TO_M   (EARTH_RADIUS * M_PI / 180.0 / 1e7)
+
+// 版本号 16 位回绕, 按序列号比较
+static bool
+newer(uint16_t a, uint16_t b)
+{
+    return (int16_t)(a - b) > 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   坐标
+// ------------------------------------------------------------------------------
+bool
+local_to_global(Autopilot_Interface &api, float x, float y, int32_t &lat, int32_t &lon)
+{
+    mavlink_global_position_int_t gp = api.current_messages.global_position_int;
+    mavlink_local_position_ned_t lp = api.current_messages.local_position_ned;
+    if (gp.lat == 0 && gp.lon == 0)
+        return false;
+
+    double dn = x - lp.x;
+    double de = y - lp.y;
+    lat = gp.lat + (int32_t)lround(dn / DEGE7_TO_M);
+    lon = gp.lon + (int32_t)lround(de / (DEGE7_TO_M * cos(gp.lat * 1e-7 * M_PI / 180.0)));
+    return true;
+}
+
+// 两点的南北 / 东西距离都在 merge_dist 以内, 与 possible_ellipse_r 的判断方式一致
+static bool
+near(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2)
+{
+    double dn = (lat1 - lat2) * DEGE7_TO_M;
+    double de = (lon1 - lon2) * DEGE7_TO_M * cos(lat1 * 1e-7 * M_PI / 180.0);
+    float merge = current_vision_config()->target.merge_dist;
+    return fabs(dn) < merge && fabs(de) < merge;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Swarm_Target
+// ------------------------------------------------------------------------------
+uint32_t
+Swarm_Target::
+T_N() const
+{
+    uint32_t n = 0;
+    for (int i = 0; i < SWARM_MAX_VOTERS; i++)
+        n += votes[i].T_N;
+    return n;
+}
+
+uint32_t
+Swarm_Target::
+F_N() const
+{
+    uint32_t n = 0;
+    for (int i = 0; i < SWARM_MAX_VOTERS; i++)
+        n += votes[i].F_N;
+    return n;
+}
+
+int
+Swarm_Target::
+decision() const
+{
+    // 与 resultTF 相同的规则
+    const Target_Config &c = current_vision_config()->target;
+    uint32_t T = T_N(), F = F_N();
+    float possible = (float)T / (float)(T + F + 0.001);
+    if (possible > c.t_possible && T > (uint32_t)c.min_votes)
+        return 1;
+    if (possible < c.t_possible && F > (uint32_t)c.min_votes)
+        return 0;
+    return -1;
+}
+
+bool
+Swarm_Target::
+local_only(uint8_t self) const
+{
+    for (int i = 0; i < SWARM_MAX_VOTERS; i++)
+        if (votes[i].voter && votes[i].voter != self && (votes[i].T_N || votes[i].F_N))
+            return false;
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Swarm_Map::
+Swarm_Map()
+{
+    link_bytes = 5760;          // 57600 波特, 每字节 10 位
+    rate_bytes = 600;           // 约 10%, 每秒两包多
+    interval_ms = 500;
+    full_sync_ms = 10000;
+
+    api = NULL;
+    self = 0;
+    running = false;
+    time_to_exit = false;
+    subscription = 0;
+    n_targets = 0;
+    memset(targets, 0, sizeof(targets));
+    for (int i = 0; i < TRACKER_MAX_TARGETS; i++)
+        local_index[i] = -1;
+    tokens = 0;
+    tokens_usec = 0;
+    next_full_usec = 0;
+
+    pthread_mutex_init(&lock, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+Swarm_Map::
+~Swarm_Map()
+{
+    stop();
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Start / Stop
+// ------------------------------------------------------------------------------
+static void *
+start_swarm_map_thread(void *args)
+{
+    ((Swarm_Map *)args)->send_thread();
+    return NULL;
+}
+
+bool
+Swarm_Map::
+start(Autopilot_Interface &api_)
+{
+    if (running)
+        return true;
+
+    api = &api_;
+    self = api->wl_link.system_id();
+    time_to_exit = false;
+
+    // 视觉线程中调用, 只更新本机的票数, 不等待
+    subscription = target_channel.subscribe(
+        [this](const Target_Snapshot_Ptr &prev, const Target_Snapshot_Ptr &next) {
+            update_local(*next);
+        });
+
+    if (pthread_create(&send_tid, NULL, &start_swarm_map_thread, this) != 0)
+    {
+        fprintf(stderr, "WARNING: could not start swarm map thread\n");
+        target_channel.unsubscribe(subscription);
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+void
+Swarm_Map::
+stop()
+{
+    if (!running)
+        return;
+
+    target_channel.unsubscribe(subscription);
+
+    pthread_mutex_lock(&lock);
+    time_to_exit = true;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+
+    pthread_join(send_tid, NULL);
+    running = false;
+}
+
+
+// ------------------------------------------------------------------------------
+//   表操作 (持有 lock 时调用)
+// ------------------------------------------------------------------------------
+Swarm_Target *
+Swarm_Map::
+find(uint8_t origin, uint8_t idx)
+{
+    for (int i = 0; i < n_targets; i++)
+        if (targets[i].origin == origin && targets[i].idx == idx)
+            return &targets[i];
+    return NULL;
+}
+
+Swarm_Target *
+Swarm_Map::
+find_near(int32_t lat, int32_t lon)
+{
+    for (int i = 0; i < n_targets; i++)
+        if (near(targets[i].lat, targets[i].lon, lat, lon))
+            return &targets[i];
+    return NULL;
+}
+
+Swarm_Target *
+Swarm_Map::
+add(uint8_t origin, uint8_t idx, int32_t lat, int32_t lon)
+{
+    static Metric_Counter &full = metrics.counter("swarm.map_full");
+    static Metric_Gauge &size = metrics.gauge("swarm.targets");
+
+    if (n_targets >= SWARM_MAX_TARGETS)
+    {
+        full.add();
+        return NULL;
+    }
+    Swarm_Target &t = targets[n_targets++];
+    memset(&t, 0, sizeof(t));
+    t.origin = origin;
+    t.idx = idx;
+    t.lat = lat;
+    t.lon = lon;
+    size.set(n_targets);
+    return &t;
+}
+
+Swarm_Vote *
+Swarm_Map::
+vote(Swarm_Target &t, uint8_t voter)
+{
+    for (int i = 0; i < SWARM_MAX_VOTERS; i++)
+        if (t.votes[i].voter == voter)
+            return &t.votes[i];
+    for (int i = 0; i < SWARM_MAX_VOTERS; i++)
+    {
+        if (t.votes[i].voter == 0)
+        {
+            t.votes[i].voter = voter;
+            return &t.votes[i];
+        }
+    }
+    return NULL;
+}
+
+
+// ------------------------------------------------------------------------------
+//   本机目标表
+// ------------------------------------------------------------------------------
+void
+Swarm_Map::
+update_local(const Target_Snapshot &snapshot)
+{
+    if (!api)
+        return;
+
+    pthread_mutex_lock(&lock);
+    size_t n = snapshot.targets.size();
+    if (n > TRACKER_MAX_TARGETS)
+        n = TRACKER_MAX_TARGETS;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const target &p = snapshot.targets[i];
+        int32_t lat, lon;
+        if (!local_to_global(*api, p.locx, p.locy, lat, lon))
+            break;
+
+        Swarm_Target *t;
+        if (local_index[i] < 0)
+        {
+            // 其他飞机已经报告过的目标, 票记在它的编号下
+            t = find_near(lat, lon);
+            if (!t)
+                t = add(self, i, lat, lon);
+            if (!t)
+                break;
+            local_index[i] = t - targets;
+            FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "swarm target %d.%d <- local %d", t->origin, t->idx, (int)i);
+        }
+        t = &targets[local_index[i]];
+
+        Swarm_Vote *v = vote(*t, self);
+        uint16_t T = p.T_N < 0xFFFF ? p.T_N : 0xFFFF;
+        uint16_t F = p.F_N < 0xFFFF ? p.F_N : 0xFFFF;
+        if (!v || (v->T_N == T && v->F_N == F && v->version))
+            continue;
+
+        v->T_N = T;
+        v->F_N = F;
+        if (++v->version == 0)
+            v->version = 1;
+        if (t->origin == self)
+        {
+            t->lat = lat;
+            t->lon = lon;
+            t->lat_version = v->version;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Receive
+// ------------------------------------------------------------------------------
+bool
+Swarm_Map::
+receive(const mavlink_message_t &message)
+{
+    static Metric_Counter &rx_packets = metrics.counter("swarm.rx_packets");
+    static Metric_Counter &rx_bytes = metrics.counter("swarm.rx_bytes");
+
+    if (message.msgid != MAVLINK_MSG_ID_V2_EXTENSION ||
+        mavlink_msg_v2_extension_get_message_type(&message) != SWARM_MAP_MESSAGE_TYPE)
+        return false;
+
+    uint8_t payload[249];
+    mavlink_msg_v2_extension_get_payload(&message, payload);
+
+    Swarm_Map_Header header;
+    memcpy(&header, payload, sizeof(header));
+    if (header.count > SWARM_MAP_RECORDS)
+        return true;
+
+    rx_packets.add();
+    rx_bytes.add(message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < header.count; i++)
+    {
+        Swarm_Map_Record record;
+        memcpy(&record, payload + sizeof(header) + i * sizeof(record), sizeof(record));
+        // 本机的票以本机为准
+        if (record.voter != self && record.voter != 0)
+            merge(header, record);
+    }
+    pthread_mutex_unlock(&lock);
+    return true;
+}
+
+// 持有 lock 时调用. 逐项取版本号大的, 重复或乱序到达的记录不改变结果
+void
+Swarm_Map::
+merge(const Swarm_Map_Header &header, const Swarm_Map_Record &record)
+{
+    static Metric_Counter &rx_records = metrics.counter("swarm.rx_records");
+    static Metric_Counter &merged = metrics.counter("swarm.rx_merged");
+
+    rx_records.add();
+    int32_t lat = header.base_lat + record.dlat * 10;
+    int32_t lon = header.base_lon + record.dlon * 10;
+
+    Swarm_Target *t = find(record.origin, record.idx);
+    if (!t)
+    {
+        t = add(record.origin, record.idx, lat, lon);
+        if (!t)
+            return;
+        FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "swarm target %d.%d from %d", record.origin, record.idx, record.voter);
+    }
+
+    Swarm_Vote *v = vote(*t, record.voter);
+    if (!v || (v->version && !newer(record.version, v->version)))
+        return;
+
+    int decided = t->decision();
+    v->version = record.version;
+    v->T_N = record.T_N;
+    v->F_N = record.F_N;
+    if (record.voter == record.origin && (!t->lat_version || newer(record.version, t->lat_version)))
+    {
+        t->lat = lat;
+        t->lon = lon;
+        t->lat_version = record.version;
+    }
+    merged.add();
+
+    if (decided < 0 && t->decision() >= 0)
+        FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "swarm target %d.%d classified %c (T %u F %u)",
+                       t->origin, t->idx, t->decision() ? 'T' : 'F', t->T_N(), t->F_N());
+}
+
+
+// ------------------------------------------------------------------------------
+//   查询
+// ------------------------------------------------------------------------------
+bool
+Swarm_Map::
+classified_near(int32_t lat, int32_t lon, uint8_t &by, int &decision)
+{
+    bool found = false;
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < n_targets && !found; i++)
+    {
+        const Swarm_Target &t = targets[i];
+        if (!near(t.lat, t.lon, lat, lon) || t.local_only(self))
+            continue;
+        decision = t.decision();
+        if (decision < 0)
+            continue;
+        by = t.origin;
+        found = true;
+    }
+    pthread_mutex_unlock(&lock);
+    return found;
+}
+
+int
+Swarm_Map::
+size()
+{
+    pthread_mutex_lock(&lock);
+    int n = n_targets;
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+bool
+Swarm_Map::
+get(int i, Swarm_Target &out)
+{
+    pthread_mutex_lock(&lock);
+    bool ok = i >= 0 && i < n_targets;
+    if (ok)
+        out = targets[i];
+    pthread_mutex_unlock(&lock);
+    return ok;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Send
+// ------------------------------------------------------------------------------
+
+// 持有 lock 时调用. 把本机变化过的票写进 payload, 返回记录数
+int
+Swarm_Map::
+build(uint8_t *payload)
+{
+    Swarm_Map_Header header;
+    memset(&header, 0, sizeof(header));
+    int count = 0;
+
+    for (int i = 0; i < n_targets && count < SWARM_MAP_RECORDS; i++)
+    {
+        Swarm_Target &t = targets[i];
+        Swarm_Vote *v = NULL;
+        for (int k = 0; k < SWARM_MAX_VOTERS; k++)
+            if (t.votes[k].voter == self)
+                v = &t.votes[k];
+        if (!v || !v->version || v->version == v->sent_version)
+            continue;
+
+        if (count == 0)
+        {
+            header.base_lat = t.lat;
+            header.base_lon = t.lon;
+        }
+        // 离基准太远的留到下一包
+        int32_t dlat = (t.lat - header.base_lat) / 10;
+        int32_t dlon = (t.lon - header.base_lon) / 10;
+        if (dlat < INT16_MIN || dlat > INT16_MAX || dlon < INT16_MIN || dlon > INT16_MAX)
+            continue;
+
+        Swarm_Map_Record record;
+        record.origin = t.origin;
+        record.idx = t.idx;
+        record.voter = self;
+        record.version = v->version;
+        record.T_N = v->T_N;
+        record.F_N = v->F_N;
+        record.dlat = dlat;
+        record.dlon = dlon;
+        memcpy(payload + sizeof(header) + count * sizeof(record), &record, sizeof(record));
+        v->sent_version = v->version;
+        count++;
+    }
+
+    header.count = count;
+    memcpy(payload, &header, sizeof(header));
+    return count;
+}
+
+void
+Swarm_Map::
+send_thread()
+{
+    static Metric_Counter &tx_packets = metrics.counter("swarm.tx_packets");
+    static Metric_Counter &tx_bytes = metrics.counter("swarm.tx_bytes");
+    static Metric_Counter &tx_records = metrics.counter("swarm.tx_records");
+    static Metric_Counter &deferred = metrics.counter("swarm.tx_deferred");
+    static Metric_Gauge &link_share = metrics.gauge("swarm.link_share");
+
+    const double frame_bytes = MAVLINK_MSG_ID_V2_EXTENSION_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    uint64_t window_usec = metrics_now_usec();
+    uint64_t window_bytes = 0;
+
+    pthread_mutex_lock(&lock);
+    tokens = frame_bytes;
+    tokens_usec = metrics_now_usec();
+    next_full_usec = tokens_usec + (uint64_t)full_sync_ms * 1000;
+
+    while (!time_to_exit)
+    {
+        uint64_t now = metrics_now_usec();
+
+        // 全量同步: 本机的票全部标为未发送
+        if (now >= next_full_usec)
+        {
+            for (int i = 0; i < n_targets; i++)
+                for (int k = 0; k < SWARM_MAX_VOTERS; k++)
+                    if (targets[i].votes[k].voter == self)
+                        targets[i].votes[k].sent_version = 0;
+            next_full_usec = now + (uint64_t)full_sync_ms * 1000;
+        }
+
+        // 令牌桶, 最多攒一包
+        tokens += (now - tokens_usec) * 1e-6 * rate_bytes;
+        if (tokens > frame_bytes)
+            tokens = frame_bytes;
+        tokens_usec = now;
+
+        uint8_t payload[MAVLINK_MSG_V2_EXTENSION_FIELD_PAYLOAD_LEN];
+        memset(payload, 0, sizeof(payload));
+        int count = 0;
+        bool dirty = false;
+        for (int i = 0; i < n_targets && !dirty; i++)
+            for (int k = 0; k < SWARM_MAX_VOTERS; k++)
+                if (targets[i].votes[k].voter == self && targets[i].votes[k].version != targets[i].votes[k].sent_version)
+                    dirty = true;
+
+        if (dirty && tokens < frame_bytes)
+            deferred.add();
+        else if (dirty)
+        {
+            count = build(payload);
+            tokens -= frame_bytes;
+        }
+        pthread_mutex_unlock(&lock);
+
+        if (count > 0)
+        {
+            mavlink_message_t message;
+            mavlink_msg_v2_extension_pack(self, WL_BROADCAST, &message, 0, WL_BROADCAST, 0,
+                                          SWARM_MAP_MESSAGE_TYPE, payload);
+            api->wl_link.send(message, WL_PRIORITY_LOW, false);
+            tx_packets.add();
+            tx_bytes.add(frame_bytes);
+            tx_records.add(count);
+            window_bytes += frame_bytes;
+        }
+
+        // 实际占用的链路比例
+        if (now - window_usec >= 5000000)
+        {
+            link_share.set(window_bytes / ((now - window_usec) * 1e-6) / link_bytes);
+            window_usec = now;
+            window_bytes = 0;
+        }
+
+        pthread_mutex_lock(&lock);
+        if (time_to_exit)
+            break;
+        uint64_t deadline = metrics_now_usec() + (uint64_t)interval_ms * 1000;
+        struct timespec ts;
+        ts.tv_sec = deadline / 1000000;
+        ts.tv_nsec = (deadline % 1000000) * 1000;
+        pthread_cond_timedwait(&cond, &lock, &ts);
+    }
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file swarm_map.h
+ *
+ * @brief Swarm-wide target map replicated over the WL link
+ *
+ * 每架飞机的视觉只维护自己的目标表, 原来只在分配投放时给某一架从机发一条 GLOBAL_POSITION_INT,
+ * 其他飞机飞到同一个目标上还要从头识别一遍. 这里把各机的目标表合并成一张共享的地图:
+ *
+ *   - 每个目标由最先发现它的飞机编号 (origin, 本机目标表下标 idx) 标识, 位置为经纬度.
+ *     本机新发现的目标若在已知目标 merge_dist 米以内, 归到已知目标上, 不再新建.
+ *   - 每个目标按投票的飞机分别记 T / F 票数和版本号 (版本向量). 每架飞机只修改自己那一份,
+ *     收到别人的记录时逐项取版本号大的, 合并与收到的先后和重复无关, 丢包后下一次全量同步即可补齐.
+ *   - 票数合计后按 resultTF 的规则判定 T / F; 任务在选择下一个目标时跳过已被其他飞机判定的目标.
+ *     距离和判定阈值与视觉使用同一份 vision_config (config/uav.yml 的 target 一节).
+ *
+ * 线上格式: V2_EXTENSION (message_type SWARM_MAP_MESSAGE_TYPE, target_system 0 广播),
+ * payload 为 Swarm_Map_Header 加最多 SWARM_MAP_RECORDS 条 Swarm_Map_Record. 记录中的位置是相对
+ * 包头基准点的 1e-6 度增量 (约 0.1m, 范围约 3km), 只发送上次发送后变化过的记录,
+ * 每 full_sync_ms 把本机的全部记录重发一遍.
+ *
+ * 57600 的数传每秒约 5760 字节, MAVLink 1 的 V2_EXTENSION 定长 262 字节. 发送按 rate_bytes
+ * (字节/秒) 的令牌桶限速, 缺省约占链路的 10%; 实际占用见 swarm.* 指标.
+ *
+ */
+
+#ifndef SWARM_MAP_H_
+#define SWARM_MAP_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mavlink/common/mavlink.h"
+#include "target_channel.h"
+#include "target_tracker.h"
+
+class Autopilot_Interface;
+
+
+#define SWARM_MAP_MESSAGE_TYPE  0xA001      // >= 32768 为非注册的扩展
+#define SWARM_MAX_TARGETS       64
+#define SWARM_MAX_VOTERS        4           // 每个目标最多记几架飞机的票
+#define SWARM_MAP_RECORDS       18
+
+// 线上格式, 小端
+#pragma pack(push, 1)
+struct Swarm_Map_Header
+{
+    int32_t base_lat;       // degE7
+    int32_t base_lon;
+    uint8_t count;
+};
+
+struct Swarm_Map_Record
+{
+    uint8_t origin;         // 目标编号
+    uint8_t idx;
+    uint8_t voter;          // 这份票数属于哪架飞机
+    uint16_t version;
+    uint16_t T_N;
+    uint16_t F_N;
+    int16_t dlat;           // 相对 base, 1e-6 度
+    int16_t dlon;
+};
+#pragma pack(pop)
+
+struct Swarm_Vote
+{
+    uint8_t voter;          // 0 为空
+    uint16_t version;
+    uint16_t T_N, F_N;
+    uint16_t sent_version;  // 本机的票: 上次广播的版本
+};
+
+struct Swarm_Target
+{
+    uint8_t origin;
+    uint8_t idx;
+    int32_t lat, lon;       // degE7, 由 origin 的记录给出
+    uint16_t lat_version;   // 给出当前位置的那条记录的版本
+    Swarm_Vote votes[SWARM_MAX_VOTERS];
+
+    uint32_t T_N() const;
+    uint32_t F_N() const;
+
+    // 1 为 T, 0 为 F, -1 为未判定
+    int decision() const;
+
+    // 只有本机投过票
+    bool local_only(uint8_t self) const;
+};
+
+
+class Swarm_Map
+{
+
+public:
+
+    Swarm_Map();
+    ~Swarm_Map();
+
+    uint32_t link_bytes;        // 链路容量 (字节/秒), 用于 swarm.link_share
+    uint32_t rate_bytes;        // 发送限速 (字节/秒)
+    uint32_t interval_ms;       // 两次发送之间的最小间隔
+    uint32_t full_sync_ms;      // 全量同步周期
+
+    // 订阅 target_channel, 启动发送线程
+    bool start(Autopilot_Interface &api);
+    void stop();
+
+    // WL 读线程收到 V2_EXTENSION 时调用, 不是目标地图时返回 false
+    bool receive(const mavlink_message_t &message);
+
+    // (lat, lon) 附近已被其他飞机判定的目标, 没有时返回 false
+    bool classified_near(int32_t lat, int32_t lon, uint8_t &by, int &decision);
+
+    int size();
+    bool get(int i, Swarm_Target &out);
+
+    void send_thread();
+
+private:
+
+    Autopilot_Interface *api;
+    uint8_t self;
+    bool running;
+    bool time_to_exit;
+    int subscription;
+    pthread_t send_tid;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    Swarm_Target targets[SWARM_MAX_TARGETS];
+    int n_targets;
+    int local_index[TRACKER_MAX_TARGETS];    // 本机目标表下标 -> targets 下标, -1 为未登记
+
+    double tokens;
+    uint64_t tokens_usec;
+    uint64_t next_full_usec;
+
+    void update_local(const Target_Snapshot &snapshot);
+    Swarm_Target *find(uint8_t origin, uint8_t idx);
+    Swarm_Target *find_near(int32_t lat, int32_t lon);
+    Swarm_Target *add(uint8_t origin, uint8_t idx, int32_t lat, int32_t lon);
+    Swarm_Vote *vote(Swarm_Target &t, uint8_t voter);
+    void merge(const Swarm_Map_Header &header, const Swarm_Map_Record &record);
+    int build(uint8_t *payload);
+
+};
+
+extern Swarm_Map swarm_map;
+
+// 本机局部坐标 (NED, m) 换算为经纬度, 以当前的 GLOBAL_POSITION_INT 和 LOCAL_POSITION_NED 为基准
+bool local_to_global(Autopilot_Interface &api, float x, float y, int32_t &lat, int32_t &lon);
+
+
+#endif // SWARM_MAP_H_
@@ -0,0 +1,12 @@
+/**
+ * @file target_channel.cpp
+ *
+ * @brief Channels between the vision thread and the mission state machine
+ *
+ */
+
+#include "target_channel.h"
+
+
+Channel<Vision_Mode> vision_mode;
+Channel<Target_Snapshot> target_channel;
@@ -0,0 +1,64 @@
+/**
+ * @file target_channel.h
+ *
+ * @brief Channels between the vision thread and the mission state machine
+ *
+ * 取代视频线程和任务线程共用的全局变量 stable / updateellipse / drop / TargetNum /
+ * droptarget / target_ellipse_position / ellipse_T / ellipse_F:
+ *
+ *   vision_mode     任务线程 -> 视觉: 当前目标编号以及是否在识别 / 只更新当前目标 / 找投放点.
+ *                   每次修改 epoch 加一, 视觉在下一帧开始时取用.
+ *   target_channel  视觉 -> 任务线程: 每帧处理完后发布一份目标表快照. 目标表由视觉线程独占,
+ *                   快照发布后不再修改, 任务线程按下标访问时不会遇到 push_back 导致的重新分配.
+ *
+ * 快照中的 classified / drop_found 只对 mode_epoch 对应的那次 vision_mode 有效.
+ *
+ */
+
+#ifndef TARGET_CHANNEL_H_
+#define TARGET_CHANNEL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "channel.h"
+#include "ellipse/EllipseDetectorYaed.h"
+
+
+// 任务线程交给视觉的工作方式
+struct Vision_Mode
+{
+    bool stable;            // 对当前目标累计 T / F 计数, 直到给出结论
+    bool update;            // 只更新当前目标, 不再加入新目标
+    bool drop;              // 在投放高度寻找小圆
+    int target_num;         // 当前目标在 targets 中的下标
+    uint32_t epoch;
+
+    Vision_Mode() : stable(false), update(false), drop(false), target_num(0), epoch(0) {}
+};
+
+// 一帧处理完后的目标表
+struct Target_Snapshot
+{
+    uint64_t frame_seq;
+    uint64_t time_usec;             // 图像采集时刻
+    uint32_t mode_epoch;            // 处理该帧时使用的 Vision_Mode
+
+    std::vector<target> targets;    // 发现的所有目标, 下标即目标编号
+    std::vector<target> T, F;       // 已给出结论的目标
+
+    bool classified;                // 当前目标已给出 T / F 结论
+    bool drop_found;                // 已找到投放点
+    coordinate drop_target;
+
+    Target_Snapshot() : frame_seq(0), time_usec(0), mode_epoch(0), classified(false), drop_found(false) {}
+};
+
+typedef Channel<Vision_Mode>::Ptr Vision_Mode_Ptr;
+typedef Channel<Target_Snapshot>::Ptr Target_Snapshot_Ptr;
+
+extern Channel<Vision_Mode> vision_mode;
+extern Channel<Target_Snapshot> target_channel;
+
+
+#endif // TARGET_CHANNEL_H_
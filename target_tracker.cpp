@@ -0,0 +1,212 @@
+/**
+ * @file target_tracker.cpp
+ *
+ * @brief Constant-velocity Kalman filter for ground targets in the local NED frame
+ *
+ */
+
+#include "target_tracker.h"
+
+#include <math.h>
+
+
+Target_Tracker::
+Target_Tracker()
+{
+    meas_noise  = 0.5f;
+    accel_noise = 0.3f;
+    gate        = 5.0f;
+    max_horizon = 1.0f;
+    timeout     = 2.0f;
+
+    pthread_mutex_init(&lock, NULL);
+    for (int i = 0; i <= TRACKER_MAX_TARGETS; i++)
+    {
+        tracks[i].valid = false;
+        tracks[i].updates = 0;
+    }
+}
+
+Target_Tracker::
+~Target_Tracker()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void
+Target_Tracker::
+reset(int id)
+{
+    if (id < 0 || id > TRACKER_MAX_TARGETS)
+        return;
+    pthread_mutex_lock(&lock);
+    tracks[id].valid = false;
+    tracks[id].updates = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+Target_Tracker::
+clear()
+{
+    for (int i = 0; i <= TRACKER_MAX_TARGETS; i++)
+        reset(i);
+}
+
+
+// ------------------------------------------------------------------------------
+//   测量更新
+// ------------------------------------------------------------------------------
+void
+Target_Tracker::
+update(int id, float x, float y, uint64_t time_usec)
+{
+    if (id < 0 || id > TRACKER_MAX_TARGETS)
+        return;
+
+    pthread_mutex_lock(&lock);
+    Track &t = tracks[id];
+
+    float dt = t.valid ? (float)((int64_t)(time_usec - t.time_usec)) / 1e6f : 0;
+    if (t.valid && dt > timeout)
+        t.valid = false;
+
+    if (t.valid)
+    {
+        if (dt > 0)
+        {
+            predict_axis(t.x, dt);
+            predict_axis(t.y, dt);
+            t.time_usec = time_usec;
+        }
+        // 与预测相差太远, 说明换了目标, 重新初始化
+        if (fabsf(x - t.x.p) > gate || fabsf(y - t.y.p) > gate)
+            t.valid = false;
+    }
+
+    if (!t.valid)
+    {
+        init_axis(t.x, x);
+        init_axis(t.y, y);
+        t.time_usec = time_usec;
+        t.updates = 1;
+        t.valid = true;
+    }
+    else
+    {
+        update_axis(t.x, x);
+        update_axis(t.y, y);
+        t.updates++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   预测 time_usec 时刻的位置, 跟踪丢失时返回 false
+// ------------------------------------------------------------------------------
+bool
+Target_Tracker::
+predict(int id, uint64_t time_usec, float &x, float &y)
+{
+    if (id < 0 || id > TRACKER_MAX_TARGETS)
+        return false;
+
+    pthread_mutex_lock(&lock);
+    const Track &t = tracks[id];
+    bool ok = t.valid;
+    if (ok)
+    {
+        float dt = (float)((int64_t)(time_usec - t.time_usec)) / 1e6f;
+        if (dt > timeout)
+            ok = false;
+        else
+        {
+            if (dt > max_horizon)
+                dt = max_horizon;
+            if (dt < 0)
+                dt = 0;
+            // 只有一次测量时速度不可信
+            float k = (t.updates > 1) ? dt : 0;
+            x = t.x.p + t.x.v * k;
+            y = t.y.p + t.y.v * k;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ok;
+}
+
+bool
+Target_Tracker::
+velocity(int id, float &vx, float &vy)
+{
+    if (id < 0 || id > TRACKER_MAX_TARGETS)
+        return false;
+
+    pthread_mutex_lock(&lock);
+    bool ok = tracks[id].valid && tracks[id].updates > 1;
+    if (ok)
+    {
+        vx = tracks[id].x.v;
+        vy = tracks[id].y.v;
+    }
+    pthread_mutex_unlock(&lock);
+    return ok;
+}
+
+
+// ------------------------------------------------------------------------------
+//   单轴滤波器  状态 [p, v],  F = [1 dt; 0 1],  H = [1 0]
+// ------------------------------------------------------------------------------
+void
+Target_Tracker::
+init_axis(Track_Axis &a, float z)
+{
+    a.p = z;
+    a.v = 0;
+    a.P[0][0] = meas_noise * meas_noise;
+    a.P[0][1] = a.P[1][0] = 0;
+    a.P[1][1] = 1.0f;
+}
+
+void
+Target_Tracker::
+predict_axis(Track_Axis &a, float dt)
+{
+    a.p += a.v * dt;
+
+    // P = F P F' + Q, Q 为离散白噪声加速度模型
+    float p00 = a.P[0][0] + dt * (a.P[1][0] + a.P[0][1]) + dt * dt * a.P[1][1];
+    float p01 = a.P[0][1] + dt * a.P[1][1];
+    float p11 = a.P[1][1];
+
+    float q = accel_noise * accel_noise;
+    float dt2 = dt * dt;
+    p00 += q * dt2 * dt2 / 4;
+    p01 += q * dt2 * dt / 2;
+    p11 += q * dt2;
+
+    a.P[0][0] = p00;
+    a.P[0][1] = a.P[1][0] = p01;
+    a.P[1][1] = p11;
+}
+
+void
+Target_Tracker::
+update_axis(Track_Axis &a, float z)
+{
+    float s = a.P[0][0] + meas_noise * meas_noise;
+    float k0 = a.P[0][0] / s;
+    float k1 = a.P[1][0] / s;
+    float r = z - a.p;
+
+    a.p += k0 * r;
+    a.v += k1 * r;
+
+    float p00 = (1 - k0) * a.P[0][0];
+    float p01 = (1 - k0) * a.P[0][1];
+    float p11 = a.P[1][1] - k1 * a.P[0][1];
+    a.P[0][0] = p00;
+    a.P[0][1] = a.P[1][0] = p01;
+    a.P[1][1] = p11;
+}
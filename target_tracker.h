@@ -0,0 +1,74 @@
+/**
+ * @file target_tracker.h
+ *
+ * @brief Constant-velocity Kalman filter for ground targets in the local NED frame
+ *
+ * 视觉线程每得到一次目标的局部坐标(realtarget 的输出)就调用 update,
+ * 控制线程可以按自己的频率调用 predict 得到当前时刻目标的位置,
+ * 不必等待下一帧图像. x, y 两个方向相互独立, 各用一个 [位置, 速度] 两状态滤波器.
+ *
+ */
+
+#ifndef TARGET_TRACKER_H_
+#define TARGET_TRACKER_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+// 可跟踪的目标数, 编号与目标表快照 targets 的下标一致; possible_ellipse_r 建立的目标不超过这个数
+#define TRACKER_MAX_TARGETS 32
+
+// 投放时跟踪的小圆单独占一个编号
+#define TRACK_DROP TRACKER_MAX_TARGETS
+
+
+struct Track_Axis
+{
+    float p;        // 位置 (m)
+    float v;        // 速度 (m/s)
+    float P[2][2];  // 协方差
+};
+
+struct Track
+{
+    Track_Axis x;
+    Track_Axis y;
+    uint64_t time_usec;     // 状态对应的时刻
+    uint32_t updates;
+    bool valid;
+};
+
+
+class Target_Tracker
+{
+
+public:
+
+    Target_Tracker();
+    ~Target_Tracker();
+
+    float meas_noise;       // 测量噪声标准差 (m)
+    float accel_noise;      // 加速度噪声标准差 (m/s^2)
+    float gate;             // 新息超过 gate 米则认为是另一个目标, 重新初始化
+    float max_horizon;      // 最多向前预测的时间 (s)
+    float timeout;          // 超过该时间没有测量则认为跟踪丢失 (s)
+
+    void update(int id, float x, float y, uint64_t time_usec);
+    bool predict(int id, uint64_t time_usec, float &x, float &y);
+    bool velocity(int id, float &vx, float &vy);
+
+    void reset(int id);
+    void clear();
+
+private:
+
+    Track tracks[TRACKER_MAX_TARGETS + 1];
+    pthread_mutex_t lock;
+
+    void init_axis(Track_Axis &a, float z);
+    void predict_axis(Track_Axis &a, float dt);
+    void update_axis(Track_Axis &a, float z);
+
+};
+
+#endif // TARGET_TRACKER_H_
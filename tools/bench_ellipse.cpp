@@ -0,0 +1,304 @@
+/**
+ * @file bench_ellipse.cpp
+ *
+ * @brief Ellipse detector benchmark: per-stage timing and counts over a frame corpus
+ *
+ * 对目录中的每张图 (或视频的每一帧) 分别缩放到各个分辨率后调用 CEllipseDetectorYaed::Detect,
+ * 统计各阶段耗时 (_times[0..5]) 和整次 Detect 耗时的 p50/p95/p99,
+ * 以及每个象限的弧段数、聚类前候选数和最终椭圆数, 结果以 JSON 输出, 便于逐次提交对比.
+ *
+ * usage: bench_ellipse <dir|video> [-o result.json] [-s 640x360,1920x1080] [-r repeat] [-w warmup]
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "ellipse/EllipseDetectorYaed.h"
+#include "tools/json_escape.h"
+
+using namespace std;
+using namespace cv;
+
+
+static const char *stage_names[6] = {"edge", "preprocess", "grouping", "estimation", "validation", "clustering"};
+
+
+// 一组样本的分位数统计
+struct Sample_Set
+{
+    vector<double> v;
+
+    void add(double x) { v.push_back(x); }
+
+    // nearest-rank 分位数
+    double percentile(double p)
+    {
+        if (v.empty())
+            return 0;
+        sort(v.begin(), v.end());
+        size_t k = (size_t)ceil(p / 100.0 * v.size());
+        return v[k > 0 ? k - 1 : 0];
+    }
+
+    double mean() const
+    {
+        double s = 0;
+        for (double x : v)
+            s += x;
+        return v.empty() ? 0 : s / v.size();
+    }
+
+    void json(FILE *f, const char *name)
+    {
+        fprintf(f, "\"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                name, mean(), percentile(50), percentile(95), percentile(99), percentile(100));
+    }
+};
+
+// 一个分辨率下的全部统计
+struct Size_Stats
+{
+    Size size;
+    Sample_Set stage[6];
+    Sample_Set total;
+    Sample_Set arcs[4];
+    Sample_Set candidates;
+    Sample_Set ellipses;
+};
+
+
+// ------------------------------------------------------------------------------
+//   读入测试帧
+// ------------------------------------------------------------------------------
+static bool
+load_frames(const string &source, vector<Mat3b> &frames)
+{
+    vector<String> files;
+    glob(source + "/*", files, false);
+    sort(files.begin(), files.end());
+    for (auto &f : files)
+    {
+        Mat3b image = imread(f, IMREAD_COLOR);
+        if (!image.empty())
+            frames.push_back(image);
+    }
+
+    // 不是图片目录时当作视频读
+    if (frames.empty())
+    {
+        VideoCapture cap(source);
+        Mat image;
+        while (cap.isOpened() && cap.read(image) && !image.empty())
+            frames.push_back(image.clone());
+    }
+
+    return !frames.empty();
+}
+
+static bool
+parse_sizes(const char *arg, vector<Size> &sizes)
+{
+    sizes.clear();
+    const char *p = arg;
+    while (*p)
+    {
+        int w, h, n = 0;
+        if (sscanf(p, "%dx%d%n", &w, &h, &n) != 2 || w <= 0 || h <= 0)
+            return false;
+        sizes.push_back(Size(w, h));
+        p += n;
+        if (*p == ',')
+            p++;
+    }
+    return !sizes.empty();
+}
+
+
+// ------------------------------------------------------------------------------
+//   Parse Command Line
+// ------------------------------------------------------------------------------
+static const char *commandline_usage =
+        "usage: bench_ellipse <dir|video> [-o result.json] [-s 640x360,1920x1080] [-r repeat] [-w warmup]";
+
+static void
+parse_commandline(int argc, char **argv, const char *&source, const char *&out_path,
+                  vector<Size> &sizes, int &repeat, int &warmup)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-s") == 0 ||
+            strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-w") == 0) {
+            if (argc <= i + 1) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            const char *value = argv[++i];
+            switch (argv[i - 1][1])
+            {
+                case 'o': out_path = value; break;
+                case 'r': repeat = max(1, atoi(value)); break;
+                case 'w': warmup = max(0, atoi(value)); break;
+                case 's':
+                    if (!parse_sizes(value, sizes)) {
+                        printf("%s\n", commandline_usage);
+                        throw EXIT_FAILURE;
+                    }
+                    break;
+            }
+            continue;
+        }
+
+        source = argv[i];
+    }
+
+    if (!source) {
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   TOP
+// ------------------------------------------------------------------------------
+int
+top(int argc, char **argv)
+{
+    const char *source = NULL;
+    const char *out_path = NULL;
+    vector<Size> sizes = {Size(640, 360), Size(1920, 1080)};
+    int repeat = 1, warmup = 3;
+    parse_commandline(argc, argv, source, out_path, sizes, repeat, warmup);
+
+    vector<Mat3b> frames;
+    if (!load_frames(source, frames))
+    {
+        fprintf(stderr, "ERROR: no frames in %s\n", source);
+        return EXIT_FAILURE;
+    }
+
+    vector<Size_Stats> stats(sizes.size());
+    for (size_t s = 0; s < sizes.size(); s++)
+    {
+        Size_Stats &st = stats[s];
+        st.size = sizes[s];
+
+        CEllipseDetectorYaed yaed;
+        yaed.SetDefaultParameters(st.size);
+
+        // 缩放和灰度转换不计入检测耗时
+        vector<Mat1b> gray(frames.size());
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            Mat3b resized;
+            resize(frames[i], resized, st.size, 0, 0, INTER_AREA);
+            cvtColor(resized, gray[i], COLOR_BGR2GRAY);
+        }
+
+        for (int i = 0; i < warmup; i++)
+        {
+            vector<Ellipse> ells;
+            yaed.Detect(gray[i % gray.size()], ells);
+        }
+
+        for (int r = 0; r < repeat; r++)
+        {
+            for (size_t i = 0; i < gray.size(); i++)
+            {
+                vector<Ellipse> ells;
+                double t0 = (double)getTickCount();
+                yaed.Detect(gray[i], ells);
+                st.total.add(((double)getTickCount() - t0) * 1000. / getTickFrequency());
+
+                vector<double> times = yaed.GetTimes();
+                for (int k = 0; k < 6; k++)
+                    st.stage[k].add(times[k]);
+                for (int q = 0; q < 4; q++)
+                    st.arcs[q].add(yaed.GetArcs(q));
+                st.candidates.add(yaed.GetCandidates());
+                st.ellipses.add(ells.size());
+            }
+        }
+
+        fprintf(stderr, "%dx%d: %lu frames, Detect p50 %.2f ms p95 %.2f ms p99 %.2f ms, ellipses mean %.2f\n",
+                st.size.width, st.size.height, (unsigned long)st.total.v.size(),
+                st.total.percentile(50), st.total.percentile(95), st.total.percentile(99), st.ellipses.mean());
+    }
+
+    // ------------------------------------------------------------------------------
+    //   JSON 输出
+    // ------------------------------------------------------------------------------
+    FILE *f = out_path ? fopen(out_path, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", out_path);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(f, "{\n  \"source\": \"%s\",\n  \"frames\": %lu,\n  \"repeat\": %d,\n  \"sizes\": [\n",
+            json_escape(source).c_str(), (unsigned long)frames.size(), repeat);
+    for (size_t s = 0; s < stats.size(); s++)
+    {
+        Size_Stats &st = stats[s];
+        fprintf(f, "    {\n      \"width\": %d, \"height\": %d,\n      \"stages_ms\": {\n",
+                st.size.width, st.size.height);
+        for (int k = 0; k < 6; k++)
+        {
+            fprintf(f, "        ");
+            st.stage[k].json(f, stage_names[k]);
+            fprintf(f, ",\n");
+        }
+        fprintf(f, "        ");
+        st.total.json(f, "total");
+        fprintf(f, "\n      },\n      \"arcs\": {\n");
+        for (int q = 0; q < 4; q++)
+        {
+            char name[8];
+            snprintf(name, sizeof(name), "q%d", q + 1);
+            fprintf(f, "        ");
+            st.arcs[q].json(f, name);
+            fprintf(f, q < 3 ? ",\n" : "\n");
+        }
+        fprintf(f, "      },\n      ");
+        st.candidates.json(f, "candidates");
+        fprintf(f, ",\n      ");
+        st.ellipses.json(f, "ellipses");
+        fprintf(f, "\n    }%s\n", s + 1 < stats.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Main
+// ------------------------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+    try
+    {
+        int result = top(argc, argv);
+        return result;
+    }
+
+    catch ( int error )
+    {
+        fprintf(stderr, "bench_ellipse threw exception %i \n", error);
+        return error;
+    }
+}
@@ -0,0 +1,622 @@
+/**
+ * @file bench_mavlink.cpp
+ *
+ * @brief MAVLink parse / encode throughput benchmark
+ *
+ * 测量串口收发热路径上各环节的吞吐:
+ *  - parse_clean   : mavlink_parse_char 解析无误码的字节流 (common 中所有消息混合, 飞控遥测消息占多数)
+ *  - parse_corrupt : 同一字节流按给定误码率翻转字节、并截断一部分帧, 统计恢复出的消息数; 另外单独解析一遍,
+ *                    直接测量从每个注入的错误到下一条完整消息之间的字节数和解析耗时
+ *  - scan_clean / scan_corrupt : 同样的字节流按 256 字节一块交给 Mavlink_Scanner 成块解析
+ *  - parse_tlog    : 解析 flight.tlog 中记录的真实消息 (-t)
+ *  - serial_pty    : 经伪终端由 Serial_Port::read_message 成块读取, 包含系统调用开销
+ *  - encode_*      : write_local_setpoint / Send_WL_Global_Position 使用的 encode + mavlink_msg_to_send_buffer
+ * 结果以 JSON 输出, 摘要打印到 stderr.
+ *
+ * usage: bench_mavlink [-n messages] [-e error_rate] [-t flight.tlog] [-o result.json] [--no-pty]
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pty.h>
+#include <pthread.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "serial_port.h"
+#include "mavlink_scanner.h"
+
+using namespace std;
+
+
+static const uint8_t message_lengths[256] = MAVLINK_MESSAGE_LENGTHS;
+static const uint8_t message_crcs[256] = MAVLINK_MESSAGE_CRCS;
+
+// 飞控实际发送频率较高的消息, 占合成字节流的一半
+static const uint8_t telemetry_ids[] = {
+        MAVLINK_MSG_ID_HEARTBEAT, MAVLINK_MSG_ID_SYS_STATUS, MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_LOCAL_POSITION_NED, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, MAVLINK_MSG_ID_HIGHRES_IMU,
+        MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED, MAVLINK_MSG_ID_MISSION_ITEM_REACHED, MAVLINK_MSG_ID_COMMAND_ACK};
+
+
+static double
+now_sec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+// 一项测试的结果
+struct Bench_Result
+{
+    string name;
+    uint64_t bytes;
+    uint64_t messages;
+    uint64_t errors;
+    double seconds;
+    vector<pair<const char *, double> > extra;  // 各项自己的附加指标
+
+    Bench_Result() : bytes(0), messages(0), errors(0), seconds(0) {}
+
+    void print() const
+    {
+        fprintf(stderr, "%-16s %10.0f msg/s %8.2f MB/s %8.1f ns/msg", name.c_str(),
+                messages / seconds, bytes / seconds / 1e6, seconds * 1e9 / (messages ? messages : 1));
+        for (auto &e : extra)
+            fprintf(stderr, "  %s %.2f", e.first, e.second);
+        fprintf(stderr, "\n");
+    }
+
+    void json(FILE *f, bool last) const
+    {
+        fprintf(f, "    \"%s\": {\"messages\": %llu, \"bytes\": %llu, \"errors\": %llu, \"seconds\": %.6f, "
+                   "\"msgs_per_sec\": %.1f, \"bytes_per_sec\": %.1f, \"ns_per_byte\": %.3f",
+                name.c_str(), (unsigned long long)messages, (unsigned long long)bytes, (unsigned long long)errors,
+                seconds, messages / seconds, bytes / seconds, seconds * 1e9 / (bytes ? bytes : 1));
+        for (auto &e : extra)
+            fprintf(f, ", \"%s\": %.3f", e.first, e.second);
+        fprintf(f, "}%s\n", last ? "" : ",");
+    }
+};
+
+
+// ------------------------------------------------------------------------------
+//   合成字节流
+// ------------------------------------------------------------------------------
+static void
+append_message(vector<uint8_t> &stream, const mavlink_message_t &message)
+{
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
+    stream.insert(stream.end(), buf, buf + len);
+}
+
+static void
+make_stream(int n, vector<uint8_t> &stream)
+{
+    vector<uint8_t> ids;
+    for (int i = 0; i < 256; i++)
+        if (message_lengths[i] > 0)
+            ids.push_back(i);
+
+    mavlink_message_t message;
+    for (int i = 0; i < n; i++)
+    {
+        uint8_t id = (rand() & 1) ? telemetry_ids[rand() % sizeof(telemetry_ids)] : ids[rand() % ids.size()];
+        uint8_t len = message_lengths[id];
+        message.msgid = id;
+        for (int k = 0; k < len; k++)
+            _MAV_PAYLOAD_NON_CONST(&message)[k] = rand() & 0xff;
+        mavlink_finalize_message(&message, 1, 1, len, len, message_crcs[id]);
+        append_message(stream, message);
+    }
+}
+
+// 按 rate 翻转字节, 另按 rate 把某些位置截掉若干字节, 模拟串口误码和丢字节.
+// error_at 为每个错误在 out 中的位置 (翻转的字节, 或截断处之后的第一个字节)
+static uint64_t
+corrupt_stream(const vector<uint8_t> &in, double rate, vector<uint8_t> &out, vector<size_t> &error_at)
+{
+    uint64_t errors = 0;
+    out.clear();
+    out.reserve(in.size());
+    error_at.clear();
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        double r = rand() / (double)RAND_MAX;
+        if (r < rate / 2)
+        {
+            error_at.push_back(out.size());
+            out.push_back(in[i] ^ (1 + rand() % 255));
+            errors++;
+        }
+        else if (r < rate)
+        {
+            error_at.push_back(out.size());
+            i += rand() % 16;
+            errors++;
+        }
+        else
+            out.push_back(in[i]);
+    }
+    return errors;
+}
+
+// tlog: 每条消息前 8 字节时间戳, 去掉时间戳后重新组成字节流
+static bool
+load_tlog(const char *path, vector<uint8_t> &stream)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open tlog %s\n", path);
+        return false;
+    }
+
+    uint8_t stamp[8];
+    mavlink_message_t message;
+    mavlink_status_t status;
+    while (fread(stamp, 1, 8, f) == 8)
+    {
+        int c, got = 0;
+        while (!got && (c = fgetc(f)) != EOF)
+            got = mavlink_parse_char(MAVLINK_COMM_2, (uint8_t)c, &message, &status);
+        if (!got)
+            break;
+        append_message(stream, message);
+    }
+
+    fclose(f);
+    return !stream.empty();
+}
+
+
+// ------------------------------------------------------------------------------
+//   mavlink_parse_char
+// ------------------------------------------------------------------------------
+static Bench_Result
+bench_parse(const char *name, const vector<uint8_t> &stream, double min_seconds)
+{
+    Bench_Result r;
+    r.name = name;
+
+    mavlink_message_t message;
+    mavlink_status_t status;
+    uint64_t checksum = 0;  // 防止循环被优化掉
+
+    double t0 = now_sec();
+    do
+    {
+        mavlink_reset_channel_status(MAVLINK_COMM_0);
+        for (size_t i = 0; i < stream.size(); i++)
+        {
+            if (mavlink_parse_char(MAVLINK_COMM_0, stream[i], &message, &status))
+            {
+                r.messages++;
+                checksum += message.checksum;
+            }
+        }
+        r.errors += mavlink_get_channel_status(MAVLINK_COMM_0)->parse_error;
+        r.bytes += stream.size();
+        r.seconds = now_sec() - t0;
+    } while (r.seconds < min_seconds);
+
+    if (checksum == 1)
+        fprintf(stderr, " ");
+    return r;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Mavlink_Scanner, 每次送入 chunk 字节, 模拟串口成块读取
+// ------------------------------------------------------------------------------
+static Bench_Result
+bench_scan(const char *name, const vector<uint8_t> &stream, size_t chunk, double min_seconds)
+{
+    Bench_Result r;
+    r.name = name;
+
+    Mavlink_Scanner scanner;
+    mavlink_message_t message;
+    uint64_t checksum = 0;
+
+    double t0 = now_sec();
+    do
+    {
+        scanner.reset();
+        size_t i = 0;
+        while (i < stream.size())
+        {
+            i += scanner.push(stream.data() + i, min(chunk, stream.size() - i));
+            while (scanner.next(message))
+            {
+                r.messages++;
+                checksum += message.checksum;
+            }
+        }
+        r.errors += scanner.stats.crc_errors + scanner.stats.length_errors;
+        r.bytes += stream.size();
+        r.seconds = now_sec() - t0;
+    } while (r.seconds < min_seconds);
+
+    if (checksum == 1)
+        fprintf(stderr, " ");
+    return r;
+}
+
+// ------------------------------------------------------------------------------
+//   恢复代价: 直接测量每个注入错误到下一条完整消息
+// ------------------------------------------------------------------------------
+// 解析到错误所在的字节时记下位置和时刻, 之后第一次解析出完整消息时结算
+// 所有未结算的错误. scan 时按 chunk 成块送入, 位置和时刻以错误所在的块开始处计,
+// 消息以所在块的末尾计, 与串口成块读取时的实际延迟一致.
+struct Recovery_Stats
+{
+    uint64_t recovered;
+    uint64_t unrecovered;       // 流结束时仍未等到完整消息
+    double bytes;               // 合计
+    double ns;
+
+    Recovery_Stats() : recovered(0), unrecovered(0), bytes(0), ns(0) {}
+
+    void settle(vector<pair<size_t, double> > &pending, size_t at, double t)
+    {
+        for (auto &p : pending)
+        {
+            bytes += at - p.first;
+            ns += (t - p.second) * 1e9;
+            recovered++;
+        }
+        pending.clear();
+    }
+};
+
+static Recovery_Stats
+measure_recovery(const vector<uint8_t> &stream, const vector<size_t> &error_at, size_t chunk)
+{
+    Recovery_Stats st;
+    vector<pair<size_t, double> > pending;   // 错误位置, 时刻
+    size_t next_error = 0;
+    mavlink_message_t message;
+
+    if (chunk == 0)
+    {
+        mavlink_status_t status;
+        mavlink_reset_channel_status(MAVLINK_COMM_0);
+        for (size_t i = 0; i < stream.size(); i++)
+        {
+            for (; next_error < error_at.size() && error_at[next_error] == i; next_error++)
+                pending.push_back(make_pair(i, now_sec()));
+            if (mavlink_parse_char(MAVLINK_COMM_0, stream[i], &message, &status) && !pending.empty())
+                st.settle(pending, i + 1, now_sec());
+        }
+    }
+    else
+    {
+        Mavlink_Scanner scanner;
+        size_t i = 0;
+        while (i < stream.size())
+        {
+            size_t end = min(i + chunk, stream.size());
+            for (; next_error < error_at.size() && error_at[next_error] < end; next_error++)
+                pending.push_back(make_pair(i, now_sec()));
+            i += scanner.push(stream.data() + i, end - i);
+            while (scanner.next(message))
+                if (!pending.empty())
+                    st.settle(pending, i, now_sec());
+        }
+    }
+
+    st.unrecovered = pending.size() + (error_at.size() - next_error);
+    return st;
+}
+
+// 每个注入错误丢失的消息数, 以及到下一条完整消息的字节数、57600 波特下的时间和解析耗时
+static void
+add_recovery(Bench_Result &corrupt_result, const vector<uint8_t> &corrupt, const vector<size_t> &error_at,
+             size_t chunk, int n)
+{
+    if (error_at.empty())
+        return;
+    uint64_t rounds = corrupt_result.bytes / corrupt.size();
+    double lost = n - corrupt_result.messages / (double)rounds;
+    corrupt_result.extra.push_back(make_pair("lost_msgs_per_error", lost / error_at.size()));
+
+    Recovery_Stats st = measure_recovery(corrupt, error_at, chunk);
+    if (!st.recovered)
+        return;
+    double bytes = st.bytes / st.recovered;
+    corrupt_result.extra.push_back(make_pair("recovery_bytes_per_error", bytes));
+    corrupt_result.extra.push_back(make_pair("recovery_ms_per_error_57600", bytes / 5760.0 * 1000));
+    corrupt_result.extra.push_back(make_pair("recovery_ns_per_error", st.ns / st.recovered));
+    corrupt_result.extra.push_back(make_pair("unrecovered_errors", (double)st.unrecovered));
+}
+
+
+// ------------------------------------------------------------------------------
+//   Serial_Port::read_message, 经伪终端
+// ------------------------------------------------------------------------------
+struct Pty_Writer
+{
+    int fd;
+    const vector<uint8_t> *stream;
+};
+
+static void *
+pty_writer(void *arg)
+{
+    Pty_Writer *w = (Pty_Writer *)arg;
+    const uint8_t *p = w->stream->data();
+    size_t left = w->stream->size();
+    while (left > 0)
+    {
+        ssize_t n = write(w->fd, p, left > 4096 ? 4096 : left);
+        if (n <= 0)
+            break;
+        p += n;
+        left -= n;
+    }
+    return NULL;
+}
+
+static bool
+bench_serial(const vector<uint8_t> &stream, uint64_t expected, Bench_Result &r)
+{
+    r.name = "serial_pty";
+
+    int master, slave;
+    char name[64];
+    if (openpty(&master, &slave, name, NULL, NULL) < 0)
+    {
+        fprintf(stderr, "WARNING: openpty failed, skipping serial_pty\n");
+        return false;
+    }
+
+    Serial_Port serial_port(name, 57600);
+    serial_port.open_serial();
+
+    Pty_Writer w = {master, &stream};
+    pthread_t tid;
+    double t0 = now_sec();
+    pthread_create(&tid, NULL, pty_writer, &w);
+
+    // VTIME=2, 没有数据时 read 0.2s 后返回, 连续几次读空即认为结束
+    mavlink_message_t message;
+    int idle = 0;
+    double last = t0;
+    while (r.messages < expected && idle < 5)
+    {
+        if (serial_port.read_message(message))
+        {
+            r.messages++;
+            idle = 0;
+            last = now_sec();
+        }
+        else if (now_sec() - last > 0.2)
+        {
+            idle++;
+            last = now_sec();
+        }
+    }
+    r.seconds = now_sec() - t0;
+    r.bytes = stream.size();
+    r.errors = expected - r.messages;
+
+    pthread_join(tid, NULL);
+    serial_port.close_serial();
+    close(slave);
+    close(master);
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   encode + mavlink_msg_to_send_buffer
+// ------------------------------------------------------------------------------
+static Bench_Result
+bench_encode_local_setpoint(int n)
+{
+    Bench_Result r;
+    r.name = "encode_local_sp";
+
+    mavlink_set_position_target_local_ned_t sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.type_mask = 0x0DF8;
+    sp.coordinate_frame = MAV_FRAME_LOCAL_NED;
+    sp.target_system = 1;
+    sp.target_component = 1;
+
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t message;
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++)
+    {
+        sp.time_boot_ms = i;
+        sp.x = i * 0.01f;
+        mavlink_msg_set_position_target_local_ned_encode(255, 0, &message, &sp);
+        r.bytes += mavlink_msg_to_send_buffer(buf, &message);
+    }
+    r.seconds = now_sec() - t0;
+    r.messages = n;
+    return r;
+}
+
+static Bench_Result
+bench_encode_global_position(int n)
+{
+    Bench_Result r;
+    r.name = "encode_wl_global";
+
+    mavlink_global_position_int_t pos;
+    memset(&pos, 0, sizeof(pos));
+    pos.lat = 300000000;
+    pos.lon = 1200000000;
+
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t message;
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++)
+    {
+        pos.time_boot_ms = i;
+        pos.relative_alt = i;
+        mavlink_msg_global_position_int_encode(2, 2, &message, &pos);
+        r.bytes += mavlink_msg_to_send_buffer(buf, &message);
+    }
+    r.seconds = now_sec() - t0;
+    r.messages = n;
+    return r;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Parse Command Line
+// ------------------------------------------------------------------------------
+static const char *commandline_usage =
+        "usage: bench_mavlink [-n messages] [-e error_rate] [-t flight.tlog] [-o result.json] [--no-pty]";
+
+static void
+parse_commandline(int argc, char **argv, int &n, double &error_rate, const char *&tlog_path,
+                  const char *&out_path, bool &use_pty)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "--no-pty") == 0) {
+            use_pty = false;
+            continue;
+        }
+
+        if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "-e") == 0 ||
+            strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "-o") == 0) {
+            if (argc <= i + 1) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            const char *value = argv[++i];
+            switch (argv[i - 1][1])
+            {
+                case 'n': n = atoi(value); break;
+                case 'e': error_rate = atof(value); break;
+                case 't': tlog_path = value; break;
+                case 'o': out_path = value; break;
+            }
+            continue;
+        }
+
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+
+    if (n <= 0 || error_rate < 0 || error_rate >= 1) {
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   TOP
+// ------------------------------------------------------------------------------
+int
+top(int argc, char **argv)
+{
+    int n = 100000;
+    double error_rate = 1e-3;
+    const char *tlog_path = NULL;
+    const char *out_path = NULL;
+    bool use_pty = true;
+    parse_commandline(argc, argv, n, error_rate, tlog_path, out_path, use_pty);
+
+    srand(1);
+    vector<uint8_t> clean, corrupt;
+    vector<size_t> error_at;
+    make_stream(n, clean);
+    uint64_t injected = corrupt_stream(clean, error_rate, corrupt, error_at);
+
+    vector<Bench_Result> results;
+
+    Bench_Result parse_clean = bench_parse("parse_clean", clean, 1.0);
+    results.push_back(parse_clean);
+
+    Bench_Result parse_corrupt = bench_parse("parse_corrupt", corrupt, 1.0);
+    add_recovery(parse_corrupt, corrupt, error_at, 0, n);
+    results.push_back(parse_corrupt);
+
+    Bench_Result scan_clean = bench_scan("scan_clean", clean, 256, 1.0);
+    results.push_back(scan_clean);
+
+    Bench_Result scan_corrupt = bench_scan("scan_corrupt", corrupt, 256, 1.0);
+    add_recovery(scan_corrupt, corrupt, error_at, 256, n);
+    results.push_back(scan_corrupt);
+
+    if (tlog_path)
+    {
+        vector<uint8_t> recorded;
+        if (!load_tlog(tlog_path, recorded))
+            return EXIT_FAILURE;
+        results.push_back(bench_parse("parse_tlog", recorded, 1.0));
+    }
+
+    if (use_pty)
+    {
+        Bench_Result serial;
+        if (bench_serial(clean, n, serial))
+            results.push_back(serial);
+    }
+
+    results.push_back(bench_encode_local_setpoint(n * 10));
+    results.push_back(bench_encode_global_position(n * 10));
+
+    fprintf(stderr, "%d synthetic messages, %lu bytes, %llu injected errors (rate %g)\n",
+            n, (unsigned long)clean.size(), (unsigned long long)injected, error_rate);
+    for (auto &r : results)
+        r.print();
+
+    // ------------------------------------------------------------------------------
+    //   JSON 输出
+    // ------------------------------------------------------------------------------
+    FILE *f = out_path ? fopen(out_path, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", out_path);
+        return EXIT_FAILURE;
+    }
+    fprintf(f, "{\n  \"messages\": %d,\n  \"error_rate\": %g,\n  \"results\": {\n", n, error_rate);
+    for (size_t i = 0; i < results.size(); i++)
+        results[i].json(f, i + 1 == results.size());
+    fprintf(f, "  }\n}\n");
+    if (f != stdout)
+        fclose(f);
+
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Main
+// ------------------------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+    try
+    {
+        int result = top(argc, argv);
+        return result;
+    }
+
+    catch ( int error )
+    {
+        fprintf(stderr, "bench_mavlink threw exception %i \n", error);
+        return error;
+    }
+}
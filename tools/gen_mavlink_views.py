@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Generate mavlink_views.h: typed, read-only views over a received mavlink_message_t.
+
+Each view wraps a pointer to the message and exposes one inline accessor per field,
+forwarding to the mavlink_msg_<name>_get_<field>() functions of the dialect, so a
+subscriber reads only the fields it needs straight from the payload buffer instead
+of decoding the whole message into a struct first.
+
+Scalar fields return the value; char / uint8_t / int8_t arrays return a pointer into
+the payload (plus a <field>_len constant); other arrays copy out through the original
+getter because their elements may be unaligned in the payload.
+
+usage: tools/gen_mavlink_views.py [mavlink/common] [mavlink_views.h]
+"""
+
+import os
+import re
+import sys
+
+SCALAR = re.compile(
+    r'static inline (\w+) mavlink_msg_(\w+?)_get_(\w+)\(const mavlink_message_t\* msg\)\s*\{\s*'
+    r'return _MAV_RETURN_\w+\(msg,\s*(\d+)\);')
+ARRAY = re.compile(
+    r'static inline uint16_t mavlink_msg_(\w+?)_get_(\w+)\(const mavlink_message_t\* msg, (\w+) \*\w+\)\s*\{\s*'
+    r'return _MAV_RETURN_\w+_array\(msg, \w+, (\d+),\s*(\d+)\);')
+BYTE_TYPES = ('char', 'uint8_t', 'int8_t')
+
+
+def class_name(msg):
+    return '_'.join(p.capitalize() for p in msg.split('_')) + '_View'
+
+
+def parse(path, msg):
+    text = open(path).read()
+    fields = []
+    for m in SCALAR.finditer(text):
+        if m.group(2) == msg:
+            fields.append(('scalar', m.group(3), m.group(1), None, int(m.group(4))))
+    for m in ARRAY.finditer(text):
+        if m.group(1) == msg:
+            fields.append(('array', m.group(2), m.group(3), int(m.group(4)), int(m.group(5))))
+    # 按在报文中的偏移排序, 与 struct 中的字段顺序一致
+    fields.sort(key=lambda f: f[4])
+    return fields
+
+
+def emit(msg, fields):
+    name = class_name(msg)
+    upper = msg.upper()
+    out = []
+    out.append('struct %s' % name)
+    out.append('{')
+    out.append('    static const uint8_t MSG_ID = MAVLINK_MSG_ID_%s;' % upper)
+    out.append('    const mavlink_message_t *msg;')
+    out.append('    explicit %s(const mavlink_message_t &message) : msg(&message) {}' % name)
+    out.append('    void decode(mavlink_%s_t &out) const { mavlink_msg_%s_decode(msg, &out); }' % (msg, msg))
+    for kind, field, ctype, length, offset in fields:
+        if kind == 'scalar':
+            out.append('    %s %s() const { return mavlink_msg_%s_get_%s(msg); }' % (ctype, field, msg, field))
+        elif ctype in BYTE_TYPES:
+            out.append('    static const uint16_t %s_len = %d;' % (field, length))
+            out.append('    const %s *%s() const { return (const %s *)(_MAV_PAYLOAD(msg) + %d); }'
+                       % (ctype, field, ctype, offset))
+        else:
+            out.append('    static const uint16_t %s_len = %d;' % (field, length))
+            out.append('    uint16_t %s(%s *out) const { return mavlink_msg_%s_get_%s(msg, out); }'
+                       % (field, ctype, msg, field))
+    out.append('};')
+    return '\n'.join(out)
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else 'mavlink/common'
+    dst = sys.argv[2] if len(sys.argv) > 2 else 'mavlink_views.h'
+
+    views = []
+    for fn in sorted(os.listdir(src)):
+        m = re.match(r'mavlink_msg_(\w+)\.h$', fn)
+        if not m:
+            continue
+        msg = m.group(1)
+        fields = parse(os.path.join(src, fn), msg)
+        if fields:
+            views.append(emit(msg, fields))
+
+    header = '''/**
+ * @file mavlink_views.h
+ *
+ * @brief Typed read-only views over received MAVLink messages
+ *
+ * 由 tools/gen_mavlink_views.py 根据 %s 生成, 不要手工修改.
+ * 视图只保存消息指针, 字段直接从负载中读取, 不先 decode 成结构体;
+ * 视图的有效期不能超过它所指向的 mavlink_message_t.
+ *
+ */
+
+#ifndef MAVLINK_VIEWS_H_
+#define MAVLINK_VIEWS_H_
+
+#include "%s/mavlink.h"
+
+''' % (src, src)
+    with open(dst, 'w') as f:
+        f.write(header)
+        f.write('\n\n'.join(views))
+        f.write('\n\n#endif // MAVLINK_VIEWS_H_\n')
+    print('%d views written to %s' % (len(views), dst))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,43 @@
+/**
+ * @file json_escape.h
+ *
+ * @brief JSON string escaping shared by the benchmark and tuning tools
+ *
+ * 工具输出的 JSON 中要写入命令行给出的文件路径, 路径原样写入时引号、反斜杠或控制字符会破坏输出.
+ *
+ */
+
+#ifndef TOOLS_JSON_ESCAPE_H_
+#define TOOLS_JSON_ESCAPE_H_
+
+#include <stdio.h>
+#include <string>
+
+
+// 引号和反斜杠前加反斜杠, 控制字符写成 \uXXXX, 返回值不含两边的引号
+static inline std::string
+json_escape(const char *s)
+{
+    std::string out;
+    for (; *s; s++)
+    {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (c < 0x20)
+        {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else
+            out += c;
+    }
+    return out;
+}
+
+
+#endif // TOOLS_JSON_ESCAPE_H_
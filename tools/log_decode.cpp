@@ -0,0 +1,357 @@
+/**
+ * @file log_decode.cpp
+ *
+ * @brief Decode the binary flight log written by Flight_Log to text or CSV
+ *
+ * 日志是自描述的: 按文件中的 FMT 记录解析其余记录, 不依赖 flight_log.h 中的结构体,
+ * 旧版本程序写的日志也能解码.
+ *
+ * usage: log_decode <flight_log.bin> [-f text|csv] [-t TYPE[,TYPE...]] [-o out]
+ *
+ *  text : 每条记录一行 "NAME TimeUS=... X=...", -o 为输出文件, 缺省 stdout
+ *  csv  : 每种记录一个 CSV 文件 <out>/<NAME>.csv (-o 为目录, 缺省当前目录);
+ *         只选了一种记录且没有 -o 时输出到 stdout
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+
+#define LOG_HEAD_BYTE1 0xA3
+#define LOG_HEAD_BYTE2 0x95
+#define LOG_FORMAT_MSG 128
+#define LOG_FORMAT_LEN 89
+
+
+// 一种记录的格式
+struct Log_Type
+{
+    bool known;
+    uint8_t length;
+    string name;
+    string format;
+    vector<string> labels;
+    FILE *csv;
+
+    Log_Type() : known(false), length(0), csv(NULL) {}
+};
+
+
+static vector<string>
+split(const string &s, char sep)
+{
+    vector<string> out;
+    size_t begin = 0;
+    while (true)
+    {
+        size_t end = s.find(sep, begin);
+        out.push_back(s.substr(begin, end == string::npos ? string::npos : end - begin));
+        if (end == string::npos)
+            break;
+        begin = end + 1;
+    }
+    return out;
+}
+
+static string
+fixed_string(const uint8_t *p, size_t len)
+{
+    size_t n = 0;
+    while (n < len && p[n])
+        n++;
+    return string((const char *)p, n);
+}
+
+
+// ------------------------------------------------------------------------------
+//   按类型字符取出一个字段, 返回字段长度
+// ------------------------------------------------------------------------------
+template <typename T>
+static T
+read_as(const uint8_t *p)
+{
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+static int
+format_field(char c, const uint8_t *p, string &out)
+{
+    char buf[96];
+    int len;
+    switch (c)
+    {
+        case 'b': snprintf(buf, sizeof(buf), "%d", read_as<int8_t>(p)); len = 1; break;
+        case 'B':
+        case 'M': snprintf(buf, sizeof(buf), "%u", read_as<uint8_t>(p)); len = 1; break;
+        case 'h': snprintf(buf, sizeof(buf), "%d", read_as<int16_t>(p)); len = 2; break;
+        case 'H': snprintf(buf, sizeof(buf), "%u", read_as<uint16_t>(p)); len = 2; break;
+        case 'i': snprintf(buf, sizeof(buf), "%d", read_as<int32_t>(p)); len = 4; break;
+        case 'I': snprintf(buf, sizeof(buf), "%u", read_as<uint32_t>(p)); len = 4; break;
+        case 'f': snprintf(buf, sizeof(buf), "%g", read_as<float>(p)); len = 4; break;
+        case 'L': snprintf(buf, sizeof(buf), "%.7f", read_as<int32_t>(p) * 1e-7); len = 4; break;
+        case 'q': snprintf(buf, sizeof(buf), "%lld", (long long)read_as<int64_t>(p)); len = 8; break;
+        case 'Q': snprintf(buf, sizeof(buf), "%llu", (unsigned long long)read_as<uint64_t>(p)); len = 8; break;
+        case 'd': snprintf(buf, sizeof(buf), "%g", read_as<double>(p)); len = 8; break;
+        case 'n': out = fixed_string(p, 4); return 4;
+        case 'N': out = fixed_string(p, 16); return 16;
+        case 'Z': out = fixed_string(p, 64); return 64;
+        default: return -1;
+    }
+    out = buf;
+    return len;
+}
+
+// CSV 中含逗号或引号的字符串加引号
+static string
+csv_escape(const string &s)
+{
+    if (s.find_first_of(",\"\n") == string::npos)
+        return s;
+    string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+
+// ------------------------------------------------------------------------------
+//   Parse Command Line
+// ------------------------------------------------------------------------------
+static const char *commandline_usage =
+        "usage: log_decode <flight_log.bin> [-f text|csv] [-t TYPE[,TYPE...]] [-o out]";
+
+static void
+parse_commandline(int argc, char **argv, const char *&log_path, bool &csv,
+                  vector<string> &types, const char *&out_path)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "-o") == 0) {
+            if (argc <= i + 1) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            const char *value = argv[++i];
+            switch (argv[i - 1][1])
+            {
+                case 'f':
+                    if (strcmp(value, "csv") == 0)
+                        csv = true;
+                    else if (strcmp(value, "text") == 0)
+                        csv = false;
+                    else {
+                        printf("%s\n", commandline_usage);
+                        throw EXIT_FAILURE;
+                    }
+                    break;
+                case 't': types = split(value, ','); break;
+                case 'o': out_path = value; break;
+            }
+            continue;
+        }
+
+        log_path = argv[i];
+    }
+
+    if (!log_path) {
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   TOP
+// ------------------------------------------------------------------------------
+int
+top(int argc, char **argv)
+{
+    const char *log_path = NULL;
+    const char *out_path = NULL;
+    bool csv = false;
+    vector<string> types;
+    parse_commandline(argc, argv, log_path, csv, types, out_path);
+
+    FILE *f = fopen(log_path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", log_path);
+        return EXIT_FAILURE;
+    }
+    vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+
+    bool csv_stdout = csv && !out_path && types.size() == 1;
+    FILE *text_out = stdout;
+    if (!csv && out_path)
+    {
+        text_out = fopen(out_path, "w");
+        if (!text_out)
+        {
+            fprintf(stderr, "ERROR: could not open %s\n", out_path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    Log_Type formats[256];
+    map<string, uint64_t> counts;
+    uint64_t skipped = 0;
+    size_t pos = 0;
+
+    while (pos + 3 <= data.size())
+    {
+        const uint8_t *p = &data[pos];
+        if (p[0] != LOG_HEAD_BYTE1 || p[1] != LOG_HEAD_BYTE2)
+        {
+            pos++;
+            skipped++;
+            continue;
+        }
+
+        uint8_t type = p[2];
+        if (type == LOG_FORMAT_MSG)
+        {
+            if (pos + LOG_FORMAT_LEN > data.size())
+                break;
+            Log_Type &t = formats[p[3]];
+            t.known = true;
+            t.length = p[4];
+            t.name = fixed_string(p + 5, 4);
+            t.format = fixed_string(p + 9, 16);
+            t.labels = split(fixed_string(p + 25, 64), ',');
+            pos += LOG_FORMAT_LEN;
+            continue;
+        }
+
+        Log_Type &t = formats[type];
+        if (!t.known || pos + t.length > data.size())
+        {
+            pos++;
+            skipped++;
+            continue;
+        }
+
+        bool selected = types.empty();
+        for (auto &s : types)
+            selected = selected || s == t.name;
+        if (!selected)
+        {
+            pos += t.length;
+            continue;
+        }
+
+        // 按格式取出各字段
+        vector<string> values;
+        const uint8_t *field = p + 3;
+        bool ok = true;
+        for (char c : t.format)
+        {
+            string v;
+            int len = format_field(c, field, v);
+            if (len < 0)
+            {
+                ok = false;
+                break;
+            }
+            values.push_back(v);
+            field += len;
+        }
+        if (!ok || field != p + t.length)
+        {
+            fprintf(stderr, "WARNING: format %s of %s does not match its length %u\n",
+                    t.format.c_str(), t.name.c_str(), t.length);
+            t.known = false;
+            continue;
+        }
+        counts[t.name]++;
+        pos += t.length;
+
+        if (!csv)
+        {
+            fprintf(text_out, "%s", t.name.c_str());
+            for (size_t i = 0; i < values.size(); i++)
+                fprintf(text_out, " %s=%s", i < t.labels.size() ? t.labels[i].c_str() : "?", values[i].c_str());
+            fprintf(text_out, "\n");
+            continue;
+        }
+
+        if (!t.csv)
+        {
+            if (csv_stdout)
+                t.csv = stdout;
+            else
+            {
+                string path = string(out_path ? out_path : ".") + "/" + t.name + ".csv";
+                t.csv = fopen(path.c_str(), "w");
+                if (!t.csv)
+                {
+                    fprintf(stderr, "ERROR: could not open %s\n", path.c_str());
+                    return EXIT_FAILURE;
+                }
+            }
+            for (size_t i = 0; i < t.labels.size(); i++)
+                fprintf(t.csv, "%s%s", i ? "," : "", t.labels[i].c_str());
+            fprintf(t.csv, "\n");
+        }
+        for (size_t i = 0; i < values.size(); i++)
+            fprintf(t.csv, "%s%s", i ? "," : "", csv_escape(values[i]).c_str());
+        fprintf(t.csv, "\n");
+    }
+
+    for (int i = 0; i < 256; i++)
+        if (formats[i].csv && formats[i].csv != stdout)
+            fclose(formats[i].csv);
+    if (text_out != stdout)
+        fclose(text_out);
+
+    fprintf(stderr, "LOG_DECODE %s: %lu bytes", log_path, (unsigned long)data.size());
+    for (auto &c : counts)
+        fprintf(stderr, ", %s %llu", c.first.c_str(), (unsigned long long)c.second);
+    if (skipped)
+        fprintf(stderr, ", %llu bytes skipped", (unsigned long long)skipped);
+    fprintf(stderr, "\n");
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Main
+// ------------------------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+    try
+    {
+        int result = top(argc, argv);
+        return result;
+    }
+
+    catch ( int error )
+    {
+        fprintf(stderr, "log_decode threw exception %i \n", error);
+        return error;
+    }
+}
@@ -0,0 +1,329 @@
+/**
+ * @file replay.cpp
+ *
+ * @brief Offline replay: drive the vision chain from a recorded video and flight tlog
+ *
+ * 用 videothread 录下的 little_e.avi (未标注的检测图, 每帧都有; 或只含解码过的大图的 big_e.avi)
+ * + little_e.csv 和 top() 录下的 flight.tlog,
+ * 在地面上按记录时刻重放: 每帧处理前先把时间不晚于该帧的 MAVLink 消息送进 Autopilot_Interface,
+ * 然后调用与机载程序相同的 Vision_Pipeline::process, 逐帧输出检测结果和耗时.
+ *
+ * usage: replay <video> <tlog> [-o frames.csv] [-t frame_times.csv] [-c calib.yml] [--config uav.yml]
+ *               [--fps N] [--stable] [--drop]
+ *
+ * 帧时刻优先取 -t 指定的文件, 缺省为视频同名的 .csv (videothread 写的 seq,time_usec,has_full);
+ * 没有时按 tlog 第一条消息的时刻加 i/fps 估计.
+ * 回放 big_e.avi 时只有 has_full 为 1 的行对应视频中的帧.
+ * 检测参数和阈值取自 --config (缺省 config/uav.yml), 没有 -c 时标定文件也按其中的 calib_file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "autopilot_interface.h"
+#include "camera_capture.h"
+#include "vision_pipeline.h"
+#include "runtime_config.h"
+
+using namespace std;
+
+
+// tlog 中的一条消息
+struct Log_Message
+{
+    uint64_t time_usec;
+    mavlink_message_t message;
+};
+
+
+// ------------------------------------------------------------------------------
+//   读 tlog: 每条消息前是 8 字节大端的接收时刻
+// ------------------------------------------------------------------------------
+static bool
+load_tlog(const char *path, vector<Log_Message> &log)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open tlog %s\n", path);
+        return false;
+    }
+
+    uint8_t stamp[8];
+    while (fread(stamp, 1, 8, f) == 8)
+    {
+        Log_Message entry;
+        entry.time_usec = 0;
+        for (int i = 0; i < 8; i++)
+            entry.time_usec = (entry.time_usec << 8) | stamp[i];
+
+        mavlink_status_t status;
+        int c, got = 0;
+        while (!got && (c = fgetc(f)) != EOF)
+            got = mavlink_parse_char(MAVLINK_COMM_2, (uint8_t)c, &entry.message, &status);
+        if (!got)
+            break;
+        log.push_back(entry);
+    }
+
+    fclose(f);
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------
+//   读帧时刻
+// ------------------------------------------------------------------------------
+static bool
+load_frame_times(const string &path, bool full_only, vector<uint64_t> &times)
+{
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f)
+        return false;
+
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long long seq, t;
+        int has_full = 1;
+        if (sscanf(line, "%llu,%llu,%d", &seq, &t, &has_full) < 2)
+            continue;
+        if (full_only && !has_full)
+            continue;
+        times.push_back(t);
+    }
+
+    fclose(f);
+    return !times.empty();
+}
+
+static string
+sidecar_path(const string &video)
+{
+    size_t dot = video.find_last_of('.');
+    size_t slash = video.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return video + ".csv";
+    return video.substr(0, dot) + ".csv";
+}
+
+static bool
+is_full_video(const string &video)
+{
+    return video.find("big_e") != string::npos;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Parse Command Line
+// ------------------------------------------------------------------------------
+static const char *commandline_usage =
+        "usage: replay <video> <tlog> [-o frames.csv] [-t frame_times.csv] [-c calib.yml] [--config uav.yml] "
+        "[--fps N] [--stable] [--drop]";
+
+static void
+parse_commandline(int argc, char **argv, const char *&video, const char *&tlog_path,
+                  const char *&out_path, const char *&times_path, const char *&calib_path,
+                  const char *&config_path, double &fps, Vision_Mode &mode)
+{
+    int positional = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "--stable") == 0) {
+            mode.stable = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--drop") == 0) {
+            mode.drop = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-t") == 0 ||
+            strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0 || strcmp(argv[i], "--fps") == 0) {
+            if (argc <= i + 1) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            if (argv[i][1] == 'o')
+                out_path = argv[i + 1];
+            else if (argv[i][1] == 't')
+                times_path = argv[i + 1];
+            else if (argv[i][1] == 'c')
+                calib_path = argv[i + 1];
+            else if (strcmp(argv[i], "--config") == 0)
+                config_path = argv[i + 1];
+            else
+                fps = atof(argv[i + 1]);
+            i++;
+            continue;
+        }
+
+        if (positional == 0)
+            video = argv[i];
+        else if (positional == 1)
+            tlog_path = argv[i];
+        positional++;
+    }
+
+    if (positional != 2) {
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   TOP
+// ------------------------------------------------------------------------------
+int
+top(int argc, char **argv)
+{
+    const char *video = NULL, *tlog_path = NULL;
+    const char *out_path = "replay_frames.csv";
+    const char *times_path = NULL;
+    const char *calib_path = NULL;
+    const char *config_path = RUNTIME_CONFIG_FILE;
+    double fps = 0;
+    Vision_Mode mode;
+    parse_commandline(argc, argv, video, tlog_path, out_path, times_path, calib_path, config_path, fps, mode);
+    load_runtime_config(config_path);
+    if (!calib_path)
+        calib_path = runtime_config.calib_file.c_str();
+
+    vector<Log_Message> log;
+    if (!load_tlog(tlog_path, log))
+        return EXIT_FAILURE;
+    printf("REPLAY %lu messages from %s\n", (unsigned long)log.size(), tlog_path);
+
+    Capture_Config capture_config;
+    capture_config.source = video;
+    Camera_Capture camera;
+    if (!camera.open(capture_config))
+        return EXIT_FAILURE;
+
+    vector<uint64_t> frame_times;
+    string times_file = times_path ? string(times_path) : sidecar_path(video);
+    if (!load_frame_times(times_file, is_full_video(video), frame_times))
+        fprintf(stderr, "WARNING: no frame times in %s, spacing frames evenly from the first message\n",
+                times_file.c_str());
+    if (fps <= 0)
+        fps = 5.0;//videothread 录像的帧率
+
+    FILE *out = fopen(out_path, "w");
+    if (!out)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", out_path);
+        return EXIT_FAILURE;
+    }
+    fprintf(out, "seq,time_usec,detected,candidates,out,T,F,targets,ellipse_T,ellipse_F,drop_x,drop_y,detect_ms,total_ms\n");
+
+    // 不连接串口, 消息由 handle_message 直接注入
+    Autopilot_Interface api(NULL, NULL);
+    Time_Stamps this_timestamps;
+    camera_model.load(calib_path, capture_config.work);
+    Vision_Pipeline pipeline;
+    pipeline.setup(capture_config.work);
+    mode.update = true;
+    mode.epoch = 1;
+    vision_mode.publish(std::make_shared<Vision_Mode>(mode));
+
+    uint64_t start_usec = log.empty() ? 0 : log[0].time_usec;
+    size_t next = 0;
+    Capture_Frame frame;
+    vector<double> total_ms;
+    double t0 = (double)getTickCount();
+
+    for (uint64_t i = 0; camera.read(frame); i++)
+    {
+        uint64_t frame_usec;
+        if (i < frame_times.size())
+            frame_usec = frame_times[i];
+        else if (frame_times.empty())
+            frame_usec = start_usec + (uint64_t)(i * 1e6 / fps);
+        else
+            break;//视频比帧时刻记录长, 多出的帧没有对应的飞行数据
+
+        // 送入该帧之前收到的所有消息
+        for (; next < log.size() && log[next].time_usec <= frame_usec; next++)
+        {
+            set_replay_time(log[next].time_usec);
+            api.handle_message(log[next].message, this_timestamps);
+        }
+        set_replay_time(frame_usec);
+        frame.time_usec = frame_usec;
+
+        Vision_Result result;
+        pipeline.process(api, camera, frame, result);
+        total_ms.push_back(result.total_ms);
+        Target_Snapshot_Ptr snapshot = target_channel.latest();
+
+        fprintf(out, "%llu,%llu,%d,%d,%lu,%d,%d,%lu,%lu,%lu,%.3f,%.3f,%.2f,%.2f\n",
+                (unsigned long long)result.seq, (unsigned long long)result.time_usec,
+                result.detected, result.candidates, (unsigned long)result.ellipses.size(),
+                result.T, result.F, (unsigned long)snapshot->targets.size(),
+                (unsigned long)snapshot->T.size(), (unsigned long)snapshot->F.size(),
+                snapshot->drop_target.locx, snapshot->drop_target.locy, result.detect_ms, result.total_ms);
+    }
+
+    double wall_s = ((double)getTickCount() - t0) / getTickFrequency();
+    fclose(out);
+
+    // ------------------------------------------------------------------------------
+    //   汇总
+    // ------------------------------------------------------------------------------
+    size_t n = total_ms.size();
+    if (n == 0)
+    {
+        fprintf(stderr, "ERROR: no frames read from %s\n", video);
+        return EXIT_FAILURE;
+    }
+    double mean = 0;
+    for (double t : total_ms)
+        mean += t;
+    mean /= n;
+    sort(total_ms.begin(), total_ms.end());
+    double p95 = total_ms[min(n - 1, (size_t)ceil(0.95 * n) - 1)];
+
+    fprintf(stderr, "REPLAY %lu frames in %.2f s (%.1f fps), total_ms mean %.2f p95 %.2f max %.2f\n",
+            (unsigned long)n, wall_s, n / wall_s, mean, p95, total_ms[n - 1]);
+    Target_Snapshot_Ptr snapshot = target_channel.latest();
+    fprintf(stderr, "REPLAY targets %lu, T %lu, F %lu, per-frame results in %s\n",
+            (unsigned long)snapshot->targets.size(), (unsigned long)snapshot->T.size(),
+            (unsigned long)snapshot->F.size(), out_path);
+    for (auto &p:snapshot->targets)
+        fprintf(stderr, "  target %d: locx %.2f locy %.2f T %u F %u\n", p.num, p.locx, p.locy, p.T_N, p.F_N);
+
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Main
+// ------------------------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+    try
+    {
+        int result = top(argc, argv);
+        return result;
+    }
+
+    catch ( int error )
+    {
+        fprintf(stderr, "replay threw exception %i \n", error);
+        return error;
+    }
+}
@@ -0,0 +1,903 @@
+/**
+ * @file sim_autopilot.cpp
+ *
+ * @brief Simulated autopilot on a pseudo-terminal, and a loopback load test of Autopilot_Interface
+ *
+ * 用 openpty 建立一对伪终端, 主端由模拟飞控读写, 从端 (/dev/pts/N) 和真实串口一样可以由 Serial_Port 打开.
+ * 模拟飞控按设定频率发送 HEARTBEAT / SYS_STATUS / ATTITUDE / LOCAL_POSITION_NED / GLOBAL_POSITION_INT /
+ * MISSION_ITEM_REACHED, 接收 SET_POSITION_TARGET_LOCAL_NED / SET_POSITION_TARGET_GLOBAL_INT / SET_MODE /
+ * COMMAND_LONG 并更新自身状态 (模式、解锁、朝设定点飞行), COMMAND_LONG 回 COMMAND_ACK.
+ * REQUEST_DATA_STREAM 和 SET_MESSAGE_INTERVAL 按 ArduPilot 的数据流分组修改各消息的发送频率.
+ * 发送按 -b 给定的波特率限速, 以模拟真实串口的带宽.
+ *
+ * 两种用法:
+ *  - 独立运行: 打印从端设备名, 供 UAVs_uart_interface -d /dev/pts/N 连接, Ctrl-C 退出
+ *  - --loopback: 在同一进程中用 Serial_Port + Autopilot_Interface 打开从端,
+ *      1) 逐条发送设定点 / SET_MODE / COMMAND_LONG, 测量从调用到模拟飞控收到的延迟
+ *      2) 以 --cmd-rate 连续发送设定点 --duration 秒, 同时统计遥测从发出到 Autopilot_Interface 处理的延迟
+ *    结果以 JSON 输出.
+ *
+ * usage: sim_autopilot [-b baud] [-r stream=hz ...] [--loopback] [-n samples] [--cmd-rate hz] [--duration s] [-o result.json]
+ *        stream: heartbeat sys_status attitude local global reached
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pty.h>
+#include <signal.h>
+#include <pthread.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "serial_port.h"
+#include "autopilot_interface.h"
+
+using namespace std;
+
+
+// ------------------------------------------------------------------------------
+//   Defines
+// ------------------------------------------------------------------------------
+
+enum Sim_Stream
+{
+    SIM_HEARTBEAT,
+    SIM_SYS_STATUS,
+    SIM_ATTITUDE,
+    SIM_LOCAL_POSITION,
+    SIM_GLOBAL_POSITION,
+    SIM_MISSION_REACHED,
+    SIM_STREAM_COUNT
+};
+
+static const char *stream_names[SIM_STREAM_COUNT] = {"heartbeat", "sys_status", "attitude", "local", "global", "reached"};
+static const float default_rates[SIM_STREAM_COUNT] = {1, 1, 10, 10, 5, 0.2f};
+
+#define SIM_TAG_RING 1024       // 记录 LOCAL_POSITION_NED 发送时刻的个数
+#define SIM_HOME_LAT 300000000  // 模拟的起飞点, degE7
+#define SIM_HOME_LON 1200000000
+#define SIM_MAX_SPEED 5.0f      // m/s
+
+
+// SET_MESSAGE_INTERVAL 的 msgid 对应的模拟数据流, 不支持的返回 -1
+static int
+message_stream(int msgid)
+{
+    switch (msgid)
+    {
+        case MAVLINK_MSG_ID_SYS_STATUS:          return SIM_SYS_STATUS;
+        case MAVLINK_MSG_ID_ATTITUDE:            return SIM_ATTITUDE;
+        case MAVLINK_MSG_ID_LOCAL_POSITION_NED:  return SIM_LOCAL_POSITION;
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT: return SIM_GLOBAL_POSITION;
+        default:                                 return -1;
+    }
+}
+
+static uint64_t
+mono_usec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Sim_Autopilot
+// ------------------------------------------------------------------------------
+class Sim_Autopilot
+{
+
+public:
+
+    Sim_Autopilot();
+    ~Sim_Autopilot();
+
+    bool open();
+    void start();
+    void stop();
+    const char *device() const { return slave_name; }
+
+    float rates[SIM_STREAM_COUNT];  // Hz, 0 为不发送
+    int baud;                       // 发送限速, 0 为不限速
+    uint8_t system_id;
+    uint8_t component_id;
+
+    // 统计
+    volatile uint64_t sent_messages;
+    volatile uint64_t sent_bytes;
+    volatile uint64_t received[256];
+    volatile uint64_t received_usec[256];   // 每种消息最近一次收到的时刻 (get_time_usec)
+    volatile uint64_t parse_errors;
+
+    // 状态
+    volatile uint32_t custom_mode;
+    volatile bool armed;
+
+    // 设定点标签 (time_boot_ms) 被收到的时刻, 供 loopback 测量连续发送时的延迟
+    vector<uint64_t> tag_received_usec;
+
+    // 由 LOCAL_POSITION_NED 的 time_boot_ms 查发送时刻, 找不到返回 0
+    uint64_t local_position_sent(uint32_t time_boot_ms);
+
+    void tx_thread();
+    void rx_thread();
+
+private:
+
+    int master;
+    int slave;
+    char slave_name[64];
+    bool time_to_exit;
+    pthread_t tx_tid;
+    pthread_t rx_tid;
+    pthread_mutex_t lock;
+
+    uint64_t boot_usec;
+    uint64_t next_usec[SIM_STREAM_COUNT];
+    uint64_t line_free_usec;    // 按波特率算出的发送端空闲时刻
+
+    float x, y, z, vx, vy, vz, yaw;
+    float sp_x, sp_y, sp_z;
+    uint16_t mission_seq;
+
+    uint32_t tag_ms[SIM_TAG_RING];
+    uint64_t tag_usec[SIM_TAG_RING];
+    int tag_head;
+
+    void send(mavlink_message_t &message);
+    void send_stream(int stream, uint64_t now);
+    void update(float dt);
+    void handle(const mavlink_message_t &message);
+
+};
+
+
+static void *
+start_sim_tx_thread(void *args)
+{
+    ((Sim_Autopilot *)args)->tx_thread();
+    return NULL;
+}
+
+static void *
+start_sim_rx_thread(void *args)
+{
+    ((Sim_Autopilot *)args)->rx_thread();
+    return NULL;
+}
+
+
+Sim_Autopilot::
+Sim_Autopilot()
+{
+    for (int i = 0; i < SIM_STREAM_COUNT; i++)
+        rates[i] = default_rates[i];
+    baud = 921600;
+    system_id = 1;
+    component_id = 1;
+
+    sent_messages = sent_bytes = parse_errors = 0;
+    for (int i = 0; i < 256; i++)
+        received[i] = received_usec[i] = 0;
+    custom_mode = 0;
+    armed = false;
+
+    master = slave = -1;
+    slave_name[0] = 0;
+    time_to_exit = false;
+    tx_tid = rx_tid = 0;
+    pthread_mutex_init(&lock, NULL);
+
+    x = y = vx = vy = vz = yaw = 0;
+    z = -12;
+    sp_x = x;
+    sp_y = y;
+    sp_z = z;
+    mission_seq = 0;
+    tag_head = 0;
+    memset(tag_ms, 0, sizeof(tag_ms));
+    memset(tag_usec, 0, sizeof(tag_usec));
+}
+
+Sim_Autopilot::
+~Sim_Autopilot()
+{
+    stop();
+    if (slave >= 0)
+        close(slave);
+    if (master >= 0)
+        close(master);
+    pthread_mutex_destroy(&lock);
+}
+
+bool
+Sim_Autopilot::
+open()
+{
+    if (openpty(&master, &slave, slave_name, NULL, NULL) < 0)
+    {
+        fprintf(stderr, "ERROR: openpty failed\n");
+        return false;
+    }
+
+    // 主端不做任何行处理
+    struct termios config;
+    tcgetattr(master, &config);
+    cfmakeraw(&config);
+    tcsetattr(master, TCSANOW, &config);
+    return true;
+}
+
+void
+Sim_Autopilot::
+start()
+{
+    boot_usec = mono_usec();
+    line_free_usec = boot_usec;
+    for (int i = 0; i < SIM_STREAM_COUNT; i++)
+        next_usec[i] = boot_usec;
+    time_to_exit = false;
+    pthread_create(&tx_tid, NULL, &start_sim_tx_thread, this);
+    pthread_create(&rx_tid, NULL, &start_sim_rx_thread, this);
+}
+
+void
+Sim_Autopilot::
+stop()
+{
+    if (time_to_exit || !tx_tid)
+        return;
+    time_to_exit = true;
+    pthread_join(tx_tid, NULL);
+    // rx 线程阻塞在 read 上, 直接取消
+    pthread_cancel(rx_tid);
+    pthread_join(rx_tid, NULL);
+}
+
+
+// ------------------------------------------------------------------------------
+//   发送
+// ------------------------------------------------------------------------------
+void
+Sim_Autopilot::
+send(mavlink_message_t &message)
+{
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
+
+    // 按波特率限速: 每字节 10 bit (8N1)
+    if (baud > 0)
+    {
+        uint64_t now = mono_usec();
+        if (line_free_usec < now)
+            line_free_usec = now;
+        line_free_usec += (uint64_t)len * 10 * 1000000ULL / baud;
+        if (line_free_usec > now + 1000)
+            usleep(line_free_usec - now - 1000);
+    }
+
+    const uint8_t *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = write(master, p, len);
+        if (n <= 0)
+            return;
+        p += n;
+        len -= n;
+        sent_bytes += n;
+    }
+    sent_messages++;
+}
+
+void
+Sim_Autopilot::
+send_stream(int stream, uint64_t now)
+{
+    mavlink_message_t message;
+    uint32_t time_boot_ms = (uint32_t)((now - boot_usec) / 1000);
+
+    pthread_mutex_lock(&lock);
+    float px = x, py = y, pz = z, pvx = vx, pvy = vy, pvz = vz, pyaw = yaw;
+    pthread_mutex_unlock(&lock);
+
+    switch (stream)
+    {
+        case SIM_HEARTBEAT:
+        {
+            uint8_t base_mode = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED | (armed ? MAV_MODE_FLAG_SAFETY_ARMED : 0);
+            mavlink_msg_heartbeat_pack(system_id, component_id, &message, MAV_TYPE_QUADROTOR,
+                                       MAV_AUTOPILOT_ARDUPILOTMEGA, base_mode, custom_mode,
+                                       armed ? MAV_STATE_ACTIVE : MAV_STATE_STANDBY);
+            break;
+        }
+
+        case SIM_SYS_STATUS:
+        {
+            mavlink_msg_sys_status_pack(system_id, component_id, &message, 0, 0, 0, 500, 12600, -1, -1,
+                                        0, 0, 0, 0, 0, 0);
+            break;
+        }
+
+        case SIM_ATTITUDE:
+        {
+            mavlink_msg_attitude_pack(system_id, component_id, &message, time_boot_ms, 0, 0, pyaw, 0, 0, 0);
+            break;
+        }
+
+        case SIM_LOCAL_POSITION:
+        {
+            // 记录发送时刻, loopback 用来计算遥测延迟
+            pthread_mutex_lock(&lock);
+            tag_ms[tag_head] = time_boot_ms;
+            tag_usec[tag_head] = get_time_usec();
+            tag_head = (tag_head + 1) % SIM_TAG_RING;
+            pthread_mutex_unlock(&lock);
+            mavlink_msg_local_position_ned_pack(system_id, component_id, &message, time_boot_ms,
+                                                px, py, pz, pvx, pvy, pvz);
+            break;
+        }
+
+        case SIM_GLOBAL_POSITION:
+        {
+            // 平面近似, 1e-7 度约 1.11 cm
+            int32_t lat = SIM_HOME_LAT + (int32_t)(px / 1.11e-2f);
+            int32_t lon = SIM_HOME_LON + (int32_t)(py / (1.11e-2f * cosf(SIM_HOME_LAT * 1e-7f * (float)M_PI / 180)));
+            uint16_t hdg = (uint16_t)fmodf(pyaw * 18000.0f / (float)M_PI + 36000.0f, 36000.0f);
+            mavlink_msg_global_position_int_pack(system_id, component_id, &message, time_boot_ms, lat, lon,
+                                                 (int32_t)(-pz * 1000), (int32_t)(-pz * 1000),
+                                                 (int16_t)(pvx * 100), (int16_t)(pvy * 100), (int16_t)(pvz * 100), hdg);
+            break;
+        }
+
+        case SIM_MISSION_REACHED:
+        {
+            mavlink_msg_mission_item_reached_pack(system_id, component_id, &message, mission_seq++);
+            break;
+        }
+
+        default:
+            return;
+    }
+
+    send(message);
+}
+
+void
+Sim_Autopilot::
+tx_thread()
+{
+    uint64_t last = mono_usec();
+    while (!time_to_exit)
+    {
+        uint64_t now = mono_usec();
+        update((now - last) / 1e6f);
+        last = now;
+
+        for (int i = 0; i < SIM_STREAM_COUNT; i++)
+        {
+            if (rates[i] <= 0 || now < next_usec[i])
+                continue;
+            send_stream(i, now);
+            next_usec[i] += (uint64_t)(1e6f / rates[i]);
+            if (next_usec[i] < now)//发送跟不上时不补发
+                next_usec[i] = now;
+        }
+
+        usleep(500);
+    }
+}
+
+// 以最大速度飞向设定点
+void
+Sim_Autopilot::
+update(float dt)
+{
+    pthread_mutex_lock(&lock);
+    float dx = sp_x - x, dy = sp_y - y, dz = sp_z - z;
+    float d = sqrtf(dx * dx + dy * dy + dz * dz);
+    if (d > 1e-3f && armed)
+    {
+        float v = min(SIM_MAX_SPEED, d / max(dt, 1e-3f));
+        vx = v * dx / d;
+        vy = v * dy / d;
+        vz = v * dz / d;
+        x += vx * dt;
+        y += vy * dt;
+        z += vz * dt;
+        if (dx * dx + dy * dy > 0.01f)
+            yaw = atan2f(dy, dx);
+    }
+    else
+        vx = vy = vz = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+
+// ------------------------------------------------------------------------------
+//   接收
+// ------------------------------------------------------------------------------
+void
+Sim_Autopilot::
+rx_thread()
+{
+    uint8_t buf[256];
+    mavlink_message_t message;
+    mavlink_status_t status;
+    while (!time_to_exit)
+    {
+        ssize_t n = read(master, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            usleep(1000);
+            continue;
+        }
+        for (ssize_t i = 0; i < n; i++)
+        {
+            if (mavlink_parse_char(MAVLINK_COMM_3, buf[i], &message, &status))
+            {
+                received[message.msgid]++;
+                received_usec[message.msgid] = get_time_usec();
+                handle(message);
+            }
+        }
+        parse_errors = mavlink_get_channel_status(MAVLINK_COMM_3)->parse_error;
+    }
+}
+
+void
+Sim_Autopilot::
+handle(const mavlink_message_t &message)
+{
+    switch (message.msgid)
+    {
+        case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+        {
+            mavlink_set_position_target_local_ned_t sp;
+            mavlink_msg_set_position_target_local_ned_decode(&message, &sp);
+            if (sp.time_boot_ms < tag_received_usec.size())
+                tag_received_usec[sp.time_boot_ms] = get_time_usec();
+            // 位置被屏蔽时按速度积分一步
+            pthread_mutex_lock(&lock);
+            if (!(sp.type_mask & 0x0007))
+            {
+                sp_x = sp.x;
+                sp_y = sp.y;
+                sp_z = sp.z;
+            }
+            else if (!(sp.type_mask & 0x0038))
+            {
+                sp_x = x + sp.vx;
+                sp_y = y + sp.vy;
+                sp_z = z + sp.vz;
+            }
+            pthread_mutex_unlock(&lock);
+            break;
+        }
+
+        case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+        {
+            mavlink_set_position_target_global_int_t sp;
+            mavlink_msg_set_position_target_global_int_decode(&message, &sp);
+            pthread_mutex_lock(&lock);
+            if (!(sp.type_mask & 0x0007))
+            {
+                sp_x = (sp.lat_int - SIM_HOME_LAT) * 1.11e-2f;
+                sp_y = (sp.lon_int - SIM_HOME_LON) * 1.11e-2f * cosf(SIM_HOME_LAT * 1e-7f * (float)M_PI / 180);
+                sp_z = -sp.alt;
+            }
+            pthread_mutex_unlock(&lock);
+            break;
+        }
+
+        case MAVLINK_MSG_ID_SET_MODE:
+        {
+            custom_mode = mavlink_msg_set_mode_get_custom_mode(&message);
+            break;
+        }
+
+        case MAVLINK_MSG_ID_COMMAND_LONG:
+        {
+            mavlink_command_long_t cmd;
+            mavlink_msg_command_long_decode(&message, &cmd);
+            uint8_t result = MAV_RESULT_ACCEPTED;
+            if (cmd.command == MAV_CMD_COMPONENT_ARM_DISARM)
+                armed = cmd.param1 > 0.5f;
+            if (cmd.command == MAV_CMD_SET_MESSAGE_INTERVAL)
+            {
+                // param2: 间隔 (us), -1 为停止, 0 为缺省频率
+                int stream = message_stream((int)cmd.param1);
+                if (stream < 0)
+                    result = MAV_RESULT_UNSUPPORTED;
+                else
+                    rates[stream] = cmd.param2 > 0 ? 1e6f / cmd.param2 : cmd.param2 == 0 ? default_rates[stream] : 0;
+            }
+            mavlink_message_t ack;
+            mavlink_msg_command_ack_pack(system_id, component_id, &ack, cmd.command, result);
+            send(ack);
+            break;
+        }
+
+        case MAVLINK_MSG_ID_REQUEST_DATA_STREAM:
+        {
+            mavlink_request_data_stream_t req;
+            mavlink_msg_request_data_stream_decode(&message, &req);
+            float hz = req.start_stop ? req.req_message_rate : 0;
+            uint8_t id = req.req_stream_id;
+            if (id == MAV_DATA_STREAM_ALL || id == MAV_DATA_STREAM_EXTENDED_STATUS)
+                rates[SIM_SYS_STATUS] = hz;
+            if (id == MAV_DATA_STREAM_ALL || id == MAV_DATA_STREAM_EXTRA1)
+                rates[SIM_ATTITUDE] = hz;
+            if (id == MAV_DATA_STREAM_ALL || id == MAV_DATA_STREAM_POSITION)
+                rates[SIM_LOCAL_POSITION] = rates[SIM_GLOBAL_POSITION] = hz;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+uint64_t
+Sim_Autopilot::
+local_position_sent(uint32_t time_boot_ms)
+{
+    uint64_t t = 0;
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < SIM_TAG_RING; i++)
+    {
+        if (tag_usec[i] && tag_ms[i] == time_boot_ms)
+        {
+            t = tag_usec[i];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return t;
+}
+
+
+// ------------------------------------------------------------------------------
+//   统计
+// ------------------------------------------------------------------------------
+struct Latency_Set
+{
+    vector<double> v;   // us
+
+    double percentile(double p)
+    {
+        if (v.empty())
+            return 0;
+        sort(v.begin(), v.end());
+        size_t k = (size_t)ceil(p / 100.0 * v.size());
+        return v[k > 0 ? k - 1 : 0];
+    }
+
+    void json(FILE *f, const char *name, bool last)
+    {
+        fprintf(f, "    \"%s\": {\"samples\": %lu, \"p50_us\": %.1f, \"p95_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}%s\n",
+                name, (unsigned long)v.size(), percentile(50), percentile(95), percentile(99), percentile(100),
+                last ? "" : ",");
+    }
+
+    void print(const char *name)
+    {
+        fprintf(stderr, "%-20s %6lu samples  p50 %8.1f us  p95 %8.1f us  p99 %8.1f us\n", name,
+                (unsigned long)v.size(), percentile(50), percentile(95), percentile(99));
+    }
+};
+
+// 等待模拟飞控收到某种消息, 返回延迟 (us), 超时返回 -1
+static double
+wait_received(Sim_Autopilot &sim, uint8_t msgid, uint64_t before, uint64_t t_send)
+{
+    uint64_t deadline = t_send + 1000000;
+    while (sim.received[msgid] == before)
+    {
+        if (get_time_usec() > deadline)
+            return -1;
+        usleep(50);
+    }
+    return (double)(sim.received_usec[msgid] - t_send);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Loopback: Serial_Port + Autopilot_Interface 接在模拟飞控上
+// ------------------------------------------------------------------------------
+static int
+loopback(Sim_Autopilot &sim, int samples, float cmd_rate, float duration, const char *out_path)
+{
+    // 机间通信口接一个空的伪终端
+    int wl_master, wl_slave;
+    char wl_name[64];
+    if (openpty(&wl_master, &wl_slave, wl_name, NULL, NULL) < 0)
+    {
+        fprintf(stderr, "ERROR: openpty failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int baud = sim.baud > 0 ? sim.baud : 921600;
+    Serial_Port serial_port(sim.device(), baud);
+    Serial_Port WL_port(wl_name, 57600);
+    Autopilot_Interface api(&serial_port, &WL_port);
+
+    // 启动时按 -r 给定的频率协商, 与接真实飞控时的过程相同
+    api.stream_rates.set(MAVLINK_MSG_ID_SYS_STATUS, sim.rates[SIM_SYS_STATUS], MAV_DATA_STREAM_EXTENDED_STATUS);
+    api.stream_rates.set(MAVLINK_MSG_ID_ATTITUDE, sim.rates[SIM_ATTITUDE], MAV_DATA_STREAM_EXTRA1);
+    api.stream_rates.set(MAVLINK_MSG_ID_LOCAL_POSITION_NED, sim.rates[SIM_LOCAL_POSITION], MAV_DATA_STREAM_POSITION);
+    api.stream_rates.set(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, sim.rates[SIM_GLOBAL_POSITION], MAV_DATA_STREAM_POSITION);
+
+    serial_port.start();
+    WL_port.start();
+    api.start();
+
+    // --------------------------------------------------------------------------
+    //   1) 单条命令延迟
+    // --------------------------------------------------------------------------
+    Latency_Set setpoint, set_mode, command_long, telemetry;
+    uint64_t timeouts = 0;
+    for (int i = 0; i < samples; i++)
+    {
+        mavlink_set_position_target_local_ned_t sp;
+        memset(&sp, 0, sizeof(sp));
+        set_position(i * 0.1f, 0, -12, sp);
+        sp.time_boot_ms = 1;
+
+        uint64_t before = sim.received[MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED];
+        uint64_t t_send = get_time_usec();
+        api.update_local_setpoint(sp);
+        double dt = wait_received(sim, MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED, before, t_send);
+        if (dt >= 0) setpoint.v.push_back(dt); else timeouts++;
+
+        before = sim.received[MAVLINK_MSG_ID_SET_MODE];
+        t_send = get_time_usec();
+        api.Set_Mode(i % 2 ? 4 : 3);
+        dt = wait_received(sim, MAVLINK_MSG_ID_SET_MODE, before, t_send);
+        if (dt >= 0) set_mode.v.push_back(dt); else timeouts++;
+
+        before = sim.received[MAVLINK_MSG_ID_COMMAND_LONG];
+        t_send = get_time_usec();
+        api.Servo_Control(11, 1250);
+        dt = wait_received(sim, MAVLINK_MSG_ID_COMMAND_LONG, before, t_send);
+        if (dt >= 0) command_long.v.push_back(dt); else timeouts++;
+    }
+
+    // --------------------------------------------------------------------------
+    //   2) 连续发送设定点, 同时统计遥测延迟
+    // --------------------------------------------------------------------------
+    int stream_count = (int)(cmd_rate * duration);
+    sim.tag_received_usec.assign(stream_count + 2, 0);
+    vector<uint64_t> tag_sent_usec(stream_count + 2, 0);
+    uint64_t telemetry_before = sim.sent_messages;
+    uint64_t bytes_before = sim.sent_bytes;
+    uint64_t t_start = get_time_usec();
+    uint32_t last_tag = 0;
+
+    for (int i = 0; i < stream_count; i++)
+    {
+        mavlink_set_position_target_local_ned_t sp;
+        memset(&sp, 0, sizeof(sp));
+        set_position(10 * cosf(i * 0.01f), 10 * sinf(i * 0.01f), -12, sp);
+        sp.time_boot_ms = i + 1;   // 作为标签, 非 0 时 write_local_setpoint 不改写
+        tag_sent_usec[i + 1] = get_time_usec();
+        api.update_local_setpoint(sp);
+
+        // 遥测: Autopilot_Interface 处理 LOCAL_POSITION_NED 的时刻减去模拟飞控发送的时刻
+        uint32_t tag = api.current_messages.local_position_ned.time_boot_ms;
+        if (tag != last_tag)
+        {
+            uint64_t sent = sim.local_position_sent(tag);
+            uint64_t handled = api.current_messages.time_stamps.local_position_ned;
+            if (sent && handled >= sent)
+                telemetry.v.push_back((double)(handled - sent));
+            last_tag = tag;
+        }
+
+        uint64_t next = t_start + (uint64_t)((i + 1) * 1e6f / cmd_rate);
+        uint64_t now = get_time_usec();
+        if (next > now)
+            usleep(next - now);
+    }
+    usleep(200000);
+    double elapsed = (get_time_usec() - t_start) / 1e6;
+
+    Latency_Set stream;
+    uint64_t lost = 0;
+    for (int i = 1; i <= stream_count; i++)
+    {
+        if (sim.tag_received_usec[i])
+            stream.v.push_back((double)(sim.tag_received_usec[i] - tag_sent_usec[i]));
+        else
+            lost++;
+    }
+    double telemetry_rate = (sim.sent_messages - telemetry_before) / elapsed;
+    double telemetry_bps = (sim.sent_bytes - bytes_before) * 10 / elapsed;
+
+    api.stop();
+    serial_port.stop();
+    WL_port.stop();
+    close(wl_slave);
+    close(wl_master);
+
+    // --------------------------------------------------------------------------
+    //   输出
+    // --------------------------------------------------------------------------
+    fprintf(stderr, "\nLOOPBACK %d baud, %d samples, %d streamed setpoints at %.0f Hz\n",
+            baud, samples, stream_count, cmd_rate);
+    setpoint.print("setpoint");
+    set_mode.print("set_mode");
+    command_long.print("command_long");
+    stream.print("setpoint_stream");
+    telemetry.print("telemetry");
+    fprintf(stderr, "telemetry %.0f msg/s (%.0f bit/s), lost setpoints %llu, timeouts %llu, sim parse errors %llu\n",
+            telemetry_rate, telemetry_bps, (unsigned long long)lost, (unsigned long long)timeouts,
+            (unsigned long long)sim.parse_errors);
+
+    FILE *f = out_path ? fopen(out_path, "w") : stdout;
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", out_path);
+        return EXIT_FAILURE;
+    }
+    fprintf(f, "{\n  \"baud\": %d,\n  \"cmd_rate\": %.1f,\n  \"telemetry_msgs_per_sec\": %.1f,\n"
+               "  \"telemetry_bits_per_sec\": %.1f,\n  \"lost_setpoints\": %llu,\n  \"timeouts\": %llu,\n"
+               "  \"sim_parse_errors\": %llu,\n  \"latency\": {\n",
+            baud, cmd_rate, telemetry_rate, telemetry_bps, (unsigned long long)lost,
+            (unsigned long long)timeouts, (unsigned long long)sim.parse_errors);
+    setpoint.json(f, "setpoint", false);
+    set_mode.json(f, "set_mode", false);
+    command_long.json(f, "command_long", false);
+    stream.json(f, "setpoint_stream", false);
+    telemetry.json(f, "telemetry", true);
+    fprintf(f, "  }\n}\n");
+    if (f != stdout)
+        fclose(f);
+
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Parse Command Line
+// ------------------------------------------------------------------------------
+static const char *commandline_usage =
+        "usage: sim_autopilot [-b baud] [-r stream=hz ...] [--loopback] [-n samples] [--cmd-rate hz] [--duration s] [-o result.json]\n"
+        "       stream: heartbeat sys_status attitude local global reached";
+
+static void
+parse_commandline(int argc, char **argv, Sim_Autopilot &sim, bool &loop, int &samples,
+                  float &cmd_rate, float &duration, const char *&out_path)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "--loopback") == 0) {
+            loop = true;
+            continue;
+        }
+
+        if (argc <= i + 1) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+        const char *value = argv[++i];
+
+        if (strcmp(argv[i - 1], "-b") == 0 || strcmp(argv[i - 1], "--baud") == 0)
+            sim.baud = atoi(value);
+        else if (strcmp(argv[i - 1], "-n") == 0)
+            samples = atoi(value);
+        else if (strcmp(argv[i - 1], "--cmd-rate") == 0)
+            cmd_rate = atof(value);
+        else if (strcmp(argv[i - 1], "--duration") == 0)
+            duration = atof(value);
+        else if (strcmp(argv[i - 1], "-o") == 0)
+            out_path = value;
+        else if (strcmp(argv[i - 1], "-r") == 0) {
+            const char *eq = strchr(value, '=');
+            int k = 0;
+            for (; eq && k < SIM_STREAM_COUNT; k++)
+                if (strncmp(value, stream_names[k], eq - value) == 0 && stream_names[k][eq - value] == 0)
+                    break;
+            if (!eq || k == SIM_STREAM_COUNT) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            sim.rates[k] = atof(eq + 1);
+        }
+        else {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+    }
+
+    if (samples < 0 || cmd_rate <= 0 || duration < 0) {
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   TOP
+// ------------------------------------------------------------------------------
+static volatile bool quit = false;
+
+static void
+quit_handler(int sig)
+{
+    quit = true;
+}
+
+int
+top(int argc, char **argv)
+{
+    Sim_Autopilot sim;
+    bool loop = false;
+    int samples = 200;
+    float cmd_rate = 50;
+    float duration = 5;
+    const char *out_path = NULL;
+    parse_commandline(argc, argv, sim, loop, samples, cmd_rate, duration, out_path);
+
+    if (!sim.open())
+        return EXIT_FAILURE;
+    sim.start();
+
+    if (loop)
+    {
+        int result = loopback(sim, samples, cmd_rate, duration, out_path);
+        sim.stop();
+        return result;
+    }
+
+    printf("SIM autopilot on %s (%d baud)\n", sim.device(), sim.baud);
+    signal(SIGINT, quit_handler);
+    uint64_t last_sent = 0;
+    while (!quit)
+    {
+        sleep(5);
+        printf("SIM sent %llu msg (%.0f msg/s), mode %u, %s, received setpoint_local %llu setpoint_global %llu "
+               "set_mode %llu command_long %llu, parse errors %llu\n",
+               (unsigned long long)sim.sent_messages, (sim.sent_messages - last_sent) / 5.0,
+               sim.custom_mode, sim.armed ? "armed" : "disarmed",
+               (unsigned long long)sim.received[MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED],
+               (unsigned long long)sim.received[MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT],
+               (unsigned long long)sim.received[MAVLINK_MSG_ID_SET_MODE],
+               (unsigned long long)sim.received[MAVLINK_MSG_ID_COMMAND_LONG],
+               (unsigned long long)sim.parse_errors);
+        last_sent = sim.sent_messages;
+    }
+
+    sim.stop();
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Main
+// ------------------------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+    try
+    {
+        int result = top(argc, argv);
+        return result;
+    }
+
+    catch ( int error )
+    {
+        fprintf(stderr, "sim_autopilot threw exception %i \n", error);
+        return error;
+    }
+}
@@ -0,0 +1,539 @@
+/**
+ * @file tune_detector.cpp
+ *
+ * @brief Offline detector parameter sweep against labelled frames: latency vs precision/recall Pareto front
+ *
+ * 对 th_length, th_obb, ns, th_score, min_reliability (config/uav.yml 的 detector 一节) 的取值网格中
+ * 每一组参数, 在标注过的帧上运行 CEllipseDetectorYaed::Detect, 统计每帧检测耗时和对标注椭圆的
+ * 准确率 (precision) / 召回率 (recall). 其余参数取自 --config. 结果以 JSON 输出, 并在终端上列出
+ * 耗时-准确率-召回率的 Pareto 前沿 (没有另一组参数在三项上都不差且至少一项更好), 用来选择工作点.
+ *
+ * usage: tune_detector <dir|video> <labels.csv> [-o tune_detector.json] [-s 640x360] [-j threads] [-n samples]
+ *                      [-r repeat] [--config uav.yml] [--tol 0.15] [-g name=v1,v2,...]
+ *
+ * labels.csv 每行一个椭圆: frame,cx,cy,a,b (帧下标按目录中文件名排序或视频帧顺序, 从 0 开始;
+ * 圆心和半轴为原图像素). 没有标注行的帧视为没有目标, 其中的检测结果都算误检.
+ * 检测结果与标注的圆心距离和半长轴之差都不超过 tol * 标注半长轴时算检出, 每个标注最多匹配一个检测.
+ *
+ * -j 个线程各自持有一个检测器, 同时评估不同的参数组, 缺省为 CPU 核数. 线程数多于空闲核时耗时会偏大,
+ * 各组之间仍可比较; 要得到与机载一致的耗时用 -j 1. -n 从网格中随机抽取 n 组, 缺省评估整个网格.
+ * -g 替换某个参数的取值网格, 可重复, 例如 -g th_score=0.3,0.4,0.5.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <random>
+
+#include "ellipse/EllipseDetectorYaed.h"
+#include "tools/json_escape.h"
+#include "runtime_config.h"
+
+using namespace std;
+using namespace cv;
+
+
+// ------------------------------------------------------------------------------
+//   参数网格
+// ------------------------------------------------------------------------------
+#define TUNE_PARAMS 5
+
+static const char *param_names[TUNE_PARAMS] = {"th_length", "th_obb", "ns", "th_score", "min_reliability"};
+
+struct Param_Grid
+{
+    vector<double> values[TUNE_PARAMS];
+
+    Param_Grid()
+    {
+        values[0] = {8, 12, 16, 20, 24};
+        values[1] = {2, 3, 4};
+        values[2] = {8, 12, 16, 24};
+        values[3] = {0.3, 0.4, 0.5, 0.6};
+        values[4] = {0.3, 0.4, 0.5};
+    }
+
+    size_t size() const
+    {
+        size_t n = 1;
+        for (int k = 0; k < TUNE_PARAMS; k++)
+            n *= values[k].size();
+        return n;
+    }
+
+    // 第 index 组参数, 覆盖 base 中对应的项
+    Detector_Config at(size_t index, const Detector_Config &base) const
+    {
+        double v[TUNE_PARAMS];
+        for (int k = TUNE_PARAMS - 1; k >= 0; k--)
+        {
+            v[k] = values[k][index % values[k].size()];
+            index /= values[k].size();
+        }
+        Detector_Config c = base;
+        c.th_length = (int)v[0];
+        c.th_obb = (float)v[1];
+        c.ns = (int)v[2];
+        c.th_score = (float)v[3];
+        c.min_reliability = (float)v[4];
+        return c;
+    }
+};
+
+// name=v1,v2,...
+static bool
+parse_grid(const char *arg, Param_Grid &grid)
+{
+    const char *eq = strchr(arg, '=');
+    if (!eq)
+        return false;
+    string name(arg, eq - arg);
+    for (int k = 0; k < TUNE_PARAMS; k++)
+    {
+        if (name != param_names[k])
+            continue;
+        vector<double> values;
+        const char *p = eq + 1;
+        while (*p)
+        {
+            char *end;
+            double x = strtod(p, &end);
+            if (end == p)
+                return false;
+            values.push_back(x);
+            p = end;
+            if (*p == ',')
+                p++;
+        }
+        if (values.empty())
+            return false;
+        grid.values[k] = values;
+        return true;
+    }
+    return false;
+}
+
+
+// ------------------------------------------------------------------------------
+//   标注帧
+// ------------------------------------------------------------------------------
+struct Label
+{
+    float cx, cy, a, b;
+};
+
+struct Labelled_Frame
+{
+    Mat1b gray;                 // 检测分辨率
+    vector<Label> labels;       // 已换算到检测分辨率
+};
+
+static bool
+load_frames(const string &source, vector<Mat3b> &frames)
+{
+    vector<String> files;
+    glob(source + "/*", files, false);
+    sort(files.begin(), files.end());
+    for (auto &f : files)
+    {
+        Mat3b image = imread(f, IMREAD_COLOR);
+        if (!image.empty())
+            frames.push_back(image);
+    }
+
+    // 不是图片目录时当作视频读
+    if (frames.empty())
+    {
+        VideoCapture cap(source);
+        Mat image;
+        while (cap.isOpened() && cap.read(image) && !image.empty())
+            frames.push_back(image.clone());
+    }
+
+    return !frames.empty();
+}
+
+static bool
+load_labels(const char *path, vector<vector<Label> > &labels)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int n = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        int frame;
+        Label l;
+        if (sscanf(line, "%d,%f,%f,%f,%f", &frame, &l.cx, &l.cy, &l.a, &l.b) != 5 || frame < 0)
+            continue;   // 表头和空行
+        if ((size_t)frame >= labels.size())
+            labels.resize(frame + 1);
+        labels[frame].push_back(l);
+        n++;
+    }
+    fclose(f);
+    printf("LABELS %d ellipses in %lu frames from %s\n", n, (unsigned long)labels.size(), path);
+    return n > 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   评估一组参数
+// ------------------------------------------------------------------------------
+struct Tune_Result
+{
+    Detector_Config config;
+    double p50_ms, p95_ms, mean_ms;
+    int tp, fp, fn;
+    double precision, recall, f1;
+    bool pareto;
+};
+
+// 贪心匹配: 按距离从近到远, 每个标注和每个检测最多用一次
+static void
+match(const vector<Label> &labels, const vector<Ellipse> &ells, float tol, int &tp, int &fp, int &fn)
+{
+    struct Pair { float d; int l, e; };
+    vector<Pair> pairs;
+    for (size_t i = 0; i < labels.size(); i++)
+    {
+        const Label &l = labels[i];
+        float la = max(l.a, l.b);
+        for (size_t j = 0; j < ells.size(); j++)
+        {
+            const Ellipse &e = ells[j];
+            float d = hypotf(e._xc - l.cx, e._yc - l.cy);
+            if (d <= tol * la && fabsf(max(e._a, e._b) - la) <= tol * la)
+                pairs.push_back({d, (int)i, (int)j});
+        }
+    }
+    sort(pairs.begin(), pairs.end(), [](const Pair &x, const Pair &y) { return x.d < y.d; });
+
+    vector<bool> label_used(labels.size(), false), ell_used(ells.size(), false);
+    int matched = 0;
+    for (auto &p : pairs)
+    {
+        if (label_used[p.l] || ell_used[p.e])
+            continue;
+        label_used[p.l] = ell_used[p.e] = true;
+        matched++;
+    }
+    tp += matched;
+    fp += (int)ells.size() - matched;
+    fn += (int)labels.size() - matched;
+}
+
+static double
+percentile(vector<double> &v, double p)
+{
+    if (v.empty())
+        return 0;
+    sort(v.begin(), v.end());
+    size_t k = (size_t)ceil(p / 100.0 * v.size());
+    return v[k > 0 ? k - 1 : 0];
+}
+
+static void
+evaluate(CEllipseDetectorYaed &yaed, const vector<Labelled_Frame> &frames, Size work, int repeat, float tol,
+         Tune_Result &r)
+{
+    r.config.apply(yaed, work);
+
+    // 预热, 不计入
+    vector<Ellipse> warm;
+    Mat1b first = frames[0].gray.clone();
+    yaed.Detect(first, warm);
+
+    vector<double> ms;
+    r.tp = r.fp = r.fn = 0;
+    for (int rep = 0; rep < repeat; rep++)
+    {
+        for (auto &f : frames)
+        {
+            // Detect 在输入图上做高斯滤波, 每次用一份拷贝
+            Mat1b gray = f.gray.clone();
+            vector<Ellipse> ells;
+            double t0 = (double)getTickCount();
+            yaed.Detect(gray, ells);
+            ms.push_back(((double)getTickCount() - t0) * 1000. / getTickFrequency());
+            if (rep == 0)
+                match(f.labels, ells, tol, r.tp, r.fp, r.fn);
+        }
+    }
+
+    double s = 0;
+    for (double x : ms)
+        s += x;
+    r.mean_ms = s / ms.size();
+    r.p50_ms = percentile(ms, 50);
+    r.p95_ms = percentile(ms, 95);
+    r.precision = r.tp + r.fp > 0 ? (double)r.tp / (r.tp + r.fp) : 0;
+    r.recall = r.tp + r.fn > 0 ? (double)r.tp / (r.tp + r.fn) : 0;
+    r.f1 = r.precision + r.recall > 0 ? 2 * r.precision * r.recall / (r.precision + r.recall) : 0;
+    r.pareto = false;
+}
+
+// a 在耗时 (p50)、准确率、召回率上都不差于 b, 且至少一项更好
+static bool
+dominates(const Tune_Result &a, const Tune_Result &b)
+{
+    if (a.p50_ms > b.p50_ms || a.precision < b.precision || a.recall < b.recall)
+        return false;
+    return a.p50_ms < b.p50_ms || a.precision > b.precision || a.recall > b.recall;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Parse Command Line
+// ------------------------------------------------------------------------------
+static const char *commandline_usage =
+        "usage: tune_detector <dir|video> <labels.csv> [-o tune_detector.json] [-s 640x360] [-j threads] [-n samples] "
+        "[-r repeat] [--config uav.yml] [--tol 0.15] [-g name=v1,v2,...]";
+
+static void
+parse_commandline(int argc, char **argv, const char *&source, const char *&labels_path, const char *&out_path,
+                  const char *&config_path, Size &work, int &threads, int &samples, int &repeat, float &tol,
+                  Param_Grid &grid)
+{
+    int positional = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("%s\n", commandline_usage);
+            throw EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "-j") == 0 ||
+            strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-g") == 0 ||
+            strcmp(argv[i], "--config") == 0 || strcmp(argv[i], "--tol") == 0) {
+            if (argc <= i + 1) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            const char *option = argv[i];
+            const char *value = argv[++i];
+            bool ok = true;
+            if (strcmp(option, "--config") == 0)
+                config_path = value;
+            else if (strcmp(option, "--tol") == 0)
+                ok = (tol = atof(value)) > 0;
+            else switch (option[1])
+            {
+                case 'o': out_path = value; break;
+                case 'j': threads = max(1, atoi(value)); break;
+                case 'n': samples = max(0, atoi(value)); break;
+                case 'r': repeat = max(1, atoi(value)); break;
+                case 's': ok = sscanf(value, "%dx%d", &work.width, &work.height) == 2 &&
+                               work.width > 0 && work.height > 0; break;
+                case 'g': ok = parse_grid(value, grid); break;
+            }
+            if (!ok) {
+                printf("%s\n", commandline_usage);
+                throw EXIT_FAILURE;
+            }
+            continue;
+        }
+
+        if (positional == 0)
+            source = argv[i];
+        else if (positional == 1)
+            labels_path = argv[i];
+        positional++;
+    }
+
+    if (positional != 2) {
+        printf("%s\n", commandline_usage);
+        throw EXIT_FAILURE;
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+//   TOP
+// ------------------------------------------------------------------------------
+int
+top(int argc, char **argv)
+{
+    const char *source = NULL, *labels_path = NULL;
+    const char *out_path = "tune_detector.json";
+    const char *config_path = RUNTIME_CONFIG_FILE;
+    Size work(640, 360);
+    int threads = max(1, (int)thread::hardware_concurrency());
+    int samples = 0, repeat = 1;
+    float tol = 0.15f;
+    Param_Grid grid;
+    parse_commandline(argc, argv, source, labels_path, out_path, config_path, work, threads, samples, repeat,
+                      tol, grid);
+
+    load_runtime_config(config_path);
+    Detector_Config base = runtime_config.vision.detector;
+
+    vector<Mat3b> images;
+    if (!load_frames(source, images))
+    {
+        fprintf(stderr, "ERROR: no frames in %s\n", source);
+        return EXIT_FAILURE;
+    }
+    vector<vector<Label> > labels;
+    if (!load_labels(labels_path, labels))
+        return EXIT_FAILURE;
+    if (labels.size() > images.size())
+        fprintf(stderr, "WARNING: labels for %lu frames, only %lu frames in %s\n",
+                (unsigned long)labels.size(), (unsigned long)images.size(), source);
+
+    // 缩放和灰度转换不计入检测耗时
+    vector<Labelled_Frame> frames(images.size());
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        Mat3b resized;
+        resize(images[i], resized, work, 0, 0, INTER_AREA);
+        cvtColor(resized, frames[i].gray, COLOR_BGR2GRAY);
+        float sx = (float)work.width / images[i].cols, sy = (float)work.height / images[i].rows;
+        if (i < labels.size())
+            for (auto l : labels[i])
+            {
+                l.cx *= sx;
+                l.cy *= sy;
+                l.a *= sx;
+                l.b *= sy;
+                frames[i].labels.push_back(l);
+            }
+    }
+    images.clear();
+
+    // 要评估的参数组: 第一组为 --config 中的参数, 作为对照
+    vector<Tune_Result> results(1);
+    results[0].config = base;
+    vector<size_t> order(grid.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    if (samples > 0 && (size_t)samples < order.size())
+    {
+        mt19937 rng(1);
+        shuffle(order.begin(), order.end(), rng);
+        order.resize(samples);
+        sort(order.begin(), order.end());
+    }
+    for (size_t i : order)
+    {
+        Tune_Result r;
+        r.config = grid.at(i, base);
+        results.push_back(r);
+    }
+    threads = min(threads, (int)results.size());
+    printf("TUNE %lu parameter sets on %lu frames at %dx%d, %d threads\n", (unsigned long)results.size(),
+           (unsigned long)frames.size(), work.width, work.height, threads);
+
+    // ------------------------------------------------------------------------------
+    //   并行评估, 每个线程一个检测器
+    // ------------------------------------------------------------------------------
+    atomic<size_t> next(0), done(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.push_back(thread([&]() {
+            CEllipseDetectorYaed yaed;
+            for (size_t i = next++; i < results.size(); i = next++)
+            {
+                evaluate(yaed, frames, work, repeat, tol, results[i]);
+                size_t n = ++done;
+                if (n % 20 == 0 || n == results.size())
+                    fprintf(stderr, "\r%lu / %lu", (unsigned long)n, (unsigned long)results.size());
+            }
+        }));
+    }
+    for (auto &w : workers)
+        w.join();
+    fprintf(stderr, "\n");
+
+    // Pareto 前沿
+    vector<size_t> front;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        bool dominated = false;
+        for (size_t j = 0; j < results.size() && !dominated; j++)
+            dominated = j != i && dominates(results[j], results[i]);
+        results[i].pareto = !dominated;
+        if (!dominated)
+            front.push_back(i);
+    }
+    sort(front.begin(), front.end(), [&](size_t a, size_t b) { return results[a].p50_ms < results[b].p50_ms; });
+
+    printf("\nPARETO latency / precision / recall\n");
+    printf("%-10s %-7s %-4s %-9s %-16s %8s %8s %9s %7s %7s\n", "th_length", "th_obb", "ns", "th_score",
+            "min_reliability", "p50_ms", "p95_ms", "precision", "recall", "f1");
+    for (size_t i : front)
+    {
+        const Tune_Result &r = results[i];
+        printf("%-10d %-7.2f %-4d %-9.2f %-16.2f %8.2f %8.2f %9.3f %7.3f %7.3f%s\n",
+                r.config.th_length, r.config.th_obb, r.config.ns, r.config.th_score, r.config.min_reliability,
+                r.p50_ms, r.p95_ms, r.precision, r.recall, r.f1, i == 0 ? "  (config)" : "");
+    }
+    const Tune_Result &b = results[0];
+    if (!b.pareto)
+        printf("config: p50 %.2f ms, precision %.3f, recall %.3f (not on the front)\n",
+                b.p50_ms, b.precision, b.recall);
+
+    // ------------------------------------------------------------------------------
+    //   JSON 输出
+    // ------------------------------------------------------------------------------
+    FILE *f = fopen(out_path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", out_path);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(f, "{\n  \"source\": \"%s\",\n  \"labels\": \"%s\",\n  \"frames\": %lu,\n"
+               "  \"width\": %d, \"height\": %d,\n  \"threads\": %d,\n  \"tol\": %.3f,\n  \"results\": [\n",
+            json_escape(source).c_str(), json_escape(labels_path).c_str(), (unsigned long)frames.size(), work.width, work.height, threads, tol);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Tune_Result &r = results[i];
+        fprintf(f, "    {\"th_length\": %d, \"th_obb\": %.3f, \"ns\": %d, \"th_score\": %.3f, \"min_reliability\": %.3f, "
+                   "\"p50_ms\": %.4f, \"p95_ms\": %.4f, \"mean_ms\": %.4f, \"tp\": %d, \"fp\": %d, \"fn\": %d, "
+                   "\"precision\": %.4f, \"recall\": %.4f, \"f1\": %.4f, \"pareto\": %s, \"config\": %s}%s\n",
+                r.config.th_length, r.config.th_obb, r.config.ns, r.config.th_score, r.config.min_reliability,
+                r.p50_ms, r.p95_ms, r.mean_ms, r.tp, r.fp, r.fn, r.precision, r.recall, r.f1,
+                r.pareto ? "true" : "false", i == 0 ? "true" : "false", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ],\n  \"pareto\": [");
+    for (size_t k = 0; k < front.size(); k++)
+        fprintf(f, "%s%lu", k ? ", " : "", (unsigned long)front[k]);
+    fprintf(f, "]\n}\n");
+    fclose(f);
+    printf("results written to %s\n", out_path);
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Main
+// ------------------------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+    try
+    {
+        int result = top(argc, argv);
+        return result;
+    }
+
+    catch ( int error )
+    {
+        fprintf(stderr, "tune_detector threw exception %i \n", error);
+        return error;
+    }
+}
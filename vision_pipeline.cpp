@@ -0,0 +1,182 @@
+/**
+ * @file vision_pipeline.cpp
+ *
+ * @brief Per-frame vision chain: ellipse detection, colour check, T/F recognition and target update
+ *
+ */
+
+#include "vision_pipeline.h"
+#include "metrics.h"
+
+
+Vision_Pipeline::
+Vision_Pipeline()
+{
+    yaed = new CEllipseDetectorYaed();
+    classified = false;
+    drop_found = false;
+    config_version = 0;
+}
+
+Vision_Pipeline::
+~Vision_Pipeline()
+{
+    delete yaed;
+}
+
+
+// ------------------------------------------------------------------------------
+//   检测参数
+// ------------------------------------------------------------------------------
+void
+Vision_Pipeline::
+setup(cv::Size work_)
+{
+    work = work_;
+    yaed->SetDefaultParameters(work);
+    config_version = 0;
+    update_config();
+}
+
+// SIGHUP 后重新读配置文件; vision_config 有新版本时设置到检测器
+void
+Vision_Pipeline::
+update_config()
+{
+    config_poll_reload();
+
+    uint64_t version = 0;
+    Vision_Config_Ptr config = vision_config.latest(&version);
+    if (!config || version == config_version)
+        return;
+    config->detector.apply(*yaed, work);
+    yaed->color = config->color;
+    config_version = version;
+}
+
+
+// ------------------------------------------------------------------------------
+//   与任务线程交换状态
+// ------------------------------------------------------------------------------
+// 任务线程改变了工作方式时, 上一次的识别结论和投放点不再有效
+void
+Vision_Pipeline::
+update_mode()
+{
+    Vision_Mode_Ptr next = vision_mode.latest();
+    if (!next || next->epoch == mode.epoch)
+        return;
+    mode = *next;
+    classified = false;
+    droptarget = coordinate();
+    drop_found = false;
+}
+
+void
+Vision_Pipeline::
+publish(const Capture_Frame &frame)
+{
+    std::shared_ptr<Target_Snapshot> snapshot = std::make_shared<Target_Snapshot>();
+    snapshot->frame_seq = frame.seq;
+    snapshot->time_usec = frame.time_usec;
+    snapshot->mode_epoch = mode.epoch;
+    snapshot->targets = targets;
+    snapshot->T = T;
+    snapshot->F = F;
+    snapshot->classified = classified;
+    snapshot->drop_found = drop_found;
+    snapshot->drop_target = droptarget;
+    target_channel.publish(snapshot);
+}
+
+
+// ------------------------------------------------------------------------------
+//   处理一帧
+// ------------------------------------------------------------------------------
+void
+Vision_Pipeline::
+process(Autopilot_Interface &api, Camera_Capture &camera, Capture_Frame &frame, Vision_Result &result)
+{
+    double t0 = (double)getTickCount();
+    uint64_t frame_usec = frame.time_usec;
+    float scale = camera.scale();//大图相对检测图的倍数
+
+    result.seq = frame.seq;
+    result.time_usec = frame_usec;
+    result.candidates = 0;
+    result.T = result.F = 0;
+    result.ellipses.clear();
+    update_mode();
+    update_config();
+
+    vector<Ellipse> ellsYaed, ellipse_in, ellipse_big, ellipseok;
+    yaed->Detect(frame.gray, ellsYaed);
+    result.detect_ms = ((double)getTickCount() - t0) * 1000. / getTickFrequency();
+    result.detected = ellsYaed.size();
+
+    resultImage = frame.small.clone();
+    Mat3b resultImage2 = frame.small.clone();
+    vector<coordinate> ellipse_out, ellipse_TF, ellipse_out1;
+    if(api.current_messages.time_stamps.local_position_ned){
+        OptimizEllipse(ellipse_in, ellsYaed);//对椭圆检测部分得到的椭圆进行预处理，输出仅有大圆的vector
+        if (!mode.drop) {
+            yaed->targetcolor(resultImage2, ellipse_in, ellipse_big);
+            filtellipse(api, ellipseok, ellipse_big, frame_usec);//滤除偶然检测出的圆
+            yaed->DrawDetectedEllipses(resultImage, ellipse_out, ellipseok);//绘制检测到的椭圆
+            vector<vector<Point> > contours;
+            // 与原来一样只在悬停识别阶段 (stable) 识别 T 和 F, resultTF 的票数阈值按这一阶段的帧数设定
+            if (mode.stable) {
+                if (!ellipse_out.empty())
+                    visual_rec_fast(camera.full(), scale, current_vision_config()->target.tf_symmetry,
+                                    ellipse_out, ellipse_TF, contours);//T和F的检测程序, 只有看到椭圆时才解码大图
+                ellipse_out1 = ellipse_TF;
+            } else
+                ellipse_out1 = ellipse_out;
+            for (auto &p:contours) {
+                vector<vector<Point> > contours1(1);
+                for (auto &q:p)
+                    contours1[0].push_back(Point(q.x / scale, q.y / scale));
+                drawContours(resultImage, contours1, 0, Scalar(255, 255, 0), 1);
+            }
+            possible_ellipse_r(api, mode, ellipse_out1, targets, frame_usec);//修改后的椭圆更新函数
+            if(mode.stable && resultTF(api, mode, targets, T, F)) {
+                classified = true;
+                mode.stable = false;//与原来清零 stable 相同, 之后按普通方式更新目标
+            }
+
+        } else {
+            yaed->targetcolor(resultImage2, ellipse_in, ellipse_big);
+            filtellipse(api, ellipseok, ellipse_big, frame_usec);//滤除偶然检测出的圆
+            yaed->DrawDetectedEllipses(resultImage, ellipse_out, ellipseok);//绘制检测到的椭圆
+            if (getdroptarget(api, droptarget, ellipse_out, frame_usec))
+                drop_found = true;
+            ellipse_out1 = ellipse_out;
+        }
+    }
+
+    result.candidates = ellipse_big.size();
+    for (auto &p:ellipse_out1) {
+        if (p.flag == 1)
+            result.T++;
+        else if (p.flag == 0)
+            result.F++;
+    }
+    result.ellipses.swap(ellipse_out1);
+    publish(frame);
+    result.total_ms = ((double)getTickCount() - t0) * 1000. / getTickFrequency();
+
+    // 各阶段耗时直方图, 名字顺序与 GetTimes() 一致
+    static Metric_Counter &frames = metrics.counter("vision.frames");
+    static Metric_Histogram &detect_us = metrics.histogram("vision.detect_us");
+    static Metric_Histogram &total_us = metrics.histogram("vision.total_us");
+    static Metric_Histogram *stage_us[6] = {
+            &metrics.histogram("vision.edge_us"), &metrics.histogram("vision.preprocess_us"),
+            &metrics.histogram("vision.grouping_us"), &metrics.histogram("vision.estimation_us"),
+            &metrics.histogram("vision.validation_us"), &metrics.histogram("vision.clustering_us")};
+    frames.add();
+    detect_us.record((uint64_t)(result.detect_ms * 1000));
+    total_us.record((uint64_t)(result.total_ms * 1000));
+    vector<double> times = yaed->GetTimes();
+    for (int k = 0; k < 6 && k < (int)times.size(); k++)
+        stage_us[k]->record((uint64_t)(times[k] * 1000));
+}
@@ -0,0 +1,71 @@
+/**
+ * @file vision_pipeline.h
+ *
+ * @brief Per-frame vision chain: ellipse detection, colour check, T/F recognition and target update
+ *
+ * videothread 和离线回放工具 (tools/replay.cpp) 共用同一套处理流程,
+ * 每帧调用一次 process. 目标表由 Vision_Pipeline 独占, 每帧处理完后向 target_channel 发布一份快照;
+ * 任务线程通过 vision_mode 改变工作方式, 在下一帧开始时生效.
+ * 检测参数和颜色阈值取自 vision_config (见 runtime_config.h), 重新载入后同样在下一帧开始时生效.
+ *
+ */
+
+#ifndef VISION_PIPELINE_H_
+#define VISION_PIPELINE_H_
+
+#include <vector>
+#include <cv.h>
+
+#include "autopilot_interface.h"
+#include "camera_capture.h"
+#include "target_channel.h"
+#include "runtime_config.h"
+#include "ellipse/EllipseDetectorYaed.h"
+
+
+// 一帧的处理结果和耗时
+struct Vision_Result
+{
+    uint64_t seq;
+    uint64_t time_usec;         // 图像采集时刻
+    int detected;               // 椭圆检测得到的椭圆数
+    int candidates;             // 颜色检验后剩下的椭圆数
+    int T, F;                   // 本帧识别为 T / F 的椭圆数
+    std::vector<coordinate> ellipses;   // 本帧送入目标更新的椭圆
+    double detect_ms;           // 椭圆检测耗时
+    double total_ms;            // 整帧处理耗时
+};
+
+
+class Vision_Pipeline
+{
+
+public:
+
+    Vision_Pipeline();
+    ~Vision_Pipeline();
+
+    void setup(cv::Size work);
+    void process(Autopilot_Interface &api, Camera_Capture &camera, Capture_Frame &frame, Vision_Result &result);
+
+    cv::Mat3b resultImage;      // 画出椭圆和字符区域的检测图
+
+private:
+
+    CEllipseDetectorYaed *yaed;
+    cv::Size work;
+    uint64_t config_version;            // 检测器当前使用的 vision_config 版本
+
+    Vision_Mode mode;                   // 最近一次取用的工作方式
+    std::vector<target> targets, T, F;  // 发现的目标和已给出结论的目标
+    coordinate droptarget;
+    bool drop_found;                    // 本次 mode 下已找到投放点, droptarget 有效
+    bool classified;                    // 本次 mode 下当前目标已给出结论
+
+    void update_mode();
+    void update_config();
+    void publish(const Capture_Frame &frame);
+
+};
+
+#endif // VISION_PIPELINE_H_
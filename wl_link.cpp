@@ -0,0 +1,514 @@
+/**
+ * @file wl_link.cpp
+ *
+ * @brief Multi-vehicle WL radio link: addressing, priority queue, ack / retry, peer status
+ *
+ */
+
+#include "wl_link.h"
+#include "flight_log.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <string>
+
+
+// ------------------------------------------------------------------------------
+//   寻址
+// ------------------------------------------------------------------------------
+// 消息本身带目标字段时用该字段, 否则为 compid
+static uint8_t
+target_of(const mavlink_message_t &message)
+{
+    switch (message.msgid)
+    {
+        case MAVLINK_MSG_ID_COMMAND_LONG:
+            return mavlink_msg_command_long_get_target_system(&message);
+        case MAVLINK_MSG_ID_PING:
+            return mavlink_msg_ping_get_target_system(&message);
+        case MAVLINK_MSG_ID_V2_EXTENSION:
+            return mavlink_msg_v2_extension_get_target_system(&message);
+        default:
+            return message.compid;
+    }
+}
+
+uint8_t
+wl_destination(const mavlink_message_t &message)
+{
+    // 地面站不知道这里的约定, 它发来的消息所有飞机都处理
+    if (message.sysid == WL_GROUND_ID)
+        return WL_BROADCAST;
+    return target_of(message);
+}
+
+static uint16_t
+ack_key(const mavlink_message_t &message)
+{
+    if (message.msgid == MAVLINK_MSG_ID_COMMAND_LONG)
+        return mavlink_msg_command_long_get_command(&message);
+    return WL_ACK_SEQ | message.seq;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Con/De structors
+// ------------------------------------------------------------------------------
+Wl_Link::
+Wl_Link()
+{
+    heartbeat_ms = 1000;
+    ping_ms = 2000;
+    retry_ms = 300;
+    max_retry_ms = 2000;
+    max_attempts = 5;
+    peer_timeout_ms = 3000;
+
+    port = NULL;
+    sysid = 0;
+    time_to_exit = false;
+    ping_seq = 0;
+    next_heartbeat_usec = 0;
+    next_ping_usec = 0;
+    memset(peers, 0, sizeof(peers));
+
+    pthread_mutex_init(&lock, NULL);
+
+    // 重发时刻按单调时钟计算
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+Wl_Link::
+~Wl_Link()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+void
+Wl_Link::
+open(Serial_Port *port_, uint8_t system_id)
+{
+    port = port_;
+    sysid = system_id;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Send
+// ------------------------------------------------------------------------------
+bool
+Wl_Link::
+send(const mavlink_message_t &message, uint8_t priority, bool reliable)
+{
+    Wl_Packet packet;
+    packet.message = message;
+    packet.priority = priority < WL_PRIORITIES ? priority : (uint8_t)WL_PRIORITY_LOW;
+    packet.dest = target_of(message);
+    packet.reliable = reliable && packet.dest != WL_BROADCAST;    // 广播不确认
+    packet.ack_key = ack_key(message);
+    packet.attempts = 0;
+    packet.queued_usec = metrics_now_usec();
+    packet.sent_usec = 0;
+    packet.next_usec = 0;
+
+    pthread_mutex_lock(&lock);
+    bool queued = enqueue(packet, false);
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+    return queued;
+}
+
+// 持有 lock 时调用
+bool
+Wl_Link::
+enqueue(const Wl_Packet &packet, bool front)
+{
+    static Metric_Counter &dropped = metrics.counter("wl.tx_dropped");
+
+    std::deque<Wl_Packet> &q = queue[packet.priority];
+    bool room = q.size() < WL_QUEUE_SIZE;
+    if (!room)
+    {
+        q.pop_front();
+        dropped.add();
+    }
+    if (front)
+        q.push_front(packet);
+    else
+        q.push_back(packet);
+    return room;
+}
+
+void
+Wl_Link::
+send_ack(const mavlink_message_t &message)
+{
+    mavlink_message_t ack;
+    mavlink_msg_command_ack_pack(sysid, message.sysid, &ack, ack_key(message), MAV_RESULT_ACCEPTED);
+    send(ack, WL_PRIORITY_HIGH, false);
+}
+
+
+// ------------------------------------------------------------------------------
+//   Receive
+// ------------------------------------------------------------------------------
+bool
+Wl_Link::
+receive(const mavlink_message_t &message)
+{
+    static Metric_Counter &not_for_us = metrics.counter("wl.rx_not_for_us");
+    static Metric_Counter &duplicates = metrics.counter("wl.rx_duplicates");
+
+    uint8_t from = message.sysid;
+    uint8_t dest = wl_destination(message);
+    if (from == sysid || (dest != WL_BROADCAST && dest != sysid))
+    {
+        not_for_us.add();
+        return false;
+    }
+
+    uint64_t now = metrics_now_usec();
+    bool deliver = true;
+    bool ack = false;
+
+    pthread_mutex_lock(&lock);
+    Wl_Peer &peer = touch_peer(from, now);
+    peer.rx++;
+
+    switch (message.msgid)
+    {
+        case MAVLINK_MSG_ID_HEARTBEAT:
+        {
+            peer.last_heartbeat_usec = now;
+            if (!peer.alive)
+            {
+                peer.alive = true;
+                FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "WL peer %d up", from);
+            }
+            if (peer.heartbeat_age)
+                peer.heartbeat_age->touch();
+            break;
+        }
+
+        case MAVLINK_MSG_ID_COMMAND_ACK:
+        {
+            handle_ack(from, mavlink_msg_command_ack_get_command(&message), now);
+            deliver = false;
+            break;
+        }
+
+        case MAVLINK_MSG_ID_PING:
+        {
+            handle_ping(message, now);
+            deliver = false;
+            break;
+        }
+
+        default:
+        {
+            // 单播和命令要回确认; 重传的消息回确认但不再交给上层
+            ack = dest == sysid || message.msgid == MAVLINK_MSG_ID_COMMAND_LONG;
+            if (ack && duplicate(peer, message, now))
+            {
+                peer.duplicates++;
+                duplicates.add();
+                deliver = false;
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    if (ack)
+        send_ack(message);
+    return deliver;
+}
+
+// 持有 lock 时调用
+Wl_Peer &
+Wl_Link::
+touch_peer(uint8_t id, uint64_t now)
+{
+    Wl_Peer &peer = peers[id];
+    if (!peer.known)
+    {
+        memset(&peer, 0, sizeof(peer));
+        peer.known = true;
+        peer.rtt_ms = peer.rtt_avg_ms = -1;
+        std::string name = "wl.peer" + std::to_string(id) + ".heartbeat";
+        peer.heartbeat_age = &metrics.age(name.c_str());
+    }
+    peer.last_rx_usec = now;
+    return peer;
+}
+
+// 持有 lock 时调用
+bool
+Wl_Link::
+duplicate(Wl_Peer &peer, const mavlink_message_t &message, uint64_t now)
+{
+    uint32_t key = ((uint32_t)message.msgid << 8) | message.seq;
+
+    // 包序号 8 位, 只在重发周期内比较
+    uint64_t window = (uint64_t)max_retry_ms * max_attempts * 1000;
+    for (int i = 0; i < WL_DEDUP_SIZE; i++)
+        if (peer.recent_usec[i] && peer.recent[i] == key && now - peer.recent_usec[i] < window)
+            return true;
+
+    peer.recent[peer.recent_next] = key;
+    peer.recent_usec[peer.recent_next] = now;
+    peer.recent_next = (peer.recent_next + 1) % WL_DEDUP_SIZE;
+    return false;
+}
+
+// 持有 lock 时调用
+void
+Wl_Link::
+handle_ack(uint8_t from, uint16_t key, uint64_t now)
+{
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        Wl_Packet &packet = pending[i];
+        if (packet.dest != from || packet.ack_key != key)
+            continue;
+
+        // 重发过的消息分不清确认的是哪一次, 不计延迟
+        if (packet.attempts == 1)
+            record_rtt(from, now - packet.sent_usec);
+        peers[from].acked++;
+        pending.erase(pending.begin() + i);
+        return;
+    }
+}
+
+// 持有 lock 时调用. target_system 为 0 的是请求, 原样带回 time_usec; 为本机号的是回应
+void
+Wl_Link::
+handle_ping(const mavlink_message_t &message, uint64_t now)
+{
+    mavlink_ping_t ping;
+    mavlink_msg_ping_decode(&message, &ping);
+
+    if (ping.target_system == WL_BROADCAST)
+    {
+        Wl_Packet reply;
+        mavlink_msg_ping_pack(sysid, message.sysid, &reply.message,
+                              ping.time_usec, ping.seq, message.sysid, message.compid);
+        reply.priority = WL_PRIORITY_HIGH;
+        reply.dest = message.sysid;
+        reply.reliable = false;
+        reply.ack_key = 0;
+        reply.attempts = 0;
+        reply.queued_usec = now;
+        reply.sent_usec = reply.next_usec = 0;
+        enqueue(reply, false);
+        pthread_cond_signal(&cond);
+    }
+    else if (ping.target_system == sysid && ping.time_usec <= now)
+        record_rtt(message.sysid, now - ping.time_usec);
+}
+
+// 持有 lock 时调用
+void
+Wl_Link::
+record_rtt(uint8_t from, uint64_t rtt_usec)
+{
+    static Metric_Histogram &rtt = metrics.histogram("wl.rtt_us");
+
+    rtt.record(rtt_usec);
+    Wl_Peer &peer = peers[from];
+    peer.rtt_ms = rtt_usec / 1000.0f;
+    if (peer.rtt_avg_ms < 0)
+        peer.rtt_avg_ms = peer.rtt_ms;
+    else
+        peer.rtt_avg_ms += 0.2f * (peer.rtt_ms - peer.rtt_avg_ms);
+}
+
+bool
+Wl_Link::
+peer(uint8_t id, Wl_Peer &out)
+{
+    pthread_mutex_lock(&lock);
+    out = peers[id];
+    pthread_mutex_unlock(&lock);
+    return out.known;
+}
+
+
+// ------------------------------------------------------------------------------
+//   Write Thread
+// ------------------------------------------------------------------------------
+void
+Wl_Link::
+run()
+{
+    static Metric_Counter &tx = metrics.counter("wl.tx_messages");
+
+    pthread_mutex_lock(&lock);
+    while (!time_to_exit)
+    {
+        uint64_t now = metrics_now_usec();
+        update_alive(now);
+
+        Wl_Packet packet;
+        uint64_t deadline;
+        if (!next_packet(packet, now, deadline))
+        {
+            struct timespec ts;
+            ts.tv_sec = deadline / 1000000;
+            ts.tv_nsec = (deadline % 1000000) * 1000;
+            pthread_cond_timedwait(&cond, &lock, &ts);
+            continue;
+        }
+
+        // 写串口 (57600 时每条几个毫秒) 期间不持有 lock, 不影响 send() 和读线程
+        pthread_mutex_unlock(&lock);
+        if (port)
+            port->write_message(packet.message);
+        tx.add();
+        pthread_mutex_lock(&lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void
+Wl_Link::
+stop()
+{
+    pthread_mutex_lock(&lock);
+    time_to_exit = true;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+// 持有 lock 时调用. 取下一条要写的消息; 没有时给出下一次需要醒来的时刻
+bool
+Wl_Link::
+next_packet(Wl_Packet &packet, uint64_t now, uint64_t &deadline)
+{
+    static Metric_Counter &retries = metrics.counter("wl.tx_retries");
+    static Metric_Counter &failed = metrics.counter("wl.tx_failed");
+
+    // 到期的重发放回所属优先级队列的最前面
+    for (size_t i = 0; i < pending.size();)
+    {
+        Wl_Packet &p = pending[i];
+        if (p.next_usec > now)
+        {
+            i++;
+            continue;
+        }
+        if (p.attempts >= max_attempts)
+        {
+            peers[p.dest].failed++;
+            failed.add();
+            FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "WL msg %d to %d not acknowledged after %d attempts",
+                           p.message.msgid, p.dest, p.attempts);
+        }
+        else
+            enqueue(p, true);
+        pending.erase(pending.begin() + i);
+    }
+
+    // 心跳和 PING 请求都是广播
+    if (now >= next_heartbeat_usec)
+    {
+        mavlink_message_t heartbeat;
+        mavlink_msg_heartbeat_pack(sysid, WL_BROADCAST, &heartbeat, MAV_TYPE_ONBOARD_CONTROLLER,
+                                   MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+        Wl_Packet p;
+        p.message = heartbeat;
+        p.priority = WL_PRIORITY_LOW;
+        p.dest = WL_BROADCAST;
+        p.reliable = false;
+        p.ack_key = 0;
+        p.attempts = 0;
+        p.queued_usec = now;
+        p.sent_usec = p.next_usec = 0;
+        enqueue(p, false);
+        next_heartbeat_usec = now + (uint64_t)heartbeat_ms * 1000;
+    }
+    bool ping_due = now >= next_ping_usec;
+
+    for (int priority = 0; priority < WL_PRIORITIES; priority++)
+    {
+        if (queue[priority].empty())
+            continue;
+
+        packet = queue[priority].front();
+        queue[priority].pop_front();
+        packet.attempts++;
+        packet.sent_usec = now;
+        if (packet.dest != WL_BROADCAST)
+            peers[packet.dest].tx++;
+        if (packet.attempts > 1)
+        {
+            peers[packet.dest].retries++;
+            retries.add();
+        }
+
+        // 先放进等待确认的表再写, 写的过程中到达的确认也能对上
+        if (packet.reliable)
+        {
+            uint64_t backoff = (uint64_t)retry_ms << (packet.attempts - 1);
+            if (backoff > max_retry_ms)
+                backoff = max_retry_ms;
+            packet.next_usec = now + backoff * 1000;
+            pending.push_back(packet);
+        }
+        return true;
+    }
+
+    // 队列空时才发 PING, time_usec 取真正发送的时刻
+    if (ping_due)
+    {
+        mavlink_msg_ping_pack(sysid, WL_BROADCAST, &packet.message, now, ping_seq++, WL_BROADCAST, 0);
+        packet.priority = WL_PRIORITY_LOW;
+        packet.dest = WL_BROADCAST;
+        packet.reliable = false;
+        packet.ack_key = 0;
+        packet.attempts = 1;
+        packet.queued_usec = packet.sent_usec = now;
+        packet.next_usec = 0;
+        next_ping_usec = now + (uint64_t)ping_ms * 1000;
+        return true;
+    }
+
+    deadline = next_heartbeat_usec < next_ping_usec ? next_heartbeat_usec : next_ping_usec;
+    for (size_t i = 0; i < pending.size(); i++)
+        if (pending[i].next_usec < deadline)
+            deadline = pending[i].next_usec;
+    return false;
+}
+
+// 持有 lock 时调用
+void
+Wl_Link::
+update_alive(uint64_t now)
+{
+    static Metric_Gauge &alive = metrics.gauge("wl.peers_alive");
+
+    int n = 0;
+    for (int id = 0; id < WL_MAX_PEERS; id++)
+    {
+        Wl_Peer &peer = peers[id];
+        if (!peer.alive)
+            continue;
+        if (now - peer.last_heartbeat_usec > (uint64_t)peer_timeout_ms * 1000)
+        {
+            peer.alive = false;
+            FLIGHT_LOG_MSG(LOG_LEVEL_INFO, "WL peer %d lost", id);
+            continue;
+        }
+        n++;
+    }
+    alive.set(n);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file wl_link.h
+ *
+ * @brief Multi-vehicle WL radio link: addressing, priority queue, ack / retry, peer status
+ *
+ * 原来的机间通信把目标机号同时写进 sysid 和 compid, 每条消息阻塞地连发 20 次,
+ * 接收方只认 sysid 40 和本机号, 没有确认也不知道对方是否在线. 现在的约定:
+ *
+ *   - sysid 为发送方机号, 目标由消息本身的 target_system 字段给出
+ *     (COMMAND_LONG / PING / V2_EXTENSION), 没有该字段的消息目标写在 compid 中, 0 为广播.
+ *     地面站 (WL_GROUND_ID) 发来的消息沿用原来的规则, 不按 compid 过滤.
+ *   - 发给本机的单播消息由接收方回 COMMAND_ACK: COMMAND_LONG 按标准回命令号,
+ *     其他消息回 WL_ACK_SEQ | 包序号. 重复收到的消息 (重传) 只回确认, 不再交给上层处理.
+ *   - 发送方 send() 只把消息放进按优先级分开的队列后立即返回; 写线程按优先级发送,
+ *     reliable 的单播消息在收到确认前按指数退避重发, 超过 max_attempts 次记为失败.
+ *   - 写线程每秒广播一次 HEARTBEAT, 每 ping_ms 广播一次 PING, 按回应计算各机的往返延迟.
+ *
+ * 57600 的数传上一条 GLOBAL_POSITION_INT 约 6ms, 确认约 2ms, 心跳和 PING 的负载可以忽略.
+ *
+ */
+
+#ifndef WL_LINK_H_
+#define WL_LINK_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+#include "serial_port.h"
+
+struct Metric_Age;
+
+#define WL_BROADCAST        0
+#define WL_GROUND_ID        40          // 地面站, 原来所有飞机都接收 sysid 40 的消息
+#define WL_ACK_SEQ          0xFF00      // COMMAND_ACK.command 高字节, 低字节为被确认消息的包序号
+#define WL_MAX_PEERS        256
+#define WL_QUEUE_SIZE       32          // 每个优先级的队列长度
+#define WL_DEDUP_SIZE       16          // 每个对端记住最近收到的消息, 用来丢弃重传
+
+enum Wl_Priority
+{
+    WL_PRIORITY_HIGH = 0,       // 命令和确认
+    WL_PRIORITY_NORMAL,         // 目标位置
+    WL_PRIORITY_LOW,            // 心跳和 PING
+    WL_PRIORITIES,
+};
+
+// 一个对端的状态和统计
+struct Wl_Peer
+{
+    bool known;
+    uint64_t last_rx_usec;          // metrics_now_usec(), 0 为从未收到
+    uint64_t last_heartbeat_usec;
+    bool alive;                     // peer_timeout_ms 内收到过心跳
+    float rtt_ms;                   // 最近一次往返延迟, < 0 为未测到
+    float rtt_avg_ms;               // 指数平均
+    uint32_t rx, tx, acked, retries, failed, duplicates;
+    Metric_Age *heartbeat_age;      // wl.peer<N>.heartbeat
+
+    uint32_t recent[WL_DEDUP_SIZE];     // (msgid << 8) | seq
+    uint64_t recent_usec[WL_DEDUP_SIZE];
+    int recent_next;
+};
+
+// 队列中的一条消息
+struct Wl_Packet
+{
+    mavlink_message_t message;
+    uint8_t priority;
+    uint8_t dest;
+    bool reliable;
+    uint16_t ack_key;               // 期望的 COMMAND_ACK.command
+    int attempts;
+    uint64_t queued_usec;
+    uint64_t sent_usec;             // 最近一次发送
+    uint64_t next_usec;             // 下一次重发
+};
+
+// 消息的目标机号, WL_BROADCAST 为广播
+uint8_t wl_destination(const mavlink_message_t &message);
+
+
+class Wl_Link
+{
+
+public:
+
+    Wl_Link();
+    ~Wl_Link();
+
+    uint32_t heartbeat_ms;      // 心跳间隔
+    uint32_t ping_ms;           // PING 间隔
+    uint32_t retry_ms;          // 第一次重发的等待时间, 之后每次加倍
+    uint32_t max_retry_ms;
+    int max_attempts;
+    uint32_t peer_timeout_ms;   // 超过该时间没有心跳认为对端离线
+
+    void open(Serial_Port *port, uint8_t system_id);
+    uint8_t system_id() const { return sysid; }
+
+    // 放入发送队列, 不阻塞; 队列满时丢弃同优先级中最早的一条, 返回 false
+    bool send(const mavlink_message_t &message, uint8_t priority = WL_PRIORITY_NORMAL, bool reliable = false);
+
+    // 读线程收到一帧时调用. 处理路由、确认、去重、心跳和 PING,
+    // 返回 true 时调用者继续按消息类型处理
+    bool receive(const mavlink_message_t &message);
+
+    // 写线程, 直到 stop()
+    void run();
+    void stop();
+
+    bool peer(uint8_t id, Wl_Peer &out);
+
+private:
+
+    Serial_Port *port;
+    uint8_t sysid;
+    bool time_to_exit;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    std::deque<Wl_Packet> queue[WL_PRIORITIES];
+    std::vector<Wl_Packet> pending;     // 等待确认
+    Wl_Peer peers[WL_MAX_PEERS];
+
+    uint32_t ping_seq;
+    uint64_t next_heartbeat_usec;
+    uint64_t next_ping_usec;
+
+    bool enqueue(const Wl_Packet &packet, bool front);
+    bool next_packet(Wl_Packet &packet, uint64_t now, uint64_t &deadline);
+    void send_ack(const mavlink_message_t &message);
+    void handle_ack(uint8_t from, uint16_t key, uint64_t now);
+    void handle_ping(const mavlink_message_t &message, uint64_t now);
+    void record_rtt(uint8_t from, uint64_t rtt_usec);
+    Wl_Peer &touch_peer(uint8_t id, uint64_t now);
+    bool duplicate(Wl_Peer &peer, const mavlink_message_t &message, uint64_t now);
+    void update_alive(uint64_t now);
+
+};
+
+
+#endif // WL_LINK_H_